@@ -71,6 +71,8 @@ using namespace FIFFLIB;
 FiffStreamServer::FiffStreamServer(QObject *parent)
 : QTcpServer(parent)
 , m_iNextClientId(0)
+, m_defaultSendPolicy(FiffStreamThread::DropOldest)
+, m_iDefaultMaxQueuedBytes(DEFAULT_MAX_QUEUED_BYTES)
 {
 
 }
@@ -175,6 +177,76 @@ void FiffStreamServer::comStopAll(Command p_command)
 }
 
 
+//*************************************************************************************************************
+
+void FiffStreamServer::comCstats(Command p_command)
+{
+    //ToDo JSON
+    QString t_sOutput("");
+    t_sOutput.append("\tID\tAlias\tPolicy\tLimit [B]\tQueued [B]\tDropped\tLag [ms]\r\n");
+    QMap<qint32, FiffStreamThread*>::iterator i;
+    for (i = this->m_qClientList.begin(); i != this->m_qClientList.end(); ++i)
+    {
+        QString str = QString("\t%1\t%2\t%3\t%4\t%5\t%6\t%7\r\n")
+                .arg(i.key())
+                .arg(i.value()->getAlias())
+                .arg(FiffStreamThread::sendPolicyToString(i.value()->getSendPolicy()))
+                .arg(i.value()->getMaxQueuedBytes())
+                .arg(i.value()->getQueuedBytes())
+                .arg(i.value()->getDroppedBuffers())
+                .arg(i.value()->getLag());
+        t_sOutput.append(str);
+    }
+    t_sOutput.append("\n");
+    qobject_cast<MNERTServer*>(this->parent())->getCommandManager()["cstats"].reply(t_sOutput);
+
+    Q_UNUSED(p_command);
+}
+
+
+//*************************************************************************************************************
+
+void FiffStreamServer::comSendpolicy(Command p_command)
+{
+    //Parameters are ordered by name: id, limit, policy
+    QString t_sOutput("");
+    QString t_sAlias(p_command.pValues()[0].toString());
+    qint64 t_iMaxQueuedBytes = p_command.pValues()[1].toLongLong();
+    FiffStreamThread::SendPolicy t_sendPolicy;
+
+    if(t_iMaxQueuedBytes <= 0 || !FiffStreamThread::parseSendPolicy(p_command.pValues()[2].toString(), t_sendPolicy))
+    {
+        t_sOutput.append("\twarning: limit has to be positive and policy one of 'drop-oldest', 'drop-newest', 'decimate' or 'disconnect'\r\n\n");
+    }
+    else if(t_sAlias.compare("all", Qt::CaseInsensitive) == 0)
+    {
+        m_defaultSendPolicy = t_sendPolicy;
+        m_iDefaultMaxQueuedBytes = t_iMaxQueuedBytes;
+
+        QMap<qint32, FiffStreamThread*>::iterator i;
+        for (i = this->m_qClientList.begin(); i != this->m_qClientList.end(); ++i)
+            i.value()->setSendPolicy(t_sendPolicy, t_iMaxQueuedBytes);
+
+        QString str = QString("\tset send policy of all FiffStreamClients to '%1' with a limit of %2 bytes\r\n\n").arg(FiffStreamThread::sendPolicyToString(t_sendPolicy)).arg(t_iMaxQueuedBytes);
+        t_sOutput.append(str);
+    }
+    else
+    {
+        qint32 t_id = -1;
+        t_sOutput.append(parseToId(t_sAlias,t_id));
+
+        if(t_id != -1)
+        {
+            m_qClientList[t_id]->setSendPolicy(t_sendPolicy, t_iMaxQueuedBytes);
+
+            QString str = QString("\tset send policy of FiffStreamClient (ID: %1) to '%2' with a limit of %3 bytes\r\n\n").arg(t_id).arg(FiffStreamThread::sendPolicyToString(t_sendPolicy)).arg(t_iMaxQueuedBytes);
+            t_sOutput.append(str);
+        }
+    }
+    qobject_cast<MNERTServer*>(this->parent())->getCommandManager()["sendpolicy"].reply(t_sOutput);
+}
+
+
 //*************************************************************************************************************
 
 void FiffStreamServer::connectCommands()
@@ -187,6 +259,8 @@ void FiffStreamServer::connectCommands()
     QObject::connect(&t_pMNERTServer->getCommandManager()["start"], &Command::executed, this, &FiffStreamServer::comStart);
     QObject::connect(&t_pMNERTServer->getCommandManager()["stop"], &Command::executed, this, &FiffStreamServer::comStop);
     QObject::connect(&t_pMNERTServer->getCommandManager()["stop-all"], &Command::executed, this, &FiffStreamServer::comStopAll);
+    QObject::connect(&t_pMNERTServer->getCommandManager()["cstats"], &Command::executed, this, &FiffStreamServer::comCstats);
+    QObject::connect(&t_pMNERTServer->getCommandManager()["sendpolicy"], &Command::executed, this, &FiffStreamServer::comSendpolicy);
 
 //    t_pMNERTServer->getCommandManager().connectSlot(QString("clist"), this, &FiffStreamServer::comClist);
 //    t_pMNERTServer->getCommandManager().connectSlot(QString("measinfo"), this, &FiffStreamServer::comMeasinfo);
@@ -370,15 +444,27 @@ QByteArray FiffStreamServer::parseToId(QString& p_sRawId, qint32& p_iParsedId)
 
 void FiffStreamServer::forwardMeasInfo(qint32 ID, const FiffInfo& p_fiffInfo)
 {
+    m_vecCalSteps = RtBufferCodec::calibrationSteps(p_fiffInfo);
+
     emit remitMeasInfo(ID, p_fiffInfo);
 }
 
 
 //*************************************************************************************************************
-//ToDo increase preformance --> try inline
+
 void FiffStreamServer::forwardRawBuffer(QSharedPointer<Eigen::MatrixXf> m_pMatRawData)
 {
-    emit remitRawBuffer(m_pMatRawData);
+    //Only encode the encodings of the clients which are receiving raw buffers
+    QList<RtBufferCodec::Encoding> t_qListEncodings;
+    QMap<qint32, FiffStreamThread*>::const_iterator i;
+    for (i = m_qClientList.constBegin(); i != m_qClientList.constEnd(); ++i)
+    {
+        if(i.value()->isSendingRawBuffer() && !t_qListEncodings.contains(i.value()->getBufferEncoding()))
+            t_qListEncodings.append(i.value()->getBufferEncoding());
+    }
+
+    for(const RtBufferCodec::Encoding& t_encoding : t_qListEncodings)
+        emit remitRawBuffer(RtBufferCodec::encodeTag(*m_pMatRawData, m_vecCalSteps, t_encoding), t_encoding);
 }
 
 
@@ -387,6 +473,7 @@ void FiffStreamServer::forwardRawBuffer(QSharedPointer<Eigen::MatrixXf> m_pMatRa
 void FiffStreamServer::incomingConnection(qintptr socketDescriptor)
 {
     FiffStreamThread* t_pStreamThread = new FiffStreamThread(m_iNextClientId, socketDescriptor, this);
+    t_pStreamThread->setSendPolicy(m_defaultSendPolicy, m_iDefaultMaxQueuedBytes);
 
     m_qClientList.insert(m_iNextClientId, t_pStreamThread);
     ++m_iNextClientId;
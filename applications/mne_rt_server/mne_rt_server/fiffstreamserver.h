@@ -37,6 +37,14 @@
 #ifndef FIFFSTREAMSERVER_H
 #define FIFFSTREAMSERVER_H
 
+//*************************************************************************************************************
+//=============================================================================================================
+// INCLUDES
+//=============================================================================================================
+
+#include "fiffstreamthread.h"
+
+
 //*************************************************************************************************************
 //=============================================================================================================
 // MNE INCLUDES
@@ -124,6 +132,14 @@ public:
 
 //public slots: --> in Qt 5 not anymore declared as slot
     void forwardMeasInfo(qint32 ID, const FiffInfo& p_fiffInfo);
+
+    //=========================================================================================================
+    /**
+     * Encodes the raw buffer once per encoding requested by the receiving clients and hands the encoded blocks to
+     * all clients. The blocks are implicitly shared, so the clients only hold references to them.
+     *
+     * @param[in] m_pMatRawData  The raw buffer to send.
+     */
     void forwardRawBuffer(QSharedPointer<Eigen::MatrixXf> m_pMatRawData);
 
 signals:
@@ -133,7 +149,7 @@ signals:
     void stopMeasFiffStreamClient(qint32 ID);
 
     void remitMeasInfo(qint32 ID, const FIFFLIB::FiffInfo& p_fiffInfo);
-    void remitRawBuffer(QSharedPointer<Eigen::MatrixXf>);
+    void remitRawBuffer(const QByteArray& p_blockRawBuffer, RtBufferCodec::Encoding p_encoding);
 
     void closeFiffStreamServer();
 
@@ -182,11 +198,31 @@ private:
      */
     void comStopAll(Command p_command);
 
+    //=========================================================================================================
+    /**
+     * Prints and sends the send queue statistics of all fiff data clients
+     *
+     * @param[in] p_command  The client statistics command.
+     */
+    void comCstats(Command p_command);
+
+    //=========================================================================================================
+    /**
+     * Sets the send queue policy and limit of a client, or of all current and future clients if the id is "all"
+     *
+     * @param[in] p_command  The send policy command.
+     */
+    void comSendpolicy(Command p_command);
+
     QByteArray parseToId(QString& p_sRawId, qint32& p_iParsedId);
 
     QMap<qint32, FiffStreamThread*> m_qClientList;
     qint32                          m_iNextClientId;
 
+    FiffStreamThread::SendPolicy    m_defaultSendPolicy;        /**< Send policy of new clients. */
+    Eigen::VectorXf                 m_vecCalSteps;              /**< Quantization step (cal * range) of each channel, used by the compact buffer encodings. */
+    qint64                          m_iDefaultMaxQueuedBytes;   /**< Send queue limit of new clients. */
+
 };
 
 
@@ -63,6 +63,7 @@
 //=============================================================================================================
 
 #include <QtNetwork>
+#include <QtEndian>
 
 
 //*************************************************************************************************************
@@ -75,6 +76,14 @@ using namespace RTSERVER;
 using namespace FIFFLIB;
 
 
+//*************************************************************************************************************
+//=============================================================================================================
+// DEFINES
+//=============================================================================================================
+
+#define SOCKET_WRITE_WATERMARK      (1024*1024)         /**< Blocks are only moved to the socket while its write buffer holds less bytes. */
+
+
 //*************************************************************************************************************
 //=============================================================================================================
 // DEFINE MEMBER METHODS
@@ -85,9 +94,16 @@ FiffStreamThread::FiffStreamThread(qint32 id, int socketDescriptor, QObject *par
 , m_iDataClientId(id)
 , m_sDataClientAlias(QString(""))
 , m_iSocketDescriptor(socketDescriptor)
+, m_sendPolicy(DropOldest)
+, m_iMaxQueuedBytes(DEFAULT_MAX_QUEUED_BYTES)
+, m_iQueuedBytes(0)
+, m_iSocketBytesToWrite(0)
+, m_iDroppedBuffers(0)
+, m_bDisconnectRequested(false)
+, m_bufferEncoding(RtBufferCodec::Float)
 , m_bIsSendingRawBuffer(false)
-, m_bIsRunning(false)
 {
+    m_qTimerSendQueue.start();
 }
 
 
@@ -100,7 +116,7 @@ FiffStreamThread::~FiffStreamThread()
     if(t_pFiffStreamServer)
         t_pFiffStreamServer->m_qClientList.remove(m_iDataClientId);
 
-    m_bIsRunning = false;
+    QThread::quit();
     QThread::wait();
 }
 
@@ -113,12 +129,12 @@ void FiffStreamThread::startMeas(qint32 ID)
     {
         qDebug() << "Activate raw buffer sending.";
 
-        m_qMutex.lock();
         // ToDo send start meas
-        FiffStream t_FiffStreamOut(&m_qSendBlock, QIODevice::WriteOnly);
+        QByteArray t_blockStart;
+        FiffStream t_FiffStreamOut(&t_blockStart, QIODevice::WriteOnly);
         t_FiffStreamOut.start_block(FIFFB_RAW_DATA);
+        enqueueSendBlock(t_blockStart);
         m_bIsSendingRawBuffer = true;
-        m_qMutex.unlock();
     }
 }
 
@@ -132,11 +148,11 @@ void FiffStreamThread::stopMeas(qint32 ID)
     {
         qDebug() << "stop raw buffer sending.";
 
-        m_qMutex.lock();
-        FiffStream t_FiffStreamOut(&m_qSendBlock, QIODevice::WriteOnly);
+        QByteArray t_blockStop;
+        FiffStream t_FiffStreamOut(&t_blockStop, QIODevice::WriteOnly);
         t_FiffStreamOut.end_block(FIFFB_RAW_DATA);
         m_bIsSendingRawBuffer = false;
-        m_qMutex.unlock();
+        enqueueSendBlock(t_blockStop);
     }
 }
 
@@ -167,6 +183,25 @@ void FiffStreamThread::parseCommand(FiffTag::SPtr p_pTag)
             printf("FiffStreamClient (ID %d): send client ID %d\r\n\n", m_iDataClientId, m_iDataClientId);
             writeClientId();
         }
+        else if(t_iCmd == MNE_RT_SET_BUFFER_ENCODING)
+        {
+            //
+            // Set raw buffer encoding
+            //
+            QString t_sEncoding(p_pTag->mid(4, p_pTag->size()-4));
+            RtBufferCodec::Encoding t_encoding;
+            if(RtBufferCodec::parseEncoding(t_sEncoding, t_encoding))
+            {
+                m_qMutex.lock();
+                m_bufferEncoding = t_encoding;
+                m_qMutex.unlock();
+                printf("FiffStreamClient (ID %d): new buffer encoding = '%s'\r\n\n", m_iDataClientId, t_sEncoding.toUtf8().constData());
+            }
+            else
+            {
+                printf("FiffStreamClient (ID %d): unknown buffer encoding '%s'\r\n\n", m_iDataClientId, t_sEncoding.toUtf8().constData());
+            }
+        }
         else
         {
             printf("FiffStreamClient (ID %d): unknown command\r\n\n", m_iDataClientId);
@@ -181,19 +216,13 @@ void FiffStreamThread::parseCommand(FiffTag::SPtr p_pTag)
 
 //*************************************************************************************************************
 
-void FiffStreamThread::sendRawBuffer(QSharedPointer<Eigen::MatrixXf> m_pMatRawData)
+void FiffStreamThread::sendRawBuffer(const QByteArray& p_blockRawBuffer, RtBufferCodec::Encoding p_encoding)
 {
-    if(m_bIsSendingRawBuffer)
+    if(m_bIsSendingRawBuffer && p_encoding == getBufferEncoding())
     {
 //        qDebug() << "Send RawBuffer to client";
 
-        m_qMutex.lock();
-
-        FiffStream t_FiffStreamOut(&m_qSendBlock, QIODevice::WriteOnly);
-        t_FiffStreamOut.write_float(FIFF_DATA_BUFFER,m_pMatRawData->data(),m_pMatRawData->rows()*m_pMatRawData->cols());
-
-        m_qMutex.unlock();
-
+        enqueueSendBlock(p_blockRawBuffer, true);
     }
 //    else
 //    {
@@ -228,9 +257,8 @@ void FiffStreamThread::sendMeasurementInfo(qint32 ID, const FiffInfo& p_fiffInfo
 {
     if(ID == m_iDataClientId)
     {
-        m_qMutex.lock();
-
-        FiffStream t_FiffStreamOut(&m_qSendBlock, QIODevice::WriteOnly);
+        QByteArray t_blockMeasInfo;
+        FiffStream t_FiffStreamOut(&t_blockMeasInfo, QIODevice::WriteOnly);
 
 //        qint32 init_info[2];
 //        init_info[0] = FIFF_MNE_RT_CLIENT_ID;
@@ -241,9 +269,9 @@ void FiffStreamThread::sendMeasurementInfo(qint32 ID, const FiffInfo& p_fiffInfo
 //FiffStream::start_writing_raw
 
         p_fiffInfo.writeToStream(&t_FiffStreamOut);
-        m_qMutex.unlock();
+        enqueueSendBlock(t_blockMeasInfo);
 
-//        qDebug() << "MeasInfo Blocksize: " << m_qSendBlock.size();
+//        qDebug() << "MeasInfo Blocksize: " << t_blockMeasInfo.size();
     }
 }
 
@@ -252,9 +280,294 @@ void FiffStreamThread::sendMeasurementInfo(qint32 ID, const FiffInfo& p_fiffInfo
 
 void FiffStreamThread::writeClientId()
 {
-    FiffStream t_FiffStreamOut(&m_qSendBlock, QIODevice::WriteOnly);
+    QByteArray t_blockClientId;
+    FiffStream t_FiffStreamOut(&t_blockClientId, QIODevice::WriteOnly);
 
     t_FiffStreamOut.write_int(FIFF_MNE_RT_CLIENT_ID, &m_iDataClientId);
+
+    enqueueSendBlock(t_blockClientId);
+}
+
+
+//*************************************************************************************************************
+
+void FiffStreamThread::setSendPolicy(SendPolicy p_sendPolicy, qint64 p_iMaxQueuedBytes)
+{
+    m_qMutex.lock();
+    m_sendPolicy = p_sendPolicy;
+    m_iMaxQueuedBytes = p_iMaxQueuedBytes;
+    m_qMutex.unlock();
+}
+
+
+//*************************************************************************************************************
+
+FiffStreamThread::SendPolicy FiffStreamThread::getSendPolicy()
+{
+    QMutexLocker t_locker(&m_qMutex);
+    return m_sendPolicy;
+}
+
+
+//*************************************************************************************************************
+
+qint64 FiffStreamThread::getMaxQueuedBytes()
+{
+    QMutexLocker t_locker(&m_qMutex);
+    return m_iMaxQueuedBytes;
+}
+
+
+//*************************************************************************************************************
+
+qint64 FiffStreamThread::getQueuedBytes()
+{
+    QMutexLocker t_locker(&m_qMutex);
+    return m_iQueuedBytes + m_iSocketBytesToWrite;
+}
+
+
+//*************************************************************************************************************
+
+qint64 FiffStreamThread::getDroppedBuffers()
+{
+    QMutexLocker t_locker(&m_qMutex);
+    return m_iDroppedBuffers;
+}
+
+
+//*************************************************************************************************************
+
+RtBufferCodec::Encoding FiffStreamThread::getBufferEncoding()
+{
+    QMutexLocker t_locker(&m_qMutex);
+    return m_bufferEncoding;
+}
+
+
+//*************************************************************************************************************
+
+qint64 FiffStreamThread::getLag()
+{
+    QMutexLocker t_locker(&m_qMutex);
+    if(m_qSendQueue.isEmpty())
+        return 0;
+
+    return m_qTimerSendQueue.elapsed() - m_qSendQueue.first().iEnqueueTime;
+}
+
+
+//*************************************************************************************************************
+
+bool FiffStreamThread::parseSendPolicy(const QString& p_sSendPolicy, SendPolicy& p_sendPolicy)
+{
+    if(p_sSendPolicy.compare("drop-oldest", Qt::CaseInsensitive) == 0)
+        p_sendPolicy = DropOldest;
+    else if(p_sSendPolicy.compare("drop-newest", Qt::CaseInsensitive) == 0)
+        p_sendPolicy = DropNewest;
+    else if(p_sSendPolicy.compare("decimate", Qt::CaseInsensitive) == 0)
+        p_sendPolicy = Decimate;
+    else if(p_sSendPolicy.compare("disconnect", Qt::CaseInsensitive) == 0)
+        p_sendPolicy = Disconnect;
+    else
+        return false;
+
+    return true;
+}
+
+
+//*************************************************************************************************************
+
+QString FiffStreamThread::sendPolicyToString(SendPolicy p_sendPolicy)
+{
+    switch(p_sendPolicy)
+    {
+        case DropOldest:
+            return QString("drop-oldest");
+        case DropNewest:
+            return QString("drop-newest");
+        case Decimate:
+            return QString("decimate");
+        case Disconnect:
+            return QString("disconnect");
+    }
+
+    return QString();
+}
+
+
+//*************************************************************************************************************
+
+void FiffStreamThread::enqueueSendBlock(const QByteArray& p_blockSend, bool p_bIsRawBuffer)
+{
+    m_qMutex.lock();
+
+    // A wake up is already pending if the queue was not empty
+    bool t_bWasEmpty = m_qSendQueue.isEmpty();
+
+    if(m_bDisconnectRequested)
+    {
+        m_qMutex.unlock();
+        return;
+    }
+
+    if(p_bIsRawBuffer && m_iQueuedBytes + p_blockSend.size() > m_iMaxQueuedBytes)
+    {
+        QList<SendBlock>::iterator it;
+
+        switch(m_sendPolicy)
+        {
+            case DropNewest:
+                ++m_iDroppedBuffers;
+                m_qMutex.unlock();
+                return;
+
+            case Disconnect:
+                for(it = m_qSendQueue.begin(); it != m_qSendQueue.end(); ++it)
+                    if(it->bIsRawBuffer)
+                        ++m_iDroppedBuffers;
+                ++m_iDroppedBuffers;
+                m_qSendQueue.clear();
+                m_iQueuedBytes = 0;
+                m_bDisconnectRequested = true;
+                m_qMutex.unlock();
+
+                printf("FiffStreamClient (ID %d): send queue limit exceeded, disconnecting\r\n\n", m_iDataClientId);
+                emit sendQueueChanged();
+                return;
+
+            case Decimate:
+            {
+                //Drop every second queued raw buffer, starting with the oldest one
+                bool t_bDrop = true;
+                it = m_qSendQueue.begin();
+                while(it != m_qSendQueue.end())
+                {
+                    if(it->bIsRawBuffer)
+                    {
+                        if(t_bDrop)
+                        {
+                            m_iQueuedBytes -= it->block.size();
+                            ++m_iDroppedBuffers;
+                            it = m_qSendQueue.erase(it);
+                            t_bDrop = false;
+                            continue;
+                        }
+                        t_bDrop = true;
+                    }
+                    ++it;
+                }
+            }
+            //If the decimated queue is still too long continue with dropping the oldest buffers
+            // fall through
+            case DropOldest:
+                it = m_qSendQueue.begin();
+                while(it != m_qSendQueue.end() && m_iQueuedBytes + p_blockSend.size() > m_iMaxQueuedBytes)
+                {
+                    if(it->bIsRawBuffer)
+                    {
+                        m_iQueuedBytes -= it->block.size();
+                        ++m_iDroppedBuffers;
+                        it = m_qSendQueue.erase(it);
+                    }
+                    else
+                    {
+                        ++it;
+                    }
+                }
+
+                //Only non-raw blocks are left which are still too long, drop the new buffer instead
+                if(!m_qSendQueue.isEmpty() && m_iQueuedBytes + p_blockSend.size() > m_iMaxQueuedBytes)
+                {
+                    ++m_iDroppedBuffers;
+                    m_qMutex.unlock();
+                    return;
+                }
+                break;
+        }
+    }
+
+    SendBlock t_sendBlock;
+    t_sendBlock.block = p_blockSend;
+    t_sendBlock.iEnqueueTime = m_qTimerSendQueue.elapsed();
+    t_sendBlock.bIsRawBuffer = p_bIsRawBuffer;
+
+    m_qSendQueue.append(t_sendBlock);
+    m_iQueuedBytes += p_blockSend.size();
+
+    m_qMutex.unlock();
+
+    if(t_bWasEmpty)
+        emit sendQueueChanged();
+}
+
+
+//*************************************************************************************************************
+
+void FiffStreamThread::writeSendQueue(QTcpSocket& p_qTcpSocket)
+{
+    if(p_qTcpSocket.state() != QAbstractSocket::ConnectedState)
+        return;
+
+    m_qMutex.lock();
+
+    if(m_bDisconnectRequested)
+    {
+        m_qMutex.unlock();
+        p_qTcpSocket.abort();
+        QThread::quit();
+        return;
+    }
+
+    //Blocks are only copied to the socket's write buffer up to the watermark, the rest stays in the bounded queue
+    //and is written when the socket signals bytesWritten
+    while(!m_qSendQueue.isEmpty() && p_qTcpSocket.bytesToWrite() < SOCKET_WRITE_WATERMARK)
+    {
+        const QByteArray& t_block = m_qSendQueue.first().block;
+        p_qTcpSocket.write(t_block);
+        m_iQueuedBytes -= t_block.size();
+        m_qSendQueue.removeFirst();
+    }
+
+    m_qMutex.unlock();
+
+    p_qTcpSocket.flush();
+
+    m_qMutex.lock();
+    m_iSocketBytesToWrite = p_qTcpSocket.bytesToWrite();
+    m_qMutex.unlock();
+}
+
+
+//*************************************************************************************************************
+
+void FiffStreamThread::readCommands(QTcpSocket& p_qTcpSocket, FiffStream& p_FiffStreamIn)
+{
+    const qint64 t_iHeaderSize = sizeof(qint32)*4;
+
+    while(p_qTcpSocket.bytesAvailable() >= t_iHeaderSize)
+    {
+        //
+        // Peek the tag size (kind, type, size, next) and wait for the next readyRead until the whole tag is available
+        //
+        QByteArray t_blockHeader = p_qTcpSocket.peek(t_iHeaderSize);
+        qint32 t_iTagSize = qFromBigEndian<qint32>(reinterpret_cast<const uchar*>(t_blockHeader.constData()) + 2*sizeof(qint32));
+
+        if(p_qTcpSocket.bytesAvailable() < t_iHeaderSize + qMax(t_iTagSize, 0))
+            return;
+
+        FiffTag::SPtr t_pTag;
+        p_FiffStreamIn.read_tag_info(t_pTag, false);
+        p_FiffStreamIn.read_tag_data(t_pTag);
+
+        //
+        // Parse the tag
+        //
+        if(t_pTag->kind == FIFF_MNE_RT_COMMAND)
+        {
+            parseCommand(t_pTag);
+        }
+    }
 }
 
 
@@ -299,8 +612,6 @@ void FiffStreamThread::writeClientId()
 
 void FiffStreamThread::run()
 {
-    m_bIsRunning = true;
-
     FiffStreamServer* t_pParentServer = qobject_cast<FiffStreamServer*>(this->parent());
 
     connect(t_pParentServer, &FiffStreamServer::remitMeasInfo,
@@ -325,64 +636,28 @@ void FiffStreamThread::run()
                t_qTcpSocket.peerPort());
     }
 
-    FiffStream t_FiffStreamIn(&t_qTcpSocket);
+    t_qTcpSocket.setSocketOption(QAbstractSocket::LowDelayOption, 1);
 
-//    int i = 0;
-    while(t_qTcpSocket.state() != QAbstractSocket::UnconnectedState && m_bIsRunning)
-    {
-        //
-        // Write available data
-        //
-        m_qMutex.lock();
-        qint32 t_iBlockSize = m_qSendBlock.size();
-//        qDebug() << "data available" << t_iBlockSize;
-        if(t_iBlockSize > 0)
-        {
-            qint32 t_iBytesWritten = t_qTcpSocket.write(m_qSendBlock);
-//            qDebug() << ++i<< "[wrote bytes] " << t_iBytesWritten;
-            t_qTcpSocket.waitForBytesWritten();
-            if(t_iBytesWritten == t_iBlockSize)
-            {
-                m_qSendBlock.clear();
-            }
-            else
-            {
-                //we have to store bytes which were not written to the socket, due to writing limit
-                //m_qSendBlock = m_qSendBlock.mid(t_iBytesWritten, t_iBlockSize-t_iBytesWritten);
-                m_qSendBlock.remove(0,t_iBytesWritten); //higher performance then mid
-            }
-        }
-        m_qMutex.unlock();
-
-        //
-        // Read: Wait 10ms for incomming tag header, read and continue
-        //
-        t_qTcpSocket.waitForReadyRead(10);
-
-        if (t_qTcpSocket.bytesAvailable() >= (int)sizeof(qint32)*4)
-        {
-//            qDebug() << "goes to read bytes " ;
-            FiffTag::SPtr t_pTag;
-            t_FiffStreamIn.read_tag_info(t_pTag, false);
-
-            //
-            // wait until tag size data are available and read the data
-            //
-            while (t_qTcpSocket.bytesAvailable() < t_pTag->size())
-            {
-                t_qTcpSocket.waitForReadyRead(10);
-            }
-            t_FiffStreamIn.read_tag_data(t_pTag);
+    FiffStream t_FiffStreamIn(&t_qTcpSocket);
 
-            //
-            // Parse the tag
-            //
-            if(t_pTag->kind == FIFF_MNE_RT_COMMAND)
-            {
-                parseCommand(t_pTag);
-            }
-        }
-    }
+    //
+    // Event driven: the socket lives in this thread, queued blocks and incoming commands are handled by the event loop
+    //
+    connect(this, &FiffStreamThread::sendQueueChanged,
+            &t_qTcpSocket, [this, &t_qTcpSocket]() { writeSendQueue(t_qTcpSocket); });
+    connect(&t_qTcpSocket, &QTcpSocket::bytesWritten,
+            &t_qTcpSocket, [this, &t_qTcpSocket]() { writeSendQueue(t_qTcpSocket); });
+    connect(&t_qTcpSocket, &QTcpSocket::readyRead,
+            &t_qTcpSocket, [this, &t_qTcpSocket, &t_FiffStreamIn]() { readCommands(t_qTcpSocket, t_FiffStreamIn); });
+    connect(&t_qTcpSocket, &QTcpSocket::disconnected,
+            this, &FiffStreamThread::quit, Qt::DirectConnection);
+
+    //Write blocks which were queued before the event loop was started
+    writeSendQueue(t_qTcpSocket);
+    readCommands(t_qTcpSocket, t_FiffStreamIn);
+
+    if(t_qTcpSocket.state() == QAbstractSocket::ConnectedState)
+        exec();
 
     t_qTcpSocket.disconnectFromHost();
     if(t_qTcpSocket.state() != QAbstractSocket::UnconnectedState)
@@ -45,6 +45,7 @@
 
 #include <fiff/fiff_stream.h>
 #include <fiff/fiff_info.h>
+#include <communication/rtClient/rtbuffercodec.h>
 
 
 //*************************************************************************************************************
@@ -56,6 +57,17 @@
 #include <QTcpSocket>
 #include <QMutex>
 #include <QSharedPointer>
+#include <QByteArray>
+#include <QList>
+#include <QElapsedTimer>
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// DEFINES
+//=============================================================================================================
+
+#define DEFAULT_MAX_QUEUED_BYTES    (64*1024*1024)      /**< Default limit of the send queue of a client in bytes. */
 
 
 //*************************************************************************************************************
@@ -72,6 +84,7 @@ namespace RTSERVER
 //=============================================================================================================
 
 using namespace FIFFLIB;
+using namespace COMMUNICATIONLIB;
 
 
 //*************************************************************************************************************
@@ -83,6 +96,16 @@ class FiffStreamThread : public QThread
 {
     Q_OBJECT
 public:
+    /**
+     * Policy which is applied to raw buffers when the send queue of a client exceeds its limit.
+     */
+    enum SendPolicy {
+        DropOldest,         /**< Drop the oldest queued raw buffers, or the incoming one if no queued raw buffer is left. */
+        DropNewest,         /**< Drop the incoming raw buffer. */
+        Decimate,           /**< Drop every second queued raw buffer. */
+        Disconnect          /**< Clear the queue and disconnect the client. */
+    };
+
     FiffStreamThread(qint32 id, int socketDescriptor, QObject *parent);
 
     ~FiffStreamThread();
@@ -93,6 +116,93 @@ public:
 
     inline QString getAlias();
 
+    //=========================================================================================================
+    /**
+     * Returns whether this client is set to receive raw buffers.
+     *
+     * @return true if raw buffers are sent to this client, false otherwise.
+     */
+    inline bool isSendingRawBuffer() const;
+
+    //=========================================================================================================
+    /**
+     * Returns the raw buffer encoding requested by this client. Thread safe.
+     *
+     * @return the raw buffer encoding.
+     */
+    RtBufferCodec::Encoding getBufferEncoding();
+
+    //=========================================================================================================
+    /**
+     * Sets the policy and the limit of the send queue. Thread safe.
+     *
+     * @param[in] p_sendPolicy           The policy which is applied when the limit is exceeded.
+     * @param[in] p_iMaxQueuedBytes      The maximum number of bytes of raw buffers which are queued for this client.
+     */
+    void setSendPolicy(SendPolicy p_sendPolicy, qint64 p_iMaxQueuedBytes);
+
+    //=========================================================================================================
+    /**
+     * Returns the policy of the send queue. Thread safe.
+     *
+     * @return the send policy.
+     */
+    SendPolicy getSendPolicy();
+
+    //=========================================================================================================
+    /**
+     * Returns the limit of the send queue. Thread safe.
+     *
+     * @return the maximum number of queued bytes.
+     */
+    qint64 getMaxQueuedBytes();
+
+    //=========================================================================================================
+    /**
+     * Returns the number of bytes waiting to be sent, including the bytes in the write buffer of the socket.
+     * Thread safe.
+     *
+     * @return the number of queued bytes.
+     */
+    qint64 getQueuedBytes();
+
+    //=========================================================================================================
+    /**
+     * Returns the number of raw buffers which were dropped for this client. Thread safe.
+     *
+     * @return the number of dropped raw buffers.
+     */
+    qint64 getDroppedBuffers();
+
+    //=========================================================================================================
+    /**
+     * Returns the age of the oldest block in the send queue. Thread safe.
+     *
+     * @return the lag in ms.
+     */
+    qint64 getLag();
+
+    //=========================================================================================================
+    /**
+     * Parses a send policy ("drop-oldest" | "drop-newest" | "decimate" | "disconnect").
+     *
+     * @param[in] p_sSendPolicy      The policy name.
+     * @param[out] p_sendPolicy      The parsed policy.
+     *
+     * @return true if the name is valid, false otherwise.
+     */
+    static bool parseSendPolicy(const QString& p_sSendPolicy, SendPolicy& p_sendPolicy);
+
+    //=========================================================================================================
+    /**
+     * Returns the name of a send policy.
+     *
+     * @param[in] p_sendPolicy       The policy.
+     *
+     * @return the policy name.
+     */
+    static QString sendPolicyToString(SendPolicy p_sendPolicy);
+
 //    void deactivateRawBufferSending();
 
 
@@ -105,18 +215,41 @@ public:
 signals:
     void error(QTcpSocket::SocketError socketError);
 
+    //=========================================================================================================
+    /**
+     * Emitted when blocks were added to an empty send queue. Wakes up the event loop of this thread.
+     */
+    void sendQueueChanged();
+
 private:
     qint32 m_iDataClientId;
     QString m_sDataClientAlias;
 
     int m_iSocketDescriptor;
 
+    /**
+     * An encoded block in the send queue.
+     */
+    struct SendBlock {
+        QByteArray block;           /**< The encoded block. Raw buffer blocks are shared between all clients. */
+        qint64 iEnqueueTime;        /**< The time the block was queued in ms. */
+        bool bIsRawBuffer;          /**< Whether the block is a raw buffer, only raw buffers are dropped. */
+    };
+
     QMutex m_qMutex;
-    QByteArray m_qSendBlock;
+    QList<SendBlock> m_qSendQueue;      /**< Encoded blocks which are waiting to be written. */
+    QElapsedTimer m_qTimerSendQueue;    /**< Time base of the queued blocks. */
 
-    bool m_bIsSendingRawBuffer;
+    SendPolicy m_sendPolicy;            /**< The policy applied when m_iMaxQueuedBytes is exceeded. */
+    qint64 m_iMaxQueuedBytes;           /**< The maximum number of queued bytes. */
+    qint64 m_iQueuedBytes;              /**< The number of bytes in m_qSendQueue. */
+    qint64 m_iSocketBytesToWrite;       /**< The number of bytes in the write buffer of the socket. */
+    qint64 m_iDroppedBuffers;           /**< The number of dropped raw buffers. */
+    bool m_bDisconnectRequested;        /**< Whether the client is disconnected due to the Disconnect policy. */
 
-    bool m_bIsRunning;
+    RtBufferCodec::Encoding m_bufferEncoding;   /**< The raw buffer encoding requested by the client. */
+
+    bool m_bIsSendingRawBuffer;
 
     void startMeas(qint32 ID);
 
@@ -124,7 +257,45 @@ private:
 
     void sendMeasurementInfo(qint32 ID, const FiffInfo& p_fiffInfo);
 
-    void sendRawBuffer(QSharedPointer<Eigen::MatrixXf> m_pMatRawData);
+    //=========================================================================================================
+    /**
+     * Queues an already encoded raw buffer tag if it matches the encoding of this client. The block is encoded once
+     * per encoding by the FiffStreamServer and shared between all clients, no copy is made here.
+     *
+     * @param[in] p_blockRawBuffer   The encoded raw buffer tag.
+     * @param[in] p_encoding         The encoding of the raw buffer tag.
+     */
+    void sendRawBuffer(const QByteArray& p_blockRawBuffer, RtBufferCodec::Encoding p_encoding);
+
+    //=========================================================================================================
+    /**
+     * Appends a block to the send queue and wakes up the event loop of this thread if the queue was empty.
+     * If a raw buffer exceeds the queue limit, the send policy is applied. Other blocks are never dropped.
+     * Thread safe.
+     *
+     * @param[in] p_blockSend        The block to send.
+     * @param[in] p_bIsRawBuffer     Whether the block is a raw buffer.
+     */
+    void enqueueSendBlock(const QByteArray& p_blockSend, bool p_bIsRawBuffer = false);
+
+    //=========================================================================================================
+    /**
+     * Moves queued blocks to the socket until its write buffer reaches a watermark, the rest stays in the
+     * bounded queue. Is called from the event loop of this thread.
+     *
+     * @param[in] p_qTcpSocket   The socket of this client.
+     */
+    void writeSendQueue(QTcpSocket& p_qTcpSocket);
+
+    //=========================================================================================================
+    /**
+     * Reads and parses all complete tags which are available on the socket. Incomplete tags are left in the
+     * socket buffer until the next readyRead.
+     *
+     * @param[in] p_qTcpSocket       The socket of this client.
+     * @param[in] p_FiffStreamIn     The stream reading from the socket.
+     */
+    void readCommands(QTcpSocket& p_qTcpSocket, FiffStream& p_FiffStreamIn);
     //void readToBuffer1();
 //    void readProc(QTcpSocket& p_qTcpSocket);
 };
@@ -142,6 +313,12 @@ inline QString FiffStreamThread::getAlias()
 }
 
 
+inline bool FiffStreamThread::isSendingRawBuffer() const
+{
+    return m_bIsSendingRawBuffer;
+}
+
+
 } // NAMESPACE
 
 #endif //FIFFSTREAMTHREAD_H
@@ -51,6 +51,7 @@ namespace RTSERVER
 
 #define MNE_RT_GET_CLIENT_ID        1       /**< Request client id at mne_rt_server */
 #define MNE_RT_SET_CLIENT_ALIAS     2       /**< Set client alias at mne_rt_server */
+#define MNE_RT_SET_BUFFER_ENCODING  3       /**< Set raw buffer encoding at mne_rt_server ("float" | "int16" | "int24" | "int16-delta" | "int24-delta") */
 
 } // NAMESPACE
 
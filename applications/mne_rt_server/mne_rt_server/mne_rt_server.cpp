@@ -329,6 +329,10 @@ void MNERTServer::init()
             "           \"description\": \"Prints and sends all available connectors.\","
             "           \"parameters\": {}"
             "        },"
+            "       \"cstats\": {"
+            "           \"description\": \"Prints and sends the send queue statistics of all FiffStreamClients.\","
+            "           \"parameters\": {}"
+            "        },"
             "       \"help\": {"
             "           \"description\": \"Prints and sends this list.\","
             "           \"parameters\": {}"
@@ -351,6 +355,23 @@ void MNERTServer::init()
             "               }"
             "           }"
             "        },"
+            "       \"sendpolicy\": {"
+            "           \"description\": \"Sets the send queue limit and the policy applied when it is exceeded (drop-oldest, drop-newest, decimate or disconnect) of the specified FiffStreamClient, or of all clients if the ID is 'all'.\","
+            "           \"parameters\": {"
+            "               \"id\": {"
+            "                   \"description\": \"ID/Alias/all\","
+            "                   \"type\": \"QString\" "
+            "               },"
+            "               \"limit\": {"
+            "                   \"description\": \"Maximum number of queued bytes\","
+            "                   \"type\": \"qlonglong\" "
+            "               },"
+            "               \"policy\": {"
+            "                   \"description\": \"drop-oldest | drop-newest | decimate | disconnect\","
+            "                   \"type\": \"QString\" "
+            "               }"
+            "           }"
+            "        },"
             "       \"start\": {"
             "           \"description\": \"Adds specified FiffStreamClient to raw data buffer receivers. If acquisition is not already started, it is triggered.\","
             "           \"parameters\": {"
@@ -62,7 +62,7 @@ DummyToolbox::DummyToolbox()
 : m_bIsRunning(false)
 , m_pDummyInput(NULL)
 , m_pDummyOutput(NULL)
-, m_pDummyBuffer(CircularMatrixBuffer<double>::SPtr())
+, m_pDummyBuffer(LockFreeMatrixBuffer<double>::SPtr())
 {
     //Add action which will be visible in the plugin's toolbar
     m_pActionShowYourWidget = new QAction(QIcon(":/images/options.png"), tr("Your Toolbar Widget"),this);
@@ -108,7 +108,7 @@ void DummyToolbox::init()
 
     //Delete Buffer - will be initailzed with first incoming data
     if(!m_pDummyBuffer.isNull())
-        m_pDummyBuffer = CircularMatrixBuffer<double>::SPtr();
+        m_pDummyBuffer = LockFreeMatrixBuffer<double>::SPtr();
 }
 
 
@@ -124,9 +124,15 @@ void DummyToolbox::unload()
 
 bool DummyToolbox::start()
 {
-//    //Check if the thread is already or still running. This can happen if the start button is pressed immediately after the stop button was pressed. In this case the stopping process is not finished yet but the start process is initiated.
-//    if(this->isRunning())
-//        QThread::wait();
+    //Check if the thread is already or still running. This can happen if the start button is pressed immediately after the stop button was pressed. In this case the stopping process is not finished yet but the start process is initiated.
+    if(this->isRunning()) {
+        QThread::wait();
+    }
+
+    //Reset the buffer while neither side is using it - update() only writes while m_bIsRunning is set
+    if(m_pDummyBuffer) {
+        m_pDummyBuffer->clear();
+    }
 
     m_bIsRunning = true;
 
@@ -143,10 +149,10 @@ bool DummyToolbox::stop()
 {
     m_bIsRunning = false;
 
-    m_pDummyBuffer->releaseFromPop();
-    m_pDummyBuffer->releaseFromPush();
-
-    m_pDummyBuffer->clear();
+    //Wake up both sides of the buffer. The buffer is reset in start() once the processing thread has finished.
+    if(m_pDummyBuffer) {
+        m_pDummyBuffer->releaseFromWait();
+    }
 
     return true;
 }
@@ -186,7 +192,7 @@ void DummyToolbox::update(SCMEASLIB::Measurement::SPtr pMeasurement)
     if(pRTMSA) {
         //Check if buffer initialized
         if(!m_pDummyBuffer) {
-            m_pDummyBuffer = CircularMatrixBuffer<double>::SPtr(new CircularMatrixBuffer<double>(64, pRTMSA->getNumChannels(), pRTMSA->getMultiSampleArray()[0].cols()));
+            m_pDummyBuffer = LockFreeMatrixBuffer<double>::SPtr(new LockFreeMatrixBuffer<double>(64, pRTMSA->getNumChannels(), pRTMSA->getMultiSampleArray()[0].cols()));
         }
 
         //Fiff information
@@ -199,11 +205,21 @@ void DummyToolbox::update(SCMEASLIB::Measurement::SPtr pMeasurement)
             m_pDummyOutput->data()->setVisibility(true);
         }
 
-        MatrixXd t_mat;
-
-        for(unsigned char i = 0; i < pRTMSA->getMultiArraySize(); ++i) {
-            t_mat = pRTMSA->getMultiSampleArray()[i];
-            m_pDummyBuffer->push(&t_mat);
+        for(unsigned char i = 0; i < pRTMSA->getMultiArraySize() && m_bIsRunning; ++i) {
+            const MatrixXd& matData = pRTMSA->getMultiSampleArray()[i];
+
+            //The slots are preallocated and must not be resized, skip blocks which do not fit the buffer
+            if(matData.rows() != static_cast<int>(m_pDummyBuffer->rows()) || matData.cols() != static_cast<int>(m_pDummyBuffer->cols())) {
+                qWarning() << "DummyToolbox::update - Skipping block of size" << matData.rows() << "x" << matData.cols()
+                           << "which does not match the buffer size" << m_pDummyBuffer->rows() << "x" << m_pDummyBuffer->cols();
+                continue;
+            }
+
+            //Write the data in place into the next free slot of the buffer
+            if(MatrixXd* pSlot = m_pDummyBuffer->acquireWrite(-1)) {
+                pSlot->noalias() = matData;
+                m_pDummyBuffer->commitWrite();
+            }
         }
     }
 }
@@ -222,14 +238,20 @@ void DummyToolbox::run()
 
     while(m_bIsRunning)
     {
-        //Dispatch the inputs
-        MatrixXd t_mat = m_pDummyBuffer->pop();
+        //Dispatch the inputs - the data are read in place from the buffer
+        const MatrixXd* pMat = m_pDummyBuffer->acquireRead(-1);
+
+        if(!pMat) {
+            continue;
+        }
 
         //ToDo: Implement your algorithm here
 
         //Send the data to the connected plugins and the online display
         //Unocmment this if you also uncommented the m_pDummyOutput in the constructor above
-        m_pDummyOutput->data()->setValue(t_mat);
+        m_pDummyOutput->data()->setValue(*pMat);
+
+        m_pDummyBuffer->release();
     }
 }
 
@@ -46,7 +46,7 @@
 #include "dummytoolbox_global.h"
 
 #include <scShared/Interfaces/IAlgorithm.h>
-#include <utils/generics/circularmatrixbuffer.h>
+#include <utils/generics/lockfreematrixbuffer.h>
 #include <scMeas/realtimemultisamplearray.h>
 #include "FormFiles/dummysetupwidget.h"
 #include "FormFiles/dummyyourwidget.h"
@@ -148,7 +148,7 @@ private:
     QSharedPointer<DummyYourWidget>                 m_pYourWidget;          /**< flag whether thread is running.*/
     QAction*                                        m_pActionShowYourWidget;/**< flag whether thread is running.*/
 
-    IOBUFFER::CircularMatrixBuffer<double>::SPtr    m_pDummyBuffer;         /**< Holds incoming data.*/
+    IOBUFFER::LockFreeMatrixBuffer<double>::SPtr    m_pDummyBuffer;         /**< Holds incoming data.*/
 
     PluginInputData<SCMEASLIB::RealTimeMultiSampleArray>::SPtr      m_pDummyInput;      /**< The RealTimeMultiSampleArray of the DummyToolbox input.*/
     PluginOutputData<SCMEASLIB::RealTimeMultiSampleArray>::SPtr     m_pDummyOutput;     /**< The RealTimeMultiSampleArray of the DummyToolbox output.*/
@@ -102,7 +102,6 @@ NeuronalConnectivity::NeuronalConnectivity()
 , m_pActionShowYourWidget(Q_NULLPTR)
 , m_iNumberBadChannels(0)
 {
-    AbstractMetric::m_bStorageModeIsActive = true;
     AbstractMetric::m_iNumberBinStart = 0;
     AbstractMetric::m_iNumberBinAmount = 100;
 }
@@ -290,14 +289,10 @@ void NeuronalConnectivity::updateSource(SCMEASLIB::Measurement::SPtr pMeasuremen
                                                                            pRTSE->getValue()[i]->data.cols() - iZeroIdx));
         }
 
-        //Pop data from buffer
-        if(m_connectivitySettings.size() >= m_iNumberAverages) {
-            m_pRtConnectivity->restart();
-            m_connectivitySettings.removeFirst(m_connectivitySettings.size()-m_iNumberAverages);
-        }
-
+        // Only pass the new trials. The worker keeps the sliding window of the last m_iNumberAverages trials.
         m_timer.restart();
-        m_pRtConnectivity->append(m_connectivitySettings);
+        m_pRtConnectivity->appendIncremental(m_connectivitySettings, m_iNumberAverages);
+        m_connectivitySettings.clearAllData();
     }
 }
 
@@ -358,14 +353,10 @@ void NeuronalConnectivity::updateRTMSA(SCMEASLIB::Measurement::SPtr pMeasurement
                 m_connectivitySettings.append(data);
             }
 
-            //Pop data from buffer
-            if(m_connectivitySettings.size() > m_iNumberAverages) {
-                m_pRtConnectivity->restart();
-                m_connectivitySettings.removeFirst(m_connectivitySettings.size()-m_iNumberAverages);
-            }
-
+            // Only pass the new trials. The worker keeps the sliding window of the last m_iNumberAverages trials.
             m_timer.restart();
-            m_pRtConnectivity->append(m_connectivitySettings);
+            m_pRtConnectivity->appendIncremental(m_connectivitySettings, m_iNumberAverages);
+            m_connectivitySettings.clearAllData();
         }
     }
 }
@@ -442,14 +433,10 @@ void NeuronalConnectivity::updateRTEV(SCMEASLIB::Measurement::SPtr pMeasurement)
 
                     m_connectivitySettings.append(data);
 
-                    //Pop data from buffer
-                    if(m_connectivitySettings.size() > m_iNumberAverages) {
-                        m_pRtConnectivity->restart();
-                        m_connectivitySettings.removeFirst(m_connectivitySettings.size()-m_iNumberAverages);
-                    }
-
+                    // Only pass the new trial. The worker keeps the sliding window of the last m_iNumberAverages trials.
                     m_timer.restart();
-                    m_pRtConnectivity->append(m_connectivitySettings);
+                    m_pRtConnectivity->appendIncremental(m_connectivitySettings, m_iNumberAverages);
+                    m_connectivitySettings.clearAllData();
 
                     break;
                 }
@@ -541,9 +528,7 @@ void NeuronalConnectivity::run()
 void NeuronalConnectivity::onNewConnectivityResultAvailable(const QList<Network>& connectivityResults,
                                                             const ConnectivitySettings& connectivitySettings)
 {
-    //QMutexLocker locker(&m_mutex);
-    m_connectivitySettings = connectivitySettings;
-    m_connectivitySettings.setConnectivityMethods(m_sConnectivityMethods);
+    Q_UNUSED(connectivitySettings)
 
     for(int i = 0; i < connectivityResults.size(); ++i) {
         m_pCircularNetworkBuffer->push(connectivityResults.at(i));
@@ -562,8 +547,8 @@ void NeuronalConnectivity::onMetricChanged(const QString& sMetric)
     m_sConnectivityMethods = QStringList() << sMetric;
     m_connectivitySettings.setConnectivityMethods(m_sConnectivityMethods);
     if(m_pRtConnectivity && m_bIsRunning) {
-        m_pRtConnectivity->restart();
-        m_pRtConnectivity->append(m_connectivitySettings);
+        // Recompute the current window with the new metric
+        m_pRtConnectivity->appendIncremental(m_connectivitySettings, m_iNumberAverages);
     }
 }
 
@@ -594,6 +579,11 @@ void NeuronalConnectivity::onTriggerTypeChanged(const QString& triggerType)
     if(triggerType != m_sAvrType) {
         m_connectivitySettings.clearAllData();
         m_sAvrType = triggerType;
+
+        // Discard the trials of the old trigger type
+        if(m_pRtConnectivity) {
+            m_pRtConnectivity->restart();
+        }
     }
 }
 
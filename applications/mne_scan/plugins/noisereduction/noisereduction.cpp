@@ -98,7 +98,7 @@ NoiseReduction::NoiseReduction()
 , m_sCurrentSystem("VectorView")
 , m_pRTMSA(RealTimeMultiSampleArray::SPtr(new RealTimeMultiSampleArray()))
 , m_pRtFilter(RTPROCESSINGLIB::RtFilter::SPtr::create())
-, m_iMaxFilterLength(1)
+, m_bFilterChanged(true)
 {
     if(m_sCurrentSystem == "BabyMEG") {
         m_iNBaseFctsFirst = 270;
@@ -466,6 +466,8 @@ void NoiseReduction::updateCompensator(int to)
 
 void NoiseReduction::setFilterChannelType(QString sType)
 {
+    m_mutex.lock();
+
     m_sFilterChannelType = sType;
 
     //This version is for when all channels of a type are to be filtered (not only the visible ones).
@@ -486,6 +488,10 @@ void NoiseReduction::setFilterChannelType(QString sType)
             }
         }
     }
+
+    m_bFilterChanged = true;
+
+    m_mutex.unlock();
 }
 
 
@@ -493,12 +499,12 @@ void NoiseReduction::setFilterChannelType(QString sType)
 
 void NoiseReduction::setFilter(const FilterData& filterData)
 {
+    m_mutex.lock();
+
     m_filterData = filterData;
+    m_bFilterChanged = true;
 
-    m_iMaxFilterLength = 1;
-    if(m_iMaxFilterLength < m_filterData.m_iFilterOrder) {
-        m_iMaxFilterLength = m_filterData.m_iFilterOrder;
-    }
+    m_mutex.unlock();
 }
 
 
@@ -506,7 +512,13 @@ void NoiseReduction::setFilter(const FilterData& filterData)
 
 void NoiseReduction::setFilterActive(bool state)
 {
+    m_mutex.lock();
+
+    //Start with a fresh filter state, the state of the last active period does not match the data anymore
     m_bFilterActivated = state;
+    m_bFilterChanged = true;
+
+    m_mutex.unlock();
 }
 
 
@@ -692,12 +704,18 @@ void NoiseReduction::run()
 
         //Do temporal filtering here
         if(m_bFilterActivated) {
-            QList<FilterData> list;
-            list << m_filterData;
-            t_mat = m_pRtFilter->filterDataBlock(t_mat,
-                                                            m_iMaxFilterLength,
-                                                            m_lFilterChannelList,
-                                                            list);
+            //Only prepare the filter if the filter or the filtered channels changed. Otherwise the filter state is kept
+            //between blocks.
+            if(m_bFilterChanged) {
+                QList<FilterData> list;
+                list << m_filterData;
+                m_pRtFilter->prepareFilter(list, m_lFilterChannelList);
+                m_bFilterChanged = false;
+            }
+
+            if(m_pRtFilter->filterDataBlock(t_mat, m_matDataFiltered)) {
+                t_mat.swap(m_matDataFiltered);
+            }
         }
 
 //        qDebug()<<"t_mat dim:"<<t_mat.rows()<<"x"<<t_mat.cols();
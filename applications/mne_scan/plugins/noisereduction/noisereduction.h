@@ -249,10 +249,10 @@ private:
     bool                            m_bSpharaActive;                            /**< Flag whether thread is running.*/
     bool                            m_bProjActivated;                           /**< Projections activated */
     bool                            m_bFilterActivated;                         /**< Projections activated */
+    bool                            m_bFilterChanged;                           /**< Flag whether the filter or the filtered channels changed since the filter was prepared. */
 
     int                             m_iNBaseFctsFirst;                          /**< The number of grad/inner base functions to use for calculating the sphara opreator.*/
     int                             m_iNBaseFctsSecond;                         /**< The number of grad/outer base functions to use for calculating the sphara opreator.*/
-    int                             m_iMaxFilterLength;                         /**< Max order of the current filters */
     int                             m_iMaxFilterTapSize;                        /**< maximum number of allowed filter taps. This number depends on the size of the receiving blocks. */
 
     QString                         m_sCurrentSystem;                           /**< The current acquisition system (EEG, babyMEG, VectorView).*/
@@ -278,6 +278,8 @@ private:
     Eigen::MatrixXd                 m_matSpharaBabyMEGOuterLoaded;              /**< The loaded babyMEG outer layer basis functions.*/
     Eigen::MatrixXd                 m_matSpharaEEGLoaded;                       /**< The loaded EEG basis functions.*/
 
+    Eigen::MatrixXd                 m_matDataFiltered;                          /**< The output buffer of the filter, swapped with the current block.*/
+
     Eigen::RowVectorXi              m_lFilterChannelList;                       /**< The indices of the channels to be filtered.*/
 
     QSharedPointer<FIFFLIB::FiffInfo>                               m_pFiffInfo;                /**< Fiff measurement info.*/
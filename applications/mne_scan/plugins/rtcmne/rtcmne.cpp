@@ -99,6 +99,7 @@ RtcMne::RtcMne()
 , m_bReceiveData(false)
 , m_bProcessData(false)
 , m_bFinishedClustering(false)
+, m_bSinglePrecision(false)
 , m_qFileFwdSolution(QCoreApplication::applicationDirPath() + "/MNE-sample-data/MEG/sample/sample_audvis-meg-eeg-oct-6-fwd.fif")
 , m_sAtlasDir(QCoreApplication::applicationDirPath() + "/MNE-sample-data/subjects/sample/label")
 , m_sSurfaceDir(QCoreApplication::applicationDirPath() + "/MNE-sample-data/subjects/sample/surf")
@@ -170,6 +171,8 @@ void RtcMne::init()
             this, &RtcMne::onTriggerTypeChanged);
     connect(m_pMinimumNormSettingsView.data(), &MinimumNormSettingsView::timePointChanged,
             this, &RtcMne::onTimePointValueChanged);
+    connect(m_pMinimumNormSettingsView.data(), &MinimumNormSettingsView::singlePrecisionChanged,
+            this, &RtcMne::onSinglePrecisionChanged);
 
     m_pRTSEOutput->data()->addControlWidget(m_pMinimumNormSettingsView);
 
@@ -521,6 +524,7 @@ void RtcMne::updateInvOp(const MNEInverseOperator& invOp)
     double lambda2 = 1.0 / pow(snr, 2); //ToDo estimate lambda using covariance
 
     m_pMinimumNorm = MinimumNorm::SPtr(new MinimumNorm(m_invOp, lambda2, m_sMethod));
+    m_pMinimumNorm->setSinglePrecision(m_bSinglePrecision);
 
     //Set up the inverse according to the parameters
     // Use 1 nave here because in case of evoked data as input the minimum norm will always be updated when the source estimate is calculated (see run method).
@@ -540,6 +544,7 @@ void RtcMne::onMethodChanged(const QString& method)
         double snr = 1.0;
         double lambda2 = 1.0 / pow(snr, 2); //ToDo estimate lambda using covariance
         m_pMinimumNorm = MinimumNorm::SPtr(new MinimumNorm(m_invOp, lambda2, m_sMethod));
+        m_pMinimumNorm->setSinglePrecision(m_bSinglePrecision);
 
         // Set up the inverse according to the parameters.
         // Use 1 nave here because in case of evoked data as input the minimum norm will always be updated when the source estimate is calculated (see run method).
@@ -572,6 +577,23 @@ void RtcMne::onTimePointValueChanged(int iTimePointMs)
 }
 
 
+//*************************************************************************************************************
+
+void RtcMne::onSinglePrecisionChanged(bool bSinglePrecision)
+{
+    QMutexLocker locker(&m_qMutex);
+
+    m_bSinglePrecision = bSinglePrecision;
+
+    if(m_pMinimumNorm) {
+        m_pMinimumNorm->setSinglePrecision(m_bSinglePrecision);
+
+        // Reassemble the kernel in the new precision.
+        m_pMinimumNorm->doInverseSetup(1,true);
+    }
+}
+
+
 //*************************************************************************************************************
 
 void RtcMne::run()
@@ -230,6 +230,14 @@ protected:
      */
     void onTimePointValueChanged(int iTimePointMs);
 
+    //=========================================================================================================
+    /**
+     * Slot called when the kernel precision changed.
+     *
+     * @param [in] bSinglePrecision        Whether the kernel should be used in single precision.
+     */
+    void onSinglePrecisionChanged(bool bSinglePrecision);
+
     virtual void run();
 
     QSharedPointer<SCSHAREDLIB::PluginInputData<SCMEASLIB::RealTimeMultiSampleArray> >      m_pRTMSAInput;              /**< The RealTimeMultiSampleArray input.*/
@@ -263,6 +271,7 @@ protected:
     bool                            m_bReceiveData;             /**< If thread is ready to receive data. */
     bool                            m_bProcessData;             /**< If data should be received for processing. */
     bool                            m_bFinishedClustering;      /**< If clustered forward solution is available. */
+    bool                            m_bSinglePrecision;         /**< If the imaging kernel is stored and applied in single precision. */
 
     QFile                           m_qFileFwdSolution;         /**< File to forward solution. */
 
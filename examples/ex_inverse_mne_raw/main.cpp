@@ -145,6 +145,7 @@ int main(int argc, char *argv[])
     QCommandLineOption snrOption("snr", "The SNR value used for computation <snr>.", "snr", "1.0");//3.0;//0.1;//3.0;
     QCommandLineOption numberAveragesOption("numAve", "The <value> for the number of averages.", "value", "40");
     QCommandLineOption methodOption("method", "Inverse estimation <method>, i.e., 'MNE', 'dSPM' or 'sLORETA'.", "method", "dSPM");//"MNE" | "dSPM" | "sLORETA"
+    QCommandLineOption singlePrecisionOption("singlePrecision", "Store and apply the imaging kernel in single precision.", "singlePrecision", "false");
 
     QCommandLineOption invFileOutOption("invOut", "Path to inverse <file>, which is to be written.", "file", "");
     QCommandLineOption stcFileOutOption("stcOut", "Path to stc <file>, which is to be written.", "file", "");
@@ -170,6 +171,7 @@ int main(int argc, char *argv[])
     parser.addOption(hemiOption);
 
     parser.addOption(methodOption);
+    parser.addOption(singlePrecisionOption);
 
     parser.addOption(invFileOutOption);
     parser.addOption(stcFileOutOption);
@@ -215,6 +217,13 @@ int main(int argc, char *argv[])
         pick_all = true;
     }
 
+    bool single_precision = false;
+    if(parser.value(singlePrecisionOption) == "false" || parser.value(singlePrecisionOption) == "0") {
+        single_precision = false;
+    } else if(parser.value(singlePrecisionOption) == "true" || parser.value(singlePrecisionOption) == "1") {
+        single_precision = true;
+    }
+
     qint32 k, p;
 
     //
@@ -544,6 +553,7 @@ int main(int argc, char *argv[])
     // Compute inverse solution
     //
     MinimumNorm minimumNorm(inverse_operator, lambda2, method);
+    minimumNorm.setSinglePrecision(single_precision);
 
     MNESourceEstimate sourceEstimate = minimumNorm.calculateInverse(evoked);
 
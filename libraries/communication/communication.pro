@@ -72,6 +72,7 @@ SOURCES += \
     rtClient/rtclient.cpp \
     rtClient/rtdataclient.cpp \
     rtClient/rtcmdclient.cpp \
+    rtClient/rtbuffercodec.cpp \
     rtCommand/command.cpp \
     rtCommand/commandmanager.cpp \
     rtCommand/commandparser.cpp \
@@ -82,6 +83,7 @@ HEADERS +=  \
     rtClient/rtclient.h \
     rtClient/rtcmdclient.h \
     rtClient/rtdataclient.h \
+    rtClient/rtbuffercodec.h \
     rtCommand/command.h \
     rtCommand/commandmanager.h \
     rtCommand/commandparser.h \
@@ -0,0 +1,534 @@
+//=============================================================================================================
+/**
+ * @file     rtbuffercodec.cpp
+ * @author   agent <agent@local>
+ * @version  dev
+ * @date     October, 2026
+ *
+ * @section  LICENSE
+ *
+ * Copyright (C) 2026, agent. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+ * the following conditions are met:
+ *     * Redistributions of source code must retain the above copyright notice, this list of conditions and the
+ *       following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+ *       the following disclaimer in the documentation and/or other materials provided with the distribution.
+ *     * Neither the name of MNE-CPP authors nor the names of its contributors may be used
+ *       to endorse or promote products derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+ * WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ * PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+ * INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ * NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ *
+ * @brief    Definition of the RtBufferCodec class
+ *
+ */
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// INCLUDES
+//=============================================================================================================
+
+#include "rtbuffercodec.h"
+
+#include <fiff/fiff_stream.h>
+#include <fiff/fiff_file.h>
+#include <fiff/fiff_constants.h>
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// QT INCLUDES
+//=============================================================================================================
+
+#include <QtEndian>
+#include <QtMath>
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// STL INCLUDES
+//=============================================================================================================
+
+#include <cstring>
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// USED NAMESPACES
+//=============================================================================================================
+
+using namespace COMMUNICATIONLIB;
+using namespace FIFFLIB;
+using namespace Eigen;
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// DEFINE GLOBAL METHODS
+//=============================================================================================================
+
+namespace {
+
+const int TAG_HEADER_SIZE = 16;         /**< kind, type, size and next. */
+const int DATA_HEADER_SIZE = 12;        /**< encoding, number of channels and number of samples. */
+const int RICE_ESCAPE = 24;             /**< Quotients of this length or longer are escaped and stored as raw 32 bit value. */
+
+//=============================================================================================================
+/**
+ * Writes a MSB first bit stream.
+ */
+class BitWriter
+{
+public:
+    explicit BitWriter(uchar* pData)
+    : m_pData(pData)
+    , m_iPos(0)
+    , m_iBuffer(0)
+    , m_iBits(0)
+    {
+    }
+
+    inline void write(quint32 iValue, int iBits)
+    {
+        m_iBuffer = (m_iBuffer << iBits) | (quint64(iValue) & ((quint64(1) << iBits) - 1));
+        m_iBits += iBits;
+
+        while(m_iBits >= 8) {
+            m_iBits -= 8;
+            m_pData[m_iPos++] = uchar(m_iBuffer >> m_iBits);
+        }
+    }
+
+    inline void writeRice(quint32 iValue, int k)
+    {
+        quint32 q = iValue >> k;
+
+        if(q < quint32(RICE_ESCAPE)) {
+            // q ones terminated by a zero followed by the k low bits
+            write((quint32(1) << (q + 1)) - 2, q + 1);
+            write(iValue, k);
+        } else {
+            write((quint32(1) << RICE_ESCAPE) - 1, RICE_ESCAPE);
+            write(iValue, 32);
+        }
+    }
+
+    inline void align()
+    {
+        if(m_iBits > 0) {
+            m_pData[m_iPos++] = uchar(m_iBuffer << (8 - m_iBits));
+            m_iBits = 0;
+        }
+    }
+
+    inline int pos() const
+    {
+        return m_iPos;
+    }
+
+private:
+    uchar*  m_pData;
+    int     m_iPos;
+    quint64 m_iBuffer;
+    int     m_iBits;
+};
+
+//=============================================================================================================
+/**
+ * Reads a MSB first bit stream with bounds checking.
+ */
+class BitReader
+{
+public:
+    BitReader(const uchar* pData, int iSize)
+    : m_pData(pData)
+    , m_iSize(iSize)
+    , m_iPos(0)
+    , m_iBuffer(0)
+    , m_iBits(0)
+    , m_bError(false)
+    {
+    }
+
+    inline quint32 read(int iBits)
+    {
+        while(m_iBits < iBits) {
+            if(m_iPos >= m_iSize) {
+                m_bError = true;
+                return 0;
+            }
+            m_iBuffer = (m_iBuffer << 8) | m_pData[m_iPos++];
+            m_iBits += 8;
+        }
+
+        m_iBits -= iBits;
+        return quint32((m_iBuffer >> m_iBits) & ((quint64(1) << iBits) - 1));
+    }
+
+    inline quint32 readRice(int k)
+    {
+        int q = 0;
+        while(q < RICE_ESCAPE && read(1) == 1 && !m_bError) {
+            ++q;
+        }
+
+        if(q == RICE_ESCAPE) {
+            return read(32);
+        }
+
+        return (quint32(q) << k) | read(k);
+    }
+
+    inline void align()
+    {
+        m_iBits = 0;
+    }
+
+    inline int pos() const
+    {
+        return m_iPos;
+    }
+
+    inline bool error() const
+    {
+        return m_bError;
+    }
+
+private:
+    const uchar*    m_pData;
+    int             m_iSize;
+    int             m_iPos;
+    quint64         m_iBuffer;
+    int             m_iBits;
+    bool            m_bError;
+};
+
+inline quint32 zigZag(qint32 iValue)
+{
+    return (quint32(iValue) << 1) ^ quint32(iValue >> 31);
+}
+
+inline qint32 unZigZag(quint32 iValue)
+{
+    return qint32((iValue >> 1) ^ (~(iValue & 1) + 1));
+}
+
+} // namespace
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// DEFINE MEMBER METHODS
+//=============================================================================================================
+
+bool RtBufferCodec::parseEncoding(const QString& sEncoding, Encoding& encoding)
+{
+    if(sEncoding.compare("float", Qt::CaseInsensitive) == 0)
+        encoding = Float;
+    else if(sEncoding.compare("int16", Qt::CaseInsensitive) == 0)
+        encoding = Int16;
+    else if(sEncoding.compare("int24", Qt::CaseInsensitive) == 0)
+        encoding = Int24;
+    else if(sEncoding.compare("int16-delta", Qt::CaseInsensitive) == 0)
+        encoding = Int16Delta;
+    else if(sEncoding.compare("int24-delta", Qt::CaseInsensitive) == 0)
+        encoding = Int24Delta;
+    else
+        return false;
+
+    return true;
+}
+
+
+//*************************************************************************************************************
+
+QString RtBufferCodec::encodingToString(Encoding encoding)
+{
+    switch(encoding) {
+        case Float:
+            return QString("float");
+        case Int16:
+            return QString("int16");
+        case Int24:
+            return QString("int24");
+        case Int16Delta:
+            return QString("int16-delta");
+        case Int24Delta:
+            return QString("int24-delta");
+    }
+
+    return QString();
+}
+
+
+//*************************************************************************************************************
+
+VectorXf RtBufferCodec::calibrationSteps(const FiffInfo& info)
+{
+    VectorXf vecCalSteps(info.chs.size());
+
+    for(int i = 0; i < info.chs.size(); ++i) {
+        vecCalSteps[i] = info.chs[i].cal * info.chs[i].range;
+    }
+
+    return vecCalSteps;
+}
+
+
+//*************************************************************************************************************
+
+QByteArray RtBufferCodec::encodeTag(const MatrixXf& matData,
+                                    const VectorXf& vecCalSteps,
+                                    Encoding encoding)
+{
+    QByteArray t_blockTag;
+
+    if(encoding == Float) {
+        FiffStream t_FiffStreamOut(&t_blockTag, QIODevice::WriteOnly);
+        t_FiffStreamOut.write_float(FIFF_DATA_BUFFER, matData.data(), matData.rows()*matData.cols());
+        return t_blockTag;
+    }
+
+    const int iNChan = matData.rows();
+    const int iNSamp = matData.cols();
+    const bool bInt16 = (encoding == Int16 || encoding == Int16Delta);
+    const bool bDelta = (encoding == Int16Delta || encoding == Int24Delta);
+    const qint32 iMaxValue = bInt16 ? 32767 : 8388607;
+
+    //
+    // Quantize each channel in units of its calibration step. The step is doubled until the channel fits.
+    //
+    VectorXf vecSteps(iNChan);
+    MatrixXi matQuant(iNChan, iNSamp);
+
+    for(int c = 0; c < iNChan; ++c) {
+        float fMaxAbs = 0.0f;
+        for(int s = 0; s < iNSamp; ++s) {
+            if(qIsFinite(matData(c,s))) {
+                fMaxAbs = qMax(fMaxAbs, qAbs(matData(c,s)));
+            }
+        }
+
+        float fStep = 1.0f;
+        if(c < vecCalSteps.size() && vecCalSteps[c] > 0.0f && qIsFinite(vecCalSteps[c])) {
+            fStep = vecCalSteps[c];
+        } else if(fMaxAbs > 0.0f) {
+            fStep = fMaxAbs / iMaxValue;
+        }
+
+        while(fMaxAbs / fStep >= iMaxValue + 0.5f) {
+            fStep *= 2.0f;
+        }
+
+        vecSteps[c] = fStep;
+
+        for(int s = 0; s < iNSamp; ++s) {
+            float fValue = matData(c,s) / fStep;
+            matQuant(c,s) = qIsNaN(fValue) ? 0 : qRound(qBound(-float(iMaxValue), fValue, float(iMaxValue)));
+        }
+    }
+
+    //
+    // Allocate for the worst case and shrink to the written size
+    //
+    int iMaxDataSize = DATA_HEADER_SIZE + 4 * iNChan;
+    if(bDelta) {
+        iMaxDataSize += iNChan * 2 + iNChan * iNSamp * 7;
+    } else {
+        iMaxDataSize += iNChan * iNSamp * (bInt16 ? 2 : 3);
+    }
+
+    t_blockTag.resize(TAG_HEADER_SIZE + iMaxDataSize);
+    uchar* pData = reinterpret_cast<uchar*>(t_blockTag.data()) + TAG_HEADER_SIZE;
+
+    qToBigEndian<qint32>(encoding, pData);
+    qToBigEndian<qint32>(iNChan, pData + 4);
+    qToBigEndian<qint32>(iNSamp, pData + 8);
+    int iPos = DATA_HEADER_SIZE;
+
+    for(int c = 0; c < iNChan; ++c) {
+        quint32 iStep;
+        std::memcpy(&iStep, &vecSteps[c], sizeof(float));
+        qToBigEndian<quint32>(iStep, pData + iPos);
+        iPos += 4;
+    }
+
+    if(bDelta) {
+        BitWriter t_writer(pData + iPos);
+
+        for(int c = 0; c < iNChan; ++c) {
+            // Rice parameter from the mean of the zig zag coded differences
+            quint64 iSum = 0;
+            qint32 iPrevious = 0;
+            for(int s = 0; s < iNSamp; ++s) {
+                iSum += zigZag(matQuant(c,s) - iPrevious);
+                iPrevious = matQuant(c,s);
+            }
+
+            quint64 iMean = iNSamp > 0 ? iSum / iNSamp : 0;
+            int k = 0;
+            while(k < 24 && (quint64(1) << (k + 1)) <= iMean) {
+                ++k;
+            }
+
+            t_writer.write(k, 8);
+
+            iPrevious = 0;
+            for(int s = 0; s < iNSamp; ++s) {
+                t_writer.writeRice(zigZag(matQuant(c,s) - iPrevious), k);
+                iPrevious = matQuant(c,s);
+            }
+
+            t_writer.align();
+        }
+
+        iPos += t_writer.pos();
+    } else {
+        const qint32* pQuant = matQuant.data();
+
+        if(bInt16) {
+            for(int i = 0; i < iNChan * iNSamp; ++i) {
+                qToBigEndian<qint16>(qint16(pQuant[i]), pData + iPos);
+                iPos += 2;
+            }
+        } else {
+            for(int i = 0; i < iNChan * iNSamp; ++i) {
+                quint32 iValue = quint32(pQuant[i]);
+                pData[iPos] = uchar(iValue >> 16);
+                pData[iPos + 1] = uchar(iValue >> 8);
+                pData[iPos + 2] = uchar(iValue);
+                iPos += 3;
+            }
+        }
+    }
+
+    t_blockTag.resize(TAG_HEADER_SIZE + iPos);
+
+    //
+    // Tag header
+    //
+    uchar* pHeader = reinterpret_cast<uchar*>(t_blockTag.data());
+    qToBigEndian<qint32>(FIFF_MNE_RT_COMPACT_DATA_BUFFER, pHeader);
+    qToBigEndian<qint32>(FIFFT_BYTE, pHeader + 4);
+    qToBigEndian<qint32>(iPos, pHeader + 8);
+    qToBigEndian<qint32>(FIFFV_NEXT_SEQ, pHeader + 12);
+
+    return t_blockTag;
+}
+
+
+//*************************************************************************************************************
+
+bool RtBufferCodec::decodeTag(const FiffTag& tag,
+                              MatrixXf& matData)
+{
+    VectorXf vecSteps;
+    return decodeTag(tag, matData, vecSteps);
+}
+
+
+//*************************************************************************************************************
+
+bool RtBufferCodec::decodeTag(const FiffTag& tag,
+                              MatrixXf& matData,
+                              VectorXf& vecSteps)
+{
+    const uchar* pData = reinterpret_cast<const uchar*>(tag.constData());
+    const int iSize = tag.size();
+
+    if(tag.kind != FIFF_MNE_RT_COMPACT_DATA_BUFFER || iSize < DATA_HEADER_SIZE) {
+        qWarning("RtBufferCodec::decodeTag - Not a compact data buffer.");
+        return false;
+    }
+
+    qint32 iEncoding = qFromBigEndian<qint32>(pData);
+    qint32 iNChan = qFromBigEndian<qint32>(pData + 4);
+    qint32 iNSamp = qFromBigEndian<qint32>(pData + 8);
+
+    if(iEncoding < Int16 || iEncoding > Int24Delta || iNChan <= 0 || iNSamp < 0
+       || iSize < DATA_HEADER_SIZE + 4 * qint64(iNChan)) {
+        qWarning("RtBufferCodec::decodeTag - Malformed header.");
+        return false;
+    }
+
+    const bool bInt16 = (iEncoding == Int16 || iEncoding == Int16Delta);
+    const bool bDelta = (iEncoding == Int16Delta || iEncoding == Int24Delta);
+
+    vecSteps.resize(iNChan);
+    int iPos = DATA_HEADER_SIZE;
+    for(int c = 0; c < iNChan; ++c) {
+        quint32 iStep = qFromBigEndian<quint32>(pData + iPos);
+        std::memcpy(&vecSteps[c], &iStep, sizeof(float));
+        iPos += 4;
+    }
+
+    // Every sample takes at least one bit in the delta and two bytes in the plain encodings
+    if(qint64(iNChan) * iNSamp > (bDelta ? 8 : 1) * qint64(iSize - iPos)) {
+        qWarning("RtBufferCodec::decodeTag - Data size does not match the header.");
+        return false;
+    }
+
+    matData.resize(iNChan, iNSamp);
+
+    if(bDelta) {
+        BitReader t_reader(pData + iPos, iSize - iPos);
+
+        for(int c = 0; c < iNChan; ++c) {
+            int k = t_reader.read(8);
+            if(k > 24) {
+                qWarning("RtBufferCodec::decodeTag - Malformed Rice parameter.");
+                return false;
+            }
+
+            qint32 iValue = 0;
+            for(int s = 0; s < iNSamp; ++s) {
+                iValue = qint32(quint32(iValue) + quint32(unZigZag(t_reader.readRice(k))));
+                matData(c,s) = iValue * vecSteps[c];
+            }
+
+            t_reader.align();
+        }
+
+        if(t_reader.error()) {
+            qWarning("RtBufferCodec::decodeTag - Data is truncated.");
+            return false;
+        }
+    } else {
+        const qint64 iNValues = qint64(iNChan) * iNSamp;
+
+        if(iSize - iPos != iNValues * (bInt16 ? 2 : 3)) {
+            qWarning("RtBufferCodec::decodeTag - Data size does not match the header.");
+            return false;
+        }
+
+        float* pMatData = matData.data();
+
+        if(bInt16) {
+            for(qint64 i = 0; i < iNValues; ++i) {
+                pMatData[i] = qFromBigEndian<qint16>(pData + iPos) * vecSteps[i % iNChan];
+                iPos += 2;
+            }
+        } else {
+            for(qint64 i = 0; i < iNValues; ++i) {
+                qint32 iValue = (qint32(pData[iPos]) << 16) | (qint32(pData[iPos + 1]) << 8) | qint32(pData[iPos + 2]);
+                if(iValue & 0x800000) {
+                    iValue -= 0x1000000;
+                }
+                pMatData[i] = iValue * vecSteps[i % iNChan];
+                iPos += 3;
+            }
+        }
+    }
+
+    return true;
+}
@@ -0,0 +1,183 @@
+//=============================================================================================================
+/**
+ * @file     rtbuffercodec.h
+ * @author   agent <agent@local>
+ * @version  dev
+ * @date     October, 2026
+ *
+ * @section  LICENSE
+ *
+ * Copyright (C) 2026, agent. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+ * the following conditions are met:
+ *     * Redistributions of source code must retain the above copyright notice, this list of conditions and the
+ *       following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+ *       the following disclaimer in the documentation and/or other materials provided with the distribution.
+ *     * Neither the name of MNE-CPP authors nor the names of its contributors may be used
+ *       to endorse or promote products derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+ * WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ * PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+ * INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ * NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ *
+ * @brief    Declaration of the RtBufferCodec class
+ *
+ */
+
+#ifndef RTBUFFERCODEC_H
+#define RTBUFFERCODEC_H
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// INCLUDES
+//=============================================================================================================
+
+#include "../communication_global.h"
+
+#include <fiff/fiff_info.h>
+#include <fiff/fiff_tag.h>
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// QT INCLUDES
+//=============================================================================================================
+
+#include <QByteArray>
+#include <QString>
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// Eigen INCLUDES
+//=============================================================================================================
+
+#include <Eigen/Core>
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// DEFINE NAMESPACE COMMUNICATIONLIB
+//=============================================================================================================
+
+namespace COMMUNICATIONLIB
+{
+
+
+//=============================================================================================================
+/**
+ * Encodes and decodes raw data buffers which are streamed between mne_rt_server and its data clients. Besides
+ * the plain float FIFF_DATA_BUFFER tag, buffers can be sent as FIFF_MNE_RT_COMPACT_DATA_BUFFER tag. The samples
+ * are then quantized to int16 or int24 in units of the channel calibration (cal * range), i.e. the original ADC
+ * values are restored if the data was read from an integer recording. Channels whose values exceed the integer
+ * range are coarsened by a power of two. The delta variants additionally store the sample to sample differences
+ * per channel with an adaptive Rice code, which is lossless with respect to the quantized values.
+ *
+ * Layout of the compact tag data (big endian): encoding, number of channels, number of samples (int32 each),
+ * the quantization step of each channel (float32) followed by the samples. The plain variants store the samples
+ * in the same (sample major) order as the float buffer, the delta variants store one byte aligned Rice coded
+ * stream per channel, each beginning with its Rice parameter.
+ *
+ * @brief Compact encoding of real-time data buffers
+ */
+class COMMUNICATIONSHARED_EXPORT RtBufferCodec
+{
+
+public:
+    /**
+     * The buffer encodings.
+     */
+    enum Encoding {
+        Float = 0,          /**< Plain float FIFF_DATA_BUFFER tag. */
+        Int16 = 1,          /**< Samples quantized to int16. */
+        Int24 = 2,          /**< Samples quantized to int24. */
+        Int16Delta = 3,     /**< Samples quantized to int16, delta and Rice coded. */
+        Int24Delta = 4      /**< Samples quantized to int24, delta and Rice coded. */
+    };
+
+    //=========================================================================================================
+    /**
+     * Parses an encoding name ("float" | "int16" | "int24" | "int16-delta" | "int24-delta").
+     *
+     * @param [in] sEncoding     The encoding name.
+     * @param [out] encoding     The parsed encoding.
+     *
+     * @return true if the name is valid, false otherwise.
+     */
+    static bool parseEncoding(const QString& sEncoding, Encoding& encoding);
+
+    //=========================================================================================================
+    /**
+     * Returns the name of an encoding.
+     *
+     * @param [in] encoding      The encoding.
+     *
+     * @return the encoding name.
+     */
+    static QString encodingToString(Encoding encoding);
+
+    //=========================================================================================================
+    /**
+     * Returns the quantization step (cal * range) of each channel.
+     *
+     * @param [in] info          The measurement info.
+     *
+     * @return the quantization steps.
+     */
+    static Eigen::VectorXf calibrationSteps(const FIFFLIB::FiffInfo& info);
+
+    //=========================================================================================================
+    /**
+     * Encodes a raw buffer as complete FIFF tag (header and data) which can be written to a socket as is.
+     *
+     * @param [in] matData           The raw buffer (channels x samples).
+     * @param [in] vecCalSteps       The quantization step of each channel, see calibrationSteps. If empty or not
+     *                               positive the step is derived from the maximum value of the channel.
+     * @param [in] encoding          The encoding.
+     *
+     * @return the encoded tag.
+     */
+    static QByteArray encodeTag(const Eigen::MatrixXf& matData,
+                                const Eigen::VectorXf& vecCalSteps,
+                                Encoding encoding);
+
+    //=========================================================================================================
+    /**
+     * Decodes the data of a FIFF_MNE_RT_COMPACT_DATA_BUFFER tag.
+     *
+     * @param [in] tag           The tag read from the stream.
+     * @param [out] matData      The decoded raw buffer (channels x samples).
+     *
+     * @return true if succeeded, false if the tag is malformed.
+     */
+    static bool decodeTag(const FIFFLIB::FiffTag& tag,
+                          Eigen::MatrixXf& matData);
+
+    //=========================================================================================================
+    /**
+     * Decodes the data of a FIFF_MNE_RT_COMPACT_DATA_BUFFER tag. Does not allocate memory when matData and
+     * vecSteps already have the size of the buffer.
+     *
+     * @param [in] tag           The tag read from the stream.
+     * @param [out] matData      The decoded raw buffer (channels x samples).
+     * @param [out] vecSteps     Scratch vector receiving the quantization steps of the channels.
+     *
+     * @return true if succeeded, false if the tag is malformed.
+     */
+    static bool decodeTag(const FIFFLIB::FiffTag& tag,
+                          Eigen::MatrixXf& matData,
+                          Eigen::VectorXf& vecSteps);
+};
+
+} // NAMESPACE
+
+#endif // RTBUFFERCODEC_H
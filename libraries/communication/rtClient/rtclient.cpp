@@ -44,6 +44,14 @@
 #include "rtdataclient.h"
 
 
+//*************************************************************************************************************
+//=============================================================================================================
+// DEFINES
+//=============================================================================================================
+
+#define RAW_BUFFER_RING_SIZE 8      /**< Number of raw buffers which can be read from the data client at once. */
+
+
 //*************************************************************************************************************
 //=============================================================================================================
 // USED NAMESPACES
@@ -140,7 +148,8 @@ void RtClient::run()
     //
     // Inits
     //
-    MatrixXf t_matRawBuffer;
+    QVector<MatrixXf> t_ringRawBuffers(RAW_BUFFER_RING_SIZE);
+    qint32 t_iRingIndex = 0;
 
     fiff_int_t kind;
 
@@ -178,20 +187,31 @@ void RtClient::run()
 //        while(m_bIsMeasuring)
 
 
-        t_dataClient.readRawBuffer(m_pFiffInfo->nchan, t_matRawBuffer, kind);
+        // Drain all pending buffers at once, the ring matrices are reused once they have the buffer size
+        qint32 t_iNumRead = t_dataClient.readRawBuffers(m_pFiffInfo->nchan, t_ringRawBuffers, t_iRingIndex, RAW_BUFFER_RING_SIZE, kind);
 
-        if(kind == FIFF_DATA_BUFFER)
+        // readRawBuffers returns immediately once the data connection is lost, do not spin on it
+        if(t_iNumRead == 0 && t_dataClient.state() != QAbstractSocket::ConnectedState)
         {
+            qWarning("RtClient::run - Lost connection to mne_rt_server.");
+            m_bIsRunning = false;
+            break;
+        }
+
+        for(qint32 i = 0; i < t_iNumRead; ++i)
+        {
+            const MatrixXf& t_matRawBuffer = t_ringRawBuffers[t_iRingIndex];
+
             to += t_matRawBuffer.cols();
             printf("Reading %d ... %d  =  %9.3f ... %9.3f secs...", from, to, ((float)from)/m_pFiffInfo->sfreq, ((float)to)/m_pFiffInfo->sfreq);
             from += t_matRawBuffer.cols();
 
             emit rawBufferReceived(t_matRawBuffer);
-        }
-        else if(FIFF_DATA_BUFFER == FIFF_BLOCK_END)
-            m_bIsRunning = false;
 
-        printf("[done]\n");
+            t_iRingIndex = (t_iRingIndex + 1) % RAW_BUFFER_RING_SIZE;
+
+            printf("[done]\n");
+        }
     }
 
     //
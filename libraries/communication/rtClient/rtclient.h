@@ -168,10 +168,12 @@ signals:
     //=========================================================================================================
     /**
      * Emits a received raw buffer - ToDo change the emits to fiff raw data.
+     * The buffer is a slot of the internal receive ring. Directly connected slots get it without a copy and must not
+     * keep the reference, queued connections receive their own copy.
      *
      * @param[in] p_rawBuffer    the received raw buffer
      */
-    void rawBufferReceived(Eigen::MatrixXf p_rawBuffer);
+    void rawBufferReceived(const Eigen::MatrixXf& p_rawBuffer);
 
     //=========================================================================================================
     /**
@@ -42,6 +42,16 @@
 #include "rtdataclient.h"
 #include <fiff/fiff_file.h>
 
+#include <cstring>
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// QT INCLUDES
+//=============================================================================================================
+
+#include <QtEndian>
+
 
 //*************************************************************************************************************
 //=============================================================================================================
@@ -51,6 +61,18 @@
 using namespace COMMUNICATIONLIB;
 
 
+//*************************************************************************************************************
+//=============================================================================================================
+// DEFINE GLOBAL METHODS
+//=============================================================================================================
+
+namespace {
+
+const int TAG_HEADER_SIZE = 16;         /**< kind, type, size and next. */
+
+}
+
+
 //*************************************************************************************************************
 //=============================================================================================================
 // DEFINE MEMBER METHODS
@@ -359,25 +381,47 @@ FiffInfo::SPtr RtDataClient::readInfo()
 
 void RtDataClient::readRawBuffer(qint32 p_nChannels, MatrixXf& data, fiff_int_t& kind)
 {
-//        data = [];
+    if(!readTagInto(p_nChannels, data, kind))
+        kind = FIFF_NOP;
+}
 
-    FiffStream t_fiffStream(this);
-    //
-    // Find the start
-    //
-    FiffTag::SPtr t_pTag;
 
-    t_fiffStream.read_rt_tag(t_pTag);
+//*************************************************************************************************************
+
+qint32 RtDataClient::readRawBuffers(qint32 p_nChannels,
+                                    QVector<MatrixXf>& p_ringBuffers,
+                                    qint32 p_iWriteIndex,
+                                    qint32 p_iMaxBuffers,
+                                    fiff_int_t& kind)
+{
+    kind = FIFF_NOP;
+
+    const qint32 iRingSize = p_ringBuffers.size();
+    if(iRingSize == 0 || p_iWriteIndex < 0)
+        return 0;
 
-    kind = t_pTag->kind;
+    p_iMaxBuffers = qMin(p_iMaxBuffers, iRingSize);
 
-    if(kind == FIFF_DATA_BUFFER)
+    qint32 iNumRead = 0;
+    while(iNumRead < p_iMaxBuffers)
     {
-        qint32 nSamples = (t_pTag->size()/4)/p_nChannels;
-        data = MatrixXf(Map< MatrixXf >(t_pTag->toFloat(), p_nChannels, nSamples));
+        // Only the first tag is waited for, further tags are read as long as they are completely received
+        if(iNumRead > 0 && !isTagAvailable())
+            break;
+
+        if(!readTagInto(p_nChannels, p_ringBuffers[(p_iWriteIndex + iNumRead) % iRingSize], kind))
+        {
+            kind = FIFF_NOP;
+            break;
+        }
+
+        if(kind != FIFF_DATA_BUFFER)
+            break;
+
+        ++iNumRead;
     }
-//        else
-//            data = tag.data;
+
+    return iNumRead;
 }
 
 
@@ -389,3 +433,178 @@ void RtDataClient::setClientAlias(const QString &p_sAlias)
     t_fiffStream.write_rt_command(2, p_sAlias);//MNE_RT.MNE_RT_SET_CLIENT_ALIAS, alias);
     this->flush();
 }
+
+
+//*************************************************************************************************************
+
+void RtDataClient::setBufferEncoding(RtBufferCodec::Encoding p_encoding)
+{
+    FiffStream t_fiffStream(this);
+    t_fiffStream.write_rt_command(3, RtBufferCodec::encodingToString(p_encoding));//MNE_RT.MNE_RT_SET_BUFFER_ENCODING, encoding);
+    this->flush();
+}
+
+
+//*************************************************************************************************************
+
+bool RtDataClient::readTagInto(qint32 p_nChannels, MatrixXf& data, fiff_int_t& kind)
+{
+    uchar t_header[TAG_HEADER_SIZE];
+    if(!readFully(reinterpret_cast<char*>(t_header), TAG_HEADER_SIZE))
+        return false;
+
+    kind = qFromBigEndian<qint32>(t_header);
+    fiff_int_t type = qFromBigEndian<qint32>(t_header + 4);
+    qint32 size = qFromBigEndian<qint32>(t_header + 8);
+
+    if(size < 0)
+    {
+        qWarning("RtDataClient::readTagInto - Received tag with negative size.");
+        return false;
+    }
+
+    //
+    // Float raw buffers are read directly into the matrix memory and swapped in place
+    //
+    if(kind == FIFF_DATA_BUFFER && type == FIFFT_FLOAT && p_nChannels > 0 && size % (4*p_nChannels) == 0)
+    {
+        qint32 nSamples = (size/4)/p_nChannels;
+        if(data.rows() != p_nChannels || data.cols() != nSamples)
+            data.resize(p_nChannels, nSamples);
+
+        if(!readFully(reinterpret_cast<char*>(data.data()), size))
+            return false;
+
+        quint32* pData = reinterpret_cast<quint32*>(data.data());
+        for(qint32 i = 0; i < size/4; ++i)
+            pData[i] = qFromBigEndian<quint32>(pData[i]);
+
+        return true;
+    }
+
+    //
+    // Everything else goes through the reused tag buffer
+    //
+    m_tagBuffer.kind = kind;
+    m_tagBuffer.type = type;
+    m_tagBuffer.resize(size);
+
+    if(size > 0 && !readFully(m_tagBuffer.data(), size))
+        return false;
+
+    if(kind == FIFF_MNE_RT_COMPACT_DATA_BUFFER)
+    {
+        if(RtBufferCodec::decodeTag(m_tagBuffer, data, m_vecDecodeSteps) && data.rows() == p_nChannels)
+            kind = FIFF_DATA_BUFFER;
+    }
+    else if(kind == FIFF_DATA_BUFFER)
+    {
+        // Raw buffers which could not be decoded must not be counted as data
+        if(!decodeDataBuffer(p_nChannels, data))
+        {
+            qWarning("RtDataClient::readTagInto - Skipping raw buffer of type %d and size %d.", type, size);
+            kind = FIFF_NOP;
+        }
+    }
+
+    return true;
+}
+
+
+//*************************************************************************************************************
+
+bool RtDataClient::decodeDataBuffer(qint32 p_nChannels, MatrixXf& data)
+{
+    qint32 iBytesPerValue;
+    switch(m_tagBuffer.type)
+    {
+        case FIFFT_SHORT:
+        case FIFFT_DAU_PACK16:
+            iBytesPerValue = 2;
+            break;
+        case FIFFT_INT:
+        case FIFFT_FLOAT:
+            iBytesPerValue = 4;
+            break;
+        case FIFFT_DOUBLE:
+            iBytesPerValue = 8;
+            break;
+        default:
+            return false;
+    }
+
+    const qint32 size = m_tagBuffer.size();
+    if(p_nChannels <= 0 || size % (iBytesPerValue*p_nChannels) != 0)
+        return false;
+
+    const qint32 nValues = size/iBytesPerValue;
+    if(data.rows() != p_nChannels || data.cols() != nValues/p_nChannels)
+        data.resize(p_nChannels, nValues/p_nChannels);
+
+    const uchar* pSrc = reinterpret_cast<const uchar*>(m_tagBuffer.constData());
+    float* pDst = data.data();
+
+    for(qint32 i = 0; i < nValues; ++i, pSrc += iBytesPerValue)
+    {
+        switch(m_tagBuffer.type)
+        {
+            case FIFFT_SHORT:
+            case FIFFT_DAU_PACK16:
+                pDst[i] = qFromBigEndian<qint16>(pSrc);
+                break;
+            case FIFFT_INT:
+                pDst[i] = qFromBigEndian<qint32>(pSrc);
+                break;
+            case FIFFT_FLOAT:
+            {
+                quint32 iBits = qFromBigEndian<quint32>(pSrc);
+                memcpy(&pDst[i], &iBits, 4);
+                break;
+            }
+            case FIFFT_DOUBLE:
+            {
+                quint64 iBits = qFromBigEndian<quint64>(pSrc);
+                double dValue;
+                memcpy(&dValue, &iBits, 8);
+                pDst[i] = dValue;
+                break;
+            }
+        }
+    }
+
+    return true;
+}
+
+
+//*************************************************************************************************************
+
+bool RtDataClient::readFully(char* p_pData, qint64 p_iSize)
+{
+    qint64 iRead = 0;
+    while(iRead < p_iSize)
+    {
+        qint64 iChunk = this->read(p_pData + iRead, p_iSize - iRead);
+
+        if(iChunk < 0)
+            return false;
+
+        iRead += iChunk;
+
+        if(iRead < p_iSize && !this->waitForReadyRead(10) && this->state() != QAbstractSocket::ConnectedState && this->bytesAvailable() == 0)
+            return false;
+    }
+
+    return true;
+}
+
+
+//*************************************************************************************************************
+
+bool RtDataClient::isTagAvailable()
+{
+    uchar t_header[TAG_HEADER_SIZE];
+    if(this->peek(reinterpret_cast<char*>(t_header), TAG_HEADER_SIZE) < TAG_HEADER_SIZE)
+        return false;
+
+    return this->bytesAvailable() >= TAG_HEADER_SIZE + qint64(qFromBigEndian<qint32>(t_header + 8));
+}
@@ -43,6 +43,7 @@
 //=============================================================================================================
 
 #include "../communication_global.h"
+#include "rtbuffercodec.h"
 
 
 //*************************************************************************************************************
@@ -63,6 +64,7 @@
 #include <QSharedPointer>
 #include <QString>
 #include <QTcpSocket>
+#include <QVector>
 
 
 //*************************************************************************************************************
@@ -137,14 +139,37 @@ public:
 
     //=========================================================================================================
     /**
-     * Reads fiff measurement information of a data the connection
+     * Reads a raw buffer from the connection. Compact buffers (see setBufferEncoding) are decoded and reported
+     * as FIFF_DATA_BUFFER kind.
      *
      * @param[in] p_nChannels    Number of channels to reshape the received data
      * @param[out] data          The read data - ToDo change this to raw buffer data object
-     * @param[out] kind          Data kind
+     * @param[out] kind          Data kind, FIFF_NOP if the connection was lost
      */
     void readRawBuffer(qint32 p_nChannels, MatrixXf& data, fiff_int_t& kind);
 
+    //=========================================================================================================
+    /**
+     * Reads raw buffers from the connection into a caller owned ring of matrices. Blocks until the first tag
+     * arrived and then decodes all further raw buffers which are already completely received, so a backlog on
+     * the socket is drained in one call. The samples are decoded directly into the ring matrices; when these
+     * already have the size of the received buffers no memory is allocated. Reading stops after the first tag
+     * which is not a raw buffer.
+     *
+     * @param[in] p_nChannels        Number of channels to reshape the received data
+     * @param[in, out] p_ringBuffers The preallocated ring of matrices the raw buffers are decoded into
+     * @param[in] p_iWriteIndex      Ring index of the first matrix to write to
+     * @param[in] p_iMaxBuffers      Maximal number of raw buffers to read, at most the ring size is used
+     * @param[out] kind              Kind of the last read tag
+     *
+     * @return the number of raw buffers written to p_ringBuffers, starting at p_iWriteIndex and wrapping around
+     */
+    qint32 readRawBuffers(qint32 p_nChannels,
+                          QVector<MatrixXf>& p_ringBuffers,
+                          qint32 p_iWriteIndex,
+                          qint32 p_iMaxBuffers,
+                          fiff_int_t& kind);
+
     //=========================================================================================================
     /**
      * Sets the alias of the data client
@@ -153,8 +178,62 @@ public:
      */
     void setClientAlias(const QString &p_sAlias);
 
+    //=========================================================================================================
+    /**
+     * Requests the encoding in which mne_rt_server sends the raw buffers to this client. The quantized encodings
+     * reduce the bandwidth by a factor of 2 (int16) to 4 and more (delta variants). Should be set before the
+     * measurement is started.
+     *
+     * @param[in] p_encoding     The raw buffer encoding
+     */
+    void setBufferEncoding(RtBufferCodec::Encoding p_encoding);
+
 private:
-    qint32 m_clientID;  /**< Corresponding client id of the data client at mne_rt_server */
+    //=========================================================================================================
+    /**
+     * Reads a single tag and decodes raw buffers directly into data.
+     *
+     * @param[in] p_nChannels    Number of channels to reshape the received data
+     * @param[out] data          The read data, only written for raw buffer tags
+     * @param[out] kind          Data kind, FIFF_DATA_BUFFER for decoded raw buffers
+     *
+     * @return true if the tag was read, false if the connection was lost
+     */
+    bool readTagInto(qint32 p_nChannels, MatrixXf& data, fiff_int_t& kind);
+
+    //=========================================================================================================
+    /**
+     * Decodes the raw buffer held by m_tagBuffer (short, dau16, int, float or double) into data.
+     *
+     * @param[in] p_nChannels    Number of channels to reshape the received data
+     * @param[out] data          The decoded data
+     *
+     * @return true if the buffer was decoded, false if its type or size does not fit the number of channels
+     */
+    bool decodeDataBuffer(qint32 p_nChannels, MatrixXf& data);
+
+    //=========================================================================================================
+    /**
+     * Reads exactly p_iSize bytes from the socket, waiting for data as necessary.
+     *
+     * @param[out] p_pData   Destination of the read bytes
+     * @param[in] p_iSize    Number of bytes to read
+     *
+     * @return true if succeeded, false if the connection was lost
+     */
+    bool readFully(char* p_pData, qint64 p_iSize);
+
+    //=========================================================================================================
+    /**
+     * Checks whether a complete tag is already available on the socket, i.e. can be read without blocking.
+     *
+     * @return true if a complete tag can be read
+     */
+    bool isTagAvailable();
+
+    qint32          m_clientID;         /**< Corresponding client id of the data client at mne_rt_server */
+    FiffTag         m_tagBuffer;        /**< Reused payload buffer of compact and skipped tags */
+    VectorXf        m_vecDecodeSteps;   /**< Reused quantization steps of compact raw buffers */
 
 signals:
     
@@ -54,6 +54,8 @@
 #include "metrics/unbiasedsquaredphaselagindex.h"
 #include "metrics/debiasedsquaredweightedphaselagindex.h"
 
+#include <utils/spectral.h>
+
 
 //*************************************************************************************************************
 //=============================================================================================================
@@ -70,6 +72,8 @@
 // Eigen INCLUDES
 //=============================================================================================================
 
+#include <unsupported/Eigen/FFT>
+
 
 //*************************************************************************************************************
 //=============================================================================================================
@@ -77,6 +81,8 @@
 //=============================================================================================================
 
 using namespace CONNECTIVITYLIB;
+using namespace Eigen;
+using namespace UTILSLIB;
 
 
 //*************************************************************************************************************
@@ -104,6 +110,22 @@ QList<Network> Connectivity::calculate(ConnectivitySettings& connectivitySetting
     QElapsedTimer timer;
     timer.start();
 
+    // Share the tapered spectra between the spectral metrics if more than one of them is requested
+    QStringList lSpectralMethods;
+    lSpectralMethods << "WPLI" << "USPLI" << "XCOR" << "PLI" << "COH" << "IMAGCOH" << "PLV" << "DSWPLI";
+
+    int iNumberSpectralMethods = 0;
+    for(int i = 0; i < lSpectralMethods.size(); ++i) {
+        if(lMethods.contains(lSpectralMethods.at(i))) {
+            iNumberSpectralMethods++;
+        }
+    }
+
+    if(iNumberSpectralMethods > 1 && !connectivitySettings.isEmpty()) {
+        computeTapSpectra(connectivitySettings);
+        AbstractMetric::m_bTapSpectraCacheIsActive = true;
+    }
+
     if(lMethods.contains("WPLI")) {
         results.append(WeightedPhaseLagIndex::calculate(connectivitySettings));
     }
@@ -140,8 +162,46 @@ QList<Network> Connectivity::calculate(ConnectivitySettings& connectivitySetting
         results.append(DebiasedSquaredWeightedPhaseLagIndex::calculate(connectivitySettings));
     }
 
+    if(AbstractMetric::m_bTapSpectraCacheIsActive) {
+        AbstractMetric::m_bTapSpectraCacheIsActive = false;
+
+        // Only keep the spectra if the trial data is stored for subsequent calls
+        if(!AbstractMetric::m_bStorageModeIsActive && !connectivitySettings.isStorageModeActive()) {
+            for(int i = 0; i < connectivitySettings.getTrialData().size(); ++i) {
+                connectivitySettings.getTrialData()[i].vecTapSpectra.clear();
+            }
+        }
+    }
+
     qWarning() << "Total" << timer.elapsed();
     qDebug() << "Connectivity::calculateMultiMethods - Calculated"<< lMethods <<"for" << connectivitySettings.size() << "trials in"<< timer.elapsed() << "msecs.";
 
     return results;
 }
+
+
+//*************************************************************************************************************
+
+void Connectivity::computeTapSpectra(ConnectivitySettings& connectivitySettings)
+{
+    #ifdef EIGEN_FFTW_DEFAULT
+        fftw_make_planner_thread_safe();
+    #endif
+
+    int iSignalLength = connectivitySettings.at(0).matData.cols();
+    int iNfft = connectivitySettings.getFFTSize();
+
+    // Generate tapers
+    QPair<MatrixXd, VectorXd> tapers = Spectral::generateTapers(iSignalLength, connectivitySettings.getWindowType());
+
+    std::function<void(ConnectivitySettings::IntermediateTrialData&)> computeLambda = [&](ConnectivitySettings::IntermediateTrialData& inputData) {
+        AbstractMetric::computeTapSpectra(inputData,
+                                          iNfft,
+                                          tapers);
+    };
+
+    // Compute the tapered spectra in parallel for all trials. Trials which already hold their spectra are skipped.
+    QFuture<void> result = QtConcurrent::map(connectivitySettings.getTrialData(),
+                                             computeLambda);
+    result.waitForFinished();
+}
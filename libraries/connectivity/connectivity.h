@@ -111,6 +111,14 @@ public:
     static QList<Network> calculate(ConnectivitySettings& connectivitySettings);
 
 protected:
+    //=========================================================================================================
+    /**
+     * Computes the tapered spectra of all trials which do not hold them already. The spectra are then shared by all
+     * spectral metrics of a calculate call instead of being recomputed by every metric.
+     *
+     * @param[in, out] connectivitySettings     The connectivity settings holding the trial data.
+     */
+    static void computeTapSpectra(ConnectivitySettings& connectivitySettings);
 };
 
 
@@ -87,6 +87,7 @@ ConnectivitySettings::ConnectivitySettings()
 : m_fFreqResolution(1.0f)
 , m_fSFreq(1000.0f)
 , m_sWindowType("hanning")
+, m_bStorageModeIsActive(false)
 {
     m_iNfft = int(m_fSFreq/m_fFreqResolution);
     qRegisterMetaType<CONNECTIVITYLIB::ConnectivitySettings>("CONNECTIVITYLIB::ConnectivitySettings");
@@ -105,12 +106,14 @@ void ConnectivitySettings::clearAllData()
 
 //*******************************************************************************************************
 
-void ConnectivitySettings::clearIntermediateData() 
+void ConnectivitySettings::clearIntermediateData(bool bKeepTapSpectra)
 {
     for (int i = 0; i < m_trialData.size(); ++i) {
         m_trialData[i].matPsd.resize(0,0);
         m_trialData[i].vecPairCsd.clear();
-        m_trialData[i].vecTapSpectra.clear();
+        if(!bKeepTapSpectra) {
+            m_trialData[i].vecTapSpectra.clear();
+        }
         m_trialData[i].vecPairCsdNormalized.clear();
         m_trialData[i].vecPairCsdImagSign.clear();
         m_trialData[i].vecPairCsdImagAbs.clear();
@@ -453,3 +456,19 @@ ConnectivitySettings::IntermediateSumData& ConnectivitySettings::getIntermediate
 {
     return m_intermediateSumData;
 }
+
+
+//*******************************************************************************************************
+
+void ConnectivitySettings::setStorageModeActive(bool bStorageModeIsActive)
+{
+    m_bStorageModeIsActive = bStorageModeIsActive;
+}
+
+
+//*******************************************************************************************************
+
+bool ConnectivitySettings::isStorageModeActive() const
+{
+    return m_bStorageModeIsActive;
+}
@@ -136,7 +136,7 @@ public:
 
     void clearAllData();
 
-    void clearIntermediateData();
+    void clearIntermediateData(bool bKeepTapSpectra = false);
 
     void append(const QList<Eigen::MatrixXd>& matInputData);
 
@@ -184,6 +184,17 @@ public:
 
     IntermediateSumData& getIntermediateSumData();
 
+    //=========================================================================================================
+    /**
+     * Keeps the intermediate data of the trials after each calculation. Unlike AbstractMetric::m_bStorageModeIsActive
+     * this only affects the calculations done on this object.
+     *
+     * @param[in] bStorageModeIsActive   Whether to keep the intermediate data.
+     */
+    void setStorageModeActive(bool bStorageModeIsActive);
+
+    bool isStorageModeActive() const;
+
 protected:
     QStringList                     m_sConnectivityMethods;         /**< The connectivity methods. */
     QString                         m_sWindowType;                  /**< The window type used to compute tapered spectra. */
@@ -194,6 +205,8 @@ protected:
 
     Eigen::MatrixX3f                m_matNodePositions;             /**< The node position in 3D space. */
 
+    bool                            m_bStorageModeIsActive;         /**< Whether the intermediate data of the trials is kept after each calculation. */
+
     IntermediateSumData             m_intermediateSumData;          /**< The intermediate sum data holds data calculated over all trials as a whole. */
     QList<IntermediateTrialData>    m_trialData;                    /**< The trial data holds the actual and intermediate data calcualted for each trial. */
 
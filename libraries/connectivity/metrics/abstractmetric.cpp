@@ -52,6 +52,9 @@
 // Eigen INCLUDES
 //=============================================================================================================
 
+#include <Eigen/Dense>
+#include <unsupported/Eigen/FFT>
+
 
 //*************************************************************************************************************
 //=============================================================================================================
@@ -59,6 +62,7 @@
 //=============================================================================================================
 
 using namespace CONNECTIVITYLIB;
+using namespace Eigen;
 
 
 //*************************************************************************************************************
@@ -67,6 +71,7 @@ using namespace CONNECTIVITYLIB;
 //=============================================================================================================
 
 bool AbstractMetric::m_bStorageModeIsActive = false;
+bool AbstractMetric::m_bTapSpectraCacheIsActive = false;
 int AbstractMetric::m_iNumberBinStart = -1;
 int AbstractMetric::m_iNumberBinAmount = -1;
 
@@ -80,3 +85,107 @@ AbstractMetric::AbstractMetric()
 {
 }
 
+
+//*************************************************************************************************************
+
+void AbstractMetric::computeTapSpectra(ConnectivitySettings::IntermediateTrialData& inputData,
+                                       int iNfft,
+                                       const QPair<MatrixXd, VectorXd>& tapers)
+{
+    int iNRows = inputData.matData.rows();
+
+    if(inputData.vecTapSpectra.size() == iNRows) {
+        return;
+    }
+
+    inputData.vecTapSpectra.clear();
+
+    // This code was copied and changed modified Utils/Spectra since we do not want to call the function due to time loss.
+    int iNFreqs = int(floor(iNfft / 2.0)) + 1;
+
+    RowVectorXd vecInputFFT, rowData;
+    RowVectorXcd vecTmpFreq;
+
+    MatrixXcd matTapSpectrum(tapers.first.rows(), iNFreqs);
+
+    FFT<double> fft;
+    fft.SetFlag(fft.HalfSpectrum);
+
+    for (int i = 0; i < iNRows; ++i) {
+        // Substract mean
+        rowData.array() = inputData.matData.row(i).array() - inputData.matData.row(i).mean();
+
+        // Calculate tapered spectra
+        for(int j = 0; j < tapers.first.rows(); j++) {
+            // Zero padd if necessary. The zero padding in Eigen's FFT is only working for column vectors.
+            if (rowData.cols() < iNfft) {
+                vecInputFFT.setZero(iNfft);
+                vecInputFFT.block(0,0,1,rowData.cols()) = rowData.cwiseProduct(tapers.first.row(j));
+            } else {
+                vecInputFFT = rowData.cwiseProduct(tapers.first.row(j));
+            }
+
+            // FFT for freq domain returning the half spectrum and multiply taper weights
+            fft.fwd(vecTmpFreq, vecInputFFT, iNfft);
+            matTapSpectrum.row(j) = vecTmpFreq * tapers.second(j);
+        }
+
+        inputData.vecTapSpectra.append(matTapSpectrum);
+    }
+}
+
+
+//*************************************************************************************************************
+
+QVector<QPair<int,MatrixXcd> > AbstractMetric::computeCSD(const QVector<MatrixXcd>& vecTapSpectra,
+                                                          const VectorXd& vecTaperWeights,
+                                                          int iNFreqs,
+                                                          int iNfft)
+{
+    QVector<QPair<int,MatrixXcd> > vecPairCsd;
+
+    int iNRows = vecTapSpectra.size();
+
+    if(iNRows == 0) {
+        return vecPairCsd;
+    }
+
+    int iNTapers = vecTapSpectra.at(0).rows();
+    double denomCSD = vecTaperWeights.cwiseAbs2().sum() / 2.0;
+
+    vecPairCsd.reserve(iNRows);
+    for(int i = 0; i < iNRows; ++i) {
+        vecPairCsd.append(QPair<int,MatrixXcd>(i,MatrixXcd(iNRows, m_iNumberBinAmount)));
+    }
+
+    MatrixXcd matSpectra(iNRows, iNTapers);
+    MatrixXcd matCsd(iNRows, iNRows);
+
+    for(int f = 0; f < m_iNumberBinAmount; ++f) {
+        // Stack the tapered spectra of all rows for this frequency bin
+        for(int i = 0; i < iNRows; ++i) {
+            matSpectra.row(i) = vecTapSpectra.at(i).col(m_iNumberBinStart + f).transpose();
+        }
+
+        // Compute CSD for all pairs (sum over tapers). Only the upper triangle is written.
+        matCsd.setZero();
+        matCsd.selfadjointView<Upper>().rankUpdate(matSpectra, 1.0 / denomCSD);
+
+        // Divide first and last element by 2 due to half spectrum
+        if(m_iNumberBinStart + f == 0) {
+            matCsd /= 2.0;
+        }
+
+        if(iNfft % 2 == 0 && m_iNumberBinStart + f == iNFreqs - 1) {
+            matCsd /= 2.0;
+        }
+
+        // Fill in the lower triangle from the Hermitian symmetry
+        for(int i = 0; i < iNRows; ++i) {
+            vecPairCsd[i].second.col(f).head(i) = matCsd.col(i).head(i).conjugate();
+            vecPairCsd[i].second.col(f).tail(iNRows - i) = matCsd.row(i).tail(iNRows - i).transpose();
+        }
+    }
+
+    return vecPairCsd;
+}
@@ -42,6 +42,7 @@
 //=============================================================================================================
 
 #include "../connectivity_global.h"
+#include "../connectivitysettings.h"
 
 
 //*************************************************************************************************************
@@ -51,6 +52,7 @@
 
 #include <QSharedPointer>
 #include <QVector>
+#include <QPair>
 
 
 //*************************************************************************************************************
@@ -100,11 +102,42 @@ public:
      */
     explicit AbstractMetric();
 
+    //=========================================================================================================
+    /**
+     * Computes the tapered spectra of all rows of a trial, if they are not available already. The mean is substracted
+     * before tapering.
+     *
+     * @param[in, out] inputData     The trial data. The tapered spectra are stored in inputData.vecTapSpectra.
+     * @param[in] iNfft              The FFT length.
+     * @param[in] tapers             The tapers and their weights.
+     */
+    static void computeTapSpectra(ConnectivitySettings::IntermediateTrialData& inputData,
+                                  int iNfft,
+                                  const QPair<Eigen::MatrixXd, Eigen::VectorXd>& tapers);
+
     static bool     m_bStorageModeIsActive;
+    static bool     m_bTapSpectraCacheIsActive;     /**< Set by Connectivity::calculate while the tapered spectra are shared between metrics. */
     static int      m_iNumberBinStart;
     static int      m_iNumberBinAmount;
 
 protected:
+    //=========================================================================================================
+    /**
+     * Computes the cross spectral densities between all rows for the frequency bins set by m_iNumberBinStart and
+     * m_iNumberBinAmount. For every frequency bin the tapered spectra of all rows are stacked into one matrix and
+     * all pairs are computed with a single Hermitian rank update (S * S^H) instead of one product per row pair.
+     *
+     * @param[in] vecTapSpectra      The tapered spectra (tapers x frequencies) of all rows.
+     * @param[in] vecTaperWeights    The taper weights.
+     * @param[in] iNFreqs            The number of frequencies of the half spectrum.
+     * @param[in] iNfft              The FFT length.
+     *
+     * @return The CSDs. Entry i holds the CSDs between row i and all rows (rows x frequency bins).
+     */
+    static QVector<QPair<int,Eigen::MatrixXcd> > computeCSD(const QVector<Eigen::MatrixXcd>& vecTapSpectra,
+                                                           const Eigen::VectorXd& vecTaperWeights,
+                                                           int iNFreqs,
+                                                           int iNfft);
 
 };
 
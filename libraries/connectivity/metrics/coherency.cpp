@@ -122,6 +122,7 @@ void Coherency::calculateAbs(Network& finalNetwork,
     int iNFreqs = int(floor(iNfft / 2.0)) + 1;
 
     // Compute PSD/CSD for each trial
+    bool bStorageModeIsActive = AbstractMetric::m_bStorageModeIsActive || connectivitySettings.isStorageModeActive();
     QMutex mutex;
 
     std::function<void(ConnectivitySettings::IntermediateTrialData&)> computeLambda = [&](ConnectivitySettings::IntermediateTrialData& inputData) {
@@ -132,7 +133,8 @@ void Coherency::calculateAbs(Network& finalNetwork,
                 iNRows,
                 iNFreqs,
                 iNfft,
-                tapers);
+                tapers,
+                bStorageModeIsActive);
     };
 
 //    iTime = timer.elapsed();
@@ -147,10 +149,11 @@ void Coherency::calculateAbs(Network& finalNetwork,
 //    qWarning() << "ComputeSpectraPSDCSD" << iTime;
 //    timer.restart();
 
-    // Compute CSD/sqrt(PSD_X * PSD_Y)
+    // Compute CSD/sqrt(PSD_X * PSD_Y). The edges are written to the packed network weights without locking.
+    finalNetwork.initPackedWeights(m_iNumberBinAmount);
+
     std::function<void(QPair<int,MatrixXcd>&)> computePSDCSDLambda = [&](QPair<int,MatrixXcd>& pairInput) {
-        computePSDCSDAbs(mutex,
-                         finalNetwork,
+        computePSDCSDAbs(finalNetwork,
                          pairInput,
                          connectivitySettings.getIntermediateSumData().matPsdSum);
     };
@@ -159,6 +162,8 @@ void Coherency::calculateAbs(Network& finalNetwork,
                                                    computePSDCSDLambda);
     resultCSDPSD.waitForFinished();
 
+    finalNetwork.finalizePackedWeights();
+
 //    iTime = timer.elapsed();
 //    qWarning() << "Compute" << iTime;
 //    timer.restart();
@@ -194,6 +199,7 @@ void Coherency::calculateImag(Network& finalNetwork,
     int iNFreqs = int(floor(iNfft / 2.0)) + 1;
 
     // Compute PSD/CSD for each trial
+    bool bStorageModeIsActive = AbstractMetric::m_bStorageModeIsActive || connectivitySettings.isStorageModeActive();
     QMutex mutex;
 
     std::function<void(ConnectivitySettings::IntermediateTrialData&)> computeLambda = [&](ConnectivitySettings::IntermediateTrialData& inputData) {
@@ -204,7 +210,8 @@ void Coherency::calculateImag(Network& finalNetwork,
                 iNRows,
                 iNFreqs,
                 iNfft,
-                tapers);
+                tapers,
+                bStorageModeIsActive);
     };
 
 //    iTime = timer.elapsed();
@@ -219,10 +226,11 @@ void Coherency::calculateImag(Network& finalNetwork,
 //    qWarning() << "ComputeSpectraPSDCSD" << iTime;
 //    timer.restart();
 
-    // Compute CSD/sqrt(PSD_X * PSD_Y)
+    // Compute CSD/sqrt(PSD_X * PSD_Y). The edges are written to the packed network weights without locking.
+    finalNetwork.initPackedWeights(m_iNumberBinAmount);
+
     std::function<void(QPair<int,MatrixXcd>&)> computePSDCSDLambda = [&](QPair<int,MatrixXcd>& pairInput) {
-        computePSDCSDImag(mutex,
-                          finalNetwork,
+        computePSDCSDImag(finalNetwork,
                           pairInput,
                           connectivitySettings.getIntermediateSumData().matPsdSum);
     };
@@ -231,6 +239,8 @@ void Coherency::calculateImag(Network& finalNetwork,
                                                    computePSDCSDLambda);
     resultCSDPSD.waitForFinished();
 
+    finalNetwork.finalizePackedWeights();
+
 //    iTime = timer.elapsed();
 //    qWarning() << "Compute" << iTime;
 //    timer.restart();
@@ -246,86 +256,62 @@ void Coherency::compute(ConnectivitySettings::IntermediateTrialData& inputData,
                         int iNRows,
                         int iNFreqs,
                         int iNfft,
-                        const QPair<MatrixXd, VectorXd>& tapers)
+                        const QPair<MatrixXd, VectorXd>& tapers,
+                        bool bStorageModeIsActive)
 {
 //    QElapsedTimer timer;
 //    qint64 iTime = 0;
 //    timer.start();
 
-    if(inputData.vecPairCsd.size() == iNRows) {
-        //qDebug() << "Coherency::compute - vecPairCsd were already computed for this trial.";
+    // The CSD might have been computed by another metric already, the PSD is only computed by this one
+    if(inputData.vecPairCsd.size() == iNRows && inputData.matPsd.rows() == iNRows) {
+        //qDebug() << "Coherency::compute - vecPairCsd and matPsd were already computed for this trial.";
         return;
     }
 
     //qDebug() << "Coherency::compute - vecPairCsdSum and matPsdSum are computed for this trial.";
 
-    // Substract mean, compute tapered spectra and PSD
-    // This code was copied and changed modified Utils/Spectra since we do not want to call the function due to time loss.
-    bool bNfftEven = false;
-    if (iNfft % 2 == 0){
-        bNfftEven = true;
-    }
+    // Calculate tapered spectra if not available already
+    computeTapSpectra(inputData, iNfft, tapers);
 
-    FFT<double> fft;
-    fft.SetFlag(fft.HalfSpectrum);
+    int i,j;
 
-    double denomPSD = tapers.second.cwiseAbs2().sum() / 2.0;
+    // Compute PSD
+    if(inputData.matPsd.rows() != iNRows) {
+        bool bNfftEven = false;
+        if (iNfft % 2 == 0){
+            bNfftEven = true;
+        }
 
-    RowVectorXd vecInputFFT, rowData;
-    RowVectorXcd vecTmpFreq;
+        double denomPSD = tapers.second.cwiseAbs2().sum() / 2.0;
 
-    MatrixXcd matTapSpectrum(tapers.first.rows(), iNFreqs);
+        inputData.matPsd = MatrixXd(iNRows, m_iNumberBinAmount);
 
-    int i,j;
+        for (i = 0; i < iNRows; ++i) {
+            // Compute PSD (average over tapers if necessary).
+            inputData.matPsd.row(i) = inputData.vecTapSpectra.at(i).block(0,m_iNumberBinStart,inputData.vecTapSpectra.at(i).rows(),m_iNumberBinAmount).cwiseAbs2().colwise().sum() / denomPSD;
 
-    inputData.matPsd = MatrixXd(iNRows, m_iNumberBinAmount);
-
-    for (i = 0; i < iNRows; ++i) {
-        // Substract mean
-        rowData.array() = inputData.matData.row(i).array() - inputData.matData.row(i).mean();
-
-        // Calculate tapered spectra if not available already
-        if(inputData.vecTapSpectra.size() != iNRows) {
-            for(j = 0; j < tapers.first.rows(); j++) {
-                // Zero padd if necessary. The zero padding in Eigen's FFT is only working for column vectors.
-                if (rowData.cols() < iNfft) {
-                    vecInputFFT.setZero(iNfft);
-                    vecInputFFT.block(0,0,1,rowData.cols()) = rowData.cwiseProduct(tapers.first.row(j));;
-                } else {
-                    vecInputFFT = rowData.cwiseProduct(tapers.first.row(j));
-                }
-
-                // FFT for freq domain returning the half spectrum and multiply taper weights
-                fft.fwd(vecTmpFreq, vecInputFFT, iNfft);
-                matTapSpectrum.row(j) = vecTmpFreq * tapers.second(j);
+            // Divide first and last element by 2 due to half spectrum
+            if(m_iNumberBinStart == 0) {
+                inputData.matPsd.row(i)(0) /= 2.0;
             }
 
-            inputData.vecTapSpectra.append(matTapSpectrum);
+            if(bNfftEven && m_iNumberBinStart + m_iNumberBinAmount >= iNFreqs) {
+                inputData.matPsd.row(i).tail(1) /= 2.0;
+            }
         }
 
-        // Compute PSD (average over tapers if necessary).
-        inputData.matPsd.row(i) = inputData.vecTapSpectra.at(i).block(0,m_iNumberBinStart,inputData.vecTapSpectra.at(i).rows(),m_iNumberBinAmount).cwiseAbs2().colwise().sum() / denomPSD;
-
-        // Divide first and last element by 2 due to half spectrum
-        if(m_iNumberBinStart == 0) {
-            inputData.matPsd.row(i)(0) /= 2.0;
-        }
+        mutex.lock();
 
-        if(bNfftEven && m_iNumberBinStart + m_iNumberBinAmount >= iNFreqs) {
-            inputData.matPsd.row(i).tail(1) /= 2.0;
+        if(matPsdSum.rows() == 0 || matPsdSum.cols() == 0) {
+            matPsdSum = inputData.matPsd;
+        } else {
+            matPsdSum += inputData.matPsd;
         }
-    }
-
-    mutex.lock();
 
-    if(matPsdSum.rows() == 0 || matPsdSum.cols() == 0) {
-        matPsdSum = inputData.matPsd;
-    } else {
-        matPsdSum += inputData.matPsd;
+        mutex.unlock();
     }
 
-    mutex.unlock();
-
 //    iTime = timer.elapsed();
 //    qWarning() << QThread::currentThreadId() << "Coherency::compute timer - compute - Tapered spectra and PSD (summing):" << iTime;
 //    timer.restart();
@@ -334,28 +320,7 @@ void Coherency::compute(ConnectivitySettings::IntermediateTrialData& inputData,
     if(inputData.vecPairCsd.size() != iNRows) {
         inputData.vecPairCsd.clear();
 
-        //MatrixXcd matCsd = MatrixXcd(iNRows, iNFreqs);
-        MatrixXcd matCsd = MatrixXcd(iNRows, m_iNumberBinAmount);
-
-        double denomCSD = sqrt(tapers.second.cwiseAbs2().sum()) * sqrt(tapers.second.cwiseAbs2().sum()) / 2.0;
-
-        for (i = 0; i < iNRows; ++i) {
-            for (j = i; j < iNRows; ++j) {
-                // Compute CSD (average over tapers if necessary)
-                matCsd.row(j) = inputData.vecTapSpectra.at(i).block(0,m_iNumberBinStart,inputData.vecTapSpectra.at(i).rows(),m_iNumberBinAmount).cwiseProduct(inputData.vecTapSpectra.at(j).block(0,m_iNumberBinStart,inputData.vecTapSpectra.at(j).rows(),m_iNumberBinAmount).conjugate()).colwise().sum() / denomCSD;
-
-                // Divide first and last element by 2 due to half spectrum
-                if(m_iNumberBinStart == 0) {
-                    matCsd.row(j)(0) /= 2.0;
-                }
-
-                if(bNfftEven && m_iNumberBinStart + m_iNumberBinAmount >= iNFreqs) {
-                    matCsd.row(j).tail(1) /= 2.0;
-                }
-            }
-
-            inputData.vecPairCsd.append(QPair<int,MatrixXcd>(i,matCsd));
-        }
+        inputData.vecPairCsd = computeCSD(inputData.vecTapSpectra, tapers.second, iNFreqs, iNfft);
 
         mutex.lock();
 
@@ -375,9 +340,11 @@ void Coherency::compute(ConnectivitySettings::IntermediateTrialData& inputData,
 //    timer.restart();
 
     //Do not store data to save memory
-    if(!m_bStorageModeIsActive) {
+    if(!bStorageModeIsActive) {
         inputData.vecPairCsd.clear();
-        inputData.vecTapSpectra.clear();
+        if(!m_bTapSpectraCacheIsActive) {
+            inputData.vecTapSpectra.clear();
+        }
     }
 
 //    iTime = timer.elapsed();
@@ -388,8 +355,7 @@ void Coherency::compute(ConnectivitySettings::IntermediateTrialData& inputData,
 
 //*************************************************************************************************************
 
-void Coherency::computePSDCSDAbs(QMutex& mutex,
-                                 Network& finalNetwork,
+void Coherency::computePSDCSDAbs(Network& finalNetwork,
                                  const QPair<int,MatrixXcd>& pairInput,
                                  const MatrixXd& matPsdSum)
 {
@@ -403,28 +369,20 @@ void Coherency::computePSDCSDAbs(QMutex& mutex,
     // Average. Note that the number of trials cancel each other out.
     MatrixXcd matCohy = pairInput.second.cwiseQuotient(matPSDtmp.cwiseSqrt());
 
-    QSharedPointer<NetworkEdge> pEdge;
     MatrixXd matWeight;
     int j;
     int i = pairInput.first;
 
     for(j = i; j < matCohy.rows(); ++j) {
         matWeight = matCohy.row(j).cwiseAbs().transpose();
-        pEdge = QSharedPointer<NetworkEdge>(new NetworkEdge(i, j, matWeight));
-
-        mutex.lock();
-        finalNetwork.getNodeAt(i)->append(pEdge);
-        finalNetwork.getNodeAt(j)->append(pEdge);
-        finalNetwork.append(pEdge);
-        mutex.unlock();
+        finalNetwork.setPackedWeights(i, j, matWeight);
     }
 }
 
 
 //*************************************************************************************************************
 
-void Coherency::computePSDCSDImag(QMutex& mutex,
-                                  Network& finalNetwork,
+void Coherency::computePSDCSDImag(Network& finalNetwork,
                                   const QPair<int,MatrixXcd>& pairInput,
                                   const MatrixXd& matPsdSum)
 {
@@ -437,19 +395,12 @@ void Coherency::computePSDCSDImag(QMutex& mutex,
 
     MatrixXcd matCohy = pairInput.second.cwiseQuotient(matPSDtmp.cwiseSqrt());
 
-    QSharedPointer<NetworkEdge> pEdge;
     MatrixXd matWeight;
     int j;
     int i = pairInput.first;
 
     for(j = i; j < matCohy.rows(); ++j) {
         matWeight = matCohy.row(j).imag().transpose();
-        pEdge = QSharedPointer<NetworkEdge>(new NetworkEdge(i, j, matWeight));
-
-        mutex.lock();
-        finalNetwork.getNodeAt(i)->append(pEdge);
-        finalNetwork.getNodeAt(j)->append(pEdge);
-        finalNetwork.append(pEdge);
-        mutex.unlock();
+        finalNetwork.setPackedWeights(i, j, matWeight);
     }
 }
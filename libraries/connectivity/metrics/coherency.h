@@ -142,6 +142,7 @@ private:
      * @param[in]    iNFreqs             The number of frequenciy bins.
      * @param[in]    iNfft               The FFT length.
      * @param[in]    tapers              The taper information.
+     * @param[in]    bStorageModeIsActive Whether to keep the intermediate data of this trial.
      */
     static void compute(ConnectivitySettings::IntermediateTrialData& inputData,
                         Eigen::MatrixXd& matPsdSum,
@@ -150,18 +151,17 @@ private:
                         int iNRows,
                         int iNFreqs,
                         int iNfft,
-                        const QPair<Eigen::MatrixXd, Eigen::VectorXd>& tapers);
+                        const QPair<Eigen::MatrixXd, Eigen::VectorXd>& tapers,
+                        bool bStorageModeIsActive);
 
     //=========================================================================================================
     /**
-     * Computes the PSD and CSD. This function gets called in parallel.
+     * Computes the PSD and CSD. This function gets called in parallel and writes to the packed weights of the network.
      */
-    static void computePSDCSDAbs(QMutex& mutex,
-                                 Network& finalNetwork,
+    static void computePSDCSDAbs(Network& finalNetwork,
                                  const QPair<int,Eigen::MatrixXcd>& pairInput,
                                  const Eigen::MatrixXd& matPsdSum);
-    static void computePSDCSDImag(QMutex& mutex,
-                                  Network& finalNetwork,
+    static void computePSDCSDImag(Network& finalNetwork,
                                   const QPair<int,Eigen::MatrixXcd>& pairInput,
                                   const Eigen::MatrixXd& matPsdSum);
 };
@@ -108,8 +108,10 @@ Network CrossCorrelation::calculate(ConnectivitySettings& connectivitySettings)
         return finalNetwork;
     }
 
-    if(AbstractMetric::m_bStorageModeIsActive == false) {
-        connectivitySettings.clearIntermediateData();
+    bool bStorageModeIsActive = AbstractMetric::m_bStorageModeIsActive || connectivitySettings.isStorageModeActive();
+
+    if(!bStorageModeIsActive) {
+        connectivitySettings.clearIntermediateData(AbstractMetric::m_bTapSpectraCacheIsActive);
     }
 
     finalNetwork.setSamplingFrequency(connectivitySettings.getSamplingFrequency());
@@ -145,7 +147,8 @@ Network CrossCorrelation::calculate(ConnectivitySettings& connectivitySettings)
                 matDist,
                 mutex,
                 iNfft,
-                tapers);
+                tapers,
+                bStorageModeIsActive);
     };
 
 //    iTime = timer.elapsed();
@@ -194,14 +197,14 @@ void CrossCorrelation::compute(ConnectivitySettings::IntermediateTrialData& inpu
                                MatrixXd& matDist,
                                QMutex& mutex,
                                int iNfft,
-                               const QPair<MatrixXd, VectorXd>& tapers)
+                               const QPair<MatrixXd, VectorXd>& tapers,
+                               bool bStorageModeIsActive)
 {
 //    QElapsedTimer timer;
 //    qint64 iTime = 0;
 //    timer.start();
 
-    // Calculate tapered spectra if not available already
-    RowVectorXd vecInputFFT, rowData;
+    RowVectorXd vecInputFFT;
     RowVectorXcd vecResultFreq;
 
     FFT<double> fft;
@@ -211,33 +214,7 @@ void CrossCorrelation::compute(ConnectivitySettings::IntermediateTrialData& inpu
     int iNRows = inputData.matData.rows();
 
     // Calculate tapered spectra if not available already
-    // This code was copied and changed modified Utils/Spectra since we do not want to call the function due to time loss.
-    if(inputData.vecTapSpectra.isEmpty()) {
-        int iNFreqs = int(floor(iNfft / 2.0)) + 1;
-        MatrixXcd matTapSpectrum(tapers.first.rows(), iNFreqs);
-
-        for (i = 0; i < iNRows; ++i) {
-            // Substract mean
-            rowData.array() = inputData.matData.row(i).array() - inputData.matData.row(i).mean();
-
-            // Calculate tapered spectra
-            for(j = 0; j < tapers.first.rows(); j++) {
-                // Zero padd if necessary. The zero padding in Eigen's FFT is only working for column vectors.
-                if (rowData.cols() < iNfft) {
-                    vecInputFFT.setZero(iNfft);
-                    vecInputFFT.block(0,0,1,rowData.cols()) = rowData.cwiseProduct(tapers.first.row(j));;
-                } else {
-                    vecInputFFT = rowData.cwiseProduct(tapers.first.row(j));
-                }
-
-                // FFT for freq domain returning the half spectrum and multiply taper weights
-                fft.fwd(vecResultFreq, vecInputFFT, iNfft);
-                matTapSpectrum.row(j) = vecResultFreq * tapers.second(j);
-            }
-
-            inputData.vecTapSpectra.append(matTapSpectrum);
-        }
-    }
+    computeTapSpectra(inputData, iNfft, tapers);
 
 //    iTime = timer.elapsed();
 //    qDebug() << QThread::currentThreadId() << "CrossCorrelation::compute timer - Tapered spectra:" << iTime;
@@ -284,7 +261,7 @@ void CrossCorrelation::compute(ConnectivitySettings::IntermediateTrialData& inpu
 //    qDebug() << QThread::currentThreadId() << "CrossCorrelation::compute timer - Summing up matDist:" << iTime;
 //    timer.restart();
 
-    if(!m_bStorageModeIsActive) {
+    if(!bStorageModeIsActive && !m_bTapSpectraCacheIsActive) {
         inputData.vecTapSpectra.clear();
     }
 }
@@ -125,12 +125,14 @@ protected:
      * @param[in]    mutex               The mutex used to safely access matDist.
      * @param[in]    iNfft               The FFT length.
      * @param[in]    tapers              The taper information.
+     * @param[in]    bStorageModeIsActive Whether to keep the intermediate data of this trial.
      */
     static void compute(ConnectivitySettings::IntermediateTrialData& inputData,
                         Eigen::MatrixXd& matDist,
                         QMutex& mutex,
                         int iNfft,
-                        const QPair<Eigen::MatrixXd, Eigen::VectorXd>& tapers);
+                        const QPair<Eigen::MatrixXd, Eigen::VectorXd>& tapers,
+                        bool bStorageModeIsActive);
 
 };
 
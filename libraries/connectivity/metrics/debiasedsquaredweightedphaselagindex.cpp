@@ -108,8 +108,10 @@ Network DebiasedSquaredWeightedPhaseLagIndex::calculate(ConnectivitySettings& co
         return finalNetwork;
     }
 
-    if(AbstractMetric::m_bStorageModeIsActive == false) {
-        connectivitySettings.clearIntermediateData();
+    bool bStorageModeIsActive = AbstractMetric::m_bStorageModeIsActive || connectivitySettings.isStorageModeActive();
+
+    if(!bStorageModeIsActive) {
+        connectivitySettings.clearIntermediateData(AbstractMetric::m_bTapSpectraCacheIsActive);
     }
 
     finalNetwork.setSamplingFrequency(connectivitySettings.getSamplingFrequency());
@@ -171,7 +173,8 @@ Network DebiasedSquaredWeightedPhaseLagIndex::calculate(ConnectivitySettings& co
                        iNRows,
                        iNFreqs,
                        iNfft,
-                       tapers);
+                       tapers,
+                       bStorageModeIsActive);
     };
 
 //    iTime = timer.elapsed();
@@ -209,7 +212,8 @@ void DebiasedSquaredWeightedPhaseLagIndex::compute(ConnectivitySettings::Interme
                                                    int iNRows,
                                                    int iNFreqs,
                                                    int iNfft,
-                                                   const QPair<MatrixXd, VectorXd>& tapers)
+                                                   const QPair<MatrixXd, VectorXd>& tapers,
+                                                   bool bStorageModeIsActive)
 {
     if(inputData.vecPairCsd.size() == iNRows &&
        inputData.vecPairCsdImagSqrd.size() == iNRows &&
@@ -218,71 +222,18 @@ void DebiasedSquaredWeightedPhaseLagIndex::compute(ConnectivitySettings::Interme
         return;
     }
 
-    int i,j;
+    int i;
 
     // Calculate tapered spectra if not available already
-    // This code was copied and changed modified Utils/Spectra since we do not want to call the function due to time loss.
-    if(inputData.vecTapSpectra.isEmpty()) {
-        RowVectorXd vecInputFFT, rowData;
-        RowVectorXcd vecTmpFreq;
-
-        MatrixXcd matTapSpectrum(tapers.first.rows(), iNFreqs);
-
-        FFT<double> fft;
-        fft.SetFlag(fft.HalfSpectrum);
-
-        for (i = 0; i < iNRows; ++i) {
-            // Substract mean
-            rowData.array() = inputData.matData.row(i).array() - inputData.matData.row(i).mean();
-
-            // Calculate tapered spectra if not available already
-            for(j = 0; j < tapers.first.rows(); j++) {
-                // Zero padd if necessary. The zero padding in Eigen's FFT is only working for column vectors.
-                if (rowData.cols() < iNfft) {
-                    vecInputFFT.setZero(iNfft);
-                    vecInputFFT.block(0,0,1,rowData.cols()) = rowData.cwiseProduct(tapers.first.row(j));;
-                } else {
-                    vecInputFFT = rowData.cwiseProduct(tapers.first.row(j));
-                }
-
-                // FFT for freq domain returning the half spectrum and multiply taper weights
-                fft.fwd(vecTmpFreq, vecInputFFT, iNfft);
-                matTapSpectrum.row(j) = vecTmpFreq * tapers.second(j);
-            }
-
-            inputData.vecTapSpectra.append(matTapSpectrum);
-        }
-    }
+    computeTapSpectra(inputData, iNfft, tapers);
 
     // Compute CSD
     if(inputData.vecPairCsd.isEmpty()) {
-        MatrixXcd matCsd(iNRows, m_iNumberBinAmount);
-
-        bool bNfftEven = false;
-        if (iNfft % 2 == 0){
-            bNfftEven = true;
-        }
-
-        double denomCSD = sqrt(tapers.second.cwiseAbs2().sum()) * sqrt(tapers.second.cwiseAbs2().sum()) / 2.0;
+        inputData.vecPairCsd = computeCSD(inputData.vecTapSpectra, tapers.second, iNFreqs, iNfft);
 
         for (i = 0; i < iNRows; ++i) {
-            for (j = i; j < iNRows; ++j) {
-                // Compute CSD (average over tapers if necessary)
-                matCsd.row(j) = inputData.vecTapSpectra.at(i).block(0,m_iNumberBinStart,inputData.vecTapSpectra.at(i).rows(),m_iNumberBinAmount).cwiseProduct(inputData.vecTapSpectra.at(j).block(0,m_iNumberBinStart,inputData.vecTapSpectra.at(j).rows(),m_iNumberBinAmount).conjugate()).colwise().sum() / denomCSD;
-
-                // Divide first and last element by 2 due to half spectrum
-                if(m_iNumberBinStart == 0) {
-                    matCsd.row(j)(0) /= 2.0;
-                }
-
-                if(bNfftEven && m_iNumberBinStart + m_iNumberBinAmount >= iNFreqs) {
-                    matCsd.row(j).tail(1) /= 2.0;
-                }
-            }
-
-            inputData.vecPairCsd.append(QPair<int,MatrixXcd>(i,matCsd));
-            inputData.vecPairCsdImagSqrd.append(QPair<int,MatrixXd>(i,matCsd.imag().array().square()));
-            inputData.vecPairCsdImagAbs.append(QPair<int,MatrixXd>(i,matCsd.imag().cwiseAbs()));
+            inputData.vecPairCsdImagSqrd.append(QPair<int,MatrixXd>(i,inputData.vecPairCsd.at(i).second.imag().array().square()));
+            inputData.vecPairCsdImagAbs.append(QPair<int,MatrixXd>(i,inputData.vecPairCsd.at(i).second.imag().cwiseAbs()));
         }
 
         mutex.lock();
@@ -338,9 +289,11 @@ void DebiasedSquaredWeightedPhaseLagIndex::compute(ConnectivitySettings::Interme
         }
     }
 
-    if(!m_bStorageModeIsActive) {
+    if(!bStorageModeIsActive) {
         inputData.vecPairCsd.clear();
-        inputData.vecTapSpectra.clear();
+        if(!m_bTapSpectraCacheIsActive) {
+            inputData.vecTapSpectra.clear();
+        }
         inputData.vecPairCsdImagAbs.clear();
         inputData.vecPairCsdImagSqrd.clear();
     }
@@ -355,9 +308,10 @@ void DebiasedSquaredWeightedPhaseLagIndex::computeDSWPLI(ConnectivitySettings &c
     // Compute final DSWPLI and create Network
     MatrixXd matNom, matDenom;
     MatrixXd matWeight;
-    QSharedPointer<NetworkEdge> pEdge;
     int j;
 
+    finalNetwork.initPackedWeights(m_iNumberBinAmount);
+
     for (int i = 0; i < connectivitySettings.at(0).matData.rows(); ++i) {
 
         matNom = connectivitySettings.getIntermediateSumData().vecPairCsdSum.at(i).second.imag().array().square();
@@ -371,15 +325,12 @@ void DebiasedSquaredWeightedPhaseLagIndex::computeDSWPLI(ConnectivitySettings &c
 
         for(j = i; j < connectivitySettings.at(0).matData.rows(); ++j) {
             matWeight = matDenom.row(j).transpose();
-
-            pEdge = QSharedPointer<NetworkEdge>(new NetworkEdge(i, j, matWeight));
-
-            finalNetwork.getNodeAt(i)->append(pEdge);
-            finalNetwork.getNodeAt(j)->append(pEdge);
-            finalNetwork.append(pEdge);
+            finalNetwork.setPackedWeights(i, j, matWeight);
         }
 
     }
+
+    finalNetwork.finalizePackedWeights();
 }
 
 
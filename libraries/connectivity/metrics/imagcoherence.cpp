@@ -101,8 +101,8 @@ Network ImagCoherence::calculate(ConnectivitySettings& connectivitySettings)
         return finalNetwork;
     }
 
-    if(AbstractMetric::m_bStorageModeIsActive == false) {
-        connectivitySettings.clearIntermediateData();
+    if(!AbstractMetric::m_bStorageModeIsActive && !connectivitySettings.isStorageModeActive()) {
+        connectivitySettings.clearIntermediateData(AbstractMetric::m_bTapSpectraCacheIsActive);
     }
 
     finalNetwork.setSamplingFrequency(connectivitySettings.getSamplingFrequency());
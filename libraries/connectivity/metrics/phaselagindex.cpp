@@ -108,8 +108,10 @@ Network PhaseLagIndex::calculate(ConnectivitySettings& connectivitySettings)
         return finalNetwork;
     }
 
-    if(AbstractMetric::m_bStorageModeIsActive == false) {
-        connectivitySettings.clearIntermediateData();
+    bool bStorageModeIsActive = AbstractMetric::m_bStorageModeIsActive || connectivitySettings.isStorageModeActive();
+
+    if(!bStorageModeIsActive) {
+        connectivitySettings.clearIntermediateData(AbstractMetric::m_bTapSpectraCacheIsActive);
     }
 
     finalNetwork.setSamplingFrequency(connectivitySettings.getSamplingFrequency());
@@ -168,7 +170,8 @@ Network PhaseLagIndex::calculate(ConnectivitySettings& connectivitySettings)
                 iNRows,
                 iNFreqs,
                 iNfft,
-                tapers);
+                tapers,
+                bStorageModeIsActive);
     };
 
 //    iTime = timer.elapsed();
@@ -205,77 +208,25 @@ void PhaseLagIndex::compute(ConnectivitySettings::IntermediateTrialData& inputDa
                             int iNRows,
                             int iNFreqs,
                             int iNfft,
-                            const QPair<MatrixXd, VectorXd>& tapers)
+                            const QPair<MatrixXd, VectorXd>& tapers,
+                            bool bStorageModeIsActive)
 {
     if(inputData.vecPairCsdImagSign.size() == iNRows) {
         //qDebug() << "PhaseLagIndex::compute - vecPairCsdImagSign was already computed for this trial.";
         return;
     }
 
-    int i,j;
+    int i;
 
     // Calculate tapered spectra if not available already
-    // This code was copied and changed modified Utils/Spectra since we do not want to call the function due to time loss.
-    if(inputData.vecTapSpectra.isEmpty()) {
-        RowVectorXd vecInputFFT, rowData;
-        RowVectorXcd vecTmpFreq;
-
-        MatrixXcd matTapSpectrum(tapers.first.rows(), iNFreqs);
-
-        FFT<double> fft;
-        fft.SetFlag(fft.HalfSpectrum);
-
-        for (i = 0; i < iNRows; ++i) {
-            // Substract mean
-            rowData.array() = inputData.matData.row(i).array() - inputData.matData.row(i).mean();
-
-            // Calculate tapered spectra
-            for(j = 0; j < tapers.first.rows(); j++) {
-                // Zero padd if necessary. The zero padding in Eigen's FFT is only working for column vectors.
-                if (rowData.cols() < iNfft) {
-                    vecInputFFT.setZero(iNfft);
-                    vecInputFFT.block(0,0,1,rowData.cols()) = rowData.cwiseProduct(tapers.first.row(j));;
-                } else {
-                    vecInputFFT = rowData.cwiseProduct(tapers.first.row(j));
-                }
-
-                // FFT for freq domain returning the half spectrum and multiply taper weights
-                fft.fwd(vecTmpFreq, vecInputFFT, iNfft);
-                matTapSpectrum.row(j) = vecTmpFreq * tapers.second(j);
-            }
-
-            inputData.vecTapSpectra.append(matTapSpectrum);
-        }
-    }
+    computeTapSpectra(inputData, iNfft, tapers);
 
     // Compute CSD
     if(inputData.vecPairCsd.isEmpty()) {
-        MatrixXcd matCsd = MatrixXcd(iNRows, m_iNumberBinAmount);
-
-        double denomCSD = sqrt(tapers.second.cwiseAbs2().sum()) * sqrt(tapers.second.cwiseAbs2().sum()) / 2.0;
-
-        bool bNfftEven = false;
-        if (iNfft % 2 == 0){
-            bNfftEven = true;
-        }
+        inputData.vecPairCsd = computeCSD(inputData.vecTapSpectra, tapers.second, iNFreqs, iNfft);
 
         for (i = 0; i < iNRows; ++i) {
-            for (j = i; j < iNRows; ++j) {
-                // Compute CSD (average over tapers if necessary)
-                matCsd.row(j) = inputData.vecTapSpectra.at(i).block(0,m_iNumberBinStart,inputData.vecTapSpectra.at(i).rows(),m_iNumberBinAmount).cwiseProduct(inputData.vecTapSpectra.at(j).block(0,m_iNumberBinStart,inputData.vecTapSpectra.at(j).rows(),m_iNumberBinAmount).conjugate()).colwise().sum() / denomCSD;
-
-                // Divide first and last element by 2 due to half spectrum
-                if(m_iNumberBinStart == 0) {
-                    matCsd.row(j)(0) /= 2.0;
-                }
-
-                if(bNfftEven && m_iNumberBinStart + m_iNumberBinAmount >= iNFreqs) {
-                    matCsd.row(j).tail(1) /= 2.0;
-                }
-            }
-
-            inputData.vecPairCsd.append(QPair<int,MatrixXcd>(i,matCsd));
-            inputData.vecPairCsdImagSign.append(QPair<int,MatrixXd>(i,matCsd.imag().cwiseSign()));
+            inputData.vecPairCsdImagSign.append(QPair<int,MatrixXd>(i,inputData.vecPairCsd.at(i).second.imag().cwiseSign()));
         }
 
         mutex.lock();
@@ -311,9 +262,11 @@ void PhaseLagIndex::compute(ConnectivitySettings::IntermediateTrialData& inputDa
         }
     }
 
-    if(!m_bStorageModeIsActive) {
+    if(!bStorageModeIsActive) {
         inputData.vecPairCsd.clear();
-        inputData.vecTapSpectra.clear();
+        if(!m_bTapSpectraCacheIsActive) {
+            inputData.vecTapSpectra.clear();
+        }
         inputData.vecPairCsdImagSign.clear();
     }
 }
@@ -327,21 +280,19 @@ void PhaseLagIndex::computePLI(ConnectivitySettings &connectivitySettings,
     // Compute final PLI and create Network
     MatrixXd matNom;
     MatrixXd matWeight;
-    QSharedPointer<NetworkEdge> pEdge;
     int j;
 
+    finalNetwork.initPackedWeights(m_iNumberBinAmount);
+
     for (int i = 0; i < connectivitySettings.getIntermediateSumData().vecPairCsdImagSignSum.size(); ++i) {
         matNom = connectivitySettings.getIntermediateSumData().vecPairCsdImagSignSum.at(i).second.cwiseAbs() / connectivitySettings.size();
 
         for(j = i; j < matNom.rows(); ++j) {
             matWeight = matNom.row(j).transpose();
-
-            pEdge = QSharedPointer<NetworkEdge>(new NetworkEdge(i, j, matWeight));
-
-            finalNetwork.getNodeAt(i)->append(pEdge);
-            finalNetwork.getNodeAt(j)->append(pEdge);
-            finalNetwork.append(pEdge);
+            finalNetwork.setPackedWeights(i, j, matWeight);
         }
     }
+
+    finalNetwork.finalizePackedWeights();
 }
 
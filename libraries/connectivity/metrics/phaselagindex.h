@@ -132,6 +132,7 @@ protected:
      * @param[in] iNFreqs                The number of frequenciy bins.
      * @param[in] iNfft                  The FFT length.
      * @param[in] tapers                 The taper information.
+     * @param[in] bStorageModeIsActive   Whether to keep the intermediate data of this trial.
      */
     static void compute(ConnectivitySettings::IntermediateTrialData& inputData,
                         QVector<QPair<int,Eigen::MatrixXcd> >& vecPairCsdSum,
@@ -140,7 +141,8 @@ protected:
                         int iNRows,
                         int iNFreqs,
                         int iNfft,
-                        const QPair<Eigen::MatrixXd, Eigen::VectorXd>& tapers);
+                        const QPair<Eigen::MatrixXd, Eigen::VectorXd>& tapers,
+                        bool bStorageModeIsActive);
 
     //=========================================================================================================
     /**
@@ -108,8 +108,10 @@ Network PhaseLockingValue::calculate(ConnectivitySettings& connectivitySettings)
         return finalNetwork;
     }
 
-    if(AbstractMetric::m_bStorageModeIsActive == false) {
-        connectivitySettings.clearIntermediateData();
+    bool bStorageModeIsActive = AbstractMetric::m_bStorageModeIsActive || connectivitySettings.isStorageModeActive();
+
+    if(!bStorageModeIsActive) {
+        connectivitySettings.clearIntermediateData(AbstractMetric::m_bTapSpectraCacheIsActive);
     }
 
     finalNetwork.setSamplingFrequency(connectivitySettings.getSamplingFrequency());
@@ -169,7 +171,8 @@ Network PhaseLockingValue::calculate(ConnectivitySettings& connectivitySettings)
                 iNRows,
                 iNFreqs,
                 iNfft,
-                tapers);
+                tapers,
+                bStorageModeIsActive);
     };
 
 //    iTime = timer.elapsed();
@@ -206,77 +209,25 @@ void PhaseLockingValue::compute(ConnectivitySettings::IntermediateTrialData& inp
                                 int iNRows,
                                 int iNFreqs,
                                 int iNfft,
-                                const QPair<MatrixXd, VectorXd>& tapers)
+                                const QPair<MatrixXd, VectorXd>& tapers,
+                                bool bStorageModeIsActive)
 {
     if(inputData.vecPairCsdNormalized.size() == iNRows) {
         //qDebug() << "PhaseLockingValue::compute - vecPairCsdNormalized was already computed for this trial.";
         return;
     }
 
-    int i,j;
+    int i;
 
     // Calculate tapered spectra if not available already
-    // This code was copied and changed modified Utils/Spectra since we do not want to call the function due to time loss.
-    if(inputData.vecTapSpectra.isEmpty()) {
-        RowVectorXd vecInputFFT, rowData;
-        RowVectorXcd vecTmpFreq;
-
-        MatrixXcd matTapSpectrum(tapers.first.rows(), iNFreqs);
-
-        FFT<double> fft;
-        fft.SetFlag(fft.HalfSpectrum);
-
-        for (i = 0; i < iNRows; ++i) {
-            // Substract mean
-            rowData.array() = inputData.matData.row(i).array() - inputData.matData.row(i).mean();
-
-            // Calculate tapered spectra if not available already
-            for(j = 0; j < tapers.first.rows(); j++) {
-                // Zero padd if necessary. The zero padding in Eigen's FFT is only working for column vectors.
-                if (rowData.cols() < iNfft) {
-                    vecInputFFT.setZero(iNfft);
-                    vecInputFFT.block(0,0,1,rowData.cols()) = rowData.cwiseProduct(tapers.first.row(j));;
-                } else {
-                    vecInputFFT = rowData.cwiseProduct(tapers.first.row(j));
-                }
-
-                // FFT for freq domain returning the half spectrum and multiply taper weights
-                fft.fwd(vecTmpFreq, vecInputFFT, iNfft);
-                matTapSpectrum.row(j) = vecTmpFreq * tapers.second(j);
-            }
-
-            inputData.vecTapSpectra.append(matTapSpectrum);
-        }
-    }
+    computeTapSpectra(inputData, iNfft, tapers);
 
     // Compute CSD
     if(inputData.vecPairCsd.isEmpty()) {
-        MatrixXcd matCsd = MatrixXcd(iNRows, m_iNumberBinAmount);
-
-        bool bNfftEven = false;
-        if (iNfft % 2 == 0){
-            bNfftEven = true;
-        }
-
-        double denomCSD = sqrt(tapers.second.cwiseAbs2().sum()) * sqrt(tapers.second.cwiseAbs2().sum()) / 2.0;
+        inputData.vecPairCsd = computeCSD(inputData.vecTapSpectra, tapers.second, iNFreqs, iNfft);
 
         for (i = 0; i < iNRows; ++i) {
-            for (j = i; j < iNRows; ++j) {
-                // Compute CSD (average over tapers if necessary)
-                matCsd.row(j) = inputData.vecTapSpectra.at(i).block(0,m_iNumberBinStart,inputData.vecTapSpectra.at(i).rows(),m_iNumberBinAmount).cwiseProduct(inputData.vecTapSpectra.at(j).block(0,m_iNumberBinStart,inputData.vecTapSpectra.at(j).rows(),m_iNumberBinAmount).conjugate()).colwise().sum() / denomCSD;
-
-                // Divide first and last element by 2 due to half spectrum
-                if(m_iNumberBinStart == 0) {
-                    matCsd.row(j)(0) /= 2.0;
-                }
-
-                if(bNfftEven && m_iNumberBinStart + m_iNumberBinAmount >= iNFreqs) {
-                    matCsd.row(j).tail(1) /= 2.0;
-                }
-            }
-
-            inputData.vecPairCsd.append(QPair<int,MatrixXcd>(i,matCsd));
-            inputData.vecPairCsdNormalized.append(QPair<int,MatrixXcd>(i,matCsd.cwiseQuotient(matCsd.cwiseAbs())));
+            inputData.vecPairCsdNormalized.append(QPair<int,MatrixXcd>(i,inputData.vecPairCsd.at(i).second.cwiseQuotient(inputData.vecPairCsd.at(i).second.cwiseAbs())));
         }
 
         mutex.lock();
@@ -312,9 +263,11 @@ void PhaseLockingValue::compute(ConnectivitySettings::IntermediateTrialData& inp
         }
     }
 
-    if(!m_bStorageModeIsActive) {
+    if(!bStorageModeIsActive) {
         inputData.vecPairCsd.clear();
-        inputData.vecTapSpectra.clear();
+        if(!m_bTapSpectraCacheIsActive) {
+            inputData.vecTapSpectra.clear();
+        }
         inputData.vecPairCsdNormalized.clear();
     }
 }
@@ -328,20 +281,18 @@ void PhaseLockingValue::computePLV(ConnectivitySettings &connectivitySettings,
     // Compute final PLV and create Network
     MatrixXd matNom;
     MatrixXd matWeight;
-    QSharedPointer<NetworkEdge> pEdge;
     int j;
 
+    finalNetwork.initPackedWeights(m_iNumberBinAmount);
+
     for (int i = 0; i < connectivitySettings.at(0).matData.rows(); ++i) {
         matNom = connectivitySettings.getIntermediateSumData().vecPairCsdNormalizedSum.at(i).second.cwiseAbs() / connectivitySettings.size();
 
         for(j = i; j < connectivitySettings.at(0).matData.rows(); ++j) {
             matWeight = matNom.row(j).transpose();
-
-            pEdge = QSharedPointer<NetworkEdge>(new NetworkEdge(i, j, matWeight));
-
-            finalNetwork.getNodeAt(i)->append(pEdge);
-            finalNetwork.getNodeAt(j)->append(pEdge);
-            finalNetwork.append(pEdge);
+            finalNetwork.setPackedWeights(i, j, matWeight);
         }
     }
+
+    finalNetwork.finalizePackedWeights();
 }
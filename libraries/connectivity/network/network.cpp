@@ -93,6 +93,10 @@ Network::Network(const QString& sConnectivityMethod,
 , m_fSFreq(0.0f)
 , m_iFFTSize(128)
 , m_iNumberFreqBins(0)
+, m_bEdgeViewsCreated(false)
+, m_bPacked(false)
+, m_pMatPackedWeights(QSharedPointer<MatrixXd>::create())
+, m_iMinMaxFreqBins(QPair<int,int>(-1,-1))
 {
     qRegisterMetaType<CONNECTIVITYLIB::Network>("CONNECTIVITYLIB::Network");
     qRegisterMetaType<CONNECTIVITYLIB::Network::SPtr>("CONNECTIVITYLIB::Network::SPtr");
@@ -108,6 +112,25 @@ MatrixXd Network::getFullConnectivityMatrix(bool bGetMirroredVersion) const
     MatrixXd matDist(m_lNodes.size(), m_lNodes.size());
     matDist.setZero();
 
+    if(m_bPacked) {
+        // Self connections are ignored, the diagonal stays zero
+        for(int i = 0, p = 0; i < m_lNodes.size(); ++i) {
+            for(int j = i; j < m_lNodes.size(); ++j, ++p) {
+                if(i == j) {
+                    continue;
+                }
+
+                matDist(i,j) = m_vecPackedAverages(p);
+
+                if(bGetMirroredVersion) {
+                    matDist(j,i) = m_vecPackedAverages(p);
+                }
+            }
+        }
+
+        return matDist;
+    }
+
     for(int i = 0; i < m_lFullEdges.size(); ++i) {
         int row = m_lFullEdges.at(i)->getStartNodeID();
         int col = m_lFullEdges.at(i)->getEndNodeID();
@@ -133,6 +156,23 @@ MatrixXd Network::getThresholdedConnectivityMatrix(bool bGetMirroredVersion) con
     MatrixXd matDist(m_lNodes.size(), m_lNodes.size());
     matDist.setZero();
 
+    if(m_bPacked) {
+        // Self connections are ignored, the diagonal stays zero
+        for(int i = 0, p = 0; i < m_lNodes.size(); ++i) {
+            for(int j = i; j < m_lNodes.size(); ++j, ++p) {
+                if(i != j && fabs(m_vecPackedAverages(p)) >= m_dThreshold) {
+                    matDist(i,j) = m_vecPackedAverages(p);
+
+                    if(bGetMirroredVersion) {
+                        matDist(j,i) = m_vecPackedAverages(p);
+                    }
+                }
+            }
+        }
+
+        return matDist;
+    }
+
     for(int i = 0; i < m_lThresholdedEdges.size(); ++i) {
         int row = m_lThresholdedEdges.at(i)->getStartNodeID();
         int col = m_lThresholdedEdges.at(i)->getEndNodeID();
@@ -417,6 +457,12 @@ void Network::setFrequencyRange(float fLowerFreq, float fUpperFreq)
     int iLowerBin = fLowerFreq * dScaleFactor;
     int iUpperBin = fUpperFreq * dScaleFactor;
 
+    if(m_bPacked) {
+        m_iMinMaxFreqBins = QPair<int,int>(iLowerBin,iUpperBin);
+        updatePackedAverages();
+        return;
+    }
+
     // Update the min max values
     m_minMaxFullWeights = QPair<double,double>(std::numeric_limits<double>::max(),0.0);
 
@@ -473,6 +519,10 @@ void Network::append(NetworkNode::SPtr newNode)
 
 bool Network::isEmpty() const
 {
+    if(m_bPacked) {
+        return m_lNodes.isEmpty() || m_pMatPackedWeights->cols() == 0;
+    }
+
     if(m_lFullEdges.isEmpty() || m_lNodes.isEmpty()) {
         return true;
     }
@@ -491,6 +541,10 @@ void Network::normalize()
         return;
     }
 
+    if(m_bPacked) {
+        m_vecPackedAverages /= m_minMaxFullWeights.second;
+    }
+
     for(int i = 0; i < m_lFullEdges.size(); ++i) {
         m_lFullEdges.at(i)->setWeight(m_lFullEdges.at(i)->getWeight()/m_minMaxFullWeights.second);
     }
@@ -566,3 +620,148 @@ int Network::getFFTSize()
     return m_iFFTSize;
 }
 
+
+//*************************************************************************************************************
+
+void Network::initPackedWeights(int iNumberFreqBins)
+{
+    int iNumberNodes = m_lNodes.size();
+
+    m_pMatPackedWeights = QSharedPointer<MatrixXd>(new MatrixXd(MatrixXd::Zero(iNumberFreqBins, iNumberNodes * (iNumberNodes + 1) / 2)));
+    m_vecPackedAverages = VectorXd::Zero(m_pMatPackedWeights->cols());
+    m_iMinMaxFreqBins = QPair<int,int>(-1,-1);
+
+    m_lFullEdges.clear();
+    m_lThresholdedEdges.clear();
+    m_bEdgeViewsCreated = false;
+    m_bPacked = true;
+}
+
+
+//*************************************************************************************************************
+
+void Network::setPackedWeights(int iStartNodeID,
+                               int iEndNodeID,
+                               const MatrixXd& matWeight)
+{
+    if(!m_bPacked || iStartNodeID == iEndNodeID) {
+        return;
+    }
+
+    if(matWeight.rows() != m_pMatPackedWeights->rows()) {
+        qDebug() << "Network::setPackedWeights - Number of weights does not match the number of frequency bins. Returning.";
+        return;
+    }
+
+    m_pMatPackedWeights->col(packedIndex(iStartNodeID, iEndNodeID)) = matWeight.col(0);
+}
+
+
+//*************************************************************************************************************
+
+void Network::finalizePackedWeights()
+{
+    if(!m_bPacked) {
+        return;
+    }
+
+    updatePackedAverages();
+
+    m_minMaxThresholdedWeights.first = m_dThreshold;
+    m_minMaxThresholdedWeights.second = m_minMaxFullWeights.second;
+
+    createEdgeViews();
+}
+
+
+//*************************************************************************************************************
+
+bool Network::isPacked() const
+{
+    return m_bPacked;
+}
+
+
+//*************************************************************************************************************
+
+void Network::createEdgeViews()
+{
+    if(!m_bPacked || m_bEdgeViewsCreated) {
+        return;
+    }
+
+    m_bEdgeViewsCreated = true;
+
+    NetworkEdge::SPtr pEdge;
+    bool bIsActive;
+
+    // Self connections are ignored, same as in append()
+    for(int i = 0, p = 0; i < m_lNodes.size(); ++i) {
+        for(int j = i; j < m_lNodes.size(); ++j, ++p) {
+            if(i == j) {
+                continue;
+            }
+
+            bIsActive = fabs(m_vecPackedAverages(p)) >= m_dThreshold;
+            pEdge = NetworkEdge::SPtr(new NetworkEdge(i, j, m_pMatPackedWeights->col(p), bIsActive, m_iMinMaxFreqBins.first, m_iMinMaxFreqBins.second));
+
+            // Keep normalized weights
+            pEdge->setWeight(m_vecPackedAverages(p));
+
+            m_lNodes.at(i)->append(pEdge);
+            m_lNodes.at(j)->append(pEdge);
+            m_lFullEdges << pEdge;
+
+            if(bIsActive) {
+                m_lThresholdedEdges << pEdge;
+            }
+        }
+    }
+}
+
+
+//*************************************************************************************************************
+
+void Network::updatePackedAverages()
+{
+    const MatrixXd& matWeights = *m_pMatPackedWeights;
+    int iStartBin = m_iMinMaxFreqBins.first;
+    int iEndBin = m_iMinMaxFreqBins.second;
+    int rows = matWeights.rows();
+
+    if(iEndBin < iStartBin || iStartBin < -1 || iEndBin < -1 || rows == 0) {
+        return;
+    }
+
+    // Same averaging as in NetworkEdge::calculateAveragedWeight
+    if(iEndBin == -1 && iStartBin == -1) {
+        m_vecPackedAverages = matWeights.colwise().mean().transpose();
+    } else if(iStartBin < rows) {
+        iEndBin = qMin(iEndBin, rows - 1);
+        m_vecPackedAverages = matWeights.middleRows(iStartBin, iEndBin - iStartBin + 1).colwise().mean().transpose();
+    }
+
+    // Update the min max values and already created edges. Self connections (diagonal) are ignored.
+    m_minMaxFullWeights = QPair<double,double>(std::numeric_limits<double>::max(),0.0);
+
+    double dWeight;
+    int e = 0;
+
+    for(int i = 0, p = 0; i < m_lNodes.size(); ++i) {
+        for(int j = i; j < m_lNodes.size(); ++j, ++p) {
+            if(i == j) {
+                continue;
+            }
+
+            dWeight = fabs(m_vecPackedAverages(p));
+            m_minMaxFullWeights.first = qMin(m_minMaxFullWeights.first, dWeight);
+            m_minMaxFullWeights.second = qMax(m_minMaxFullWeights.second, dWeight);
+
+            if(e < m_lFullEdges.size()) {
+                m_lFullEdges.at(e)->setFrequencyBins(m_iMinMaxFreqBins);
+                m_lFullEdges.at(e)->setWeight(m_vecPackedAverages(p));
+                ++e;
+            }
+        }
+    }
+}
@@ -115,7 +115,8 @@ public:
 
     //=========================================================================================================
     /**
-     * Returns the full connectivity matrix for this network structure.
+     * Returns the full connectivity matrix for this network structure. In packed mode the matrix is sliced directly from
+     * the averaged packed weights without creating edges.
      *
      * @param[in] bGetMirroredVersion    Flag whether to return the mirrored version of the connectivity matrix, if the network
      *                                   is a non-directional one. Otherwise returns zeros for the lower part of the matrix.
@@ -127,7 +128,8 @@ public:
 
     //=========================================================================================================
     /**
-     * Returns the thresholded connectivity matrix for this network structure.
+     * Returns the thresholded connectivity matrix for this network structure. In packed mode the matrix is sliced directly from
+     * the averaged packed weights without creating edges.
      *
      * @param[in] bGetMirroredVersion    Flag whether to return the mirrored version of the connectivity matrix, if the network
      *                                   is a non-directional one. Otherwise returns zeros for the lower part of the matrix.
@@ -404,9 +406,75 @@ public:
      */
     int getFFTSize();
 
+    //=========================================================================================================
+    /**
+     * Switches the network to the packed weight storage. Instead of one heap allocated edge per node pair, the weights
+     * of all pairs are stored in one contiguous matrix holding the upper triangle (including the diagonal) of the
+     * node x node x frequency tensor. The metric workers fill it without locking, the network edges and the edges of
+     * the nodes are created once by finalizePackedWeights. The nodes must have been appended before calling this
+     * function.
+     *
+     * @param[in] iNumberFreqBins    The number of frequency bins stored per edge.
+     */
+    void initPackedWeights(int iNumberFreqBins);
+
+    //=========================================================================================================
+    /**
+     * Sets the weights of an edge in packed mode. Calls for different node pairs can be made concurrently without
+     * locking. Self connections are ignored.
+     *
+     * @param[in] iStartNodeID   The start node id of the edge.
+     * @param[in] iEndNodeID     The end node id of the edge.
+     * @param[in] matWeight      The edge weights with one row per frequency bin.
+     */
+    void setPackedWeights(int iStartNodeID,
+                          int iEndNodeID,
+                          const Eigen::MatrixXd& matWeight);
+
+    //=========================================================================================================
+    /**
+     * Averages the packed weights over the current frequency bins, updates the minimum and maximum weights and creates
+     * the network edges. Needs to be called once all weights have been set.
+     */
+    void finalizePackedWeights();
+
+    //=========================================================================================================
+    /**
+     * Returns whether the network uses the packed weight storage.
+     *
+     * @return   The flag identifying whether the network uses the packed weight storage.
+     */
+    bool isPacked() const;
+
 protected:
-    QList<QSharedPointer<NetworkEdge> >     m_lFullEdges;               /**< List with all edges of the network.*/
-    QList<QSharedPointer<NetworkEdge> >     m_lThresholdedEdges;        /**< List with all the active (thresholded) edges of the network.*/
+    //=========================================================================================================
+    /**
+     * Returns the column of an edge in the packed weight storage.
+     *
+     * @param[in] iStartNodeID   The start node id of the edge.
+     * @param[in] iEndNodeID     The end node id of the edge.
+     *
+     * @return   The column index.
+     */
+    inline int packedIndex(int iStartNodeID,
+                           int iEndNodeID) const;
+
+    //=========================================================================================================
+    /**
+     * Creates the network edges from the packed weights and appends them to the nodes, if not done already. Called
+     * once by finalizePackedWeights, so that getters never modify the nodes which are shared between copies.
+     */
+    void createEdgeViews();
+
+    //=========================================================================================================
+    /**
+     * Averages the packed weights over the current frequency bins and updates the minimum and maximum weights as well
+     * as already created edges.
+     */
+    void updatePackedAverages();
+
+    QList<QSharedPointer<NetworkEdge> >     m_lFullEdges;               /**< List with all edges of the network. Created by finalizePackedWeights in packed mode.*/
+    QList<QSharedPointer<NetworkEdge> >     m_lThresholdedEdges;        /**< List with all the active (thresholded) edges of the network. Created by finalizePackedWeights in packed mode.*/
 
     QList<QSharedPointer<NetworkNode> >     m_lNodes;                   /**< List with all nodes of the network.*/
 
@@ -424,6 +492,12 @@ protected:
     int                                     m_iFFTSize;                 /**< The used FFT size (number of total frequency bins for a half spectrum - only positive frequencies).*/
 
     VisualizationInfo                       m_visualizationInfo;        /**< The current visualization info used to plot the network later on.*/
+
+    bool                                    m_bEdgeViewsCreated;        /**< Whether the edges were created from the packed weights.*/
+    bool                                    m_bPacked;                  /**< Whether the packed weight storage is used.*/
+    QSharedPointer<Eigen::MatrixXd>         m_pMatPackedWeights;        /**< The packed weights, one column of frequency bins per node pair. Shared between copies since it is not modified after filling.*/
+    Eigen::VectorXd                         m_vecPackedAverages;        /**< The packed weights averaged over the current frequency bins.*/
+    QPair<int,int>                          m_iMinMaxFreqBins;          /**< The frequency bins to average from/to in packed mode. (-1,-1) averages all bins.*/
 };
 
 
@@ -432,6 +506,15 @@ protected:
 // INLINE DEFINITIONS
 //=============================================================================================================
 
+inline int Network::packedIndex(int iStartNodeID,
+                                int iEndNodeID) const
+{
+    int i = qMin(iStartNodeID, iEndNodeID);
+    int j = qMax(iStartNodeID, iEndNodeID);
+
+    return i * m_lNodes.size() - i * (i - 1) / 2 + j - i;
+}
+
 
 } // namespace CONNECTIVITYLIB
 
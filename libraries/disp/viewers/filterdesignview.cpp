@@ -207,7 +207,6 @@ void FilterDesignView::setFilterParameters(double hp,
 {
     ui->m_doubleSpinBox_highpass->setValue(lp);
     ui->m_doubleSpinBox_lowpass->setValue(hp);
-    ui->m_spinBox_filterTaps->setValue(order);
 
     if(type == 0) {
         ui->m_comboBox_filterType->setCurrentText("Lowpass");
@@ -228,6 +227,15 @@ void FilterDesignView::setFilterParameters(double hp,
     if(designMethod == 1) {
         ui->m_comboBox_designMethod->setCurrentText("Cosine");
     }
+    if(designMethod == 3) {
+        ui->m_comboBox_designMethod->setCurrentText("Butterworth (IIR)");
+    }
+    if(designMethod == 4) {
+        ui->m_comboBox_designMethod->setCurrentText("Chebyshev (IIR)");
+    }
+
+    //Set the order after the design method, since the valid range depends on it
+    ui->m_spinBox_filterTaps->setValue(order);
 
     ui->m_doubleSpinBox_transitionband->setValue(transition);
 
@@ -443,6 +451,21 @@ void FilterDesignView::changeStateSpinBoxes(int currentIndex)
             break;
     }
 
+    //IIR filters are designed by their order instead of the number of taps
+    if(ui->m_comboBox_designMethod->currentIndex() >= 2) {
+        if(ui->m_spinBox_filterTaps->minimum() != 1) {
+            ui->m_spinBox_filterTaps->setRange(1, 16);
+            ui->m_spinBox_filterTaps->setValue(4);
+        }
+        ui->m_label_filterTaps->setText("Filter order:");
+    } else {
+        if(ui->m_spinBox_filterTaps->minimum() != 16) {
+            ui->m_spinBox_filterTaps->setRange(16, 512);
+            ui->m_spinBox_filterTaps->setValue(128);
+        }
+        ui->m_label_filterTaps->setText("Filter taps:");
+    }
+
     //Change visibility of spin boxes depending on filter type
     switch(ui->m_comboBox_filterType->currentIndex()) {
         case 0: //Bandpass
@@ -500,7 +523,7 @@ void FilterDesignView::filterParametersChanged()
 
     //Calculate the needed fft length
     m_iFilterTaps = ui->m_spinBox_filterTaps->value();
-    if(ui->m_spinBox_filterTaps->value()%2 != 0)
+    if(ui->m_spinBox_filterTaps->value()%2 != 0 && ui->m_comboBox_designMethod->currentIndex() < 2)
         m_iFilterTaps--;
 
     int fftLength = m_iWindowSize + ui->m_spinBox_filterTaps->value() * 4; // *2 to take into account the overlap in front and back after the convolution. Another *2 to take into account the appended and prepended data.
@@ -535,6 +558,14 @@ void FilterDesignView::filterParametersChanged()
         dMethod = FilterData::Cosine;
     }
 
+    if(ui->m_comboBox_designMethod->currentText() == "Butterworth (IIR)") {
+        dMethod = FilterData::IIRButterworth;
+    }
+
+    if(ui->m_comboBox_designMethod->currentText() == "Chebyshev (IIR)") {
+        dMethod = FilterData::IIRChebyshev;
+    }
+
     //Generate filters
     //Note: Always use "User Design" as filter name for user designed filters, which are stored in the model. This needs to be done because there only should be one filter in this model which holds the user designed filter.
     //Otherwise everytime a filter is designed a new filter would be added to this model -> too much storage consumption.
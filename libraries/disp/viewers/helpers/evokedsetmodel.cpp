@@ -42,6 +42,8 @@
 #include <fiff/fiff_info.h>
 #include <fiff/fiff_evoked_set.h>
 
+#include <utils/filterTools/iirfilter.h>
+
 
 //*************************************************************************************************************
 //=============================================================================================================
@@ -892,8 +894,20 @@ void EvokedSetModel::setFilter(const FilterData& filterData)
     m_filterData.clear();
     m_filterData << filterData;
 
+    //IIR filters are applied via their cascaded second order sections, their order is not a filter length
+    m_filterDataFIR.clear();
+    m_matSOS.resize(0,6);
+
     m_iMaxFilterLength = 1;
     for(int i=0; i<m_filterData.size(); i++) {
+        if(m_filterData.at(i).isIIR()) {
+            m_matSOS.conservativeResize(m_matSOS.rows() + m_filterData.at(i).m_matSOS.rows(), 6);
+            m_matSOS.bottomRows(m_filterData.at(i).m_matSOS.rows()) = m_filterData.at(i).m_matSOS;
+            continue;
+        }
+
+        m_filterDataFIR << m_filterData.at(i);
+
         if(m_iMaxFilterLength < m_filterData.at(i).m_iFilterOrder) {
             m_iMaxFilterLength = m_filterData.at(i).m_iFilterOrder;
         }
@@ -1013,15 +1027,28 @@ void EvokedSetModel::filterDataBlock()
 
     //Generate QList structure which can be handled by the QConcurrent framework for each average in set
     for(int j = 0; j < m_matData.size(); ++j) {
+        //Apply the IIR filters first
+        if(m_matSOS.rows() > 0) {
+            MatrixXd matDataIIR = m_matData.at(j);
+            filterDataBlockIIR(matDataIIR);
+            m_matDataFiltered[j] = matDataIIR;
+
+            if(m_filterDataFIR.isEmpty()) {
+                continue;
+            }
+        }
+
+        const MatrixXd& matData = m_matSOS.rows() > 0 ? m_matDataFiltered.at(j) : m_matData.at(j);
+
         QList<QPair<QList<FilterData>,QPair<int,RowVectorXd> > > timeData;
         QList<int> notFilterChannelIndex;
 
         //Also append mirrored data in front and back to get rid of edge effects
-        for(qint32 i = 0; i < m_matData.at(j).rows(); ++i) {
+        for(qint32 i = 0; i < matData.rows(); ++i) {
             if(m_filterChannelList.contains(m_pEvokedSet->info.chs.at(i).ch_name)) {
-                RowVectorXd datTemp(m_matData.at(j).row(i).cols() + 2 * m_iMaxFilterLength);
-                datTemp << m_matData.at(j).row(i).head(m_iMaxFilterLength).reverse(), m_matData.at(j).row(i), m_matData.at(j).row(i).tail(m_iMaxFilterLength).reverse();
-                timeData.append(QPair<QList<FilterData>,QPair<int,RowVectorXd> >(m_filterData,QPair<int,RowVectorXd>(i,datTemp)));
+                RowVectorXd datTemp(matData.row(i).cols() + 2 * m_iMaxFilterLength);
+                datTemp << matData.row(i).head(m_iMaxFilterLength).reverse(), matData.row(i), matData.row(i).tail(m_iMaxFilterLength).reverse();
+                timeData.append(QPair<QList<FilterData>,QPair<int,RowVectorXd> >(m_filterDataFIR,QPair<int,RowVectorXd>(i,datTemp)));
             } else {
                 notFilterChannelIndex.append(i);
             }
@@ -1046,3 +1073,36 @@ void EvokedSetModel::filterDataBlock()
     }
 }
 
+
+//*************************************************************************************************************
+
+void EvokedSetModel::filterDataBlockIIR(MatrixXd& data)
+{
+    //Gather the channels which are to be filtered, so that all channels of one sample are contiguous in memory
+    QList<int> filterChannelIndex;
+
+    for(qint32 i = 0; i < data.rows(); ++i) {
+        if(m_filterChannelList.contains(m_pEvokedSet->info.chs.at(i).ch_name)) {
+            filterChannelIndex.append(i);
+        }
+    }
+
+    if(filterChannelIndex.isEmpty() || data.cols() == 0) {
+        return;
+    }
+
+    //Prepend the time reversed data to warm up the filter state
+    MatrixXd matDataSOS(filterChannelIndex.size(), 2 * data.cols());
+
+    for(int i = 0; i < filterChannelIndex.size(); ++i) {
+        matDataSOS.row(i) << data.row(filterChannelIndex.at(i)).reverse(), data.row(filterChannelIndex.at(i));
+    }
+
+    MatrixXd matState;
+    IIRFilter::filterSOS(m_matSOS, matDataSOS, matState);
+
+    for(int i = 0; i < filterChannelIndex.size(); ++i) {
+        data.row(filterChannelIndex.at(i)) = matDataSOS.row(i).tail(data.cols());
+    }
+}
+
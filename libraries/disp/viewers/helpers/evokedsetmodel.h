@@ -431,6 +431,16 @@ private:
      */
     void filterDataBlock();
 
+    //=========================================================================================================
+    /**
+     * Applies the cascaded second order sections of the IIR filters to the channels which are to be filtered. The
+     * filter state is warmed up with the time reversed data, so that the start of the average does not show the
+     * transient of the filter.
+     *
+     * @param[in, out] data    the data which is to be filtered in place
+     */
+    void filterDataBlockIIR(Eigen::MatrixXd& data);
+
     QSharedPointer<FIFFLIB::FiffEvokedSet>  m_pEvokedSet;                   /**< The evoked set measurement. */
 
     QMap<qint32,qint32>                     m_qMapIdxRowSelection;          /**< Selection mapping.*/
@@ -461,10 +471,12 @@ private:
     bool                                    m_bCompActivated;               /**< Compensator activated */
     bool                                    m_bPerformFiltering;            /**< Flag whether to activate/deactivate filtering. */
     float                                   m_fSps;                         /**< Sampling rate */
-    qint32                                  m_iMaxFilterLength;             /**< Max order of the current filters */
+    qint32                                  m_iMaxFilterLength;             /**< Max length of the current FIR filters */
 
     QString                                 m_sFilterChannelType;           /**< Kind of channel which is to be filtered */
     QList<UTILSLIB::FilterData>             m_filterData;                   /**< List of currently active filters. */
+    QList<UTILSLIB::FilterData>             m_filterDataFIR;                /**< List of currently active FIR filters. */
+    Eigen::MatrixXd                         m_matSOS;                       /**< The cascaded second order sections of the active IIR filters. */
     QStringList                             m_filterChannelList;            /**< List of channels which are to be filtered.*/
     QStringList                             m_visibleChannelList;           /**< List of currently visible channels in the view.*/
 
@@ -48,6 +48,7 @@
 #include <utils/detecttrigger.h>
 #include <utils/ioutils.h>
 #include <utils/filterTools/sphara.h>
+#include <utils/filterTools/iirfilter.h>
 
 
 //*************************************************************************************************************
@@ -100,6 +101,7 @@ RtFiffRawViewModel::RtFiffRawViewModel(QObject *parent)
 , m_iCurrentBlockSize(1024)
 , m_iResidual(0)
 , m_bDrawFilterFront(true)
+, m_bUpdateFilter(true)
 , m_bTriggerDetectionActive(false)
 , m_dTriggerThreshold(0.01)
 , m_iDistanceTimerSpacer(1000)
@@ -327,7 +329,7 @@ void RtFiffRawViewModel::setFiffInfo(QSharedPointer<FIFFLIB::FiffInfo> &p_pFiffI
         m_vecLastBlockFirstValuesRaw.conservativeResize(m_pFiffInfo->chs.size());
         m_vecLastBlockFirstValuesRaw.setZero();
 
-        m_matOverlap.conservativeResize(m_pFiffInfo->chs.size(), m_iMaxFilterLength);
+        m_bUpdateFilter = true;
 
         m_matSparseProjMult = SparseMatrix<double>(m_pFiffInfo->chs.size(),m_pFiffInfo->chs.size());
         m_matSparseCompMult = SparseMatrix<double>(m_pFiffInfo->chs.size(),m_pFiffInfo->chs.size());
@@ -910,18 +912,27 @@ void RtFiffRawViewModel::updateSpharaOptions(const QString& sSytemType, int nBas
 void RtFiffRawViewModel::setFilter(QList<FilterData> filterData)
 {
     m_filterData = filterData;
+    m_filterDataFIR.clear();
 
-    m_iMaxFilterLength = 1;
+    //IIR filters are applied via their cascaded second order sections. They do not introduce a fixed delay.
+    m_matSOS.resize(0,6);
+
+    //The FIR filters are applied in cascade, hence their delays add up
+    int iFilterLength = 0;
     for(int i=0; i<filterData.size(); ++i) {
-        if(m_iMaxFilterLength<filterData.at(i).m_iFilterOrder) {
-            m_iMaxFilterLength = filterData.at(i).m_iFilterOrder;
+        if(filterData.at(i).isIIR()) {
+            m_matSOS.conservativeResize(m_matSOS.rows() + filterData.at(i).m_matSOS.rows(), 6);
+            m_matSOS.bottomRows(filterData.at(i).m_matSOS.rows()) = filterData.at(i).m_matSOS;
+            continue;
         }
+
+        m_filterDataFIR.append(filterData.at(i));
+        iFilterLength += filterData.at(i).m_dCoeffA.cols();
     }
 
-    m_matOverlap.conservativeResize(m_pFiffInfo->chs.size(), m_iMaxFilterLength);
-    m_matOverlap.setZero();
+    m_iMaxFilterLength = qMax(1, iFilterLength);
 
-    m_bDrawFilterFront = false;
+    m_bUpdateFilter = true;
 
     //Filter all visible data channels at once
     //filterDataBlock();
@@ -933,6 +944,11 @@ void RtFiffRawViewModel::setFilter(QList<FilterData> filterData)
 void RtFiffRawViewModel::setFilterActive(bool state)
 {
     m_bPerformFiltering = state;
+
+    //The filter state of the last active period does not match the incoming data anymore
+    if(state) {
+        m_bUpdateFilter = true;
+    }
 }
 
 
@@ -979,6 +995,8 @@ void RtFiffRawViewModel::setFilterChannelType(QString channelType)
 
 //    m_bDrawFilterFront = false;
 
+    m_bUpdateFilter = true;
+
     //Filter all visible data channels at once
     //filterDataBlock();
 }
@@ -1021,6 +1039,8 @@ void RtFiffRawViewModel::createFilterChannelList(QStringList channelNames)
 //    for(int i = 0; i<m_filterChannelList.size(); ++i)
 //        std::cout<<m_filterChannelList.at(i).toStdString()<<std::endl;
 
+    m_bUpdateFilter = true;
+
     //Filter all visible data channels at once
     //filterDataBlock();
 }
@@ -1149,6 +1169,24 @@ void RtFiffRawViewModel::filterDataBlock()
         return;
     }
 
+    //Apply the IIR filters to all available data with a fresh state
+    MatrixXd matDataRaw = m_matDataRaw;
+
+    if(m_matSOS.rows() > 0) {
+        MatrixXd matState;
+        filterDataBlockIIR(matDataRaw, matState);
+
+        if(m_filterDataFIR.isEmpty()) {
+            m_matDataFiltered = matDataRaw;
+
+            if(!m_bIsFreezed) {
+                m_vecLastBlockFirstValuesFiltered = m_matDataFiltered.col(0);
+            }
+
+            return;
+        }
+    }
+
     //Create temporary filters with higher fft length because we are going to filter all available data at once for one time
     QList<FilterData> tempFilterList;
 
@@ -1156,16 +1194,16 @@ void RtFiffRawViewModel::filterDataBlock()
     int exp = ceil(MNEMath::log2(fftLength));
     fftLength = pow(2, exp) < 512 ? 512 : pow(2, exp);
 
-    for(int i = 0; i<m_filterData.size(); ++i) {
-        FilterData tempFilter(m_filterData.at(i).m_sName,
-                              m_filterData.at(i).m_Type,
-                              m_filterData.at(i).m_iFilterOrder,
-                              m_filterData.at(i).m_dCenterFreq,
-                              m_filterData.at(i).m_dBandwidth,
-                              m_filterData.at(i).m_dParksWidth,
-                              m_filterData.at(i).m_sFreq,
+    for(int i = 0; i<m_filterDataFIR.size(); ++i) {
+        FilterData tempFilter(m_filterDataFIR.at(i).m_sName,
+                              m_filterDataFIR.at(i).m_Type,
+                              m_filterDataFIR.at(i).m_iFilterOrder,
+                              m_filterDataFIR.at(i).m_dCenterFreq,
+                              m_filterDataFIR.at(i).m_dBandwidth,
+                              m_filterDataFIR.at(i).m_dParksWidth,
+                              m_filterDataFIR.at(i).m_sFreq,
                               fftLength,
-                              m_filterData.at(i).m_designMethod);
+                              m_filterDataFIR.at(i).m_designMethod);
 
         tempFilterList.append(tempFilter);
     }
@@ -1175,10 +1213,10 @@ void RtFiffRawViewModel::filterDataBlock()
     QList<int> notFilterChannelIndex;
 
     //Also append mirrored data in front and back to get rid of edge effects
-    for(qint32 i=0; i<m_matDataRaw.rows(); ++i) {
+    for(qint32 i=0; i<matDataRaw.rows(); ++i) {
         if(m_filterChannelList.contains(m_pFiffInfo->chs.at(i).ch_name)) {
-            RowVectorXd datTemp(m_matDataRaw.row(i).cols() + 2 * m_iMaxFilterLength);
-            datTemp << m_matDataRaw.row(i).head(m_iMaxFilterLength).reverse(), m_matDataRaw.row(i), m_matDataRaw.row(i).tail(m_iMaxFilterLength).reverse();
+            RowVectorXd datTemp(matDataRaw.row(i).cols() + 2 * m_iMaxFilterLength);
+            datTemp << matDataRaw.row(i).head(m_iMaxFilterLength).reverse(), matDataRaw.row(i), matDataRaw.row(i).tail(m_iMaxFilterLength).reverse();
             timeData.append(QPair<QList<FilterData>,QPair<int,RowVectorXd> >(tempFilterList,QPair<int,RowVectorXd>(i,datTemp)));
         } else {
             notFilterChannelIndex.append(i);
@@ -1194,7 +1232,6 @@ void RtFiffRawViewModel::filterDataBlock()
 
         for(int r = 0; r < timeData.size(); ++r) {
             m_matDataFiltered.row(timeData.at(r).second.first) = timeData.at(r).second.second.segment(m_iMaxFilterLength+m_iMaxFilterLength/2, m_matDataRaw.cols());
-            m_matOverlap.row(timeData.at(r).second.first) = timeData.at(r).second.second.tail(m_iMaxFilterLength);
         }
     }
 
@@ -1213,118 +1250,114 @@ void RtFiffRawViewModel::filterDataBlock()
 
 //*************************************************************************************************************
 
-void RtFiffRawViewModel::filterDataBlock(const MatrixXd &data, int iDataIndex)
+void RtFiffRawViewModel::filterDataBlock(const MatrixXd &dataIn, int iDataIndex)
 {
-    //std::cout<<"START RtFiffRawViewModel::filterDataBlock"<<std::endl;
-
-    if(iDataIndex >= m_matDataFiltered.cols() || data.cols() < m_iMaxFilterLength) {
+    if(iDataIndex >= m_matDataFiltered.cols()) {
         return;
     }
 
-    //Generate QList structure which can be handled by the QConcurrent framework
-    QList<QPair<QList<FilterData>,QPair<int,RowVectorXd> > > timeData;
-    QList<int> notFilterChannelIndex;
+    //Only prepare the streaming filter if the filters or the filtered channels changed. Otherwise the filter state
+    //is kept from the last block.
+    if(m_bUpdateFilter) {
+        m_vecFilterPicks.resize(m_pFiffInfo->chs.size());
+        int iNumPicks = 0;
 
-    for(qint32 i = 0; i < data.rows(); ++i) {
-        if(m_filterChannelList.contains(m_pFiffInfo->chs.at(i).ch_name)) {
-            timeData.append(QPair<QList<FilterData>,QPair<int,RowVectorXd> >(m_filterData,QPair<int,RowVectorXd>(i,data.row(i))));
-        } else {
-            notFilterChannelIndex.append(i);
+        for(qint32 i = 0; i < m_pFiffInfo->chs.size(); ++i) {
+            if(m_filterChannelList.contains(m_pFiffInfo->chs.at(i).ch_name)) {
+                m_vecFilterPicks[iNumPicks++] = i;
             }
-    }
+        }
 
-    //Do the concurrent filtering
-    if(!timeData.isEmpty()) {
-        QFuture<void> future = QtConcurrent::map(timeData,
-                                             doFilterPerChannelRTMSA);
+        m_vecFilterPicks.conservativeResize(iNumPicks);
 
-        future.waitForFinished();
+        m_streamingFilter.prepareFilter(m_filterData, m_vecFilterPicks);
 
-        //Do the overlap add method and store in m_matDataFiltered
-        int iFilterDelay = m_iMaxFilterLength/2;
-        int iFilteredNumberCols = timeData.at(0).second.second.cols();
+        m_bUpdateFilter = false;
+        m_bDrawFilterFront = false;
+    }
 
-        for(int r = 0; r<timeData.size(); ++r) {
-            if(iDataIndex+2*data.cols() > m_matDataRaw.cols()) {
-                //Handle last data block
-                //std::cout<<"Handle last data block"<<std::endl;
+    //Show the unfiltered data if the filters could not be applied
+    if(!m_streamingFilter.filterDataBlock(dataIn, m_matDataFilteredBlock)) {
+        m_matDataFiltered.block(0, iDataIndex, dataIn.rows(), dataIn.cols()) = dataIn;
+        return;
+    }
 
-                if(m_bDrawFilterFront) {
-                    //Get the currently filtered data. This data has a delay of filterLength/2 in front and back.
-                    RowVectorXd tempData = timeData.at(r).second.second;
+    //Channels which are not filtered and the IIR filtered channels are not delayed
+    m_matDataFiltered.block(0, iDataIndex, dataIn.rows(), dataIn.cols()) = m_matDataFilteredBlock;
 
-                    //Perform the actual overlap add by adding the last filterlength data to the newly filtered one
-                    tempData.head(m_iMaxFilterLength) += m_matOverlap.row(timeData.at(r).second.first);
+    //The FIR filtered channels are delayed by half of the filter length. Write them back by this delay, so that they
+    //line up with the raw data. Right after the filter was prepared the front only holds the transient of the new
+    //filter. Do not write it into the last block, otherwise there are nasty signal jumps when changing the filter.
+    int iFilterDelay = m_filterDataFIR.isEmpty() ? 0 : m_iMaxFilterLength/2;
 
-                    //Write the newly calulated filtered data to the filter data matrix. Keep in mind that the current block also effect last part of the last block (begin at dataIndex-iFilterDelay).
-                    int start = iDataIndex-iFilterDelay < 0 ? 0 : iDataIndex-iFilterDelay;
-                    m_matDataFiltered.row(timeData.at(r).second.first).segment(start,iFilteredNumberCols-m_iMaxFilterLength) = tempData.head(iFilteredNumberCols-m_iMaxFilterLength);
-                } else {
-                    //Perform this else case everytime the filter was changed. Do not begin to plot from dataIndex-iFilterDelay because the impsulse response and m_matOverlap do not match with the new filter anymore.
-                    m_matDataFiltered.row(timeData.at(r).second.first).segment(iDataIndex-iFilterDelay,m_iMaxFilterLength) = timeData.at(r).second.second.segment(m_iMaxFilterLength,m_iMaxFilterLength);
-                    m_matDataFiltered.row(timeData.at(r).second.first).segment(iDataIndex+iFilterDelay,iFilteredNumberCols-2*m_iMaxFilterLength) = timeData.at(r).second.second.segment(m_iMaxFilterLength,iFilteredNumberCols-2*m_iMaxFilterLength);
-                }
+    if(iFilterDelay > 0) {
+        int iCol = m_bDrawFilterFront ? 0 : qMin(iFilterDelay, int(dataIn.cols()));
+        int iNumCols = dataIn.cols() - iCol;
+        int iStart = iDataIndex - iFilterDelay + iCol;
 
-                //Refresh the m_matOverlap with the new calculated filtered data.
-                m_matOverlap.row(timeData.at(r).second.first) = timeData.at(r).second.second.tail(m_iMaxFilterLength);
-            } else if(iDataIndex == 0) {
-                //Handle first data block
-                //std::cout<<"Handle first data block"<<std::endl;
+        if(iStart < 0) {
+            //The front belongs to the end of the last pass through the data matrix. The residual is != 0 if the
+            //chosen block size cannot be evenly fit into the matrix size.
+            int iFront = qMin(-iStart, iNumCols);
+            int iEnd = m_matDataFiltered.cols() - m_iResidual;
 
-                if(m_bDrawFilterFront) {
-                    //Get the currently filtered data. This data has a delay of filterLength/2 in front and back.
-                    RowVectorXd tempData = timeData.at(r).second.second;
+            if(iDataIndex == 0 && iEnd + iStart >= 0) {
+                for(int i = 0; i < m_vecFilterPicks.cols(); ++i) {
+                    m_matDataFiltered.row(m_vecFilterPicks[i]).segment(iEnd + iStart, iFront) = m_matDataFilteredBlock.row(m_vecFilterPicks[i]).segment(iCol, iFront);
+                }
+            }
 
-                    //Add newly calculate data to the tail of the current filter data matrix
-                    m_matDataFiltered.row(timeData.at(r).second.first).segment(m_matDataFiltered.cols()-iFilterDelay-m_iResidual, iFilterDelay) = tempData.head(iFilterDelay) + m_matOverlap.row(timeData.at(r).second.first).head(iFilterDelay);
+            iCol += iFront;
+            iNumCols -= iFront;
+            iStart = 0;
+        }
 
-                    //Perform the actual overlap add by adding the last filterlength data to the newly filtered one
-                    tempData.head(m_iMaxFilterLength) += m_matOverlap.row(timeData.at(r).second.first);
-                    m_matDataFiltered.row(timeData.at(r).second.first).head(iFilteredNumberCols-m_iMaxFilterLength-iFilterDelay) = tempData.segment(iFilterDelay,iFilteredNumberCols-m_iMaxFilterLength-iFilterDelay);
+        if(iNumCols > 0) {
+            for(int i = 0; i < m_vecFilterPicks.cols(); ++i) {
+                m_matDataFiltered.row(m_vecFilterPicks[i]).segment(iStart, iNumCols) = m_matDataFilteredBlock.row(m_vecFilterPicks[i]).segment(iCol, iNumCols);
+            }
+        }
+    }
 
-                    //Copy residual data from the front to the back. The residual is != 0 if the chosen block size cannot be evenly fit into the matrix size
-                    m_matDataFiltered.row(timeData.at(r).second.first).tail(m_iResidual) = m_matDataFiltered.row(timeData.at(r).second.first).head(m_iResidual);
-                } else {
-                    //Perform this else case everytime the filter was changed. Do not begin to plot from dataIndex-iFilterDelay because the impsulse response and m_matOverlap do not match with the new filter anymore.
-                    m_matDataFiltered.row(timeData.at(r).second.first).head(m_iMaxFilterLength) = timeData.at(r).second.second.segment(m_iMaxFilterLength,m_iMaxFilterLength);
-                    m_matDataFiltered.row(timeData.at(r).second.first).segment(iFilterDelay,iFilteredNumberCols-2*m_iMaxFilterLength) = timeData.at(r).second.second.segment(m_iMaxFilterLength,iFilteredNumberCols-2*m_iMaxFilterLength);
-                }
+    //Copy residual data from the front to the back
+    if(iDataIndex == 0 && m_iResidual > 0) {
+        m_matDataFiltered.rightCols(m_iResidual) = m_matDataFiltered.leftCols(m_iResidual);
+    }
 
-                //Refresh the m_matOverlap with the new calculated filtered data.
-                m_matOverlap.row(timeData.at(r).second.first) = timeData.at(r).second.second.tail(m_iMaxFilterLength);
-            } else {
-                //Handle middle data blocks
-                //std::cout<<"Handle middle data block"<<std::endl;
+    m_bDrawFilterFront = true;
+}
 
-                if(m_bDrawFilterFront) {
-                    //Get the currently filtered data. This data has a delay of filterLength/2 in front and back.
-                    RowVectorXd tempData = timeData.at(r).second.second;
 
-                    //Perform the actual overlap add by adding the last filterlength data to the newly filtered one
-                    tempData.head(m_iMaxFilterLength) += m_matOverlap.row(timeData.at(r).second.first);
+//*************************************************************************************************************
 
-                    //Write the newly calulated filtered data to the filter data matrix. Keep in mind that the current block also effect last part of the last block (begin at dataIndex-iFilterDelay).
-                    m_matDataFiltered.row(timeData.at(r).second.first).segment(iDataIndex-iFilterDelay,iFilteredNumberCols-m_iMaxFilterLength) = tempData.head(iFilteredNumberCols-m_iMaxFilterLength);
-                } else {
-                    //Perform this else case everytime the filter was changed. Do not begin to plot from dataIndex-iFilterDelay because the impsulse response and m_matOverlap do not match with the new filter anymore.
-                    m_matDataFiltered.row(timeData.at(r).second.first).segment(iDataIndex-iFilterDelay,m_iMaxFilterLength).setZero();// = timeData.at(r).second.second.segment(m_iMaxFilterLength,m_iMaxFilterLength);
-                    m_matDataFiltered.row(timeData.at(r).second.first).segment(iDataIndex+iFilterDelay,iFilteredNumberCols-2*m_iMaxFilterLength) = timeData.at(r).second.second.segment(m_iMaxFilterLength,iFilteredNumberCols-2*m_iMaxFilterLength);
-                }
+void RtFiffRawViewModel::filterDataBlockIIR(MatrixXd &data, MatrixXd &matState)
+{
+    //Gather the channels which are to be filtered, so that all channels of one sample are contiguous in memory
+    QList<int> filterChannelIndex;
 
-                //Refresh the m_matOverlap with the new calculated filtered data.
-                m_matOverlap.row(timeData.at(r).second.first) = timeData.at(r).second.second.tail(m_iMaxFilterLength);
-            }
+    for(qint32 i = 0; i < data.rows(); ++i) {
+        if(m_filterChannelList.contains(m_pFiffInfo->chs.at(i).ch_name)) {
+            filterChannelIndex.append(i);
         }
     }
 
-    m_bDrawFilterFront = true;
+    if(filterChannelIndex.isEmpty()) {
+        return;
+    }
 
-    //Fill filtered data with raw data if the channel was not filtered
-    for(int i = 0; i < notFilterChannelIndex.size(); ++i) {
-        m_matDataFiltered.row(notFilterChannelIndex.at(i)).segment(iDataIndex,data.row(notFilterChannelIndex.at(i)).cols()) = data.row(notFilterChannelIndex.at(i));
+    if(m_matSOSData.rows() != filterChannelIndex.size() || m_matSOSData.cols() != data.cols()) {
+        m_matSOSData.resize(filterChannelIndex.size(), data.cols());
     }
 
-    //std::cout<<"END RtFiffRawViewModel::filterDataBlock"<<std::endl;
+    for(int i = 0; i < filterChannelIndex.size(); ++i) {
+        m_matSOSData.row(i) = data.row(filterChannelIndex.at(i));
+    }
+
+    IIRFilter::filterSOS(m_matSOS, m_matSOSData, matState);
+
+    for(int i = 0; i < filterChannelIndex.size(); ++i) {
+        data.row(filterChannelIndex.at(i)) = m_matSOSData.row(i);
+    }
 }
 
 
@@ -1340,7 +1373,7 @@ void RtFiffRawViewModel::clearModel()
     m_matDataFilteredFreeze.setZero();
     m_vecLastBlockFirstValuesFiltered.setZero();
     m_vecLastBlockFirstValuesRaw.setZero();
-    m_matOverlap.setZero();
+    m_streamingFilter.resetFilter();
 
     endResetModel();
 }
@@ -47,6 +47,7 @@
 #include <fiff/fiff_types.h>
 #include <fiff/fiff_proj.h>
 #include <utils/filterTools/filterdata.h>
+#include <utils/filterTools/streamingfilter.h>
 
 
 //*************************************************************************************************************
@@ -536,13 +537,23 @@ private:
 
     //=========================================================================================================
     /**
-     * Calculates the filtered version of the raw input data
+     * Calculates the filtered version of the raw input data with the streaming filter. The filter is only prepared
+     * again if the filters or the filtered channels changed, otherwise its state is kept from the last block.
      *
      * @param [in] data          data which is to be filtered
      * @param [in] iDataIndex    current position in the global data matrix
      */
     void filterDataBlock(const Eigen::MatrixXd &data, int iDataIndex);
 
+    //=========================================================================================================
+    /**
+     * Applies the IIR filters of the current filter list in place to all channels which are to be filtered
+     *
+     * @param [in, out] data        data which is to be filtered
+     * @param [in, out] matState    the IIR filter state of the filtered channels, kept between blocks
+     */
+    void filterDataBlockIIR(Eigen::MatrixXd &data, Eigen::MatrixXd &matState);
+
     //=========================================================================================================
     /**
      * Clears the model
@@ -554,6 +565,7 @@ private:
     bool                                m_bSpharaActivated;                         /**< Sphara activated */
     bool                                m_bIsFreezed;                               /**< Display is freezed */
     bool                                m_bDrawFilterFront;                         /**< Flag whether to plot/write the delayed frontal part of the filtered signal. This flag is necessary to get rid of nasty signal jumps when changing the filter parameters. */
+    bool                                m_bUpdateFilter;                            /**< Flag whether the filters or the filtered channels changed and the streaming filter needs to be prepared again. */
     bool                                m_bPerformFiltering;                        /**< Flag whether to activate/deactivate filtering. */
     bool                                m_bTriggerDetectionActive;                  /**< Trigger detection activation state */
     float                               m_fSps;                                     /**< Sampling rate */
@@ -563,7 +575,7 @@ private:
     qint32                              m_iMaxSamples;                              /**< Max samples per window */
     qint32                              m_iCurrentSample;                           /**< Current sample which holds the current position in the data matrix */
     qint32                              m_iCurrentSampleFreeze;                     /**< Current sample which holds the current position in the data matrix when freezing tool is active */
-    qint32                              m_iMaxFilterLength;                         /**< Max order of the current filters */
+    qint32                              m_iMaxFilterLength;                         /**< Combined length of the current FIR filters, twice their delay */
     qint32                              m_iCurrentBlockSize;                        /**< Current block size */
     qint32                              m_iResidual;                                /**< Current amount of samples which were to size */
     int                                 m_iCurrentTriggerChIndex;                   /**< The index of the current trigger channel */
@@ -578,12 +590,15 @@ private:
     Eigen::RowVectorXi                  m_vecBadIdcs;                               /**< Idcs of bad channels */
     Eigen::VectorXd                     m_vecLastBlockFirstValuesFiltered;          /**< The first value of the last complete filtered data display block */
     Eigen::VectorXd                     m_vecLastBlockFirstValuesRaw;               /**< The first value of the last complete raw data display block */
+    Eigen::RowVectorXi                  m_vecFilterPicks;                           /**< The indices of the channels which are filtered by the streaming filter */
 
     MatrixXdR                           m_matDataRaw;                               /**< The raw data */
     MatrixXdR                           m_matDataFiltered;                          /**< The filtered data */
     MatrixXdR                           m_matDataRawFreeze;                         /**< The raw data in freeze mode */
     MatrixXdR                           m_matDataFilteredFreeze;                    /**< The raw filtered data in freeze mode */
-    Eigen::MatrixXd                     m_matOverlap;                               /**< Last overlap block for the back */
+    Eigen::MatrixXd                     m_matDataFilteredBlock;                     /**< The output buffer of the streaming filter */
+    Eigen::MatrixXd                     m_matSOS;                                   /**< The cascaded second order sections of the current IIR filters */
+    Eigen::MatrixXd                     m_matSOSData;                               /**< The gathered channels for the IIR filtering */
 
     Eigen::VectorXi                     m_vecIndicesFirstVV;                        /**< The indices of the channels to pick for the first SPHARA operator in case of a VectorView system.*/
     Eigen::VectorXi                     m_vecIndicesSecondVV;                       /**< The indices of the channels to pick for the second SPHARA operator in case of a VectorView system.*/
@@ -613,12 +628,15 @@ private:
     QMap<int,QList<QPair<int,double> > >m_qMapDetectedTriggerOldFreeze;             /**< Old detected trigger for each trigger channel while display is freezed. */
     QMap<qint32,float>                  m_qMapChScaling;                            /**< Channel scaling map. */
     QList<UTILSLIB::FilterData>         m_filterData;                               /**< List of currently active filters. */
+    QList<UTILSLIB::FilterData>         m_filterDataFIR;                            /**< List of currently active FIR filters. */
     QStringList                         m_filterChannelList;                        /**< List of channels which are to be filtered.*/
     QStringList                         m_visibleChannelList;                       /**< List of currently visible channels in the view.*/
     QMap<qint32,qint32>                 m_qMapIdxRowSelection;                      /**< Selection mapping.*/
 
     QColor                              m_colBackground;                            /**< The background color.*/
 
+    UTILSLIB::StreamingFilter           m_streamingFilter;                          /**< The streaming filter of the incoming blocks.*/
+
 signals:
     //=========================================================================================================
     /**
@@ -83,6 +83,9 @@ MinimumNormSettingsView::MinimumNormSettingsView(QWidget *parent,
     connect(ui->m_spinBox_timepoint, static_cast<void (QSpinBox::*)(int)>(&QSpinBox::valueChanged),
             this, &MinimumNormSettingsView::onTimePointValueChanged);
 
+    connect(ui->m_checkBox_singlePrecision, &QCheckBox::toggled,
+            this, &MinimumNormSettingsView::onSinglePrecisionChanged);
+
     this->setWindowTitle("MinimumNorm Settings");
     this->setMinimumWidth(330);
     this->setMaximumWidth(330);
@@ -131,3 +134,11 @@ void MinimumNormSettingsView::onTimePointValueChanged(int iTimePointMs)
 {
     emit timePointChanged(iTimePointMs);
 }
+
+
+//*************************************************************************************************************
+
+void MinimumNormSettingsView::onSinglePrecisionChanged(bool bSinglePrecision)
+{
+    emit singlePrecisionChanged(bSinglePrecision);
+}
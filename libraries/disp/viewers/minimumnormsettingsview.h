@@ -151,6 +151,14 @@ protected:
      */
     void onTimePointValueChanged(int iTimePointMs);
 
+    //=========================================================================================================
+    /**
+     * Slot called when the single precision check box was toggled.
+     *
+     * @param [in] bSinglePrecision        Whether the kernel should be used in single precision.
+     */
+    void onSinglePrecisionChanged(bool bSinglePrecision);
+
     Ui::MinimumNormSettingsViewWidget* ui;
 
 signals:
@@ -178,6 +186,14 @@ signals:
      */
     void timePointChanged(int iTimePoint);
 
+    //=========================================================================================================
+    /**
+     * Emit signal whenever the kernel precision changed.
+     *
+     * @param [in] bSinglePrecision        Whether the kernel should be used in single precision.
+     */
+    void singlePrecisionChanged(bool bSinglePrecision);
+
 };
 
 } // NAMESPACE
@@ -74,7 +74,7 @@ RtSensorInterpolationMatWorker::RtSensorInterpolationMatWorker()
 {
     m_lInterpolationData.dCancelDistance = 0.05;
     m_lInterpolationData.interpolationFunction = DISP3DLIB::Interpolation::cubic;
-    m_lInterpolationData.matDistanceMatrix = QSharedPointer<MatrixXd>(new MatrixXd());
+    m_lInterpolationData.matDistanceMatrix = QSharedPointer<Eigen::SparseMatrix<double, Eigen::RowMajor> >(new Eigen::SparseMatrix<double, Eigen::RowMajor>());
 }
 
 
@@ -166,12 +166,7 @@ void RtSensorInterpolationMatWorker::setBadChannels(const FiffInfo& info)
 
     m_lInterpolationData.fiffInfo = info;
 
-    //filtering of bad channels out of the distance table
-    GeometryInfo::filterBadChannels(m_lInterpolationData.matDistanceMatrix,
-                                    m_lInterpolationData.fiffInfo,
-                                    m_lInterpolationData.iSensorType);    
-
-    //set vecExcludeIndex
+    //set vecExcludeIndex, bad channels are skipped when creating the interpolation matrix
     m_lInterpolationData.vecExcludeIndex.clear();
     int iCounter = 0;
     for(const FiffChInfo &info : m_lInterpolationData.fiffInfo.chs) {
@@ -197,16 +192,11 @@ void RtSensorInterpolationMatWorker::calculateInterpolationOperator()
         return;
     }
 
-    //SCDC with cancel distance
-    m_lInterpolationData.matDistanceMatrix = GeometryInfo::scdc(m_lInterpolationData.matVertices,
-                                                                m_lInterpolationData.vecNeighborVertices,
-                                                                m_lInterpolationData.vecMappedSubset,
-                                                                m_lInterpolationData.dCancelDistance);
-
-    //filtering of bad channels out of the distance table
-    GeometryInfo::filterBadChannels(m_lInterpolationData.matDistanceMatrix,
-                                    m_lInterpolationData.fiffInfo,
-                                    m_lInterpolationData.iSensorType);
+    //SCDC with cancel distance, bounded and stored sparse
+    m_lInterpolationData.matDistanceMatrix = GeometryInfo::scdcSparse(m_lInterpolationData.matVertices,
+                                                                      m_lInterpolationData.vecNeighborVertices,
+                                                                      m_lInterpolationData.vecMappedSubset,
+                                                                      m_lInterpolationData.dCancelDistance);
 
     emitMatrix();
 }
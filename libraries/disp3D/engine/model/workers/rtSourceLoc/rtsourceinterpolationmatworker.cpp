@@ -82,7 +82,7 @@ RtSourceInterpolationMatWorker::RtSourceInterpolationMatWorker()
 {
     m_lInterpolationData.dCancelDistance = 0.05;
     m_lInterpolationData.interpolationFunction = DISP3DLIB::Interpolation::cubic;
-    m_lInterpolationData.matDistanceMatrix = QSharedPointer<MatrixXd>(new MatrixXd());
+    m_lInterpolationData.matDistanceMatrix = QSharedPointer<SparseMatrix<double, RowMajor> >(new SparseMatrix<double, RowMajor>());
 }
 
 
@@ -215,11 +215,11 @@ void RtSourceInterpolationMatWorker::calculateInterpolationOperator()
         return;
     }
 
-    //SCDC with cancel distance
-    m_lInterpolationData.matDistanceMatrix = GeometryInfo::scdc(m_lInterpolationData.matVertices,
-                                                                m_lInterpolationData.vecNeighborVertices,
-                                                                m_lInterpolationData.vecMappedSubset,
-                                                                m_lInterpolationData.dCancelDistance);
+    //SCDC with cancel distance, bounded and stored sparse
+    m_lInterpolationData.matDistanceMatrix = GeometryInfo::scdcSparse(m_lInterpolationData.matVertices,
+                                                                      m_lInterpolationData.vecNeighborVertices,
+                                                                      m_lInterpolationData.vecMappedSubset,
+                                                                      m_lInterpolationData.dCancelDistance);
 
     //create Interpolation matrix
     m_pMatInterpolationMat = Interpolation::createInterpolationMat(m_lInterpolationData.vecMappedSubset,
@@ -40,6 +40,7 @@
 //=============================================================================================================
 
 #include "geometryinfo.h"
+#include "vertexkdtree.h"
 
 #include <fiff/fiff_info.h>
 
@@ -51,6 +52,8 @@
 
 #include <cmath>
 #include <fstream>
+#include <functional>
+#include <queue>
 #include <set>
 
 
@@ -155,102 +158,84 @@ QSharedPointer<MatrixXd> GeometryInfo::scdc(const MatrixX3f &matVertices,
 
 //*************************************************************************************************************
 
-QVector<int> GeometryInfo::projectSensors(const MatrixX3f &matVertices,
-                                             const QVector<Vector3f> &vecSensorPositions)
+QSharedPointer<SparseMatrix<double, RowMajor> > GeometryInfo::scdcSparse(const MatrixX3f &matVertices,
+                                                                          const QVector<QVector<int> > &vecNeighborVertices,
+                                                                          QVector<int> &vecVertSubset,
+                                                                          double dCancelDist)
 {
-    QVector<int> vecOutputArray;
+    if(vecVertSubset.empty()) {
+        // caller passed an empty subset, need to fill in all vertex IDs
+        vecVertSubset.reserve(matVertices.rows());
+        for(qint32 id = 0; id < matVertices.rows(); ++id) {
+            vecVertSubset.push_back(id);
+        }
+    }
 
-    qint32 iCores = QThread::idealThreadCount();
-    if (iCores <= 0)
-    {
+    // convention: first dimension in distance table is "from", second dimension "to"
+    QSharedPointer<SparseMatrix<double, RowMajor> > returnMat = QSharedPointer<SparseMatrix<double, RowMajor> >::create(matVertices.rows(),
+                                                                                                                         vecVertSubset.size());
+
+    // distribute calculation on cores
+    int iCores = QThread::idealThreadCount();
+    if (iCores <= 0) {
         // assume that we have at least two available cores
         iCores = 2;
     }
 
-    const qint32 iSubArraySize = (ceil(double(vecSensorPositions.size()) / double(iCores)));
+    // start threads with their respective parts of the final subset, every thread collects its own triplets
+    qint32 iSubArraySize = (ceil(double(vecVertSubset.size()) / double(iCores)));
+    QVector<QFuture<QVector<Triplet<double> > > > vecThreads(iCores - 1);
+    qint32 iBegin = 0;
+    qint32 iEnd = iSubArraySize;
 
-    //small input size no threads needed
-    if(iSubArraySize <= 1)
-    {
-        vecOutputArray.append(nearestNeighbor(matVertices,
-                                              vecSensorPositions.constBegin(),
-                                              vecSensorPositions.constEnd()));
-        return vecOutputArray;
-    }
-    // split input array + thread start
-    QVector<QFuture<QVector<int> > > vecThreads(iCores - 1);
-    qint32 iBeginOffset = iSubArraySize;
-    qint32 iEndOffset = iBeginOffset + iSubArraySize;
-    for(qint32 i = 0; i < vecThreads.size(); ++i)
-    {
-        //last round
-        if(i == vecThreads.size() -1)
-        {
-            vecThreads[i] = QtConcurrent::run(nearestNeighbor,
-                                              matVertices,
-                                              vecSensorPositions.constBegin() + iBeginOffset,
-                                              vecSensorPositions.constEnd());
-            break;
-        }
-        else
-        {
-            vecThreads[i] = QtConcurrent::run(nearestNeighbor,
-                                              matVertices,
-                                              vecSensorPositions.constBegin() + iBeginOffset,
-                                              vecSensorPositions.constBegin() + iEndOffset);
-            iBeginOffset = iEndOffset;
-            iEndOffset += iSubArraySize;
-        }
+    for (int i = 0; i < vecThreads.size(); ++i) {
+        vecThreads[i] = QtConcurrent::run(std::bind(boundedDijkstra,
+                                                    std::cref(matVertices),
+                                                    std::cref(vecNeighborVertices),
+                                                    std::cref(vecVertSubset),
+                                                    qMin(iBegin, vecVertSubset.size()),
+                                                    qMin(iEnd, vecVertSubset.size()),
+                                                    dCancelDist));
+        iBegin += iSubArraySize;
+        iEnd += iSubArraySize;
     }
-    //calc while waiting for other threads
-    vecOutputArray.append(nearestNeighbor(matVertices,
-                                          vecSensorPositions.constBegin(),
-                                          vecSensorPositions.constBegin() + iSubArraySize));
 
-    //wait for threads to finish
-    for (QFuture<QVector<int> >& f : vecThreads) {
+    // use main thread to calculate last part of the final subset
+    QVector<Triplet<double> > vecTriplets = boundedDijkstra(matVertices,
+                                                            vecNeighborVertices,
+                                                            vecVertSubset,
+                                                            qMin(iBegin, vecVertSubset.size()),
+                                                            vecVertSubset.size(),
+                                                            dCancelDist);
+
+    // wait for all other threads to finish and gather their results
+    for (QFuture<QVector<Triplet<double> > >& f : vecThreads) {
         f.waitForFinished();
+        vecTriplets.append(f.result());
     }
 
-    //move sub arrays back into output
-    for(qint32 i = 0; i < vecThreads.size(); ++i)
-    {
-        vecOutputArray.append(std::move(vecThreads[i].result()));
-    }
+    // explicit zeros (the root vertices themselves) are kept by setFromTriplets
+    returnMat->setFromTriplets(vecTriplets.begin(), vecTriplets.end());
 
-    return vecOutputArray;
+    return returnMat;
 }
 
 
 //*************************************************************************************************************
 
-QVector<int> GeometryInfo::nearestNeighbor(const MatrixX3f &matVertices,
-                                              QVector<Vector3f>::const_iterator itSensorBegin,
-                                              QVector<Vector3f>::const_iterator itSensorEnd)
+QVector<int> GeometryInfo::projectSensors(const MatrixX3f &matVertices,
+                                             const QVector<Vector3f> &vecSensorPositions)
 {
-    ///lin search sensor positions
-    QVector<int> vecMappedSensors;
-    vecMappedSensors.reserve(std::distance(itSensorBegin, itSensorEnd));
-
-    for(auto sensor = itSensorBegin; sensor != itSensorEnd; ++sensor)
-    {
-        qint32 iChampionId;
-        double iChampDist = std::numeric_limits<double>::max();
-        for(qint32 i = 0; i < matVertices.rows(); ++i)
-        {
-            //calculate 3d euclidian distance
-            double dDist = sqrt(squared(matVertices(i, 0) - (*sensor)[0])  // x-cord
-                    + squared(matVertices(i, 1) - (*sensor)[1])    // y-cord
-                    + squared(matVertices(i, 2) - (*sensor)[2]));  // z-cord
-            if(dDist < iChampDist)
-            {
-                iChampionId = i;
-                iChampDist = dDist;
-            }
-        }
-        vecMappedSensors.push_back(iChampionId);
-    }
-    return vecMappedSensors;
+    return projectSensors(VertexKdTree(matVertices), vecSensorPositions);
+}
+
+
+//*************************************************************************************************************
+
+QVector<int> GeometryInfo::projectSensors(const VertexKdTree &vertexTree,
+                                             const QVector<Vector3f> &vecSensorPositions)
+{
+    return vertexTree.nearestNeighbors(vecSensorPositions);
 }
 
 
@@ -319,6 +304,75 @@ void GeometryInfo::iterativeDijkstra(QSharedPointer<MatrixXd> matOutputDistMatri
 }
 
 
+//*************************************************************************************************************
+
+QVector<Triplet<double> > GeometryInfo::boundedDijkstra(const MatrixX3f &matVertices,
+                                                        const QVector<QVector<int> > &vecNeighborVertices,
+                                                        const QVector<int> &vecVertSubset,
+                                                        qint32 iBegin,
+                                                        qint32 iEnd,
+                                                        double dCancelDistance)
+{
+    typedef std::pair<double, qint32> DistVertex;
+
+    // initialization, distances are reset only for the vertices touched by the previous root
+    const QVector<QVector<int> > &vecAdjacency = vecNeighborVertices;
+    QVector<double> vecMinDists(vecAdjacency.size(), FLOAT_INFINITY);
+    QVector<qint32> vecTouched;
+    std::priority_queue<DistVertex, std::vector<DistVertex>, std::greater<DistVertex> > vertexQ;
+    QVector<Triplet<double> > vecTriplets;
+
+    // outer loop, iterated for each vertex of 'vertSubset' between 'begin' and 'end'
+    for (qint32 i = iBegin; i < iEnd; ++i) {
+        for (qint32 t : vecTouched) {
+            vecMinDists[t] = FLOAT_INFINITY;
+        }
+        vecTouched.clear();
+
+        const qint32 iRoot = vecVertSubset.at(i);
+        vecMinDists[iRoot] = 0.0;
+        vecTouched.push_back(iRoot);
+        vertexQ.push(std::make_pair(0.0, iRoot));
+
+        // dijkstra main loop, vertices beyond the cancel distance never enter the queue
+        while (vertexQ.empty() == false) {
+            const double dDist = vertexQ.top().first;
+            const qint32 u = vertexQ.top().second;
+            vertexQ.pop();
+
+            // skip outdated queue entries (lazy decreaseKey)
+            if (dDist > vecMinDists[u]) {
+                continue;
+            }
+
+            vecTriplets.push_back(Triplet<double>(u, i, dDist));
+
+            // visit each neighbour of u
+            const QVector<int>& vecNeighbours = vecAdjacency[u];
+
+            for (qint32 ne = 0; ne < vecNeighbours.length(); ++ne) {
+                qint32 v = vecNeighbours[ne];
+
+                const double dDistX = matVertices(u, 0) - matVertices(v, 0);
+                const double dDistY = matVertices(u, 1) - matVertices(v, 1);
+                const double dDistZ = matVertices(u, 2) - matVertices(v, 2);
+                const double dDistWithU = dDist + sqrt(dDistX * dDistX + dDistY * dDistY + dDistZ * dDistZ);
+
+                if (dDistWithU <= dCancelDistance && dDistWithU < vecMinDists[v]) {
+                    if (vecMinDists[v] == FLOAT_INFINITY) {
+                        vecTouched.push_back(v);
+                    }
+                    vecMinDists[v] = dDistWithU;
+                    vertexQ.push(std::make_pair(dDistWithU, v));
+                }
+            }
+        }
+    }
+
+    return vecTriplets;
+}
+
+
 //*************************************************************************************************************
 
 QVector<int> GeometryInfo::filterBadChannels(QSharedPointer<Eigen::MatrixXd> matDistanceTable,
@@ -67,6 +67,7 @@
 //=============================================================================================================
 
 #include <Eigen/Core>
+#include <Eigen/SparseCore>
 
 
 //*************************************************************************************************************
@@ -94,6 +95,8 @@ namespace DISP3DLIB {
 // DISP3DLIB FORWARD DECLARATIONS
 //=============================================================================================================
 
+class VertexKdTree;
+
 
 //=============================================================================================================
 /**
@@ -135,10 +138,32 @@ public:
                                                 QVector<int> &pVecVertSubset,
                                                 double dCancelDist = FLOAT_INFINITY);
 
+    //=========================================================================================================
+    /**
+     * @brief scdcSparse                     Calculates surface constrained distances on a mesh, bounded by a cancel distance.
+     *
+     * Each Dijkstra run stops as soon as the next vertex in the queue lies beyond dCancelDist, so only the neighborhood
+     * of each subset vertex is explored. Only distances below or equal to dCancelDist are stored. Use this instead of scdc
+     * whenever a finite cancel distance is used, e.g. for the creation of interpolation matrices.
+     *
+     * @param[in] matVertices                The surface on which distances should be calculated.
+     * @param[in] vecNeighborVertices        The neighbor vertex information.
+     * @param[in/out] pVecVertSubset         The subset of IDs for which the distances should be calculated.
+     * @param[in] dCancelDist                Distances higher than this are not stored.
+     *
+     * @return                               A sparse row major (CSR) double matrix of size vertices x subset. Missing entries are out of reach.
+     */
+    static QSharedPointer<Eigen::SparseMatrix<double, Eigen::RowMajor> > scdcSparse(const Eigen::MatrixX3f &matVertices,
+                                                                                     const QVector<QVector<int> > &vecNeighborVertices,
+                                                                                     QVector<int> &pVecVertSubset,
+                                                                                     double dCancelDist);
+
     //=========================================================================================================
     /**
      * @brief                            Calculates the nearest neighbor (euclidian distance) vertex to each sensor
      *
+     * Builds a VertexKdTree over the vertices. Use the overload below when projecting repeatedly onto the same surface.
+     *
      * @param[in] matVertices            Holds all vertex information that is needed.
      * @param[in] vecSensorPositions     Each sensor postion in saved in an Eigen vector with x, y & z coord.
      *
@@ -147,6 +172,18 @@ public:
     static QVector<int> projectSensors(const Eigen::MatrixX3f &matVertices,
                                           const QVector<Eigen::Vector3f> &vecSensorPositions);
 
+    //=========================================================================================================
+    /**
+     * @brief                            Calculates the nearest neighbor (euclidian distance) vertex to each sensor
+     *
+     * @param[in] vertexTree             The spatial index, built once for the surface the sensors should be projected on.
+     * @param[in] vecSensorPositions     Each sensor postion in saved in an Eigen vector with x, y & z coord.
+     *
+     * @return                           Output vector where the vector index position represents the id of the sensor and the int in each cell is the vertex it is mapped to
+     */
+    static QVector<int> projectSensors(const VertexKdTree &vertexTree,
+                                          const QVector<Eigen::Vector3f> &vecSensorPositions);
+
     //=========================================================================================================
     /**
      * @brief filterBadChannels          Filters bad channels from distance table
@@ -172,20 +209,6 @@ protected:
      */
     static inline  double squared(double dBase);
 
-    //=========================================================================================================
-    /**
-     * @brief nearestNeighbor        Calculates the nearest vertex of an MNEmatVertices for each position between the two iterators
-     *
-     * @param[in] matVertices        The MNEmatVertices that holds the vertex information
-     * @param[in] itSensorBegin      The iterator that indicates the start of the wanted section of positions
-     * @param[in] itSensorEnd        The iterator that indicates the end of the wanted section of positions
-     *
-     * @return                       A vector of nearest vertex IDs that corresponds to the subvector between the two iterators
-     */
-    static QVector<int> nearestNeighbor(const Eigen::MatrixX3f &matVertices,
-                                           QVector<Eigen::Vector3f>::const_iterator itSensorBegin,
-                                           QVector<Eigen::Vector3f>::const_iterator itSensorEnd);
-
     //=========================================================================================================
     /**
      * @brief iterativeDijkstra     Calculates shortest distances on the mesh that is held by the MNEmatVertices for each vertex of the passed vector that lies between the two indices
@@ -205,6 +228,26 @@ protected:
                                   qint32 iBegin,
                                   qint32 iEnd,
                                   double dCancelDistance);
+
+    //=========================================================================================================
+    /**
+     * @brief boundedDijkstra       Calculates shortest distances up to a cancel distance for each vertex of the passed vector that lies between the two indices
+     *
+     * @param[in] matVertices           The surface on which distances should be calculated
+     * @param[in] vecNeighborVertices   The neighbor vertex information.
+     * @param[in] vecVertSubset         The subset of vertices
+     * @param[in] iBegin                Start index of distance calculation
+     * @param[in] iEnd                  End index of distance calculation, exclusive
+     * @param[in] dCancelDistance       Distance threshold: vertices that are further away from the respective root vertex are neither visited nor stored
+     *
+     * @return                          The reached distances as (vertex, subset index, distance) triplets
+     */
+    static QVector<Eigen::Triplet<double> > boundedDijkstra(const Eigen::MatrixX3f &matVertices,
+                                                            const QVector<QVector<int> > &vecNeighborVertices,
+                                                            const QVector<int> &vecVertSubset,
+                                                            qint32 iBegin,
+                                                            qint32 iEnd,
+                                                            double dCancelDistance);
 };
 
 
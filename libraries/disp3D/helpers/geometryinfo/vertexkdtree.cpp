@@ -0,0 +1,229 @@
+//=============================================================================================================
+/**
+ * @file     vertexkdtree.cpp
+ * @author   agent <agent@local>
+ * @version  dev
+ * @date     October, 2026
+ *
+ * @section  LICENSE
+ *
+ * Copyright (C) 2026, agent. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+ * the following conditions are met:
+ *     * Redistributions of source code must retain the above copyright notice, this list of conditions and the
+ *       following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+ *       the following disclaimer in the documentation and/or other materials provided with the distribution.
+ *     * Neither the name of MNE-CPP authors nor the names of its contributors may be used
+ *       to endorse or promote products derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+ * WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ * PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+ * INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ * NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ *
+ * @brief     VertexKdTree class definition.
+ *
+ */
+
+//*************************************************************************************************************
+//=============================================================================================================
+// INCLUDES
+//=============================================================================================================
+
+#include "vertexkdtree.h"
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// INCLUDES
+//=============================================================================================================
+
+#include <algorithm>
+#include <limits>
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// USED NAMESPACES
+//=============================================================================================================
+
+using namespace DISP3DLIB;
+using namespace Eigen;
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// DEFINE MEMBER METHODS
+//=============================================================================================================
+
+VertexKdTree::VertexKdTree()
+{
+}
+
+
+//*************************************************************************************************************
+
+VertexKdTree::VertexKdTree(const MatrixX3f &matVertices)
+{
+    build(matVertices);
+}
+
+
+//*************************************************************************************************************
+
+void VertexKdTree::build(const MatrixX3f &matVertices)
+{
+    const qint32 iNumVert = matVertices.rows();
+
+    m_vecIds.resize(iNumVert);
+    for(qint32 i = 0; i < iNumVert; ++i) {
+        m_vecIds[i] = i;
+    }
+    m_vecSplitAxis.fill(0, iNumVert);
+
+    buildRecursive(matVertices, 0, iNumVert);
+
+    // store positions in tree order for cache friendly queries
+    m_vecPoints.resize(iNumVert);
+    for(qint32 i = 0; i < iNumVert; ++i) {
+        m_vecPoints[i] = matVertices.row(m_vecIds[i]).transpose();
+    }
+}
+
+
+//*************************************************************************************************************
+
+bool VertexKdTree::isEmpty() const
+{
+    return m_vecIds.isEmpty();
+}
+
+
+//*************************************************************************************************************
+
+qint32 VertexKdTree::size() const
+{
+    return m_vecIds.size();
+}
+
+
+//*************************************************************************************************************
+
+qint32 VertexKdTree::nearestNeighbor(const Vector3f &vecPosition,
+                                     float *pSquaredDist) const
+{
+    if(isEmpty()) {
+        return -1;
+    }
+
+    qint32 iChampionPos = 0;
+    float fChampDist = std::numeric_limits<float>::max();
+
+    searchRecursive(vecPosition, 0, m_vecIds.size(), iChampionPos, fChampDist);
+
+    if(pSquaredDist) {
+        *pSquaredDist = fChampDist;
+    }
+
+    return m_vecIds[iChampionPos];
+}
+
+
+//*************************************************************************************************************
+
+QVector<int> VertexKdTree::nearestNeighbors(const QVector<Vector3f> &vecPositions) const
+{
+    QVector<int> vecMapped;
+    vecMapped.reserve(vecPositions.size());
+
+    for(const Vector3f &vecPosition : vecPositions) {
+        vecMapped.push_back(nearestNeighbor(vecPosition));
+    }
+
+    return vecMapped;
+}
+
+
+//*************************************************************************************************************
+
+void VertexKdTree::buildRecursive(const MatrixX3f &matVertices,
+                                  qint32 iBegin,
+                                  qint32 iEnd)
+{
+    if(iEnd - iBegin <= 1) {
+        return;
+    }
+
+    // split along the axis of largest extent
+    Vector3f vecMin = matVertices.row(m_vecIds[iBegin]).transpose();
+    Vector3f vecMax = vecMin;
+    for(qint32 i = iBegin + 1; i < iEnd; ++i) {
+        vecMin = vecMin.cwiseMin(matVertices.row(m_vecIds[i]).transpose());
+        vecMax = vecMax.cwiseMax(matVertices.row(m_vecIds[i]).transpose());
+    }
+
+    int iAxis = 0;
+    (vecMax - vecMin).maxCoeff(&iAxis);
+
+    const qint32 iMid = iBegin + (iEnd - iBegin) / 2;
+    std::nth_element(m_vecIds.begin() + iBegin,
+                     m_vecIds.begin() + iMid,
+                     m_vecIds.begin() + iEnd,
+                     [&matVertices, iAxis](qint32 a, qint32 b) {
+                         return matVertices(a, iAxis) < matVertices(b, iAxis);
+                     });
+    m_vecSplitAxis[iMid] = iAxis;
+
+    buildRecursive(matVertices, iBegin, iMid);
+    buildRecursive(matVertices, iMid + 1, iEnd);
+}
+
+
+//*************************************************************************************************************
+
+void VertexKdTree::searchRecursive(const Vector3f &vecPosition,
+                                   qint32 iBegin,
+                                   qint32 iEnd,
+                                   qint32 &iChampionPos,
+                                   float &fChampDist) const
+{
+    if(iBegin >= iEnd) {
+        return;
+    }
+
+    const qint32 iMid = iBegin + (iEnd - iBegin) / 2;
+    const float fDist = (m_vecPoints[iMid] - vecPosition).squaredNorm();
+
+    // prefer the lower vertex index on ties to match a linear search
+    if(fDist < fChampDist || (fDist == fChampDist && m_vecIds[iMid] < m_vecIds[iChampionPos])) {
+        iChampionPos = iMid;
+        fChampDist = fDist;
+    }
+
+    if(iEnd - iBegin == 1) {
+        return;
+    }
+
+    const int iAxis = m_vecSplitAxis[iMid];
+    const float fDiff = vecPosition[iAxis] - m_vecPoints[iMid][iAxis];
+
+    // descend into the side of the query first, visit the other side only if the splitting plane is closer than the champion
+    if(fDiff < 0.0f) {
+        searchRecursive(vecPosition, iBegin, iMid, iChampionPos, fChampDist);
+        if(fDiff * fDiff <= fChampDist) {
+            searchRecursive(vecPosition, iMid + 1, iEnd, iChampionPos, fChampDist);
+        }
+    } else {
+        searchRecursive(vecPosition, iMid + 1, iEnd, iChampionPos, fChampDist);
+        if(fDiff * fDiff <= fChampDist) {
+            searchRecursive(vecPosition, iBegin, iMid, iChampionPos, fChampDist);
+        }
+    }
+}
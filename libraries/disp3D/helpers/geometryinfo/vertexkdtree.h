@@ -0,0 +1,182 @@
+//=============================================================================================================
+/**
+ * @file     vertexkdtree.h
+ * @author   agent <agent@local>
+ * @version  dev
+ * @date     October, 2026
+ *
+ * @section  LICENSE
+ *
+ * Copyright (C) 2026, agent. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+ * the following conditions are met:
+ *     * Redistributions of source code must retain the above copyright notice, this list of conditions and the
+ *       following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+ *       the following disclaimer in the documentation and/or other materials provided with the distribution.
+ *     * Neither the name of MNE-CPP authors nor the names of its contributors may be used
+ *       to endorse or promote products derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+ * WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ * PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+ * INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ * NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ *
+ * @brief     VertexKdTree class declaration.
+ *
+ */
+
+#ifndef DISP3DLIB_VERTEXKDTREE_H
+#define DISP3DLIB_VERTEXKDTREE_H
+
+//*************************************************************************************************************
+//=============================================================================================================
+// INCLUDES
+//=============================================================================================================
+
+#include "../../disp3D_global.h"
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// QT INCLUDES
+//=============================================================================================================
+
+#include <QSharedPointer>
+#include <QVector>
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// Eigen INCLUDES
+//=============================================================================================================
+
+#include <Eigen/Core>
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// DEFINE NAMESPACE DISP3DLIB
+//=============================================================================================================
+
+namespace DISP3DLIB {
+
+
+//=============================================================================================================
+/**
+ * Spatial index over a set of vertices. The tree is built once per surface (O(n log n)) and answers closest vertex
+ * queries in O(log n) on average, e.g. for mapping sensors, digitizers or HPI coils onto a mesh after every head position update.
+ * The tree is stored implicitly: every range [begin, end) of the internal index array is a node whose splitting vertex sits at its median.
+ *
+ * @brief k-d tree for nearest vertex queries on 3D vertex sets
+ */
+class DISP3DSHARED_EXPORT VertexKdTree
+{
+
+public:
+    typedef QSharedPointer<VertexKdTree> SPtr;            /**< Shared pointer type for VertexKdTree. */
+    typedef QSharedPointer<const VertexKdTree> ConstSPtr; /**< Const shared pointer type for VertexKdTree. */
+
+    //=========================================================================================================
+    /**
+     * Default constructor, creates an empty tree.
+     */
+    VertexKdTree();
+
+    //=========================================================================================================
+    /**
+     * Constructs the tree from the passed vertices.
+     *
+     * @param[in] matVertices        The vertices (one per row) to be indexed.
+     */
+    explicit VertexKdTree(const Eigen::MatrixX3f &matVertices);
+
+    //=========================================================================================================
+    /**
+     * (Re)builds the tree from the passed vertices.
+     *
+     * @param[in] matVertices        The vertices (one per row) to be indexed.
+     */
+    void build(const Eigen::MatrixX3f &matVertices);
+
+    //=========================================================================================================
+    /**
+     * Returns whether the tree holds any vertices.
+     *
+     * @return true if no vertices are indexed, false otherwise.
+     */
+    bool isEmpty() const;
+
+    //=========================================================================================================
+    /**
+     * Returns the number of indexed vertices.
+     *
+     * @return The number of indexed vertices.
+     */
+    qint32 size() const;
+
+    //=========================================================================================================
+    /**
+     * Finds the closest (euclidian distance) vertex to the passed position.
+     *
+     * @param[in] vecPosition        The query position.
+     * @param[out] pSquaredDist      If not null, the squared distance to the closest vertex is stored here.
+     *
+     * @return The row index of the closest vertex, -1 if the tree is empty.
+     */
+    qint32 nearestNeighbor(const Eigen::Vector3f &vecPosition,
+                           float *pSquaredDist = Q_NULLPTR) const;
+
+    //=========================================================================================================
+    /**
+     * Finds the closest (euclidian distance) vertex to each of the passed positions.
+     *
+     * @param[in] vecPositions       The query positions.
+     *
+     * @return Vector where the index represents the position and the value the row index of its closest vertex.
+     */
+    QVector<int> nearestNeighbors(const QVector<Eigen::Vector3f> &vecPositions) const;
+
+private:
+    //=========================================================================================================
+    /**
+     * Recursively sorts the index range [iBegin, iEnd) so that its median splits the vertices along the axis of largest extent.
+     *
+     * @param[in] matVertices        The vertices to be indexed.
+     * @param[in] iBegin             Start of the index range.
+     * @param[in] iEnd               End of the index range, exclusive.
+     */
+    void buildRecursive(const Eigen::MatrixX3f &matVertices,
+                        qint32 iBegin,
+                        qint32 iEnd);
+
+    //=========================================================================================================
+    /**
+     * Recursively searches the node [iBegin, iEnd) for a vertex closer than the current champion.
+     *
+     * @param[in] vecPosition        The query position.
+     * @param[in] iBegin             Start of the index range.
+     * @param[in] iEnd               End of the index range, exclusive.
+     * @param[in, out] iChampionPos  Tree position of the closest vertex found so far.
+     * @param[in, out] fChampDist    Squared distance of the closest vertex found so far.
+     */
+    void searchRecursive(const Eigen::Vector3f &vecPosition,
+                         qint32 iBegin,
+                         qint32 iEnd,
+                         qint32 &iChampionPos,
+                         float &fChampDist) const;
+
+    QVector<Eigen::Vector3f>    m_vecPoints;        /**< The vertex positions in tree order. */
+    QVector<qint32>             m_vecIds;           /**< The original vertex row indices in tree order. */
+    QVector<qint8>              m_vecSplitAxis;     /**< The splitting axis of each node, stored at the position of its median. */
+};
+
+} // namespace DISP3DLIB
+
+#endif // DISP3DLIB_VERTEXKDTREE_H
@@ -46,6 +46,7 @@
 //=============================================================================================================
 
 #include <QSet>
+#include <QHash>
 #include <QDebug>
 
 
@@ -149,6 +150,78 @@ QSharedPointer<SparseMatrix<float> > Interpolation::createInterpolationMat(const
 }
 
 
+//*************************************************************************************************************
+
+QSharedPointer<SparseMatrix<float> > Interpolation::createInterpolationMat(const QVector<int> &vecProjectedSensors,
+                                                                           const QSharedPointer<SparseMatrix<double, RowMajor> > matDistanceTable,
+                                                                           double (*interpolationFunction) (double),
+                                                                           const double dCancelDist,
+                                                                           const QVector<int> &vecExcludeIndex)
+{
+    if(matDistanceTable->rows() == 0 && matDistanceTable->cols() == 0) {
+        qDebug() << "[WARNING] Interpolation::createInterpolationMat - received an empty distance table.";
+        return QSharedPointer<SparseMatrix<float> >::create();
+    }
+
+    // initialization
+    QSharedPointer<Eigen::SparseMatrix<float> > matInterpolationMatrix = QSharedPointer<SparseMatrix<float> >::create(matDistanceTable->rows(), vecProjectedSensors.size());
+
+    // temporary helper structure for filling sparse matrix
+    QVector<Triplet<float> > vecNonZeroEntries;
+    vecNonZeroEntries.reserve(matDistanceTable->nonZeros());
+    const qint32 iRows = matInterpolationMatrix->rows();
+
+    // flag excluded columns and map each sensor vertex to its (first) column for faster lookup during later computation
+    QVector<bool> vecExcluded(vecProjectedSensors.size(), false);
+    for(const qint32& idx : vecExcludeIndex){
+        if(idx >= 0 && idx < vecExcluded.size()) {
+            vecExcluded[idx] = true;
+        }
+    }
+
+    QHash<qint32, qint32> sensorLookup;
+    for(qint32 c = 0; c < vecProjectedSensors.size(); ++c){
+        if(!vecExcluded[c] && !sensorLookup.contains(vecProjectedSensors[c])){
+            sensorLookup.insert(vecProjectedSensors[c], c);
+        }
+    }
+
+    // main loop: go through the stored entries of each row of the distance table and calculate weights
+    for (qint32 r = 0; r < iRows; ++r) {
+        QHash<qint32, qint32>::const_iterator itSensor = sensorLookup.constFind(r);
+
+        if (itSensor == sensorLookup.constEnd()) {
+            // "normal" node, i.e. one which was not assigned a sensor
+            const qint32 iFirst = vecNonZeroEntries.size();
+            float dWeightsSum = 0.0;
+
+            for (SparseMatrix<double, RowMajor>::InnerIterator it(*matDistanceTable, r); it; ++it) {
+                const float dDist = it.value();
+
+                if (dDist < dCancelDist && !vecExcluded[it.col()]) {
+                    const float dValueWeight = std::fabs(1.0 / interpolationFunction(dDist));
+                    dWeightsSum += dValueWeight;
+                    vecNonZeroEntries.push_back(Eigen::Triplet<float> (r, it.col(), dValueWeight));
+                }
+            }
+
+            // normalize the weights of this row in place
+            for (qint32 i = iFirst; i < vecNonZeroEntries.size(); ++i) {
+                vecNonZeroEntries[i] = Eigen::Triplet<float> (r, vecNonZeroEntries[i].col(), vecNonZeroEntries[i].value() / dWeightsSum);
+            }
+        } else {
+            // a sensor has been assigned to this node, we do not need to interpolate anything
+            //(final vertex signal is equal to sensor input signal, thus factor 1)
+            vecNonZeroEntries.push_back(Eigen::Triplet<float> (r, itSensor.value(), 1));
+        }
+    }
+
+    matInterpolationMatrix->setFromTriplets(vecNonZeroEntries.begin(), vecNonZeroEntries.end());
+
+    return matInterpolationMatrix;
+}
+
+
 //*************************************************************************************************************
 
 VectorXf Interpolation::interpolateSignal(const QSharedPointer<SparseMatrix<float> > matInterpolationMatrix,
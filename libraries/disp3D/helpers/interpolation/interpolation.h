@@ -133,6 +133,27 @@ public:
                                                                               const double dCancelDist = FLOAT_INFINITY,
                                                                               const QVector<int> &vecExcludeIndex = QVector<int>());
 
+    //=========================================================================================================
+    /**
+     * Same as above, but consumes the sparse distance table produced by <i>GeometryInfo::scdcSparse</i>. Only the stored
+     * entries of each row are visited, entries that are not stored are treated as out of reach.
+     * Columns listed in vecExcludeIndex (e.g. bad channels) are neither used as interpolation sources nor as sensor vertices,
+     * so the distance table does not need to be filtered beforehand.
+     *
+     * @param[in] vecProjectedSensors           Vector of IDs of sensor vertices
+     * @param[in] matDistanceTable              Sparse row major matrix that contains all distances below the cancel distance
+     * @param[in] interpolationFunction         Function that computes interpolation coefficients using the distance values
+     * @param[in] dCancelDist                   Distances higher than this are ignored, i.e. the respective coefficients are set to zero
+     * @param[in] vecExcludeIndex               The indices to be excluded from vecProjectedSensors, e.g., bad channels (empty by default)
+     *
+     * @return                                  The distance matrix created
+     */
+    static QSharedPointer<Eigen::SparseMatrix<float> > createInterpolationMat(const QVector<int> &vecProjectedSensors,
+                                                                              const QSharedPointer<Eigen::SparseMatrix<double, Eigen::RowMajor> > matDistanceTable,
+                                                                              double (*interpolationFunction) (double),
+                                                                              const double dCancelDist = FLOAT_INFINITY,
+                                                                              const QVector<int> &vecExcludeIndex = QVector<int>());
+
     //=========================================================================================================
     /**
      * The interpolation essentially corresponds to a matrix * vector multiplication. A vector of sensor data (i.e. a vector of double-values)
@@ -0,0 +1,368 @@
+//=============================================================================================================
+/**
+ * @file     fiff_raw_block_reader.cpp
+ * @author   agent <agent@local>
+ * @version  dev
+ * @date     October, 2026
+ *
+ * @section  LICENSE
+ *
+ * Copyright (C) 2026, agent. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+ * the following conditions are met:
+ *     * Redistributions of source code must retain the above copyright notice, this list of conditions and the
+ *       following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+ *       the following disclaimer in the documentation and/or other materials provided with the distribution.
+ *     * Neither the name of MNE-CPP authors nor the names of its contributors may be used
+ *       to endorse or promote products derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+ * WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ * PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+ * INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ * NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ *
+ * @brief    FiffRawBlockReader class definition.
+ *
+ */
+
+//*************************************************************************************************************
+//=============================================================================================================
+// INCLUDES
+//=============================================================================================================
+
+#include "fiff_raw_block_reader.h"
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// Qt INCLUDES
+//=============================================================================================================
+
+#include <QtConcurrent>
+#include <QMutexLocker>
+#include <QDebug>
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// USED NAMESPACES
+//=============================================================================================================
+
+using namespace FIFFLIB;
+using namespace Eigen;
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// DEFINE MEMBER METHODS
+//=============================================================================================================
+
+FiffRawBlockReader::FiffRawBlockReader(const FiffRawData& p_FiffRawData,
+                                       fiff_int_t iBlockSize,
+                                       const RowVectorXi& sel,
+                                       int iPrefetchBlocks,
+                                       fiff_int_t from,
+                                       fiff_int_t to)
+: m_rawData(p_FiffRawData)
+, m_sel(sel)
+, m_iBlockSize(qMax(iBlockSize, 1))
+, m_iNextFrom(from == -1 ? p_FiffRawData.first_samp : qMax(from, p_FiffRawData.first_samp))
+, m_iTo(to == -1 ? p_FiffRawData.last_samp : qMin(to, p_FiffRawData.last_samp))
+, m_iPrefetchBlocks(qMax(iPrefetchBlocks, 1))
+, m_iRawDirCursor(0)
+, m_iCachedRawDir(-1)
+{
+    if(!m_rawData.file || !m_rawData.file->device()) {
+        qWarning() << "FiffRawBlockReader::FiffRawBlockReader - No file available.";
+        m_iNextFrom = m_iTo + 1;
+        return;
+    }
+
+    if(!m_rawData.file->device()->isOpen() && !m_rawData.file->device()->open(QIODevice::ReadOnly)) {
+        qWarning() << "FiffRawBlockReader::FiffRawBlockReader - Cannot open file" << m_rawData.info.filename;
+        m_iNextFrom = m_iTo + 1;
+        return;
+    }
+
+    //
+    //  The operators do not change while iterating, get them once
+    //
+    SparseMatrix<double> matCal;
+    m_rawData.get_operators(m_sel, matCal, m_matMult);
+    m_vecCal = matCal.diagonal();
+
+    scheduleBlocks();
+}
+
+
+//*************************************************************************************************************
+
+FiffRawBlockReader::~FiffRawBlockReader()
+{
+    discardBlocks();
+}
+
+
+//*************************************************************************************************************
+
+bool FiffRawBlockReader::hasNext() const
+{
+    return !m_qBlocks.isEmpty();
+}
+
+
+//*************************************************************************************************************
+
+bool FiffRawBlockReader::next(MatrixXd& data,
+                              MatrixXd& times)
+{
+    if(m_qBlocks.isEmpty()) {
+        return false;
+    }
+
+    QFuture<Block::SPtr> future = m_qBlocks.dequeue();
+
+    //
+    //  Keep the queue filled while the caller processes this block
+    //
+    scheduleBlocks();
+
+    Block::SPtr pBlock = future.result();
+
+    if(!pBlock || !pBlock->valid) {
+        return false;
+    }
+
+    data.swap(pBlock->data);
+    times.swap(pBlock->times);
+
+    return true;
+}
+
+
+//*************************************************************************************************************
+
+void FiffRawBlockReader::seek(fiff_int_t from)
+{
+    discardBlocks();
+
+    m_iNextFrom = qMax(from, m_rawData.first_samp);
+
+    scheduleBlocks();
+}
+
+
+//*************************************************************************************************************
+
+void FiffRawBlockReader::scheduleBlocks()
+{
+    while(m_qBlocks.size() < m_iPrefetchBlocks && m_iNextFrom <= m_iTo) {
+        fiff_int_t to = qMin(m_iNextFrom + m_iBlockSize - 1, m_iTo);
+
+        m_qBlocks.enqueue(QtConcurrent::run(this, &FiffRawBlockReader::readBlock, m_iNextFrom, to));
+
+        m_iNextFrom = to + 1;
+    }
+}
+
+
+//*************************************************************************************************************
+
+void FiffRawBlockReader::discardBlocks()
+{
+    while(!m_qBlocks.isEmpty()) {
+        m_qBlocks.dequeue().waitForFinished();
+    }
+}
+
+
+//*************************************************************************************************************
+
+FiffRawBlockReader::Block::SPtr FiffRawBlockReader::readBlock(fiff_int_t from,
+                                                               fiff_int_t to) const
+{
+    Block::SPtr pBlock = Block::SPtr(new Block);
+    pBlock->valid = true;
+
+    qint32 nchan = m_rawData.info.nchan;
+    qint32 nrows = m_sel.size() == 0 ? nchan : m_sel.size();
+    qint32 r;
+
+    pBlock->data.resize(nrows, to-from+1);
+
+    QSharedPointer<const MatrixXd> pBuffer;
+    qint32 k = findRawDir(from);
+    qint32 kLast = k;
+
+    for(; k < m_rawData.rawdir.size(); ++k) {
+        const FiffRawDir& rawDir = m_rawData.rawdir[k];
+
+        if(rawDir.first > to) {
+            break;
+        }
+
+        kLast = k;
+
+        //
+        //  Pick the part of the buffer which overlaps with the block
+        //
+        fiff_int_t firstPick = qMax(from, rawDir.first) - rawDir.first;
+        fiff_int_t picksamp = qMin(to, rawDir.last) - rawDir.first - firstPick + 1;
+        fiff_int_t dest = qMax(from, rawDir.first) - from;
+
+        if(picksamp <= 0) {
+            continue;
+        }
+
+        if(rawDir.ent->kind == -1) {
+            //
+            //  Skips are translated to zeros
+            //
+            pBlock->data.middleCols(dest, picksamp).setZero();
+            continue;
+        }
+
+        if(!readBuffer(k, pBuffer)) {
+            pBlock->valid = false;
+            return pBlock;
+        }
+
+        const MatrixXd& matBuffer = *pBuffer;
+
+        if(m_matMult.cols() == 0) {
+            if(m_sel.size() == 0) {
+                pBlock->data.middleCols(dest, picksamp) = m_vecCal.asDiagonal() * matBuffer.middleCols(firstPick, picksamp);
+            } else {
+                for(r = 0; r < m_sel.size(); ++r) {
+                    pBlock->data.row(r).segment(dest, picksamp) = m_vecCal[r] * matBuffer.row(m_sel[r]).segment(firstPick, picksamp);
+                }
+            }
+        } else {
+            pBlock->data.middleCols(dest, picksamp) = m_matMult * matBuffer.middleCols(firstPick, picksamp);
+        }
+    }
+
+    {
+        QMutexLocker locker(&m_mutexCache);
+        m_iRawDirCursor = kLast;
+    }
+
+    pBlock->times.resize(1, to-from+1);
+
+    for(qint32 i = 0; i < pBlock->times.cols(); ++i) {
+        pBlock->times(0, i) = ((float)(from+i)) / m_rawData.info.sfreq;
+    }
+
+    return pBlock;
+}
+
+
+//*************************************************************************************************************
+
+qint32 FiffRawBlockReader::findRawDir(fiff_int_t from) const
+{
+    const QList<FiffRawDir>& rawdir = m_rawData.rawdir;
+
+    qint32 k;
+    {
+        QMutexLocker locker(&m_mutexCache);
+        k = qBound(0, m_iRawDirCursor, qMax(rawdir.size() - 1, 0));
+    }
+
+    //
+    //  Blocks run concurrently and may finish out of order, walk in whichever direction is needed
+    //
+    while(k > 0 && rawdir[k-1].last >= from) {
+        --k;
+    }
+
+    while(k < rawdir.size() && rawdir[k].last < from) {
+        ++k;
+    }
+
+    return k;
+}
+
+
+//*************************************************************************************************************
+
+bool FiffRawBlockReader::readBuffer(qint32 iRawDir,
+                                    QSharedPointer<const MatrixXd>& pBuffer) const
+{
+    {
+        QMutexLocker locker(&m_mutexCache);
+
+        if(m_iCachedRawDir == iRawDir && m_pCachedBuffer) {
+            pBuffer = m_pCachedBuffer;
+            return true;
+        }
+    }
+
+    const FiffRawDir& rawDir = m_rawData.rawdir[iRawDir];
+
+    QSharedPointer<MatrixXd> pMatBuffer(new MatrixXd(m_rawData.info.nchan, rawDir.nsamp));
+
+    const uchar* pData = NULL;
+    QByteArray baData;
+
+    {
+        QMutexLocker locker(&m_mutexIO);
+
+        if(m_rawData.isMemoryMapped()) {
+            pData = m_rawData.map_raw_buffer(rawDir);
+        }
+
+        if(!pData) {
+            //
+            //  The data are located after the tag info (kind, type, size, next)
+            //
+            QIODevice* pDevice = m_rawData.file->device();
+
+            if(!pDevice->seek(static_cast<qint64>(rawDir.ent->pos) + 4*sizeof(fiff_int_t))) {
+                qWarning() << "FiffRawBlockReader::readBuffer - Could not seek to buffer at" << rawDir.ent->pos;
+                return false;
+            }
+
+            baData = pDevice->read(rawDir.ent->size);
+
+            if(baData.size() != rawDir.ent->size) {
+                qWarning() << "FiffRawBlockReader::readBuffer - Could not read buffer at" << rawDir.ent->pos;
+                return false;
+            }
+        }
+    }
+
+    //
+    //  Decoding is done outside of the lock
+    //
+    bool bSuccess = FiffRawData::decode_raw_buffer(pData ? pData : reinterpret_cast<const uchar*>(baData.constData()),
+                                                   rawDir.ent->type,
+                                                   rawDir.ent->size,
+                                                   *pMatBuffer);
+
+    if(pData) {
+        QMutexLocker locker(&m_mutexIO);
+        m_rawData.unmap_raw_buffer(pData);
+    }
+
+    if(!bSuccess) {
+        return false;
+    }
+
+    pBuffer = pMatBuffer;
+
+    {
+        QMutexLocker locker(&m_mutexCache);
+        m_iCachedRawDir = iRawDir;
+        m_pCachedBuffer = pBuffer;
+    }
+
+    return true;
+}
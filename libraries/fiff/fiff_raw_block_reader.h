@@ -0,0 +1,233 @@
+//=============================================================================================================
+/**
+ * @file     fiff_raw_block_reader.h
+ * @author   agent <agent@local>
+ * @version  dev
+ * @date     October, 2026
+ *
+ * @section  LICENSE
+ *
+ * Copyright (C) 2026, agent. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+ * the following conditions are met:
+ *     * Redistributions of source code must retain the above copyright notice, this list of conditions and the
+ *       following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+ *       the following disclaimer in the documentation and/or other materials provided with the distribution.
+ *     * Neither the name of MNE-CPP authors nor the names of its contributors may be used
+ *       to endorse or promote products derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+ * WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ * PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+ * INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ * NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ *
+ * @brief    FiffRawBlockReader class declaration.
+ *
+ */
+
+#ifndef FIFF_RAW_BLOCK_READER_H
+#define FIFF_RAW_BLOCK_READER_H
+
+//*************************************************************************************************************
+//=============================================================================================================
+// INCLUDES
+//=============================================================================================================
+
+#include "fiff_global.h"
+#include "fiff_raw_data.h"
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// Eigen INCLUDES
+//=============================================================================================================
+
+#include <Eigen/Core>
+#include <Eigen/SparseCore>
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// Qt INCLUDES
+//=============================================================================================================
+
+#include <QFuture>
+#include <QMutex>
+#include <QQueue>
+#include <QSharedPointer>
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// DEFINE NAMESPACE FIFFLIB
+//=============================================================================================================
+
+namespace FIFFLIB
+{
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// USED NAMESPACES
+//=============================================================================================================
+
+using namespace Eigen;
+
+
+//=============================================================================================================
+/**
+ * Iterates over a raw data recording in fixed size, calibrated blocks. The blocks following the current one are
+ * read and decoded (byte order, dau16/int/float conversion, calibration, projection and compensation) on the global
+ * thread pool while the caller processes the current block. The number of blocks in flight is bounded.
+ *
+ * File access is serialized internally. The file of the raw data must not be read by others while the reader is
+ * active.
+ *
+ * @brief Prefetching block reader for FIFF raw data
+ */
+class FIFFSHARED_EXPORT FiffRawBlockReader
+{
+public:
+    typedef QSharedPointer<FiffRawBlockReader> SPtr;               /**< Shared pointer type for FiffRawBlockReader. */
+    typedef QSharedPointer<const FiffRawBlockReader> ConstSPtr;    /**< Const shared pointer type for FiffRawBlockReader. */
+
+    //=========================================================================================================
+    /**
+     * Constructs a block reader and starts prefetching the first blocks.
+     *
+     * @param[in] p_FiffRawData      The raw data to iterate over.
+     * @param[in] iBlockSize         The number of samples per block. The last block may be shorter.
+     * @param[in] sel                Channel selection vector (optional).
+     * @param[in] iPrefetchBlocks    The maximum number of blocks which are read ahead (optional).
+     * @param[in] from               First sample to include. Defaults to the first sample in data (optional).
+     * @param[in] to                 Last sample to include. Defaults to the last sample in data (optional).
+     */
+    FiffRawBlockReader(const FiffRawData& p_FiffRawData,
+                       fiff_int_t iBlockSize,
+                       const RowVectorXi& sel = defaultRowVectorXi,
+                       int iPrefetchBlocks = 2,
+                       fiff_int_t from = -1,
+                       fiff_int_t to = -1);
+
+    //=========================================================================================================
+    /**
+     * Destroys the block reader. Waits for all blocks which are still being read.
+     */
+    ~FiffRawBlockReader();
+
+    //=========================================================================================================
+    /**
+     * Returns whether there are blocks left to read.
+     *
+     * @return true if there are blocks left, false otherwise.
+     */
+    bool hasNext() const;
+
+    //=========================================================================================================
+    /**
+     * Returns the next block. Blocks until the block is available and schedules the next block to be read ahead.
+     *
+     * @param[out] data      The calibrated data of the block (channels x samples).
+     * @param[out] times     The time values corresponding to the samples.
+     *
+     * @return true if a block was returned, false if there are no blocks left or the block could not be read.
+     */
+    bool next(MatrixXd& data,
+              MatrixXd& times);
+
+    //=========================================================================================================
+    /**
+     * Discards all prefetched blocks and restarts reading at the given sample.
+     *
+     * @param[in] from   The first sample of the next block.
+     */
+    void seek(fiff_int_t from);
+
+private:
+    //=========================================================================================================
+    /**
+     * A block which was read ahead.
+     */
+    struct Block {
+        typedef QSharedPointer<Block> SPtr;     /**< Shared pointer type for Block. */
+
+        bool        valid;      /**< Whether the block was read successfully. */
+        MatrixXd    data;       /**< The calibrated data (channels x samples). */
+        MatrixXd    times;      /**< The time values corresponding to the samples. */
+    };
+
+    //=========================================================================================================
+    /**
+     * Schedules blocks to be read until the prefetch queue is full or all blocks were scheduled.
+     */
+    void scheduleBlocks();
+
+    //=========================================================================================================
+    /**
+     * Waits for and discards all scheduled blocks.
+     */
+    void discardBlocks();
+
+    //=========================================================================================================
+    /**
+     * Reads and decodes the given segment. This is run on the thread pool.
+     *
+     * @param[in] from   First sample of the block.
+     * @param[in] to     Last sample of the block.
+     *
+     * @return the block.
+     */
+    Block::SPtr readBlock(fiff_int_t from,
+                          fiff_int_t to) const;
+
+    //=========================================================================================================
+    /**
+     * Finds the first raw directory entry which ends at or after the given sample. The search starts at the entry
+     * the last block ended in, since consecutive blocks continue in the same or the following buffer.
+     *
+     * @param[in] from   The sample to look for.
+     *
+     * @return the index of the raw directory entry, or the number of entries if the sample is past the data.
+     */
+    qint32 findRawDir(fiff_int_t from) const;
+
+    //=========================================================================================================
+    /**
+     * Reads and decodes a single raw data buffer. File access is serialized, decoding is done in parallel. The last
+     * decoded buffer is kept, so blocks which share a buffer read and decode it only once.
+     *
+     * @param[in] iRawDir        The index of the raw directory entry of the buffer.
+     * @param[out] pBuffer       The decoded, uncalibrated buffer (channels x samples).
+     *
+     * @return true if succeeded, false otherwise.
+     */
+    bool readBuffer(qint32 iRawDir,
+                    QSharedPointer<const MatrixXd>& pBuffer) const;
+
+    FiffRawData                 m_rawData;          /**< The raw data to iterate over. */
+    RowVectorXi                 m_sel;              /**< The channel selection. */
+    SparseMatrix<double>        m_matMult;          /**< The combined projection, compensation and calibration operator. */
+    VectorXd                    m_vecCal;           /**< The calibration values of the selected channels. */
+    fiff_int_t                  m_iBlockSize;       /**< The number of samples per block. */
+    fiff_int_t                  m_iNextFrom;        /**< The first sample of the next block to be scheduled. */
+    fiff_int_t                  m_iTo;              /**< The last sample to read. */
+    int                         m_iPrefetchBlocks;  /**< The maximum number of blocks in flight. */
+    QQueue<QFuture<Block::SPtr> > m_qBlocks;        /**< The scheduled blocks in order. */
+    mutable QMutex              m_mutexIO;          /**< Serializes the file access of the worker threads. */
+
+    mutable QMutex              m_mutexCache;       /**< Guards the raw directory cursor and the buffer cache. */
+    mutable qint32              m_iRawDirCursor;    /**< The raw directory entry the last block ended in. */
+    mutable qint32              m_iCachedRawDir;    /**< The raw directory entry of the cached buffer, -1 if none. */
+    mutable QSharedPointer<const MatrixXd> m_pCachedBuffer;  /**< The last decoded buffer. */
+};
+
+} // NAMESPACE
+
+#endif // FIFF_RAW_BLOCK_READER_H
@@ -44,6 +44,25 @@
 #include "fiff_stream.h"
 #include "cstdlib"
 
+
+//*************************************************************************************************************
+//=============================================================================================================
+// Qt INCLUDES
+//=============================================================================================================
+
+#include <QFileDevice>
+#include <QMutexLocker>
+#include <QtEndian>
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// DEFINES
+//=============================================================================================================
+
+#define FIFF_RAW_MAP_WINDOW_SIZE (64*1024*1024)     /**< Maximal size of a memory mapped window of raw data buffers in bytes. */
+
+
 //*************************************************************************************************************
 //=============================================================================================================
 // USED NAMESPACES
@@ -52,6 +71,44 @@
 using namespace FIFFLIB;
 
 
+//*************************************************************************************************************
+//=============================================================================================================
+// STATIC HELPERS
+//=============================================================================================================
+
+namespace {
+
+template<typename T>
+inline T readBigEndian(const uchar* p_pData)
+{
+    return qFromBigEndian<T>(p_pData);
+}
+
+template<>
+inline float readBigEndian<float>(const uchar* p_pData)
+{
+    quint32 iValue = qFromBigEndian<quint32>(p_pData);
+    float fValue;
+    memcpy(&fValue, &iValue, sizeof(float));
+    return fValue;
+}
+
+//=============================================================================================================
+
+template<typename T>
+void decodeBigEndian(const uchar* p_pData, MatrixXd& p_matBuffer)
+{
+    const qint64 iSize = p_matBuffer.size();
+    double* pOut = p_matBuffer.data();
+
+    for(qint64 i = 0; i < iSize; ++i) {
+        pOut[i] = static_cast<double>(readBigEndian<T>(p_pData + i*sizeof(T)));
+    }
+}
+
+} // NAMESPACE
+
+
 //*************************************************************************************************************
 //=============================================================================================================
 // DEFINE MEMBER METHODS
@@ -60,6 +117,8 @@ using namespace FIFFLIB;
 FiffRawData::FiffRawData()
 : first_samp(-1)
 , last_samp(-1)
+, m_bMemoryMapped(false)
+, m_pOperatorCache(new OperatorCache)
 {
 
 }
@@ -70,6 +129,8 @@ FiffRawData::FiffRawData()
 FiffRawData::FiffRawData(QIODevice &p_IODevice)
 : first_samp(-1)
 , last_samp(-1)
+, m_bMemoryMapped(false)
+, m_pOperatorCache(new OperatorCache)
 {
     //setup FiffRawData object
     if(!FiffStream::setup_read_raw(p_IODevice, *this))
@@ -92,6 +153,8 @@ FiffRawData::FiffRawData(const FiffRawData &p_FiffRawData)
 , rawdir(p_FiffRawData.rawdir)
 , proj(p_FiffRawData.proj)
 , comp(p_FiffRawData.comp)
+, m_bMemoryMapped(p_FiffRawData.m_bMemoryMapped)
+, m_pOperatorCache(p_FiffRawData.m_pOperatorCache)
 {
 
 }
@@ -128,11 +191,8 @@ bool FiffRawData::read_raw_segment(MatrixXd& data,
                                    const RowVectorXi& sel,
                                    bool do_debug) const
 {
-    bool projAvailable = true;
-
     if (this->proj.size() == 0) {
         qDebug() << "FiffRawData::read_raw_segment - No projectors setup. Consider calling MNE::setup_compensators.";
-        projAvailable = false;
     }
 
     if(from == -1)
@@ -160,91 +220,17 @@ bool FiffRawData::read_raw_segment(MatrixXd& data,
     qint32 dest  = 0;//1;
     qint32 i, k, r;
 
-    typedef Eigen::Triplet<double> T;
-    std::vector<T> tripletList;
-    tripletList.reserve(nchan);
-    for(i = 0; i < nchan; ++i)
-        tripletList.push_back(T(i, i, this->cals[i]));
-
-    SparseMatrix<double> cal(nchan, nchan);
-    cal.setFromTriplets(tripletList.begin(), tripletList.end());
-//    cal.makeCompressed();
-
-    MatrixXd mult_full;
     //
+    //  Get the calibration and the combined projection, compensation and calibration operator.
+    //  These are cached and only recomputed if proj, comp, cals or sel changed.
+    //
+    SparseMatrix<double> cal, mult;
+    get_operators(sel, cal, mult);
+
     if (sel.size() == 0)
-    {
         data = MatrixXd(nchan, to-from+1);
-//            data->setZero();
-        if (projAvailable || this->comp.kind != -1)
-        {
-            if (!projAvailable)
-                mult_full = this->comp.data->data*cal;
-            else if (this->comp.kind == -1)
-                mult_full = this->proj*cal;
-            else
-                mult_full = this->proj*this->comp.data->data*cal;
-        }
-    }
     else
-    {
         data = MatrixXd(sel.size(),to-from+1);
-//            data->setZero();
-
-        MatrixXd selVect(sel.size(), nchan);
-
-        selVect.setZero();
-
-        if (!projAvailable && this->comp.kind == -1)
-        {
-            tripletList.clear();
-            tripletList.reserve(sel.size());
-            for(i = 0; i < sel.size(); ++i)
-                tripletList.push_back(T(i, i, this->cals[sel[i]]));
-            cal = SparseMatrix<double>(sel.size(), sel.size());
-            cal.setFromTriplets(tripletList.begin(), tripletList.end());
-        }
-        else
-        {
-            if (!projAvailable)
-            {
-                qDebug() << "This has to be debugged! #1";
-                for( i = 0; i  < sel.size(); ++i)
-                    selVect.row(i) = this->comp.data->data.block(sel[i],0,1,nchan);
-                mult_full = selVect*cal;
-            }
-            else if (this->comp.kind == -1)
-            {
-                for( i = 0; i  < sel.size(); ++i)
-                    selVect.row(i) = this->proj.block(sel[i],0,1,nchan);
-
-                mult_full = selVect*cal;
-            }
-            else
-            {
-                qDebug() << "This has to be debugged! #3";
-                for( i = 0; i  < sel.size(); ++i)
-                    selVect.row(i) = this->proj.block(sel[i],0,1,nchan);
-
-                mult_full = selVect*this->comp.data->data*cal;
-            }
-        }
-    }
-
-    //
-    // Make mult sparse
-    //
-    tripletList.clear();
-    tripletList.reserve(mult_full.rows()*mult_full.cols());
-    for(i = 0; i < mult_full.rows(); ++i)
-        for(k = 0; k < mult_full.cols(); ++k)
-            if(mult_full(i,k) != 0)
-                tripletList.push_back(T(i, k, mult_full(i,k)));
-
-    SparseMatrix<double> mult(mult_full.rows(),mult_full.cols());
-    if(tripletList.size() > 0)
-        mult.setFromTriplets(tripletList.begin(), tripletList.end());
-//    mult.makeCompressed();
 
     //
 
@@ -262,7 +248,8 @@ bool FiffRawData::read_raw_segment(MatrixXd& data,
         fid = this->file;
     }
 
-    MatrixXd one;
+    MatrixXd one, matRawBuffer;
+    MappedWindow window;
     fiff_int_t first_pick, last_pick, picksamp;
     for(k = 0; k < this->rawdir.size(); ++k)
     {
@@ -286,6 +273,32 @@ bool FiffRawData::read_raw_segment(MatrixXd& data,
 
                 one.setZero();
             }
+            else if (m_bMemoryMapped && read_raw_buffer_mapped(k, to, window, matRawBuffer))
+            {
+                //
+                //   The buffer was decoded straight from the file pages
+                //
+                if (mult.cols() == 0)
+                {
+                    if (sel.cols() == 0)
+                    {
+                        one = cal*matRawBuffer;
+                    }
+                    else
+                    {
+                        MatrixXd newData(sel.cols(), thisRawDir.nsamp);
+
+                        for(r = 0; r < sel.size(); ++r)
+                            newData.row(r) = matRawBuffer.row(sel[r]);
+
+                        one = cal*newData;
+                    }
+                }
+                else
+                {
+                    one = mult*matRawBuffer;
+                }
+            }
             else
             {
                 FiffTag::SPtr t_pTag;
@@ -441,6 +454,8 @@ bool FiffRawData::read_raw_segment(MatrixXd& data,
         }
     }
 
+    unmap_window(window);
+
 //        fclose(fid);
 
     times = MatrixXd(1, to-from+1);
@@ -462,11 +477,8 @@ bool FiffRawData::read_raw_segment(MatrixXd& data,
                                    const RowVectorXi& sel,
                                    bool do_debug) const
 {
-    bool projAvailable = true;
-
     if (this->proj.size() == 0) {
         qDebug() << "FiffRawData::read_raw_segment - No projectors setup. Consider calling MNE::setup_compensators.";
-        projAvailable = false;
     }
 
     if(from == -1)
@@ -494,91 +506,17 @@ bool FiffRawData::read_raw_segment(MatrixXd& data,
     qint32 dest  = 0;//1;
     qint32 i, k, r;
 
-    typedef Eigen::Triplet<double> T;
-    std::vector<T> tripletList;
-    tripletList.reserve(nchan);
-    for(i = 0; i < nchan; ++i)
-        tripletList.push_back(T(i, i, this->cals[i]));
-
-    SparseMatrix<double> cal(nchan, nchan);
-    cal.setFromTriplets(tripletList.begin(), tripletList.end());
-//    cal.makeCompressed();
-
-    MatrixXd mult_full;
     //
+    //  Get the calibration and the combined projection, compensation and calibration operator.
+    //  These are cached and only recomputed if proj, comp, cals or sel changed.
+    //
+    SparseMatrix<double> cal, mult;
+    get_operators(sel, cal, mult);
+
     if (sel.size() == 0)
-    {
         data = MatrixXd(nchan, to-from+1);
-//            data->setZero();
-        if (projAvailable || this->comp.kind != -1)
-        {
-            if (!projAvailable)
-                mult_full = this->comp.data->data*cal;
-            else if (this->comp.kind == -1)
-                mult_full = this->proj*cal;
-            else
-                mult_full = this->proj*this->comp.data->data*cal;
-        }
-    }
     else
-    {
         data = MatrixXd(sel.size(),to-from+1);
-//            data->setZero();
-
-        MatrixXd selVect(sel.size(), nchan);
-
-        selVect.setZero();
-
-        if (!projAvailable && this->comp.kind == -1)
-        {
-            tripletList.clear();
-            tripletList.reserve(sel.size());
-            for(i = 0; i < sel.size(); ++i)
-                tripletList.push_back(T(i, i, this->cals[sel[i]]));
-            cal = SparseMatrix<double>(sel.size(), sel.size());
-            cal.setFromTriplets(tripletList.begin(), tripletList.end());
-        }
-        else
-        {
-            if (!projAvailable)
-            {
-                qDebug() << "This has to be debugged! #1";
-                for( i = 0; i  < sel.size(); ++i)
-                    selVect.row(i) = this->comp.data->data.block(sel[i],0,1,nchan);
-                mult_full = selVect*cal;
-            }
-            else if (this->comp.kind == -1)
-            {
-                for( i = 0; i  < sel.size(); ++i)
-                    selVect.row(i) = this->proj.block(sel[i],0,1,nchan);
-
-                mult_full = selVect*cal;
-            }
-            else
-            {
-                qDebug() << "This has to be debugged! #3";
-                for( i = 0; i  < sel.size(); ++i)
-                    selVect.row(i) = this->proj.block(sel[i],0,1,nchan);
-
-                mult_full = selVect*this->comp.data->data*cal;
-            }
-        }
-    }
-
-    //
-    // Make mult sparse
-    //
-    tripletList.clear();
-    tripletList.reserve(mult_full.rows()*mult_full.cols());
-    for(i = 0; i < mult_full.rows(); ++i)
-        for(k = 0; k < mult_full.cols(); ++k)
-            if(mult_full(i,k) != 0)
-                tripletList.push_back(T(i, k, mult_full(i,k)));
-
-    SparseMatrix<double> mult(mult_full.rows(),mult_full.cols());
-    if(tripletList.size() > 0)
-        mult.setFromTriplets(tripletList.begin(), tripletList.end());
-//    mult.makeCompressed();
 
     //
 
@@ -596,7 +534,8 @@ bool FiffRawData::read_raw_segment(MatrixXd& data,
         fid = this->file;
     }
 
-    MatrixXd one;
+    MatrixXd one, matRawBuffer;
+    MappedWindow window;
     fiff_int_t first_pick, last_pick, picksamp;
     for(k = 0; k < this->rawdir.size(); ++k)
     {
@@ -620,6 +559,32 @@ bool FiffRawData::read_raw_segment(MatrixXd& data,
 
                 one.setZero();
             }
+            else if (m_bMemoryMapped && read_raw_buffer_mapped(k, to, window, matRawBuffer))
+            {
+                //
+                //   The buffer was decoded straight from the file pages
+                //
+                if (mult.cols() == 0)
+                {
+                    if (sel.cols() == 0)
+                    {
+                        one = cal*matRawBuffer;
+                    }
+                    else
+                    {
+                        MatrixXd newData(sel.cols(), thisRawDir.nsamp);
+
+                        for(r = 0; r < sel.size(); ++r)
+                            newData.row(r) = matRawBuffer.row(sel[r]);
+
+                        one = cal*newData;
+                    }
+                }
+                else
+                {
+                    one = mult*matRawBuffer;
+                }
+            }
             else
             {
                 FiffTag::SPtr t_pTag;
@@ -775,6 +740,8 @@ bool FiffRawData::read_raw_segment(MatrixXd& data,
         }
     }
 
+    unmap_window(window);
+
     if(mult.cols()==0)
         multSegment = cal;
     else
@@ -808,3 +775,343 @@ bool FiffRawData::read_raw_segment_times(MatrixXd& data,
     //
     return this->read_raw_segment(data, times, (qint32)from, (qint32)to, sel);
 }
+
+
+//*************************************************************************************************************
+
+void FiffRawData::setMemoryMapped(bool bMemoryMapped)
+{
+    m_bMemoryMapped = bMemoryMapped;
+}
+
+
+//*************************************************************************************************************
+
+bool FiffRawData::isMemoryMapped() const
+{
+    return m_bMemoryMapped;
+}
+
+
+//*************************************************************************************************************
+
+const uchar* FiffRawData::map_raw_buffer(const FiffRawDir& p_RawDir) const
+{
+    if(!this->file || !p_RawDir.ent || p_RawDir.ent->kind == -1 || p_RawDir.ent->size <= 0) {
+        return NULL;
+    }
+
+    QFileDevice* pFileDevice = qobject_cast<QFileDevice*>(this->file->device());
+
+    if(!pFileDevice) {
+        return NULL;
+    }
+
+    if(!pFileDevice->isOpen() && !pFileDevice->open(QIODevice::ReadOnly)) {
+        printf("Cannot open file %s",this->info.filename.toUtf8().constData());
+        return NULL;
+    }
+
+    //
+    //   The data are located after the tag info (kind, type, size, next)
+    //
+    return pFileDevice->map(static_cast<qint64>(p_RawDir.ent->pos) + 4*sizeof(fiff_int_t),
+                            static_cast<qint64>(p_RawDir.ent->size));
+}
+
+
+//*************************************************************************************************************
+
+bool FiffRawData::unmap_raw_buffer(const uchar* p_pData) const
+{
+    if(!this->file || !p_pData) {
+        return false;
+    }
+
+    QFileDevice* pFileDevice = qobject_cast<QFileDevice*>(this->file->device());
+
+    if(!pFileDevice) {
+        return false;
+    }
+
+    return pFileDevice->unmap(const_cast<uchar*>(p_pData));
+}
+
+
+//*************************************************************************************************************
+
+bool FiffRawData::read_raw_buffer_mapped(const FiffRawDir& p_RawDir,
+                                         MatrixXd& p_matBuffer) const
+{
+    if(!p_RawDir.ent) {
+        return false;
+    }
+
+    qint32 nchan = this->info.nchan;
+
+    if(p_matBuffer.rows() != nchan || p_matBuffer.cols() != p_RawDir.nsamp) {
+        p_matBuffer.resize(nchan, p_RawDir.nsamp);
+    }
+
+    //
+    //  Skips are translated to zeros
+    //
+    if(p_RawDir.ent->kind == -1) {
+        p_matBuffer.setZero();
+        return true;
+    }
+
+    const uchar* pData = map_raw_buffer(p_RawDir);
+
+    if(!pData) {
+        return false;
+    }
+
+    bool bSuccess = decode_raw_buffer(pData, p_RawDir.ent->type, p_RawDir.ent->size, p_matBuffer);
+
+    unmap_raw_buffer(pData);
+
+    return bSuccess;
+}
+
+
+//*************************************************************************************************************
+
+bool FiffRawData::read_raw_buffer_mapped(int p_iBuffer,
+                                         fiff_int_t p_iTo,
+                                         MappedWindow& p_window,
+                                         MatrixXd& p_matBuffer) const
+{
+    const FiffRawDir& rawDir = this->rawdir.at(p_iBuffer);
+
+    if(!rawDir.ent || rawDir.ent->kind == -1) {
+        return read_raw_buffer_mapped(rawDir, p_matBuffer);
+    }
+
+    //
+    //   The data are located after the tag info (kind, type, size, next)
+    //
+    qint64 iPos = static_cast<qint64>(rawDir.ent->pos) + 4*sizeof(fiff_int_t);
+    qint64 iSize = static_cast<qint64>(rawDir.ent->size);
+
+    if(!p_window.pData || iPos < p_window.iPos || iPos + iSize > p_window.iPos + p_window.iSize) {
+        unmap_window(p_window);
+
+        QFileDevice* pFileDevice = this->file ? qobject_cast<QFileDevice*>(this->file->device()) : Q_NULLPTR;
+
+        if(!pFileDevice || iSize <= 0) {
+            return false;
+        }
+
+        if(!pFileDevice->isOpen() && !pFileDevice->open(QIODevice::ReadOnly)) {
+            printf("Cannot open file %s",this->info.filename.toUtf8().constData());
+            return false;
+        }
+
+        //
+        //   Span the following buffers which are needed and stored behind this one
+        //
+        qint64 iEnd = iPos + iSize;
+
+        for(int k = p_iBuffer + 1; k < this->rawdir.size() && this->rawdir.at(k).first <= p_iTo; ++k) {
+            const FiffRawDir& nextRawDir = this->rawdir.at(k);
+
+            if(!nextRawDir.ent || nextRawDir.ent->kind == -1) {
+                continue;
+            }
+
+            qint64 iNextPos = static_cast<qint64>(nextRawDir.ent->pos) + 4*sizeof(fiff_int_t);
+            qint64 iNextEnd = iNextPos + static_cast<qint64>(nextRawDir.ent->size);
+
+            if(iNextPos < iPos || iNextEnd - iPos > FIFF_RAW_MAP_WINDOW_SIZE) {
+                break;
+            }
+
+            iEnd = qMax(iEnd, iNextEnd);
+        }
+
+        p_window.pData = pFileDevice->map(iPos, iEnd - iPos);
+
+        if(!p_window.pData) {
+            return false;
+        }
+
+        p_window.iPos = iPos;
+        p_window.iSize = iEnd - iPos;
+    }
+
+    qint32 nchan = this->info.nchan;
+
+    if(p_matBuffer.rows() != nchan || p_matBuffer.cols() != rawDir.nsamp) {
+        p_matBuffer.resize(nchan, rawDir.nsamp);
+    }
+
+    return decode_raw_buffer(p_window.pData + (iPos - p_window.iPos), rawDir.ent->type, rawDir.ent->size, p_matBuffer);
+}
+
+
+//*************************************************************************************************************
+
+void FiffRawData::unmap_window(MappedWindow& p_window) const
+{
+    if(p_window.pData) {
+        unmap_raw_buffer(p_window.pData);
+    }
+
+    p_window = MappedWindow();
+}
+
+
+//*************************************************************************************************************
+
+bool FiffRawData::decode_raw_buffer(const uchar* p_pData,
+                                    fiff_int_t p_iType,
+                                    fiff_int_t p_iSize,
+                                    MatrixXd& p_matBuffer)
+{
+    qint64 iSampleSize;
+
+    switch(p_iType) {
+        case FIFFT_DAU_PACK16:
+        case FIFFT_SHORT:
+            iSampleSize = sizeof(fiff_short_t);
+            break;
+        case FIFFT_INT:
+            iSampleSize = sizeof(fiff_int_t);
+            break;
+        case FIFFT_FLOAT:
+            iSampleSize = sizeof(fiff_float_t);
+            break;
+        default:
+            printf("Data Storage Format not supported for direct decoding!! Type: %d\n", p_iType);
+            return false;
+    }
+
+    if(static_cast<qint64>(p_iSize) < iSampleSize * p_matBuffer.size()) {
+        printf("Raw data buffer is smaller than expected (%d bytes)\n", p_iSize);
+        return false;
+    }
+
+    switch(p_iType) {
+        case FIFFT_DAU_PACK16:
+        case FIFFT_SHORT:
+            decodeBigEndian<fiff_short_t>(p_pData, p_matBuffer);
+            break;
+        case FIFFT_INT:
+            decodeBigEndian<fiff_int_t>(p_pData, p_matBuffer);
+            break;
+        case FIFFT_FLOAT:
+            decodeBigEndian<float>(p_pData, p_matBuffer);
+            break;
+    }
+
+    return true;
+}
+
+
+//*************************************************************************************************************
+
+void FiffRawData::get_operators(const RowVectorXi& sel,
+                                SparseMatrix<double>& cal,
+                                SparseMatrix<double>& mult) const
+{
+    bool projAvailable = this->proj.size() != 0;
+    bool compAvailable = this->comp.kind != -1 && this->comp.data;
+
+    QMutexLocker locker(&m_pOperatorCache->mutex);
+
+    OperatorCache& cache = *m_pOperatorCache;
+
+    //
+    //  Reuse the cached operators if nothing changed
+    //
+    if(cache.valid
+       && cache.cals.size() == this->cals.size() && cache.cals == this->cals
+       && cache.sel.size() == sel.size() && cache.sel == sel
+       && cache.proj.rows() == this->proj.rows() && cache.proj.cols() == this->proj.cols() && cache.proj == this->proj
+       && cache.compKind == (compAvailable ? this->comp.kind : -1)
+       && (!compAvailable || (cache.compData.rows() == this->comp.data->data.rows()
+                              && cache.compData.cols() == this->comp.data->data.cols()
+                              && cache.compData == this->comp.data->data))) {
+        cal = cache.cal;
+        mult = cache.mult;
+        return;
+    }
+
+    qint32 nchan = this->info.nchan;
+    qint32 i;
+
+    typedef Eigen::Triplet<double> T;
+    std::vector<T> tripletList;
+    tripletList.reserve(nchan);
+    for(i = 0; i < nchan; ++i)
+        tripletList.push_back(T(i, i, this->cals[i]));
+
+    cal = SparseMatrix<double>(nchan, nchan);
+    cal.setFromTriplets(tripletList.begin(), tripletList.end());
+
+    MatrixXd mult_full;
+    //
+    if (sel.size() == 0)
+    {
+        if (projAvailable || compAvailable)
+        {
+            if (!projAvailable)
+                mult_full = this->comp.data->data*cal;
+            else if (!compAvailable)
+                mult_full = this->proj*cal;
+            else
+                mult_full = this->proj*this->comp.data->data*cal;
+        }
+    }
+    else
+    {
+        if (!projAvailable && !compAvailable)
+        {
+            tripletList.clear();
+            tripletList.reserve(sel.size());
+            for(i = 0; i < sel.size(); ++i)
+                tripletList.push_back(T(i, i, this->cals[sel[i]]));
+            cal = SparseMatrix<double>(sel.size(), sel.size());
+            cal.setFromTriplets(tripletList.begin(), tripletList.end());
+        }
+        else
+        {
+            MatrixXd selVect(sel.size(), nchan);
+
+            if (!projAvailable)
+            {
+                for( i = 0; i  < sel.size(); ++i)
+                    selVect.row(i) = this->comp.data->data.row(sel[i]);
+                mult_full = selVect*cal;
+            }
+            else
+            {
+                for( i = 0; i  < sel.size(); ++i)
+                    selVect.row(i) = this->proj.row(sel[i]);
+
+                if (!compAvailable)
+                    mult_full = selVect*cal;
+                else
+                    mult_full = selVect*this->comp.data->data*cal;
+            }
+        }
+    }
+
+    //
+    // Make mult sparse
+    //
+    mult = mult_full.sparseView();
+
+    //
+    // Update the cache
+    //
+    cache.proj = this->proj;
+    cache.compKind = compAvailable ? this->comp.kind : -1;
+    cache.compData = compAvailable ? this->comp.data->data : MatrixXd();
+    cache.cals = this->cals;
+    cache.sel = sel;
+    cache.cal = cal;
+    cache.mult = mult;
+    cache.valid = true;
+}
@@ -63,6 +63,7 @@
 //=============================================================================================================
 
 #include <QList>
+#include <QMutex>
 #include <QSharedPointer>
 
 
@@ -206,6 +207,90 @@ public:
                                 float to,
                                 const RowVectorXi& sel = defaultRowVectorXi) const;
 
+    //=========================================================================================================
+    /**
+     * Enables or disables the memory mapped read mode. If enabled, read_raw_segment decodes the raw data buffers
+     * straight from the file pages instead of reading every buffer into an intermediate FiffTag first. The file is
+     * mapped in windows of consecutive buffers, not buffer by buffer. Memory mapping is only available if the underlying device is a QFile, otherwise the regular read path is used.
+     *
+     * @param[in] bMemoryMapped  Whether to use the memory mapped read mode.
+     */
+    void setMemoryMapped(bool bMemoryMapped);
+
+    //=========================================================================================================
+    /**
+     * Returns whether the memory mapped read mode is enabled.
+     *
+     * @return true if the memory mapped read mode is enabled, false otherwise.
+     */
+    bool isMemoryMapped() const;
+
+    //=========================================================================================================
+    /**
+     * Maps the data of a raw data buffer directly from the file pages. The view is in file byte order (big endian)
+     * and stays valid until it is released with unmap_raw_buffer or the file is closed.
+     *
+     * @param[in] p_RawDir   The raw directory entry of the buffer to map.
+     *
+     * @return pointer to the tag data of the buffer, NULL if the buffer could not be mapped.
+     */
+    const uchar* map_raw_buffer(const FiffRawDir& p_RawDir) const;
+
+    //=========================================================================================================
+    /**
+     * Releases a view which was returned by map_raw_buffer.
+     *
+     * @param[in] p_pData    The view to release.
+     *
+     * @return true if succeeded, false otherwise.
+     */
+    bool unmap_raw_buffer(const uchar* p_pData) const;
+
+    //=========================================================================================================
+    /**
+     * Decodes a raw data buffer from the memory mapped file pages into a caller provided matrix. The byte order is
+     * converted while decoding, no intermediate tag or matrix is allocated. The output is not calibrated and is
+     * only resized if its dimensions do not match (channels x samples of the buffer). Skips are returned as zeros.
+     *
+     * @param[in] p_RawDir       The raw directory entry of the buffer to read.
+     * @param[out] p_matBuffer   The decoded buffer (channels x samples).
+     *
+     * @return true if succeeded, false otherwise.
+     */
+    bool read_raw_buffer_mapped(const FiffRawDir& p_RawDir,
+                                MatrixXd& p_matBuffer) const;
+
+    //=========================================================================================================
+    /**
+     * Decodes the data of a raw data buffer tag, which is stored in file byte order (big endian), into a caller
+     * provided matrix. The matrix has to be sized to channels x samples of the buffer beforehand.
+     *
+     * @param[in] p_pData        The tag data in file byte order.
+     * @param[in] p_iType        The tag data type (FIFFT_DAU_PACK16, FIFFT_SHORT, FIFFT_INT or FIFFT_FLOAT).
+     * @param[in] p_iSize        The size of the tag data in bytes.
+     * @param[out] p_matBuffer   The decoded buffer (channels x samples).
+     *
+     * @return true if succeeded, false otherwise.
+     */
+    static bool decode_raw_buffer(const uchar* p_pData,
+                                  fiff_int_t p_iType,
+                                  fiff_int_t p_iSize,
+                                  MatrixXd& p_matBuffer);
+
+    //=========================================================================================================
+    /**
+     * Returns the calibration and the combined projection, compensation and calibration operator for the given
+     * channel selection. The operators are cached and only recomputed if proj, comp, cals or sel changed.
+     *
+     * @param[in] sel        channel selection vector
+     * @param[out] cal       the calibration operator
+     * @param[out] mult      the combined projection, compensation and calibration operator. Empty if neither
+     *                       projectors nor compensators are set up.
+     */
+    void get_operators(const RowVectorXi& sel,
+                       SparseMatrix<double>& cal,
+                       SparseMatrix<double>& mult) const;
+
 public:
     FiffStream::SPtr file;      /**< replaces fid */
     FiffInfo info;              /**< Fiff measurement information */
@@ -215,6 +300,66 @@ public:
     QList<FiffRawDir> rawdir;   /**< Special fiff diretory entry for raw data. */
     MatrixXd proj;              /**< SSP operator to apply to the data. */
     FiffCtfComp comp;           /**< Compensator. */
+
+private:
+    //=========================================================================================================
+    /**
+     * Cached calibration and projection operators together with the data they were computed from.
+     */
+    struct OperatorCache {
+        OperatorCache() : valid(false), compKind(-1) {}
+
+        QMutex                  mutex;      /**< Guards the cache, read_raw_segment may be called from several threads. */
+        bool                    valid;      /**< Whether the cached operators were computed yet. */
+        MatrixXd                proj;       /**< The SSP operator the cache was computed for. */
+        fiff_int_t              compKind;   /**< The compensator kind the cache was computed for. */
+        MatrixXd                compData;   /**< The compensator data the cache was computed for. */
+        RowVectorXd             cals;       /**< The calibration values the cache was computed for. */
+        RowVectorXi             sel;        /**< The channel selection the cache was computed for. */
+        SparseMatrix<double>    cal;        /**< The cached calibration operator. */
+        SparseMatrix<double>    mult;       /**< The cached combined operator. */
+    };
+
+    //=========================================================================================================
+    /**
+     * A memory mapped file range which holds the data of consecutive raw data buffers.
+     */
+    struct MappedWindow {
+        MappedWindow() : pData(NULL), iPos(0), iSize(0) {}
+
+        const uchar*    pData;      /**< The mapped file range, NULL if nothing is mapped. */
+        qint64          iPos;       /**< The file position of the mapped range. */
+        qint64          iSize;      /**< The size of the mapped range in bytes. */
+    };
+
+    //=========================================================================================================
+    /**
+     * Decodes a raw data buffer from a memory mapped window. If the buffer is not part of the current window, the
+     * window is replaced by a new one which starts at the buffer and spans the following buffers up to the sample
+     * p_iTo, as far as they fit into FIFF_RAW_MAP_WINDOW_SIZE bytes.
+     *
+     * @param[in] p_iBuffer          The index of the buffer in rawdir.
+     * @param[in] p_iTo              The last sample which is going to be read.
+     * @param[in, out] p_window      The current window. Has to be released with unmap_window.
+     * @param[out] p_matBuffer       The decoded buffer (channels x samples).
+     *
+     * @return true if succeeded, false otherwise.
+     */
+    bool read_raw_buffer_mapped(int p_iBuffer,
+                                fiff_int_t p_iTo,
+                                MappedWindow& p_window,
+                                MatrixXd& p_matBuffer) const;
+
+    //=========================================================================================================
+    /**
+     * Releases a window which was mapped by read_raw_buffer_mapped.
+     *
+     * @param[in, out] p_window      The window to release.
+     */
+    void unmap_window(MappedWindow& p_window) const;
+
+    bool m_bMemoryMapped;                               /**< Whether raw data buffers are decoded straight from the memory mapped file. */
+    QSharedPointer<OperatorCache> m_pOperatorCache;     /**< The cached read operators, shared between copies. */
 };
 
 } // NAMESPACE
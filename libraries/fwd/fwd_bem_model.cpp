@@ -1747,9 +1747,8 @@ void FwdBemModel::fwd_bem_pot_grad_calc(float *rd, float *Q, FwdBemModel* m, Fwd
     grads[1] = ygrad;
     grads[2] = zgrad;
 
-    if (!m->v0)
-        m->v0 = MALLOC_40(m->nsol,float);
-    v0 = m->v0;
+    VectorXf vecV0(m->nsol);
+    v0 = vecV0.data();
 
     VEC_COPY_40(mri_rd,rd);
     VEC_COPY_40(mri_Q,Q);
@@ -1804,9 +1803,8 @@ void FwdBemModel::fwd_bem_lin_pot_calc(float *rd, float *Q, FwdBemModel *m, FwdC
     float *v0;
     float **solution;
 
-    if (!m->v0)
-        m->v0 = MALLOC_40(m->nsol,float);
-    v0 = m->v0;
+    VectorXf vecV0(m->nsol);
+    v0 = vecV0.data();
 
     VEC_COPY_40(mri_rd,rd);
     VEC_COPY_40(mri_Q,Q);
@@ -1859,9 +1857,8 @@ void FwdBemModel::fwd_bem_lin_pot_grad_calc(float *rd, float *Q, FwdBemModel *m,
     grads[1] = ygrad;
     grads[2] = zgrad;
 
-    if (!m->v0)
-        m->v0 = MALLOC_40(m->nsol,float);
-    v0 = m->v0;
+    VectorXf vecV0(m->nsol);
+    v0 = vecV0.data();
 
     VEC_COPY_40(mri_rd,rd);
     VEC_COPY_40(mri_Q,Q);
@@ -1915,9 +1912,8 @@ void FwdBemModel::fwd_bem_pot_calc(float *rd, float *Q, FwdBemModel *m, FwdCoilS
     float       **solution;
     float       mri_rd[3],mri_Q[3];
 
-    if (!m->v0)
-        m->v0 = MALLOC_40(m->nsol,float);
-    v0 = m->v0;
+    VectorXf vecV0(m->nsol);
+    v0 = vecV0.data();
 
     VEC_COPY_40(mri_rd,rd);
     VEC_COPY_40(mri_Q,Q);
@@ -2613,9 +2609,8 @@ void FwdBemModel::fwd_bem_lin_field_calc(float *rd, float *Q, FwdCoilSet *coils,
     /*
        * Infinite-medium potentials
        */
-    if (!m->v0)
-        m->v0 = MALLOC_40(m->nsol,float);
-    v0 = m->v0;
+    VectorXf vecV0(m->nsol);
+    v0 = vecV0.data();
     /*
        * The dipole location and orientation must be transformed
        */
@@ -2676,9 +2671,8 @@ void FwdBemModel::fwd_bem_field_calc(float *rd, float *Q, FwdCoilSet *coils, Fwd
     /*
        * Infinite-medium potentials
        */
-    if (!m->v0)
-        m->v0 = MALLOC_40(m->nsol,float);
-    v0 = m->v0;
+    VectorXf vecV0(m->nsol);
+    v0 = vecV0.data();
     /*
        * The dipole location and orientation must be transformed
        */
@@ -2744,9 +2738,8 @@ void FwdBemModel::fwd_bem_field_grad_calc(float *rd, float *Q, FwdCoilSet* coils
     /*
        * Infinite-medium potentials
        */
-    if (!m->v0)
-        m->v0 = MALLOC_40(m->nsol,float);
-    v0 = m->v0;
+    VectorXf vecV0(m->nsol);
+    v0 = vecV0.data();
     /*
        * The dipole location and orientation must be transformed
        */
@@ -2869,9 +2862,8 @@ void FwdBemModel::fwd_bem_lin_field_grad_calc(float *rd, float *Q, FwdCoilSet *c
     /*
        * Space for infinite-medium potentials
        */
-    if (!m->v0)
-        m->v0 = MALLOC_40(m->nsol,float);
-    v0 = m->v0;
+    VectorXf vecV0(m->nsol);
+    v0 = vecV0.data();
     /*
        * The dipole location and orientation must be transformed
        */
@@ -532,7 +532,7 @@ public:
     QString     sol_name;       /* Name of the file where the solution was loaded from */
 
     float      **solution;      /* The potential solution matrix */
-    float      *v0;             /* Space for the infinite-medium potentials */
+    float      *v0;             /* Unused: the infinite-medium potentials are computed into local space, so that the field computations do not modify the model and it can be shared by threads */
     int        nsol;            /* Size of the solution matrix */
 
     FIFFLIB::FiffCoordTransOld* head_mri_t;  /* Coordinate transformation from head to MRI coordinates */
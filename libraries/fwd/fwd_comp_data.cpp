@@ -197,19 +197,18 @@ int FwdCompData::fwd_comp_field(float *rd, float *Q, FwdCoilSet *coils, float *r
     if (!comp->comp_coils || comp->comp_coils->ncoil <= 0 || !comp->set || !comp->set->current)
         return OK;
     /*
-       * Workspace needed?
+       * Workspace is local, the compensation data are shared by the threads fitting dipoles
        */
-    if (!comp->work)
-        comp->work = MALLOC_60(comp->comp_coils->ncoil,float);
+    VectorXf work(comp->comp_coils->ncoil);
     /*
        * Compute the field in the compensation coils
        */
-    if (comp->field(rd,Q,comp->comp_coils,comp->work,comp->client) == FAIL)
+    if (comp->field(rd,Q,comp->comp_coils,work.data(),comp->client) == FAIL)
         return FAIL;
     /*
        * Compute the compensated field
        */
-    return MneCTFCompDataSet::mne_apply_ctf_comp(comp->set,TRUE,res,coils->ncoil,comp->work,comp->comp_coils->ncoil);
+    return MneCTFCompDataSet::mne_apply_ctf_comp(comp->set,TRUE,res,coils->ncoil,work.data(),comp->comp_coils->ncoil);
 }
 
 
@@ -350,20 +349,20 @@ int FwdCompData::fwd_comp_field_vec(float *rd, FwdCoilSet *coils, float **res, v
     if (!comp->comp_coils || comp->comp_coils->ncoil <= 0 || !comp->set || !comp->set->current)
         return OK;
     /*
-       * Need workspace?
+       * Local workspace
        */
-    if (!comp->vec_work)
-        comp->vec_work = ALLOC_CMATRIX_60(3,comp->comp_coils->ncoil);
+    MatrixXf work(comp->comp_coils->ncoil,3);
+    float *vec_work[3] = { work.col(0).data(), work.col(1).data(), work.col(2).data() };
     /*
        * Compute the field at the compensation sensors
        */
-    if (comp->vec_field(rd,comp->comp_coils,comp->vec_work,comp->client) == FAIL)
+    if (comp->vec_field(rd,comp->comp_coils,vec_work,comp->client) == FAIL)
         return FAIL;
     /*
        * Compute the compensated field of three orthogonal dipoles
        */
     for (k = 0; k < 3; k++) {
-        if (MneCTFCompDataSet::mne_apply_ctf_comp(comp->set,TRUE,res[k],coils->ncoil,comp->vec_work[k],comp->comp_coils->ncoil) == FAIL)
+        if (MneCTFCompDataSet::mne_apply_ctf_comp(comp->set,TRUE,res[k],coils->ncoil,vec_work[k],comp->comp_coils->ncoil) == FAIL)
             return FAIL;
     }
     return OK;
@@ -394,27 +393,24 @@ int FwdCompData::fwd_comp_field_grad(float *rd, float *Q, FwdCoilSet* coils, flo
     if (!comp->comp_coils || comp->comp_coils->ncoil <= 0 || !comp->set || !comp->set->current)
         return OK;
     /*
-     * Workspace needed?
+     * Local workspace
      */
-    if (!comp->work)
-        comp->work = MALLOC_60(comp->comp_coils->ncoil,float);
-    if (!comp->vec_work)
-        comp->vec_work = ALLOC_CMATRIX_60(3,comp->comp_coils->ncoil);
+    MatrixXf work(comp->comp_coils->ncoil,4);
     /*
      * Compute the field in the compensation coils
      */
-    if (comp->field_grad(rd,Q,comp->comp_coils,comp->work,comp->vec_work[0],comp->vec_work[1],comp->vec_work[2],comp->client) == FAIL)
+    if (comp->field_grad(rd,Q,comp->comp_coils,work.col(0).data(),work.col(1).data(),work.col(2).data(),work.col(3).data(),comp->client) == FAIL)
         return FAIL;
     /*
      * Compute the compensated field
      */
-    if (MneCTFCompDataSet::mne_apply_ctf_comp(comp->set,TRUE,res,coils->ncoil,comp->work,comp->comp_coils->ncoil) != OK)
+    if (MneCTFCompDataSet::mne_apply_ctf_comp(comp->set,TRUE,res,coils->ncoil,work.col(0).data(),comp->comp_coils->ncoil) != OK)
         return FAIL;
-    if (MneCTFCompDataSet::mne_apply_ctf_comp(comp->set,TRUE,xgrad,coils->ncoil,comp->vec_work[0],comp->comp_coils->ncoil) != OK)
+    if (MneCTFCompDataSet::mne_apply_ctf_comp(comp->set,TRUE,xgrad,coils->ncoil,work.col(1).data(),comp->comp_coils->ncoil) != OK)
         return FAIL;
-    if (MneCTFCompDataSet::mne_apply_ctf_comp(comp->set,TRUE,ygrad,coils->ncoil,comp->vec_work[1],comp->comp_coils->ncoil) != OK)
+    if (MneCTFCompDataSet::mne_apply_ctf_comp(comp->set,TRUE,ygrad,coils->ncoil,work.col(2).data(),comp->comp_coils->ncoil) != OK)
         return FAIL;
-    if (MneCTFCompDataSet::mne_apply_ctf_comp(comp->set,TRUE,zgrad,coils->ncoil,comp->vec_work[2],comp->comp_coils->ncoil) != OK)
+    if (MneCTFCompDataSet::mne_apply_ctf_comp(comp->set,TRUE,zgrad,coils->ncoil,work.col(3).data(),comp->comp_coils->ncoil) != OK)
         return FAIL;
     return OK;
 }
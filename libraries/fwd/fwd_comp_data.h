@@ -159,7 +159,7 @@ public:
     fwdFieldGradFunc    field_grad; /* Computes the field and gradient of one dipole direction */
     void                *client;    /* Client data to pass to the above functions */
     fwdUserFreeFunc     client_free;
-    float               *work;      /* The work areas */
+    float               *work;      /* Unused: the field computations use local work areas */
     float               **vec_work;
 
 // ### OLD STRUCT ###
@@ -228,10 +228,6 @@ void mne_free_dcmatrix_1 (double **m)
 
 
 
-static int         terms = 0;       /* These statistics may be useful */
-static int         eval = 0;
-
-
 //*************************************************************************************************************
 //=============================================================================================================
 // DEFINE MEMBER METHODS
@@ -534,11 +530,8 @@ void FwdEegSphereModel::calc_pot_components(double beta, double cgamma, double *
     betan = 1.0;
     p0 = p01 = p1 = p11 = 0.0;
     for (n = 1; n <= nterms; n++) {
-        if (betan < EPS) {
-            terms = terms + n;
-            eval  = eval + 1;
+        if (betan < EPS)
             break;
-        }
         next_legen (n,cgamma,&p0,&p01,&p1,&p11);
         multn = betan*fn[n-1];	/* The 2*n + 1 factor is included in fn */
         Vr = Vr + multn*p0;
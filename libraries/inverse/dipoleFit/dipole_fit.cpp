@@ -6,6 +6,9 @@
 
 #include <string.h>
 #include <QScopedPointer>
+#include <QVector>
+#include <QAtomicInt>
+#include <QtConcurrent/QtConcurrent>
 
 
 using namespace INVERSELIB;
@@ -57,6 +60,8 @@ using namespace FWDLIB;
 
 #define EPS_VALUES 0.05
 
+#define FIT_BATCH 64            /* Time points collected per worker before fitting them concurrently */
+
 
 //*************************************************************************************************************
 //=============================================================================================================
@@ -597,6 +602,66 @@ int mne_get_values_from_data_ch (float time,      /* Interesting time point */
 
 
 
+//*************************************************************************************************************
+
+static void fit_batch(const QList<DipoleFitData*>& fits,    /* One fitting data per worker */
+                      GuessData* guess,                     /* The initial guesses */
+                      const QVector<float>& times,          /* Times of the collected data points */
+                      QVector<float>& values,               /* Collected data, nchan values per time point */
+                      int nchan,
+                      int verbose,
+                      ECDSet& set)
+/*
+ * Fit the collected time points. The workers pick the next unfitted time point until the batch is exhausted.
+ * fit_one keeps the selected forward functions and its simplex user data in the fitting data, hence each worker
+ * uses its own fitting data, which share the setup. The dipoles are added to the set in time order afterwards.
+ */
+{
+    int           ntime = times.size();
+    int           nworker = qMin(fits.size(),ntime);
+    int           report_interval = 10;
+    QVector<ECD>  dips(ntime);
+    QVector<char> fitted(ntime,FALSE);
+    QAtomicInt    next(0);
+    ECD           *dip_data    = dips.data();
+    char          *fitted_data = fitted.data();
+    float         *value_data  = values.data();
+
+    auto worker = [&](DipoleFitData* fit) {
+        int k;
+        while ((k = next.fetchAndAddOrdered(1)) < ntime)
+            fitted_data[k] = DipoleFitData::fit_one(fit,guess,times.at(k),value_data+k*nchan,verbose,dip_data[k]);
+    };
+
+    if (nworker > 1) {
+        QList<QFuture<void> > futures;
+        for (int w = 1; w < nworker; w++) {
+            DipoleFitData* fit = fits[w];
+            futures.append(QtConcurrent::run([&worker,fit]() { worker(fit); }));
+        }
+        worker(fits[0]);
+        for (int w = 0; w < futures.size(); w++)
+            futures[w].waitForFinished();
+    }
+    else
+        worker(fits[0]);
+
+    for (int k = 0; k < ntime; k++) {
+        if (!fitted[k])
+            printf("t = %7.1f ms : %s\n",1000*times[k],"error (tbd: catch)");
+        else {
+            set.addEcd(dips[k]);
+            if (verbose)
+                dips[k].print(stdout);
+            else {
+                if (set.size() % report_interval == 0)
+                    fprintf(stderr,"%d..",set.size());
+            }
+        }
+    }
+}
+
+
 //*************************************************************************************************************
 //=============================================================================================================
 // DEFINE MEMBER METHODS
@@ -614,39 +679,17 @@ ECDSet DipoleFit::calculateFit() const
 {
     QScopedPointer<GuessData>guess (Q_NULLPTR);
     ECDSet              set;
-    FwdEegSphereModel*  eeg_model = NULL;
     DipoleFitData*      fit_data = NULL;
+    QList<DipoleFitData*> fits;
     MneMeasData*        data     = NULL;
     MneRawData*         raw      = NULL;
     mneChSelection      sel      = NULL;
 
     printf("---- Setting up...\n\n");
-    if (settings->include_eeg) {
-        if ((eeg_model = FwdEegSphereModel::setup_eeg_sphere_model(settings->eeg_model_file,settings->eeg_model_name,settings->eeg_sphere_rad)) == NULL)
-            goto out;
-    }
-
-    if ((fit_data = DipoleFitData::setup_dipole_fit_data(   settings->mriname,
-                                                            settings->measname,
-                                                            settings->bemname.isEmpty() ? NULL : settings->bemname.toUtf8().data(),
-                                                            &settings->r0,
-                                                            eeg_model,
-                                                            settings->accurate,
-                                                            settings->badname,
-                                                            settings->noisename,
-                                                            settings->grad_std,
-                                                            settings->mag_std,
-                                                            settings->eeg_std,
-                                                            settings->mag_reg,
-                                                            settings->grad_reg,
-                                                            settings->eeg_reg,
-                                                            settings->diagnoise,
-                                                            settings->projnames,
-                                                            settings->include_meg,
-                                                            settings->include_eeg)) == NULL)
+    if ((fit_data = setup_fit_data()) == NULL)
         goto out;
+    fits.append(fit_data);
 
-    fit_data->fit_mag_dipoles = settings->fit_mag_dipoles;
     if (settings->is_raw) {
         int c;
         float t1,t2;
@@ -709,13 +752,22 @@ ECDSet DipoleFit::calculateFit() const
         }
     }
 
+    /*
+     * Each additional worker thread gets its own fitting data sharing the complete setup
+     */
+    if (settings->nthreads > 1) {
+        printf("\n---- Setting up %d worker threads...\n\n",settings->nthreads);
+        while (fits.size() < settings->nthreads)
+            fits.append(DipoleFitData::share_dipole_fit_data(fit_data));
+    }
+
     /*
      * Proceed to computing the fits
      */
     printf("\n---- Computing the forward solution for the guesses...\n\n");
     guess.reset(new GuessData( settings->guessname,
                                settings->guess_surfname,
-                               settings->guess_mindist, settings->guess_exclude, settings->guess_grid, fit_data));
+                               settings->guess_mindist, settings->guess_exclude, settings->guess_grid, fit_data, settings->guess_cachedir));
     if (guess.isNull())
         goto out;
 
@@ -724,34 +776,82 @@ ECDSet DipoleFit::calculateFit() const
 
 
     if (raw) {
-        if (fit_dipoles_raw(settings->measname,raw,sel,fit_data,guess.take(),settings->tmin,settings->tmax,settings->tstep,settings->integ,settings->verbose) == FAIL)
+        if (fit_dipoles_raw(settings->measname,raw,sel,fits,guess.take(),settings->tmin,settings->tmax,settings->tstep,settings->integ,settings->verbose,set) == FAIL)
             goto out;
     }
     else {
-        if (fit_dipoles(settings->measname,data,fit_data,guess.take(),settings->tmin,settings->tmax,settings->tstep,settings->integ,settings->verbose,set) == FAIL)
+        if (fit_dipoles(settings->measname,data,fits,guess.take(),settings->tmin,settings->tmax,settings->tstep,settings->integ,settings->verbose,set) == FAIL)
             goto out;
     }
     printf("%d dipoles fitted\n",set.size());
 
 
 out : {
+        for (int k = 1; k < fits.size(); k++)
+            delete fits[k];
         return set;
     }
 }
 
 
+//*************************************************************************************************************
+
+DipoleFitData* DipoleFit::setup_fit_data() const
+{
+    FwdEegSphereModel*  eeg_model = NULL;
+    DipoleFitData*      fit_data  = NULL;
+
+    if (settings->include_eeg) {
+        if ((eeg_model = FwdEegSphereModel::setup_eeg_sphere_model(settings->eeg_model_file,settings->eeg_model_name,settings->eeg_sphere_rad)) == NULL)
+            return NULL;
+    }
+
+    if ((fit_data = DipoleFitData::setup_dipole_fit_data(   settings->mriname,
+                                                            settings->measname,
+                                                            settings->bemname.isEmpty() ? NULL : settings->bemname.toUtf8().data(),
+                                                            &settings->r0,
+                                                            eeg_model,
+                                                            settings->accurate,
+                                                            settings->badname,
+                                                            settings->noisename,
+                                                            settings->grad_std,
+                                                            settings->mag_std,
+                                                            settings->eeg_std,
+                                                            settings->mag_reg,
+                                                            settings->grad_reg,
+                                                            settings->eeg_reg,
+                                                            settings->diagnoise,
+                                                            settings->projnames,
+                                                            settings->include_meg,
+                                                            settings->include_eeg)) == NULL)
+        return NULL;
+
+    fit_data->fit_mag_dipoles = settings->fit_mag_dipoles;
+    return fit_data;
+}
+
+
 //*************************************************************************************************************
 
 int DipoleFit::fit_dipoles( const QString& dataname, MneMeasData* data, DipoleFitData* fit, GuessData* guess, float tmin, float tmax, float tstep, float integ, int verbose, ECDSet& p_set)
 {
-    float *one = MALLOC(data->nchan,float);
+    return fit_dipoles(dataname, data, QList<DipoleFitData*>() << fit, guess, tmin, tmax, tstep, integ, verbose, p_set);
+}
+
+
+//*************************************************************************************************************
+
+int DipoleFit::fit_dipoles( const QString& dataname, MneMeasData* data, const QList<DipoleFitData*>& fits, GuessData* guess, float tmin, float tmax, float tstep, float integ, int verbose, ECDSet& p_set)
+{
+    int            batch = FIT_BATCH*fits.size();
+    QVector<float> values(batch*data->nchan);
+    QVector<float> times;
     float time;
     ECDSet set;
-    ECD   dip;
     int   s;
-    int   report_interval = 10;
 
     set.dataname = dataname;
+    times.reserve(batch);
 
     fprintf(stderr,"Fitting...%c",verbose ? '\n' : '\0');
     for (s = 0, time = tmin; time < tmax; s++, time = tmin  + s*tstep) {
@@ -759,26 +859,23 @@ int DipoleFit::fit_dipoles( const QString& dataname, MneMeasData* data, DipoleFi
      * Pick the data point
      */
         if (mne_get_values_from_data(time,integ,data->current->data,data->current->np,data->nchan,data->current->tmin,
-                                     1.0/data->current->tstep,FALSE,one) == FAIL) {
+                                     1.0/data->current->tstep,FALSE,values.data()+times.size()*data->nchan) == FAIL) {
             fprintf(stderr,"Cannot pick time: %7.1f ms\n",1000*time);
             continue;
         }
-
-        if (!DipoleFitData::fit_one(fit,guess,time,one,verbose,dip))
-            printf("t = %7.1f ms : %s\n",1000*time,"error (tbd: catch)");
-        else {
-            set.addEcd(dip);
-            if (verbose)
-                dip.print(stdout);
-            else {
-                if (set.size() % report_interval == 0)
-                    fprintf(stderr,"%d..",set.size());
-            }
+        times.append(time);
+        /*
+     * Fit once the batch is full
+     */
+        if (times.size() == batch) {
+            fit_batch(fits,guess,times,values,data->nchan,verbose,set);
+            times.clear();
         }
     }
+    if (!times.isEmpty())
+        fit_batch(fits,guess,times,values,data->nchan,verbose,set);
     if (!verbose)
         fprintf(stderr,"[done]\n");
-    FREE(one);
     p_set = set;
     return OK;
 }
@@ -788,7 +885,17 @@ int DipoleFit::fit_dipoles( const QString& dataname, MneMeasData* data, DipoleFi
 
 int DipoleFit::fit_dipoles_raw(const QString& dataname, MneRawData* raw, mneChSelection sel, DipoleFitData* fit, GuessData* guess, float tmin, float tmax, float tstep, float integ, int verbose, ECDSet& p_set)
 {
-    float *one    = MALLOC(sel->nchan,float);
+    return fit_dipoles_raw(dataname, raw, sel, QList<DipoleFitData*>() << fit, guess, tmin, tmax, tstep, integ, verbose, p_set);
+}
+
+
+//*************************************************************************************************************
+
+int DipoleFit::fit_dipoles_raw(const QString& dataname, MneRawData* raw, mneChSelection sel, const QList<DipoleFitData*>& fits, GuessData* guess, float tmin, float tmax, float tstep, float integ, int verbose, ECDSet& p_set)
+{
+    int   batch   = FIT_BATCH*fits.size();
+    QVector<float> values(batch*sel->nchan);
+    QVector<float> times;
     float sfreq   = raw->info->sfreq;
     float myinteg = integ > 0.0 ? 2*integ : 0.1;
     int   overlap = ceil(myinteg*sfreq);
@@ -799,11 +906,10 @@ int DipoleFit::fit_dipoles_raw(const QString& dataname, MneRawData* raw, mneChSe
     int   s,picks;
     float time,stime;
     float **data  = ALLOC_CMATRIX(sel->nchan,length);
-    ECD    dip;
     ECDSet set;
-    int    report_interval = 10;
 
     set.dataname = dataname;
+    times.reserve(batch);
 
     /*
    * Load the initial data segment
@@ -824,35 +930,29 @@ int DipoleFit::fit_dipoles_raw(const QString& dataname, MneRawData* raw, mneChSe
         /*
      * Get the values
      */
-        if (mne_get_values_from_data_ch (time,integ,data,length,sel->nchan,stime,sfreq,FALSE,one) == FAIL) {
+        if (mne_get_values_from_data_ch (time,integ,data,length,sel->nchan,stime,sfreq,FALSE,values.data()+times.size()*sel->nchan) == FAIL) {
             fprintf(stderr,"Cannot pick time: %8.3f s\n",time);
             continue;
         }
+        times.append(time);
         /*
-     * Fit
+     * Fit once the batch is full
      */
-        if (!DipoleFitData::fit_one(fit,guess,time,one,verbose,dip))
-            qWarning() << "Error";
-        else {
-            set.addEcd(dip);
-            if (verbose)
-                dip.print(stdout);
-            else {
-                if (set.size() % report_interval == 0)
-                    fprintf(stderr,"%d..",set.size());
-            }
+        if (times.size() == batch) {
+            fit_batch(fits,guess,times,values,sel->nchan,verbose,set);
+            times.clear();
         }
     }
+    if (!times.isEmpty())
+        fit_batch(fits,guess,times,values,sel->nchan,verbose,set);
     if (!verbose)
         fprintf(stderr,"[done]\n");
     FREE_CMATRIX(data);
-    FREE(one);
     p_set = set;
     return OK;
 
 bad : {
         FREE_CMATRIX(data);
-        FREE(one);
         return FAIL;
     }
 }
@@ -57,6 +57,7 @@
 //=============================================================================================================
 
 #include <QSharedPointer>
+#include <QList>
 
 
 
@@ -125,6 +126,29 @@ public:
      */
     static int fit_dipoles( const QString& dataname, MneMeasData* data, DipoleFitData* fit, GuessData* guess, float tmin, float tmax, float tstep, float integ, int verbose, ECDSet& p_set);
 
+    //=========================================================================================================
+    /**
+     *
+     * Fit a single dipole to each time point of the data using one worker thread per fitting data.
+     * The fitting data hold the state of fit_one and can therefore not be used by several threads at a time, use
+     * DipoleFitData::share_dipole_fit_data to create them. The fitted dipoles are stored in time order regardless
+     * of the number of workers.
+     *
+     * @param[in] dataname
+     * @param[in] data       The measured data
+     * @param[in] fits       Precomputed fitting data, one per worker thread
+     * @param[in] guess      The initial guesses
+     * @param[in] tmin       Time range
+     * @param[in] tmax
+     * @param[in] tstep      Time step to use
+     * @param[in] integ      Integration time
+     * @param[in] verbose    Verbose output?
+     * @param[out] p_set     the fitted ECD Set
+     *
+     * @return true when successful
+     */
+    static int fit_dipoles( const QString& dataname, MneMeasData* data, const QList<DipoleFitData*>& fits, GuessData* guess, float tmin, float tmax, float tstep, float integ, int verbose, ECDSet& p_set);
+
     //=========================================================================================================
     /**
      *
@@ -147,6 +171,28 @@ public:
      */
     static int fit_dipoles_raw(const QString& dataname, MNELIB::MneRawData* raw, mneChSelection sel, DipoleFitData* fit, GuessData* guess, float tmin, float tmax, float tstep, float integ, int verbose, ECDSet& p_set);
 
+    //=========================================================================================================
+    /**
+     *
+     * Fit a single dipole to each time point of the raw data using one worker thread per fitting data.
+     * The fitted dipoles are stored in time order regardless of the number of workers.
+     *
+     * @param[in] dataname
+     * @param[in] raw        The raw data description
+     * @param[in] sel        Channel selection to use
+     * @param[in] fits       Precomputed fitting data, one per worker thread
+     * @param[in] guess      The initial guesses
+     * @param[in] tmin       Time range
+     * @param[in] tmax
+     * @param[in] tstep      Time step to use
+     * @param[in] integ      Integration time
+     * @param[in] verbose    Verbose output?
+     * @param[out] p_set     Return all results here. Warning: for large data files this may take a lot of memory
+     *
+     * @return true when successful
+     */
+    static int fit_dipoles_raw(const QString& dataname, MNELIB::MneRawData* raw, mneChSelection sel, const QList<DipoleFitData*>& fits, GuessData* guess, float tmin, float tmax, float tstep, float integ, int verbose, ECDSet& p_set);
+
     //=========================================================================================================
     /**
      *
@@ -169,6 +215,14 @@ public:
     static int fit_dipoles_raw(const QString& dataname, MNELIB::MneRawData* raw, mneChSelection sel, DipoleFitData* fit, GuessData* guess, float tmin, float tmax, float tstep, float integ, int verbose);
 
 private:
+    //=========================================================================================================
+    /**
+     * Sets up the forward model, noise covariance and projection according to the settings.
+     *
+     * @return the fitting data or NULL if the setup failed
+     */
+    DipoleFitData* setup_fit_data() const;
+
     DipoleFitSettings* settings;
 
 };
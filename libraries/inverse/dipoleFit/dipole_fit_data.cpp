@@ -27,6 +27,7 @@
 
 #define _USE_MATH_DEFINES
 #include <math.h>
+#include <string.h>
 
 
 
@@ -3787,6 +3788,7 @@ DipoleFitData::DipoleFitData()
 , funcs (NULL)
 , column_norm (COLUMN_NORM_NONE)
 , fit_mag_dipoles (FALSE)
+, shared_setup (NULL)
 {
     r0[0] = 0.0f;
     r0[1] = 0.0f;
@@ -3798,6 +3800,12 @@ DipoleFitData::DipoleFitData()
 
 DipoleFitData::~DipoleFitData()
 {
+    /*
+     * The setup belongs to the fitting data this was shared from
+     */
+    if(shared_setup)
+        return;
+
     if(mri_head_t)
         delete mri_head_t;
     if(meg_head_t)
@@ -3833,6 +3841,25 @@ DipoleFitData::~DipoleFitData()
 }
 
 
+//*************************************************************************************************************
+
+DipoleFitData* DipoleFitData::share_dipole_fit_data(DipoleFitData* d)
+{
+    /*
+     * A member-wise copy shares all the pointers. Nothing in the setup is modified while fitting: the forward
+     * calculations keep their work areas in local space.
+     */
+    DipoleFitData* res = new DipoleFitData(*d);
+
+    res->shared_setup = d;
+    res->funcs        = !d->bemname.isEmpty() ? d->bem_funcs : d->sphere_funcs;
+    res->user         = NULL;
+    res->user_free    = NULL;
+
+    return res;
+}
+
+
 //*************************************************************************************************************
 
 int DipoleFitData::setup_forward_model(DipoleFitData *d, MneCTFCompDataSet* comp_data, FwdCoilSet *comp_coils)
@@ -4684,9 +4711,12 @@ out : {
 DipoleForward* dipole_forward(DipoleFitData* d,
                               float         **rd,
                               int           ndip,
+                              const float   *fields,
                               DipoleForward* old)
 /*
  * Compute the forward solution and do other nice stuff
+ * If fields is given, it contains the precomputed fields of the three orthogonal dipoles at each location
+ * (before projection and whitening, 3*ndip consecutive rows of nmeg+neeg values)
  */
 {
     DipoleForward* res;
@@ -4718,7 +4748,13 @@ DipoleForward* dipole_forward(DipoleFitData* d,
         /*
      * Calculate the field of three orthogonal dipoles
      */
-        if ((DipoleFitData::compute_dipole_field(d,rd[k],TRUE,this_fwd)) == FAIL)
+        if (fields) {
+            for (p = 0; p < 3; p++)
+                memcpy(this_fwd[p],fields+(3*k+p)*res->nch,res->nch*sizeof(float));
+            if ((DipoleFitData::proj_whiten_dipole_field(d,TRUE,this_fwd)) == FAIL)
+                goto bad;
+        }
+        else if ((DipoleFitData::compute_dipole_field(d,rd[k],TRUE,this_fwd)) == FAIL)
             goto bad;
         /*
      * Choice of column normalization
@@ -4780,7 +4816,23 @@ DipoleForward* DipoleFitData::dipole_forward_one(DipoleFitData* d,
 {
     float *rds[1];
     rds[0] = rd;
-    return dipole_forward(d,rds,1,old);
+    return dipole_forward(d,rds,1,NULL,old);
+}
+
+
+//*************************************************************************************************************
+
+DipoleForward* DipoleFitData::dipole_forward_one(DipoleFitData* d,
+                                                 float         *rd,
+                                                 const float   *field,
+                                                 DipoleForward* old)
+/*
+ * Same as above but start from a precomputed field
+ */
+{
+    float *rds[1];
+    rds[0] = rd;
+    return dipole_forward(d,rds,1,field,old);
 }
 
 
@@ -5299,12 +5351,24 @@ int DipoleFitData::compute_dipole_field(DipoleFitData* d, float *rd, int whiten,
 /*
  * Compute the field and take whitening and projection into account
  */
+{
+    if (compute_raw_dipole_field(d,rd,fwd) == FAIL)
+        return FAIL;
+    return proj_whiten_dipole_field(d,whiten,fwd);
+}
+
+
+//*************************************************************************************************************
+
+int DipoleFitData::compute_raw_dipole_field(DipoleFitData* d, float *rd, float **fwd)
+/*
+ * Compute the field of three orthogonal dipoles with the current forward functions
+ */
 {
     float *eeg_fwd[3];
     static float Qx[] = {1.0,0.0,0.0};
     static float Qy[] = {0.0,1.0,0.0};
     static float Qz[] = {0.0,0.0,1.0};
-    int k;
     /*
    * Compute the fields
    */
@@ -5340,7 +5404,21 @@ int DipoleFitData::compute_dipole_field(DipoleFitData* d, float *rd, int whiten,
                 goto bad;
         }
     }
+    return OK;
+
+bad :
+    return FAIL;
+}
+
 
+//*************************************************************************************************************
+
+int DipoleFitData::proj_whiten_dipole_field(DipoleFitData* d, int whiten, float **fwd)
+/*
+ * Take whitening and projection into account
+ */
+{
+    int k;
     /*
    * Apply projection
    */
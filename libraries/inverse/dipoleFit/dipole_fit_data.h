@@ -201,6 +201,19 @@ public:
 
 
 
+    //=========================================================================================================
+    /**
+     * Creates fitting data for an additional thread which shares the read-only setup of the given fitting data:
+     * transformations, channels, coils, forward models, noise covariance and projection. Only the state fit_one
+     * changes while fitting, i.e., the selected forward functions and the user data, is separate.
+     * The given fitting data must be completely set up and outlive the result.
+     *
+     * @param[in] d      The fitting data to share the setup with
+     *
+     * @return the new fitting data
+     */
+    static DipoleFitData* share_dipole_fit_data(DipoleFitData* d);
+
     //=========================================================================================================
     /**
      * Fit a single dipole to the given data
@@ -221,12 +234,52 @@ public:
 
     static int compute_dipole_field(DipoleFitData* d, float *rd, int whiten, float **fwd);
 
+    //=========================================================================================================
+    /**
+     * Compute the field of three orthogonal dipoles without projection and whitening
+     *
+     * @param[in] d      The fitting data
+     * @param[in] rd     The dipole location
+     * @param[out] fwd   The fields, 3 x (nmeg+neeg)
+     *
+     * @return OK when successful
+     */
+    static int compute_raw_dipole_field(DipoleFitData* d, float *rd, float **fwd);
+
+    //=========================================================================================================
+    /**
+     * Apply the projection and optionally the whitening to fields computed with compute_raw_dipole_field
+     *
+     * @param[in] d          The fitting data
+     * @param[in] whiten     Apply whitening as well?
+     * @param[in, out] fwd   The fields, 3 x (nmeg+neeg)
+     *
+     * @return OK when successful
+     */
+    static int proj_whiten_dipole_field(DipoleFitData* d, int whiten, float **fwd);
+
     //============================= dipole_forward.c
 
     static DipoleForward* dipole_forward_one(DipoleFitData* d,
                                      float         *rd,
                                      DipoleForward* old);
 
+    //=========================================================================================================
+    /**
+     * Compute the forward solution of one dipole from its precomputed field
+     *
+     * @param[in] d      The fitting data
+     * @param[in] rd     The dipole location
+     * @param[in] field  The fields of three orthogonal dipoles from compute_raw_dipole_field, 3 x (nmeg+neeg) values
+     * @param[in] old    Forward solution to reuse (may be NULL)
+     *
+     * @return the forward solution or NULL on failure
+     */
+    static DipoleForward* dipole_forward_one(DipoleFitData* d,
+                                     float         *rd,
+                                     const float   *field,
+                                     DipoleForward* old);
+
 
 
 
@@ -264,6 +317,7 @@ public:
       int               fit_mag_dipoles;    /**< Fit magnetic dipoles? */
       void              *user;              /**< User data for anything we need */
       fitUserFreeFunc   user_free;          /**< Function to free the above */
+      DipoleFitData*    shared_setup;       /**< The fitting data whose setup this shares (NULL if the setup is owned) */
 
 // ### OLD STRUCT ###
 //    typedef struct {		      /* This structure holds all fitting-related data */
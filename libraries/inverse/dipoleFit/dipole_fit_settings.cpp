@@ -121,6 +121,7 @@ void DipoleFitSettings::initMembers()
     scale_eeg_pos  = false;     
     mag_reg      = 0.1f;         
     fit_mag_dipoles = false;
+    nthreads     = 1;
 
     grad_reg     = 0.1f;         
     eeg_reg      = 0.1f;                  
@@ -179,6 +180,8 @@ void DipoleFitSettings::checkIntegrity()
         if (guess_exclude > 0)
             printf("Guess exclude    : %6.1f mm\n",1000*guess_exclude);
     }
+    if (!guess_cachedir.isEmpty())
+        printf("Guess field cache: %s\n",guess_cachedir.toUtf8().data());
     printf("Data             : %s\n",measname.toUtf8().data());
     if (projnames.size() > 0) {
         printf("SSP sources      :\n");
@@ -276,7 +279,9 @@ void DipoleFitSettings::usage(char *name)
     printf("\t--exclude dist/mm Exclude points which are closer than this distance from the CM of the inner skull surface (default =  %6.1f mm).\n",1000*guess_exclude);
     printf("\t--mindist dist/mm Exclude points which are closer than this distance from the inner skull surface  (default = %6.1f mm).\n",1000*guess_mindist);
     printf("\t--grid    dist/mm Source space grid size (default = %6.1f mm).\n",1000*guess_grid);
+    printf("\t--guesscache dir  Store the guess forward fields in this directory and reuse them in later runs.\n");
     printf("\t--magdip          Fit magnetic dipoles instead of current dipoles.\n");
+    printf("\t--threads n       Fit the time points with this many worker threads (default = %d).\n",nthreads);
     printf("\nOutput:\n\n");
     printf("\t--dip     name    xfit dip format output file name\n");
     printf("\t--bdip    name    xfit bdip format output file name\n");
@@ -335,6 +340,14 @@ bool DipoleFitSettings::check_args (int *argc,char **argv)
             }
             guessname = QString(argv[k+1]);
         }
+        else if (strcmp(argv[k],"--guesscache") == 0) {
+            found = 2;
+            if (k == *argc - 1) {
+                qCritical ("--guesscache: argument required.");
+                return false;
+            }
+            guess_cachedir = QString(argv[k+1]);
+        }
         else if (strcmp(argv[k],"--gsurf") == 0) {
             found = 2;
             if (k == *argc - 1) {
@@ -823,6 +836,21 @@ bool DipoleFitSettings::check_args (int *argc,char **argv)
             found = 1;
             fit_mag_dipoles = true;
         }
+        else if (strcmp(argv[k],"--threads") == 0) {
+            found = 2;
+            if (k == *argc - 1) {
+                qCritical ("--threads: argument required.");
+                return false;
+            }
+            if (sscanf(argv[k+1],"%d",&nthreads) != 1) {
+                qCritical() << "Incomprehensible number of threads:" << argv[k+1];
+                return false;
+            }
+            if (nthreads <= 0) {
+                qCritical ("Number of threads must be > 0");
+                return false;
+            }
+        }
         else if (strcmp(argv[k],"--dip") == 0) {
             found = 2;
             if (k == *argc - 1) {
@@ -149,6 +149,7 @@ float guess_rad;       			/**< Radius of spherical guess surface */
     float guess_mindist;       		/**< Minimum allowed distance to the surface */
     float guess_exclude;       		/**< Exclude points closer than this to the origin */
     float guess_grid;       		/**< Grid spacing */
+    QString guess_cachedir;             /**< Directory of the guess forward field cache (not used if empty) */
 
     QString noisename;                  /**< Noise-covariance matrix */
     float grad_std;        		/**< Standard deviations to be used if noise covariance is not specified */
@@ -180,6 +181,7 @@ float  eeg_sphere_rad;      		/**< Scalp radius to use in EEG sphere model */
     bool    scale_eeg_pos;     		/**< Scale the electrode locations to scalp in the sphere model */
     float  mag_reg;         		/**< Noise-covariance matrix regularization for MEG (magnetometers and axial gradiometers)  */
     bool   fit_mag_dipoles;
+    int    nthreads;                    /**< Number of worker threads fitting the time points (1 = sequential) */
 
 float  grad_reg;         		/**< Noise-covariance matrix regularization for EEG (planar gradiometers) */
     float  eeg_reg;         		/**< Noise-covariance matrix regularization for EEG  */
@@ -45,10 +45,22 @@
 #include <mne/c/mne_surface_old.h>
 #include <mne/c/mne_source_space_old.h>
 
+#include <mne/c/mne_ctf_comp_data_set.h>
+#include <mne/c/mne_ctf_comp_data.h>
+#include <mne/c/mne_named_matrix.h>
+
 #include <fiff/fiff_stream.h>
 #include <fiff/fiff_tag.h>
 
+#include <fwd/fwd_coil_set.h>
+#include <fwd/fwd_comp_data.h>
+#include <fwd/fwd_bem_model.h>
+
 #include <QFile>
+#include <QDir>
+#include <QSaveFile>
+#include <QCryptographicHash>
+#include <QVector>
 
 
 //*************************************************************************************************************
@@ -189,6 +201,91 @@ void fromIntEigenMatrix_16(const Eigen::MatrixXi& from_mat, int **&to_mat)
 }
 
 
+//*************************************************************************************************************
+
+#define GUESS_CACHE_MAGIC "MNEGFLD1"
+
+typedef struct {
+    char   magic[8];            /* GUESS_CACHE_MAGIC */
+    char   key[20];             /* SHA-1 of everything the fields depend on */
+    qint32 nguess;              /* Number of guess locations */
+    qint32 nch;                 /* Number of channels */
+} guessCacheHeaderRec;
+
+
+static void hash_ints_16(QCryptographicHash& hash, const int *vals, int nval)
+{
+    hash.addData((const char *)vals,nval*sizeof(int));
+}
+
+
+static void hash_floats_16(QCryptographicHash& hash, const float *vals, int nval)
+{
+    hash.addData((const char *)vals,nval*sizeof(float));
+}
+
+
+static void hash_coils_16(QCryptographicHash& hash, const FwdCoilSet* coils)
+/*
+ * Everything in a coil definition which affects the computed fields
+ */
+{
+    int ncoil = coils ? coils->ncoil : 0;
+
+    hash_ints_16(hash,&ncoil,1);
+    for (int k = 0; k < ncoil; k++) {
+        const FwdCoil* coil = coils->coils[k];
+        int  ints[] = { coil->coord_frame, coil->coil_class, coil->type, coil->accuracy, coil->np };
+
+        hash_ints_16(hash,ints,5);
+        hash_floats_16(hash,coil->r0,3);
+        hash_floats_16(hash,coil->ex,3);
+        hash_floats_16(hash,coil->ey,3);
+        hash_floats_16(hash,coil->ez,3);
+        for (int p = 0; p < coil->np; p++) {
+            hash_floats_16(hash,coil->rmag[p],3);
+            hash_floats_16(hash,coil->cosmag[p],3);
+        }
+        hash_floats_16(hash,coil->w,coil->np);
+    }
+}
+
+
+static void hash_bem_16(QCryptographicHash& hash, const FwdBemModel* m)
+/*
+ * Everything in a loaded BEM model which affects the computed fields. The contents are hashed rather than the
+ * file name so that a model regenerated at the same path does not reuse stale fields.
+ */
+{
+    int nsurf = m ? m->nsurf : 0;
+
+    hash_ints_16(hash,&nsurf,1);
+    if (!m)
+        return;
+    int ints[] = { m->bem_method, m->nsol };
+    hash_ints_16(hash,ints,2);
+    hash_floats_16(hash,m->sigma,m->nsurf);
+    for (int k = 0; k < m->nsurf; k++) {
+        const MneSurfaceOld* surf = m->surfs[k];
+        int dims[] = { surf->id, surf->np, surf->ntri };
+
+        hash_ints_16(hash,dims,3);
+        for (int p = 0; p < surf->np; p++)
+            hash_floats_16(hash,surf->rr[p],3);
+        for (int t = 0; t < surf->ntri; t++)
+            hash_ints_16(hash,surf->itris[t],3);
+    }
+    if (m->head_mri_t) {
+        hash_floats_16(hash,m->head_mri_t->rot.data(),9);
+        hash_floats_16(hash,m->head_mri_t->move.data(),3);
+    }
+    if (m->solution) {
+        for (int k = 0; k < m->nsol; k++)
+            hash_floats_16(hash,m->solution[k],m->nsol);
+    }
+}
+
+
 //*************************************************************************************************************
 //=============================================================================================================
 // DEFINE MEMBER METHODS
@@ -212,7 +309,7 @@ GuessData::GuessData()
 
 //*************************************************************************************************************
 
-GuessData::GuessData(const QString &guessname, const QString &guess_surfname, float mindist, float exclude, float grid, DipoleFitData *f)
+GuessData::GuessData(const QString &guessname, const QString &guess_surfname, float mindist, float exclude, float grid, DipoleFitData *f, const QString &cachedir)
 {
     MneSourceSpaceOld* *sp = NULL;
     int            nsp = 0;
@@ -286,13 +383,21 @@ GuessData::GuessData(const QString &guessname, const QString &guess_surfname, fl
     else
         f->funcs = f->sphere_funcs;
 
-    for (k = 0; k < this->nguess; k++) {
-        if ((this->guess_fwd[k] = DipoleFitData::dipole_forward_one(f,this->rr[k],NULL)) == NULL)
+    if (!cachedir.isEmpty()) {
+        if (!compute_guess_fields_cached(f,cachedir)) {
+            f->funcs = orig;
             goto bad;
+        }
+    }
+    else {
+        for (k = 0; k < this->nguess; k++) {
+            if ((this->guess_fwd[k] = DipoleFitData::dipole_forward_one(f,this->rr[k],NULL)) == NULL)
+                goto bad;
 #ifdef DEBUG
-        sing = this->guess_fwd[k]->sing;
-        printf("%f %f %f\n",sing[0],sing[1],sing[2]);
+            sing = this->guess_fwd[k]->sing;
+            printf("%f %f %f\n",sing[0],sing[1],sing[2]);
 #endif
+        }
     }
     f->funcs = orig;
 
@@ -465,3 +570,115 @@ bool GuessData::compute_guess_fields(DipoleFitData* f)
 
     return true;
 }
+
+
+//*************************************************************************************************************
+
+QByteArray GuessData::guess_cache_key(DipoleFitData* f) const
+{
+    QCryptographicHash hash(QCryptographicHash::Sha1);
+    int ints[] = { f->fit_mag_dipoles, f->coord_frame, f->nmeg, f->neeg, this->nguess };
+
+    hash.addData(GUESS_CACHE_MAGIC);
+    hash_bem_16(hash,f->bem_model);
+    hash_ints_16(hash,ints,5);
+    hash_floats_16(hash,f->r0,3);
+    for (int k = 0; k < this->nguess; k++)
+        hash_floats_16(hash,this->rr[k],3);
+    /*
+     * Sensors and the compensation applied to the MEG fields
+     */
+    hash_coils_16(hash,f->meg_coils);
+    hash_coils_16(hash,f->eeg_els);
+    if (f->nmeg > 0 && f->funcs->meg_client) {
+        FwdCompData* comp = (FwdCompData*)f->funcs->meg_client;
+        hash_coils_16(hash,comp->comp_coils);
+        if (comp->set && comp->set->current && comp->set->current->data) {
+            MneNamedMatrix* data = comp->set->current->data;
+            int dims[] = { data->nrow, data->ncol };
+            hash_ints_16(hash,dims,2);
+            for (int k = 0; k < data->nrow; k++)
+                hash_floats_16(hash,data->data[k],data->ncol);
+        }
+    }
+    /*
+     * The EEG sphere model
+     */
+    if (f->neeg > 0 && f->eeg_model && !f->fit_mag_dipoles) {
+        FwdEegSphereModel* m = f->eeg_model;
+        int dims[] = { m->layers.size(), m->nterms, m->nfit, m->scale_pos };
+        hash_ints_16(hash,dims,4);
+        for (int k = 0; k < m->layers.size(); k++) {
+            float layer[] = { m->layers[k].rad, m->layers[k].rel_rad, m->layers[k].sigma };
+            hash_floats_16(hash,layer,3);
+        }
+        hash_floats_16(hash,m->r0.data(),3);
+        hash_floats_16(hash,m->mu.data(),m->mu.size());
+        hash_floats_16(hash,m->lambda.data(),m->lambda.size());
+    }
+    return hash.result();
+}
+
+
+//*************************************************************************************************************
+
+bool GuessData::compute_guess_fields_cached(DipoleFitData* f, const QString& cachedir)
+{
+    int                 nch    = f->nmeg+f->neeg;
+    qint64              nbytes = (qint64)this->nguess*3*nch*sizeof(float);
+    QByteArray          key    = guess_cache_key(f);
+    QFile               file(QDir(cachedir).filePath(QString("guess-%1.fld").arg(QString(key.toHex()))));
+    guessCacheHeaderRec header;
+    QVector<float>      computed;
+    const float         *fields = NULL;
+    int                 k;
+
+    memcpy(header.magic,GUESS_CACHE_MAGIC,8);
+    memcpy(header.key,key.constData(),20);
+    header.nguess = this->nguess;
+    header.nch    = nch;
+    /*
+     * Map the fields computed in an earlier run
+     */
+    if (file.open(QIODevice::ReadOnly) && file.size() == (qint64)sizeof(header)+nbytes) {
+        guessCacheHeaderRec stored;
+        if (file.read((char *)&stored,sizeof(stored)) == sizeof(stored) && memcmp(&stored,&header,sizeof(header)) == 0)
+            fields = (const float *)file.map(sizeof(header),nbytes);
+    }
+    if (fields)
+        printf("(cached in %s)...",file.fileName().toUtf8().constData());
+    else {
+        float *rows[3];
+
+        file.close();
+        computed.resize(3*this->nguess*nch);
+        for (k = 0; k < this->nguess; k++) {
+            rows[0] = computed.data()+(3*k+0)*nch;
+            rows[1] = computed.data()+(3*k+1)*nch;
+            rows[2] = computed.data()+(3*k+2)*nch;
+            if (DipoleFitData::compute_raw_dipole_field(f,this->rr[k],rows) == FAIL)
+                return false;
+        }
+        fields = computed.constData();
+        /*
+         * Store them for the next run
+         */
+        QSaveFile out(file.fileName());
+        if (QDir().mkpath(cachedir) && out.open(QIODevice::WriteOnly)) {
+            out.write((const char *)&header,sizeof(header));
+            out.write((const char *)fields,nbytes);
+            if (!out.commit())
+                printf("(could not write %s)...",out.fileName().toUtf8().constData());
+        }
+        else
+            printf("(could not write %s)...",out.fileName().toUtf8().constData());
+    }
+    /*
+     * Projection, whitening and SVD depend on the data set and are always done here
+     */
+    for (k = 0; k < this->nguess; k++) {
+        if ((this->guess_fwd[k] = DipoleFitData::dipole_forward_one(f,this->rr[k],fields+3*k*nch,this->guess_fwd[k])) == NULL)
+            return false;
+    }
+    return true;
+}
@@ -60,6 +60,8 @@
 //=============================================================================================================
 
 #include <QSharedPointer>
+#include <QByteArray>
+#include <QString>
 
 
 //*************************************************************************************************************
@@ -111,9 +113,10 @@ public:
      * Refactored: make_guess_data (setup.c)
      *
      * @param[in] guessname
+     * @param[in] cachedir   Directory where the guess fields are cached between runs (no caching if empty)
      *
      */
-    GuessData( const QString& guessname, const QString& guess_surfname, float mindist, float exclude, float grid, DipoleFitData* f);
+    GuessData( const QString& guessname, const QString& guess_surfname, float mindist, float exclude, float grid, DipoleFitData* f, const QString& cachedir = QString());
 
     //=========================================================================================================
     /**
@@ -145,6 +148,32 @@ public:
      */
     bool compute_guess_fields(DipoleFitData* f);
 
+private:
+    //=========================================================================================================
+    /**
+     * Key of the guess field cache. It covers the guess locations, the sensor and compensation definitions,
+     * the sphere model, the contents of the loaded BEM model (surfaces, conductivities and solution)
+     * and whether magnetic dipoles are fitted.
+     *
+     * @param[in] f      Dipole Fit Data with the guess forward functions selected
+     *
+     * @return the SHA-1 key
+     */
+    QByteArray guess_cache_key(DipoleFitData* f) const;
+
+    //=========================================================================================================
+    /**
+     * Computes the guess forward solutions from the fields stored in the cache directory. The fields are
+     * computed and stored first if they are not in the cache yet. Stored fields are memory-mapped.
+     * The fields are cached before projection and whitening, which are applied here for each data set.
+     *
+     * @param[in] f          Dipole Fit Data with the guess forward functions selected
+     * @param[in] cachedir   The cache directory
+     *
+     * @return true when successful
+     */
+    bool compute_guess_fields_cached(DipoleFitData* f, const QString& cachedir);
+
 public:
     float          **rr;            /**< These are the guess dipole locations */
     DipoleForward** guess_fwd;      /**< Forward solutions for the guesses */
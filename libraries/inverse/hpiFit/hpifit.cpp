@@ -90,6 +90,7 @@ using namespace FIFFLIB;
 //=============================================================================================================
 
 HPIFit::HPIFit()
+: m_bHasPrevious(false)
 {
 
 }
@@ -121,20 +122,11 @@ void HPIFit::fitHPI(const MatrixXd& t_mat,
 
     struct SensorInfo sensors;
     struct CoilParam coil;
-    int numCh = pFiffInfo->nchan;
     int samF = pFiffInfo->sfreq;
-    int samLoc = t_mat.cols(); // minimum samples required to localize numLoc times in a second
 
     //Get HPI coils from digitizers and set number of coils
-    int numCoils = 0;
-    QList<FiffDigPoint> lHPIPoints;
-
-    for(int i = 0; i < pFiffInfo->dig.size(); ++i) {
-        if(pFiffInfo->dig[i].kind == FIFFV_POINT_HPI) {
-            numCoils++;
-            lHPIPoints.append(pFiffInfo->dig[i]);
-        }
-    }
+    Eigen::MatrixXd headHPI = getHeadHPI(*pFiffInfo);
+    int numCoils = headHPI.rows();
 
     //Set coil frequencies
     Eigen::VectorXd coilfreq(numCoils);
@@ -155,50 +147,245 @@ void HPIFit::fitHPI(const MatrixXd& t_mat,
     coil.dpfiterror = Eigen::VectorXd::Zero(numCoils);
     coil.dpfitnumitr = Eigen::VectorXd::Zero(numCoils);
 
-    // Generate simulated data
-    Eigen::MatrixXd simsig(samLoc,numCoils*2);
-    Eigen::VectorXd time(samLoc);
+    // Get the indices of inner layer channels and exclude bad channels.
+    QVector<int> innerind(0);
+    MatrixXd matProjectorsInnerind;
+
+    setupInnerLayer(*pFiffInfo, t_matProjectors, innerind, sensors, matProjectorsInnerind);
+
+    //UTILSLIB::IOUtils::write_eigen_matrix(matProjectorsInnerind, "matProjectorsInnerind.txt");
+    //UTILSLIB::IOUtils::write_eigen_matrix(t_matProjectors, "t_matProjectors.txt");
+
+    // Get the data from inner layer channels
+    Eigen::MatrixXd innerdata(innerind.size(), t_mat.cols());
 
-    for (int i = 0; i < samLoc; ++i) {
-        time[i] = i*1.0/samF;
+    for(int j = 0; j < innerind.size(); ++j) {
+        innerdata.row(j) << t_mat.row(innerind[j]);
     }
 
-    for(int i = 0; i < numCoils; ++i) {
-        for(int j = 0; j < samLoc; ++j) {
-            simsig(j,i) = sin(2*M_PI*coilfreq[i]*time[j]);
-            simsig(j,i+numCoils) = cos(2*M_PI*coilfreq[i]*time[j]);
+    // Calculate topo and select sine or cosine component depending on the relative size
+    Eigen::MatrixXd amp = computeAmplitudes(innerdata,
+                                            computeReferencePinv(t_mat.cols(), samF, coilfreq),
+                                            numCoils);
+
+    //Find good seed point/starting point for the coil position in 3D space
+    Eigen::MatrixXd coilPos = Eigen::MatrixXd::Zero(numCoils,3);
+    VectorXi chIdcs(numCoils);
+
+    for (int j = 0; j < numCoils; ++j) {
+        coilPos.row(j) = computeSeedPosition(amp, innerind, *pFiffInfo, j, &chIdcs(j));
+    }
+
+    coil.pos = coilPos;
+
+    // Perform actual localization
+    coil = dipfit(coil, sensors, amp, numCoils, matProjectorsInnerind);
+
+    // Store the final result
+    storeFitResult(coil, headHPI, transDevHead, vGof, fittedPointSet);
+
+    if(bDoDebug) {
+        Eigen::Matrix4d trans = transDevHead.trans.cast<double>();
+
+        MatrixXd temp = coil.pos;
+        temp.conservativeResize(coil.pos.rows(),coil.pos.cols()+1);
+
+        temp.block(0,3,numCoils,1).setOnes();
+        temp.transposeInPlace();
+
+        MatrixXd testPos = trans * temp;
+        MatrixXd diffPos = testPos.block(0,0,3,numCoils) - headHPI.transpose();
+
+        // DEBUG HPI fitting and write debug results
+        std::cout << std::endl << std::endl << "HPIFit::fitHPI - dpfiterror" << coil.dpfiterror << std::endl << coil.pos << std::endl;
+        std::cout << std::endl << std::endl << "HPIFit::fitHPI - Initial seed point for HPI coils" << std::endl << coil.pos << std::endl;
+        std::cout << std::endl << std::endl << "HPIFit::fitHPI - temp" << std::endl << temp << std::endl;
+        std::cout << std::endl << std::endl << "HPIFit::fitHPI - testPos" << std::endl << testPos << std::endl;
+        std::cout << std::endl << std::endl << "HPIFit::fitHPI - Diff fitted - original" << std::endl << diffPos << std::endl;
+        std::cout << std::endl << std::endl << "HPIFit::fitHPI - dev/head trans" << std::endl << trans << std::endl;
+
+        QString sTimeStamp = QDateTime::currentDateTime().toString("yyMMdd_hhmmss");
+
+        if(!QDir(sHPIResourceDir).exists()) {
+            QDir().mkdir(sHPIResourceDir);
         }
+
+        UTILSLIB::IOUtils::write_eigen_matrix(coilPos, QString("%1/%2_coilPosSeed_mat").arg(sHPIResourceDir).arg(sTimeStamp));
+
+        UTILSLIB::IOUtils::write_eigen_matrix(coil.pos, QString("%1/%2_coilPos_mat").arg(sHPIResourceDir).arg(sTimeStamp));
+
+        UTILSLIB::IOUtils::write_eigen_matrix(headHPI, QString("%1/%2_headHPI_mat").arg(sHPIResourceDir).arg(sTimeStamp));
+
+        MatrixXd testPosCut = testPos.transpose();//block(0,0,3,4);
+        UTILSLIB::IOUtils::write_eigen_matrix(testPosCut, QString("%1/%2_testPos_mat").arg(sHPIResourceDir).arg(sTimeStamp));
+
+        MatrixXi idx_mat(chIdcs.rows(),1);
+        idx_mat.col(0) = chIdcs;
+        UTILSLIB::IOUtils::write_eigen_matrix(idx_mat, QString("%1/%2_idx_mat").arg(sHPIResourceDir).arg(sTimeStamp));
+
+        MatrixXd coilFreq_mat(coilfreq.rows(),1);
+        coilFreq_mat.col(0) = coilfreq;
+        UTILSLIB::IOUtils::write_eigen_matrix(coilFreq_mat, QString("%1/%2_coilFreq_mat").arg(sHPIResourceDir).arg(sTimeStamp));
+
+        UTILSLIB::IOUtils::write_eigen_matrix(diffPos, QString("%1/%2_diffPos_mat").arg(sHPIResourceDir).arg(sTimeStamp));
+
+        UTILSLIB::IOUtils::write_eigen_matrix(amp, QString("%1/%2_amp_mat").arg(sHPIResourceDir).arg(sTimeStamp));
     }
+}
 
-    // Create digitized HPI coil position matrix
-    Eigen::MatrixXd headHPI(numCoils,3);
-
-    // check the pFiffInfo->dig information. If dig is empty, set the headHPI is 0;
-    if (lHPIPoints.size() > 0) {
-        for (int i = 0; i < lHPIPoints.size(); ++i) {
-            headHPI(i,0) = lHPIPoints.at(i).r[0];
-            headHPI(i,1) = lHPIPoints.at(i).r[1];
-            headHPI(i,2) = lHPIPoints.at(i).r[2];
+
+//*************************************************************************************************************
+
+bool HPIFit::fitHPIContinuous(const MatrixXd& t_mat,
+                              const MatrixXd& t_matProjectors,
+                              FiffCoordTrans& transDevHead,
+                              const QVector<int>& vFreqs,
+                              QVector<double>& vGof,
+                              FiffDigPointSet& fittedPointSet,
+                              FiffInfo::SPtr pFiffInfo)
+{
+    if(!pFiffInfo || t_mat.rows() == 0 || t_mat.cols() == 0) {
+        std::cout<<std::endl<< "HPIFit::fitHPIContinuous - No data passed. Returning.";
+        return false;
+    }
+
+    vGof.clear();
+
+    //Redo the setup only if the session parameters changed. The digitizer points may be loaded into the same
+    //measurement info after the first fit, hence the HPI coils are compared as well.
+    Eigen::MatrixXd matHeadHPI = getHeadHPI(*pFiffInfo);
+
+    bool bDigitizerChanged = m_matHeadHPI.rows() != matHeadHPI.rows()
+                             || m_matHeadHPI.cols() != matHeadHPI.cols()
+                             || m_matHeadHPI != matHeadHPI;
+
+    bool bSetupChanged = bDigitizerChanged
+                         || m_pFiffInfo != pFiffInfo
+                         || m_lBads != pFiffInfo->bads
+                         || m_vFreqs != vFreqs
+                         || m_matSimsigPinvT.rows() != t_mat.cols()
+                         || m_matProjectors.rows() != t_matProjectors.rows()
+                         || m_matProjectors.cols() != t_matProjectors.cols()
+                         || m_matProjectors != t_matProjectors;
+
+    if(bSetupChanged) {
+        m_matHeadHPI = matHeadHPI;
+        int numCoils = m_matHeadHPI.rows();
+
+        if(vFreqs.size() < numCoils) {
+            std::cout<<std::endl<< "HPIFit::fitHPIContinuous - Not enough coil frequencies specified. Returning.";
+            resetContinuous();
+            return false;
         }
-    } else {
-        for (int i = 0; i < numCoils; ++i) {
-            headHPI(i,0) = 0;
-            headHPI(i,1) = 0;
-            headHPI(i,2) = 0;
+
+        Eigen::VectorXd coilfreq(numCoils);
+        for(int i = 0; i < numCoils; ++i) {
+            coilfreq[i] = vFreqs.at(i);
+        }
+
+        setupInnerLayer(*pFiffInfo, t_matProjectors, m_vInnerind, m_sensors, m_matProjectorsInnerind);
+        m_matSimsigPinvT = computeReferencePinv(t_mat.cols(), pFiffInfo->sfreq, coilfreq);
+
+        //The previous coil positions stay valid as long as the coils are the same
+        if(m_bHasPrevious && (bDigitizerChanged || m_coilPrevious.pos.rows() != numCoils)) {
+            m_bHasPrevious = false;
+        }
+
+        m_pFiffInfo = pFiffInfo;
+        m_lBads = pFiffInfo->bads;
+        m_vFreqs = vFreqs;
+        m_matProjectors = t_matProjectors;
+    }
+
+    const int numCoils = m_matHeadHPI.rows();
+
+    // Get the data from inner layer channels
+    m_matInnerdata.resize(m_vInnerind.size(), t_mat.cols());
+
+    for(int j = 0; j < m_vInnerind.size(); ++j) {
+        m_matInnerdata.row(j) = t_mat.row(m_vInnerind[j]);
+    }
+
+    Eigen::MatrixXd amp = computeAmplitudes(m_matInnerdata, m_matSimsigPinvT, numCoils);
+
+    // Warm start from the previous fit, coils which were not fitted well are seeded again
+    struct CoilParam coil;
+    coil.pos = computeStartPositions(amp, *pFiffInfo);
+    coil.mom = Eigen::MatrixXd::Zero(numCoils,3);
+    coil.dpfiterror = Eigen::VectorXd::Zero(numCoils);
+    coil.dpfitnumitr = Eigen::VectorXd::Zero(numCoils);
+
+    // Perform actual localization
+    coil = dipfit(coil, m_sensors, amp, numCoils, m_matProjectorsInnerind);
+
+    m_coilPrevious = coil;
+    m_bHasPrevious = true;
+
+    // Store the final result
+    storeFitResult(coil, m_matHeadHPI, transDevHead, vGof, fittedPointSet);
+
+    return true;
+}
+
+
+//*************************************************************************************************************
+
+void HPIFit::resetContinuous()
+{
+    m_pFiffInfo.clear();
+    m_lBads.clear();
+    m_vFreqs.clear();
+    m_matProjectors.resize(0,0);
+    m_matSimsigPinvT.resize(0,0);
+    m_matHeadHPI.resize(0,0);
+    m_bHasPrevious = false;
+}
+
+
+//*************************************************************************************************************
+
+MatrixXd HPIFit::getHeadHPI(const FiffInfo& fiffInfo)
+{
+    QList<FiffDigPoint> lHPIPoints;
+
+    for(int i = 0; i < fiffInfo.dig.size(); ++i) {
+        if(fiffInfo.dig[i].kind == FIFFV_POINT_HPI) {
+            lHPIPoints.append(fiffInfo.dig[i]);
         }
     }
 
+    // Create digitized HPI coil position matrix
+    Eigen::MatrixXd headHPI(lHPIPoints.size(),3);
+
+    for (int i = 0; i < lHPIPoints.size(); ++i) {
+        headHPI(i,0) = lHPIPoints.at(i).r[0];
+        headHPI(i,1) = lHPIPoints.at(i).r[1];
+        headHPI(i,2) = lHPIPoints.at(i).r[2];
+    }
+
+    return headHPI;
+}
+
+
+//*************************************************************************************************************
+
+void HPIFit::setupInnerLayer(const FiffInfo& fiffInfo,
+                             const MatrixXd& t_matProjectors,
+                             QVector<int>& innerind,
+                             SensorInfo& sensors,
+                             MatrixXd& matProjectorsInnerind)
+{
     // Get the indices of inner layer channels and exclude bad channels.
     //TODO: Only supports babymeg and vectorview gradiometeres for hpi fitting.
-    QVector<int> innerind(0);
+    innerind.clear();
 
-    for (int i = 0; i < numCh; ++i) {
-        if(pFiffInfo->chs[i].chpos.coil_type == FIFFV_COIL_BABY_MAG ||
-                pFiffInfo->chs[i].chpos.coil_type == FIFFV_COIL_VV_PLANAR_T1 ||
-                pFiffInfo->chs[i].chpos.coil_type == FIFFV_COIL_VV_PLANAR_T2 ||
-                pFiffInfo->chs[i].chpos.coil_type == FIFFV_COIL_VV_PLANAR_T3) {
+    for (int i = 0; i < fiffInfo.nchan; ++i) {
+        if(fiffInfo.chs[i].chpos.coil_type == FIFFV_COIL_BABY_MAG ||
+                fiffInfo.chs[i].chpos.coil_type == FIFFV_COIL_VV_PLANAR_T1 ||
+                fiffInfo.chs[i].chpos.coil_type == FIFFV_COIL_VV_PLANAR_T2 ||
+                fiffInfo.chs[i].chpos.coil_type == FIFFV_COIL_VV_PLANAR_T3) {
             // Check if the sensor is bad, if not append to innerind
-            if(!(pFiffInfo->bads.contains(pFiffInfo->ch_names.at(i)))) {
+            if(!(fiffInfo.bads.contains(fiffInfo.ch_names.at(i)))) {
                 innerind.append(i);
             }
         }
@@ -206,7 +393,7 @@ void HPIFit::fitHPI(const MatrixXd& t_mat,
 
     //Create new projector based on the excluded channels, first exclude the rows then the columns
     MatrixXd matProjectorsRows(innerind.size(),t_matProjectors.cols());
-    MatrixXd matProjectorsInnerind(innerind.size(),innerind.size());
+    matProjectorsInnerind.resize(innerind.size(),innerind.size());
 
     for (int i = 0; i < matProjectorsRows.rows(); ++i) {
         matProjectorsRows.row(i) = t_matProjectors.row(innerind.at(i));
@@ -216,100 +403,139 @@ void HPIFit::fitHPI(const MatrixXd& t_mat,
         matProjectorsInnerind.col(i) = matProjectorsRows.col(innerind.at(i));
     }
 
-    //UTILSLIB::IOUtils::write_eigen_matrix(matProjectorsInnerind, "matProjectorsInnerind.txt");
-    //UTILSLIB::IOUtils::write_eigen_matrix(t_matProjectors, "t_matProjectors.txt");
-
     // Initialize inner layer sensors
     sensors.coilpos = Eigen::MatrixXd::Zero(innerind.size(),3);
     sensors.coilori = Eigen::MatrixXd::Zero(innerind.size(),3);
     sensors.tra = Eigen::MatrixXd::Identity(innerind.size(),innerind.size());
 
     for(int i = 0; i < innerind.size(); i++) {
-        sensors.coilpos(i,0) = pFiffInfo->chs[innerind.at(i)].chpos.r0[0];
-        sensors.coilpos(i,1) = pFiffInfo->chs[innerind.at(i)].chpos.r0[1];
-        sensors.coilpos(i,2) = pFiffInfo->chs[innerind.at(i)].chpos.r0[2];
-        sensors.coilori(i,0) = pFiffInfo->chs[innerind.at(i)].chpos.ez[0];
-        sensors.coilori(i,1) = pFiffInfo->chs[innerind.at(i)].chpos.ez[1];
-        sensors.coilori(i,2) = pFiffInfo->chs[innerind.at(i)].chpos.ez[2];
+        sensors.coilpos(i,0) = fiffInfo.chs[innerind.at(i)].chpos.r0[0];
+        sensors.coilpos(i,1) = fiffInfo.chs[innerind.at(i)].chpos.r0[1];
+        sensors.coilpos(i,2) = fiffInfo.chs[innerind.at(i)].chpos.r0[2];
+        sensors.coilori(i,0) = fiffInfo.chs[innerind.at(i)].chpos.ez[0];
+        sensors.coilori(i,1) = fiffInfo.chs[innerind.at(i)].chpos.ez[1];
+        sensors.coilori(i,2) = fiffInfo.chs[innerind.at(i)].chpos.ez[2];
     }
+}
 
-    Eigen::MatrixXd topo(innerind.size(), numCoils*2);
-    Eigen::MatrixXd amp(innerind.size(), numCoils);
-    Eigen::MatrixXd ampC(innerind.size(), numCoils);
 
-    // Get the data from inner layer channels
-    Eigen::MatrixXd innerdata(innerind.size(), t_mat.cols());
+//*************************************************************************************************************
 
-    for(int j = 0; j < innerind.size(); ++j) {
-        innerdata.row(j) << t_mat.row(innerind[j]);
+MatrixXd HPIFit::computeReferencePinv(int iNumSamples,
+                                      double dSFreq,
+                                      const VectorXd& coilfreq)
+{
+    const int numCoils = coilfreq.size();
+
+    // Generate simulated data
+    Eigen::MatrixXd simsig(iNumSamples,numCoils*2);
+    Eigen::VectorXd time(iNumSamples);
+
+    for (int i = 0; i < iNumSamples; ++i) {
+        time[i] = i*1.0/dSFreq;
+    }
+
+    for(int i = 0; i < numCoils; ++i) {
+        for(int j = 0; j < iNumSamples; ++j) {
+            simsig(j,i) = sin(2*M_PI*coilfreq[i]*time[j]);
+            simsig(j,i+numCoils) = cos(2*M_PI*coilfreq[i]*time[j]);
+        }
     }
 
+    return UTILSLIB::MNEMath::pinv(simsig).transpose();
+}
+
+
+//*************************************************************************************************************
+
+MatrixXd HPIFit::computeAmplitudes(const MatrixXd& innerdata,
+                                   const MatrixXd& matSimsigPinvT,
+                                   int numCoils)
+{
     // Calculate topo
-    topo = innerdata * UTILSLIB::MNEMath::pinv(simsig).transpose(); // topo: # of good inner channel x 8
+    Eigen::MatrixXd topo = innerdata * matSimsigPinvT; // topo: # of good inner channel x 8
 
     // Select sine or cosine component depending on the relative size
-    amp  = topo.leftCols(numCoils); // amp: # of good inner channel x 4
-    ampC = topo.rightCols(numCoils);
+    Eigen::MatrixXd amp = topo.leftCols(numCoils); // amp: # of good inner channel x 4
 
     for(int j = 0; j < numCoils; ++j) {
-       float nS = 0.0;
-       float nC = 0.0;
-       for(int i = 0; i < innerind.size(); ++i) {
-           nS += amp(i,j)*amp(i,j);
-           nC += ampC(i,j)*ampC(i,j);
-       }
-
-       if(nC > nS) {
-         for(int i = 0; i < innerind.size(); ++i) {
-           amp(i,j) = ampC(i,j);
-         }
+       if(topo.col(numCoils + j).squaredNorm() > amp.col(j).squaredNorm()) {
+           amp.col(j) = topo.col(numCoils + j);
        }
     }
 
-    //Find good seed point/starting point for the coil position in 3D space
-    //Find biggest amplitude per pickup coil (sensor) and store corresponding sensor channel index
-    VectorXi chIdcs(numCoils);
+    return amp;
+}
 
-    for (int j = 0; j < numCoils; j++) {
-        double maxVal = 0;
-        int chIdx = 0;
 
-        for (int i = 0; i < amp.rows(); ++i) {
-            if(std::fabs(amp(i,j)) > maxVal) {
-                maxVal = std::fabs(amp(i,j));
+//*************************************************************************************************************
+
+RowVector3d HPIFit::computeSeedPosition(const MatrixXd& amp,
+                                        const QVector<int>& innerind,
+                                        const FiffInfo& fiffInfo,
+                                        int iCoil,
+                                        int* pChIdx)
+{
+    //Find biggest amplitude per pickup coil (sensor) and store corresponding sensor channel index
+    double maxVal = 0;
+    int chIdx = 0;
+
+    for (int i = 0; i < amp.rows(); ++i) {
+        if(std::fabs(amp(i,iCoil)) > maxVal) {
+            maxVal = std::fabs(amp(i,iCoil));
 
-                if(chIdx < innerind.size()) {
-                    chIdx = innerind.at(i);
-                }
+            if(chIdx < innerind.size()) {
+                chIdx = innerind.at(i);
             }
         }
+    }
 
-        chIdcs(j) = chIdx;
+    if(pChIdx) {
+        *pChIdx = chIdx;
     }
 
     //Generate seed point by projection the found channel position 3cm inwards
-    Eigen::MatrixXd coilPos = Eigen::MatrixXd::Zero(numCoils,3);
+    RowVector3d seedPos = RowVector3d::Zero();
 
-    for (int j = 0; j < chIdcs.rows(); ++j) {
-        int chIdx = chIdcs(j);
+    if(chIdx < fiffInfo.chs.size()) {
+        for(int k = 0; k < 3; ++k) {
+            seedPos(k) = -1 * fiffInfo.chs.at(chIdx).chpos.ez[k] * 0.03 + fiffInfo.chs.at(chIdx).chpos.r0[k];
+        }
+    }
 
-        if(chIdx < pFiffInfo->chs.size()) {
-            double x = pFiffInfo->chs.at(chIdcs(j)).chpos.r0[0];
-            double y = pFiffInfo->chs.at(chIdcs(j)).chpos.r0[1];
-            double z = pFiffInfo->chs.at(chIdcs(j)).chpos.r0[2];
+    return seedPos;
+}
 
-            coilPos(j,0) = -1 * pFiffInfo->chs.at(chIdcs(j)).chpos.ez[0] * 0.03 + x;
-            coilPos(j,1) = -1 * pFiffInfo->chs.at(chIdcs(j)).chpos.ez[1] * 0.03 + y;
-            coilPos(j,2) = -1 * pFiffInfo->chs.at(chIdcs(j)).chpos.ez[2] * 0.03 + z;
-        }
 
-        //std::cout << "HPIFit::fitHPI - Coil " << j << " max value index " << chIdx << std::endl;
+//*************************************************************************************************************
+
+MatrixXd HPIFit::computeStartPositions(const MatrixXd& amp,
+                                       const FiffInfo& fiffInfo) const
+{
+    const int numCoils = amp.cols();
+    MatrixXd startPos = MatrixXd::Zero(numCoils,3);
+
+    for (int j = 0; j < numCoils; ++j) {
+        if(m_bHasPrevious && m_coilPrevious.dpfiterror(j) < HPI_WARM_START_MAX_ERROR) {
+            startPos.row(j) = m_coilPrevious.pos.row(j);
+        } else {
+            startPos.row(j) = computeSeedPosition(amp, m_vInnerind, fiffInfo, j);
+        }
     }
 
-    coil.pos = coilPos;
+    return startPos;
+}
 
-    // Perform actual localization
-    coil = dipfit(coil, sensors, amp, numCoils, matProjectorsInnerind);
+
+//*************************************************************************************************************
+
+void HPIFit::storeFitResult(const CoilParam& coil,
+                            const MatrixXd& headHPI,
+                            FiffCoordTrans& transDevHead,
+                            QVector<double>& vGof,
+                            FiffDigPointSet& fittedPointSet)
+{
+    const int numCoils = coil.pos.rows();
 
     Eigen::Matrix4d trans = computeTransformation(headHPI, coil.pos);
     //Eigen::Matrix4d trans = computeTransformation(coil.pos, headHPI);
@@ -353,43 +579,6 @@ void HPIFit::fitHPI(const MatrixXd& t_mat,
 
         fittedPointSet << digPoint;
     }
-
-    if(bDoDebug) {
-        // DEBUG HPI fitting and write debug results
-        std::cout << std::endl << std::endl << "HPIFit::fitHPI - dpfiterror" << coil.dpfiterror << std::endl << coil.pos << std::endl;
-        std::cout << std::endl << std::endl << "HPIFit::fitHPI - Initial seed point for HPI coils" << std::endl << coil.pos << std::endl;
-        std::cout << std::endl << std::endl << "HPIFit::fitHPI - temp" << std::endl << temp << std::endl;
-        std::cout << std::endl << std::endl << "HPIFit::fitHPI - testPos" << std::endl << testPos << std::endl;
-        std::cout << std::endl << std::endl << "HPIFit::fitHPI - Diff fitted - original" << std::endl << diffPos << std::endl;
-        std::cout << std::endl << std::endl << "HPIFit::fitHPI - dev/head trans" << std::endl << trans << std::endl;
-
-        QString sTimeStamp = QDateTime::currentDateTime().toString("yyMMdd_hhmmss");
-
-        if(!QDir(sHPIResourceDir).exists()) {
-            QDir().mkdir(sHPIResourceDir);
-        }
-
-        UTILSLIB::IOUtils::write_eigen_matrix(coilPos, QString("%1/%2_coilPosSeed_mat").arg(sHPIResourceDir).arg(sTimeStamp));
-
-        UTILSLIB::IOUtils::write_eigen_matrix(coil.pos, QString("%1/%2_coilPos_mat").arg(sHPIResourceDir).arg(sTimeStamp));
-
-        UTILSLIB::IOUtils::write_eigen_matrix(headHPI, QString("%1/%2_headHPI_mat").arg(sHPIResourceDir).arg(sTimeStamp));
-
-        MatrixXd testPosCut = testPos.transpose();//block(0,0,3,4);
-        UTILSLIB::IOUtils::write_eigen_matrix(testPosCut, QString("%1/%2_testPos_mat").arg(sHPIResourceDir).arg(sTimeStamp));
-
-        MatrixXi idx_mat(chIdcs.rows(),1);
-        idx_mat.col(0) = chIdcs;
-        UTILSLIB::IOUtils::write_eigen_matrix(idx_mat, QString("%1/%2_idx_mat").arg(sHPIResourceDir).arg(sTimeStamp));
-
-        MatrixXd coilFreq_mat(coilfreq.rows(),1);
-        coilFreq_mat.col(0) = coilfreq;
-        UTILSLIB::IOUtils::write_eigen_matrix(coilFreq_mat, QString("%1/%2_coilFreq_mat").arg(sHPIResourceDir).arg(sTimeStamp));
-
-        UTILSLIB::IOUtils::write_eigen_matrix(diffPos, QString("%1/%2_diffPos_mat").arg(sHPIResourceDir).arg(sTimeStamp));
-
-        UTILSLIB::IOUtils::write_eigen_matrix(amp, QString("%1/%2_amp_mat").arg(sHPIResourceDir).arg(sTimeStamp));
-    }
 }
 
 
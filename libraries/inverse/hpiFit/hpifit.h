@@ -42,6 +42,7 @@
 //=============================================================================================================
 
 #include "../inverse_global.h"
+#include "hpifitdata.h"
 
 
 //*************************************************************************************************************
@@ -58,6 +59,16 @@
 //=============================================================================================================
 
 #include <QSharedPointer>
+#include <QStringList>
+#include <QVector>
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// DEFINES
+//=============================================================================================================
+
+#define HPI_WARM_START_MAX_ERROR 0.1    /**< Coils whose previous fit left a higher relative residual are seeded again instead of warm-started. */
 
 
 //*************************************************************************************************************
@@ -145,7 +156,143 @@ public:
                        bool bDoDebug = false,
                        const QString& sHPIResourceDir = QString("./HPIFittingDebug"));
 
+    //=========================================================================================================
+    /**
+     * Perform one HPI fit of a continuous HPI tracking session. In contrast to fitHPI the lock-in reference
+     * signals and their pseudo inverse, the inner layer sensor geometry, the digitized HPI coils and the
+     * projector restricted to the inner layer channels are computed once and reused as long as the number of
+     * samples, the coil frequencies, the projectors, the bad channels and the digitized HPI coils do not change.
+     * Each coil fit is warm-started from the coil position of the previous fit, unless the digitized HPI coils
+     * changed.
+     *
+     * @param[in]    t_mat           Data to estimate the HPI positions from
+     * @param[in]    t_matProjectors The projectors to apply. Bad channels are still included.
+     * @param[out]   transDevHead    The final dev head transformation matrix
+     * @param[in]    vFreqs          The frequencies for each coil.
+     * @param[out]   vGof            The goodness of fit in mm for each fitted HPI coil.
+     * @param[out]   fittedPointSet  The final fitted positions in form of a digitizer set.
+     * @param[in]    p_pFiffInfo     Associated Fiff Information.
+     *
+     * @return true if the fit was performed, false otherwise.
+     */
+    bool fitHPIContinuous(const Eigen::MatrixXd& t_mat,
+                          const Eigen::MatrixXd& t_matProjectors,
+                          FIFFLIB::FiffCoordTrans &transDevHead,
+                          const QVector<int>& vFreqs,
+                          QVector<double> &vGof,
+                          FIFFLIB::FiffDigPointSet& fittedPointSet,
+                          QSharedPointer<FIFFLIB::FiffInfo> pFiffInfo);
+
+    //=========================================================================================================
+    /**
+     * Discards the cached setup and the coil positions of the continuous HPI tracking session.
+     */
+    void resetContinuous();
+
 protected:
+    //=========================================================================================================
+    /**
+     * Collects the digitized HPI coil positions.
+     *
+     * @param[in] fiffInfo   The measurement information.
+     *
+     * @return The HPI coil positions in head space (number of coils x 3).
+     */
+    static Eigen::MatrixXd getHeadHPI(const FIFFLIB::FiffInfo& fiffInfo);
+
+    //=========================================================================================================
+    /**
+     * Selects the good inner layer channels and sets up their geometry and the projector restricted to them.
+     *
+     * @param[in] fiffInfo           The measurement information.
+     * @param[in] t_matProjectors    The projectors to apply. Bad channels are still included.
+     * @param[out] innerind          The indices of the selected channels.
+     * @param[out] sensors           The geometry of the selected channels.
+     * @param[out] matProjectorsInnerind The projector restricted to the selected channels.
+     */
+    static void setupInnerLayer(const FIFFLIB::FiffInfo& fiffInfo,
+                                const Eigen::MatrixXd& t_matProjectors,
+                                QVector<int>& innerind,
+                                SensorInfo& sensors,
+                                Eigen::MatrixXd& matProjectorsInnerind);
+
+    //=========================================================================================================
+    /**
+     * Computes the transposed pseudo inverse of the sine and cosine reference signals of the coils.
+     *
+     * @param[in] iNumSamples    The number of samples.
+     * @param[in] dSFreq         The sampling frequency.
+     * @param[in] coilfreq       The frequencies of the coils.
+     *
+     * @return The transposed pseudo inverse (number of samples x 2 * number of coils).
+     */
+    static Eigen::MatrixXd computeReferencePinv(int iNumSamples,
+                                                double dSFreq,
+                                                const Eigen::VectorXd& coilfreq);
+
+    //=========================================================================================================
+    /**
+     * Demodulates the inner layer data and selects the sine or cosine amplitude of each coil.
+     *
+     * @param[in] innerdata          The data of the inner layer channels.
+     * @param[in] matSimsigPinvT     The transposed pseudo inverse of the reference signals.
+     * @param[in] numCoils           The number of coils.
+     *
+     * @return The coil amplitudes (number of inner layer channels x number of coils).
+     */
+    static Eigen::MatrixXd computeAmplitudes(const Eigen::MatrixXd& innerdata,
+                                             const Eigen::MatrixXd& matSimsigPinvT,
+                                             int numCoils);
+
+    //=========================================================================================================
+    /**
+     * Generates the seed position of a coil by projecting the position of the channel with the biggest
+     * amplitude 3cm inwards.
+     *
+     * @param[in] amp        The coil amplitudes.
+     * @param[in] innerind   The indices of the inner layer channels.
+     * @param[in] fiffInfo   The measurement information.
+     * @param[in] iCoil      The coil.
+     * @param[out] pChIdx    If not null, receives the index of the channel the seed was generated from.
+     *
+     * @return The seed position.
+     */
+    static Eigen::RowVector3d computeSeedPosition(const Eigen::MatrixXd& amp,
+                                                  const QVector<int>& innerind,
+                                                  const FIFFLIB::FiffInfo& fiffInfo,
+                                                  int iCoil,
+                                                  int* pChIdx = Q_NULLPTR);
+
+    //=========================================================================================================
+    /**
+     * Computes the start positions of the coils for a continuous fit. Coils whose previous fit left a relative
+     * residual below HPI_WARM_START_MAX_ERROR start from their previous position, all others from their seed
+     * position.
+     *
+     * @param[in] amp        The coil amplitudes of the good inner layer channels.
+     * @param[in] fiffInfo   The measurement information.
+     *
+     * @return The start positions (number of coils x 3).
+     */
+    Eigen::MatrixXd computeStartPositions(const Eigen::MatrixXd& amp,
+                                          const FIFFLIB::FiffInfo& fiffInfo) const;
+
+    //=========================================================================================================
+    /**
+     * Computes the dev head transformation, the goodness of fit and the fitted point set from the fitted coils.
+     *
+     * @param[in]    coil            The fitted coil parameters.
+     * @param[in]    headHPI         The digitized HPI coil positions.
+     * @param[out]   transDevHead    The final dev head transformation matrix
+     * @param[out]   vGof            The goodness of fit in mm for each fitted HPI coil.
+     * @param[out]   fittedPointSet  The final fitted positions in form of a digitizer set.
+     */
+    static void storeFitResult(const CoilParam& coil,
+                               const Eigen::MatrixXd& headHPI,
+                               FIFFLIB::FiffCoordTrans &transDevHead,
+                               QVector<double> &vGof,
+                               FIFFLIB::FiffDigPointSet& fittedPointSet);
+
     //=========================================================================================================
     /**
      * Fits dipoles for the given coils and a given data set.
@@ -172,6 +319,19 @@ protected:
     static Eigen::Matrix4d computeTransformation(Eigen::MatrixXd NH, Eigen::MatrixXd BT);
 
     static QString         m_sHPIResourceDir;      /**< Hold the resource folder to store the debug information in. */
+
+    QSharedPointer<FIFFLIB::FiffInfo>   m_pFiffInfo;                /**< The measurement information the continuous setup was computed for. */
+    QStringList         m_lBads;                    /**< The bad channels the continuous setup was computed for. */
+    QVector<int>        m_vFreqs;                   /**< The coil frequencies the continuous setup was computed for. */
+    Eigen::MatrixXd     m_matProjectors;            /**< The projectors the continuous setup was computed for. */
+    QVector<int>        m_vInnerind;                /**< The indices of the good inner layer channels. */
+    SensorInfo          m_sensors;                  /**< The geometry of the good inner layer channels. */
+    Eigen::MatrixXd     m_matProjectorsInnerind;    /**< The projectors restricted to the good inner layer channels. */
+    Eigen::MatrixXd     m_matSimsigPinvT;           /**< The transposed pseudo inverse of the reference signals. */
+    Eigen::MatrixXd     m_matHeadHPI;               /**< The digitized HPI coil positions. */
+    Eigen::MatrixXd     m_matInnerdata;             /**< Reused data of the inner layer channels. */
+    CoilParam           m_coilPrevious;             /**< The coil parameters of the previous fit, used for warm starts. */
+    bool                m_bHasPrevious;             /**< Whether m_coilPrevious holds a valid fit. */
 };
 
 //*************************************************************************************************************
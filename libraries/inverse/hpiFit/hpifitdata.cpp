@@ -106,7 +106,7 @@ void HPIFitData::doDipfitConcurrent()
                                currentSensors,
                                simplex_numitr);
 
-    this->errorInfo = dipfitError(currentCoil,
+    this->errorInfo = dipfitError(this->coilPos,
                                   currentData,
                                   currentSensors,
                                   this->matProjector);
@@ -51,6 +51,7 @@
 //=============================================================================================================
 
 #include <iostream>
+#include <algorithm>
 
 
 //*************************************************************************************************************
@@ -79,6 +80,7 @@ using namespace INVERSELIB;
 MinimumNorm::MinimumNorm(const MNEInverseOperator &p_inverseOperator, float lambda, const QString method)
 : m_inverseOperator(p_inverseOperator)
 , inverseSetup(false)
+, m_bSinglePrecision(false)
 {
     this->setRegularization(lambda);
     this->setMethod(method);
@@ -89,6 +91,7 @@ MinimumNorm::MinimumNorm(const MNEInverseOperator &p_inverseOperator, float lamb
 MinimumNorm::MinimumNorm(const MNEInverseOperator &p_inverseOperator, float lambda, bool dSPM, bool sLORETA)
 : m_inverseOperator(p_inverseOperator)
 , inverseSetup(false)
+, m_bSinglePrecision(false)
 {
     this->setRegularization(lambda);
     this->setMethod(dSPM, sLORETA);
@@ -201,40 +204,18 @@ MNESourceEstimate MinimumNorm::calculateInverse(const MatrixXd &data, float tmin
         return MNESourceEstimate();
     }
 
-    if(K.cols() != data.rows()) {
-        qWarning() << "MinimumNorm::calculateInverse - Dimension mismatch between K.cols() and data.rows() -" << K.cols() << "and" << data.rows();
+    int iKernelCols = m_bSinglePrecision ? m_matKernelSingle.cols() : K.cols();
+
+    if(iKernelCols != data.rows()) {
+        qWarning() << "MinimumNorm::calculateInverse - Dimension mismatch between K.cols() and data.rows() -" << iKernelCols << "and" << data.rows();
         return MNESourceEstimate();
     }
 
-    MatrixXd sol = K * data; //apply imaging kernel
-
-
-    if (inv.source_ori == FIFFV_MNE_FREE_ORI && pick_normal == false)
-    {
-        printf("combining the current components...\n");
-
-        MatrixXd sol1(sol.rows()/3,sol.cols());
-        for(qint32 i = 0; i < sol.cols(); ++i)
-        {
-            VectorXd* tmp = MNEMath::combine_xyz(sol.col(i));
-            sol1.block(0,i,sol.rows()/3,1) = tmp->cwiseSqrt();
-            delete tmp;
-        }
-        sol.resize(sol1.rows(),sol1.cols());
-        sol = sol1;
-    }
+    MatrixXd sol(getNumberOfSources(pick_normal), data.cols());
 
-    if (m_bdSPM)
-    {
-        printf("(dSPM)...");
-        sol = inv.noisenorm*sol;
-    }
-    else if (m_bsLORETA)
-    {
-        printf("(sLORETA)...");
-        sol = inv.noisenorm*sol;
+    if(!applyInverse(data, sol, pick_normal)) {
+        return MNESourceEstimate();
     }
-    printf("[done]\n");
 
     //Results
     VectorXi p_vecVertices(inv.src[0].vertno.size() + inv.src[1].vertno.size());
@@ -249,6 +230,108 @@ MNESourceEstimate MinimumNorm::calculateInverse(const MatrixXd &data, float tmin
 }
 
 
+//*************************************************************************************************************
+
+bool MinimumNorm::applyInverse(const MatrixXd &data,
+                               Ref<MatrixXd> matSol,
+                               bool pick_normal,
+                               int iBlockSize) const
+{
+    if(!inverseSetup)
+    {
+        qWarning("MinimumNorm::applyInverse - Inverse not setup -> call doInverseSetup first!");
+        return false;
+    }
+
+    int iKernelCols = m_bSinglePrecision ? m_matKernelSingle.cols() : K.cols();
+
+    if(iKernelCols != data.rows()) {
+        qWarning() << "MinimumNorm::applyInverse - Dimension mismatch between K.cols() and data.rows() -" << iKernelCols << "and" << data.rows();
+        return false;
+    }
+
+    bool bCombineXyz = (inv.source_ori == FIFFV_MNE_FREE_ORI && pick_normal == false);
+    int iNSources = getNumberOfSources(pick_normal);
+
+    if(matSol.rows() != iNSources || matSol.cols() != data.cols()) {
+        qWarning() << "MinimumNorm::applyInverse - Solution buffer has wrong dimensions -" << matSol.rows() << "x" << matSol.cols() << "instead of" << iNSources << "x" << data.cols();
+        return false;
+    }
+
+    // dSPM and sLORETA noise normalization. The noise normalization matrix is diagonal.
+    VectorXd vecNoiseNorm;
+    if(m_bdSPM || m_bsLORETA) {
+        if(inv.noisenorm.rows() != iNSources) {
+            qWarning() << "MinimumNorm::applyInverse - Dimension mismatch between noise normalization and sources -" << inv.noisenorm.rows() << "and" << iNSources;
+            return false;
+        }
+
+        vecNoiseNorm = inv.noisenorm.diagonal();
+    }
+
+    if(iBlockSize <= 0) {
+        iBlockSize = data.cols();
+    }
+
+    MatrixXd matBlock;
+    MatrixXf matBlockSingle;
+    int iCols;
+
+    for(int iStart = 0; iStart < data.cols(); iStart += iBlockSize) {
+        iCols = std::min(iBlockSize, int(data.cols()) - iStart);
+
+        if(m_bSinglePrecision) {
+            //apply imaging kernel in single precision, pooling and noise normalization are done in double
+            matBlockSingle.noalias() = m_matKernelSingle * data.middleCols(iStart, iCols).cast<float>();
+
+            if(bCombineXyz) {
+                matBlock = matBlockSingle.cast<double>();
+
+                for(int i = 0; i < iCols; ++i) {
+                    matSol.col(iStart + i) = Map<const MatrixXd>(matBlock.col(i).data(), 3, iNSources).colwise().norm().transpose();
+                }
+            } else {
+                matSol.middleCols(iStart, iCols) = matBlockSingle.cast<double>();
+            }
+        } else if(bCombineXyz) {
+            //apply imaging kernel and combine the current components
+            matBlock.noalias() = K * data.middleCols(iStart, iCols);
+
+            for(int i = 0; i < iCols; ++i) {
+                matSol.col(iStart + i) = Map<const MatrixXd>(matBlock.col(i).data(), 3, iNSources).colwise().norm().transpose();
+            }
+        } else {
+            //apply imaging kernel
+            matSol.middleCols(iStart, iCols).noalias() = K * data.middleCols(iStart, iCols);
+        }
+
+        if(vecNoiseNorm.size() > 0) {
+            matSol.middleCols(iStart, iCols).array().colwise() *= vecNoiseNorm.array();
+        }
+    }
+
+    return true;
+}
+
+
+//*************************************************************************************************************
+
+int MinimumNorm::getNumberOfSources(bool pick_normal) const
+{
+    if(!inverseSetup) {
+        return -1;
+    }
+
+    int iKernelRows = m_bSinglePrecision ? m_matKernelSingle.rows() : K.rows();
+
+    if(inv.source_ori == FIFFV_MNE_FREE_ORI && pick_normal == false) {
+        return iKernelRows / 3;
+    }
+
+    return iKernelRows;
+}
+
+
 //*************************************************************************************************************
 
 void MinimumNorm::doInverseSetup(qint32 nave, bool pick_normal)
@@ -263,6 +346,13 @@ void MinimumNorm::doInverseSetup(qint32 nave, bool pick_normal)
 
     std::cout << "K " << K.rows() << " x " << K.cols() << std::endl;
 
+    if(m_bSinglePrecision) {
+        m_matKernelSingle = K.cast<float>();
+        K.resize(0, 0);
+    } else {
+        m_matKernelSingle.resize(0, 0);
+    }
+
     inverseSetup = true;
 }
 
@@ -334,3 +424,16 @@ void MinimumNorm::setRegularization(float lambda)
 {
     m_fLambda = lambda;
 }
+
+
+//*************************************************************************************************************
+
+void MinimumNorm::setSinglePrecision(bool bSinglePrecision)
+{
+    if(inverseSetup && bSinglePrecision != m_bSinglePrecision) {
+        qWarning("MinimumNorm::setSinglePrecision - Precision changed after the inverse setup -> call doInverseSetup again!");
+        inverseSetup = false;
+    }
+
+    m_bSinglePrecision = bSinglePrecision;
+}
@@ -128,6 +128,37 @@ public:
 
     virtual MNESourceEstimate calculateInverse(const MatrixXd &data, float tmin, float tstep, bool pick_normal = false) const;
 
+    //=========================================================================================================
+    /**
+     * Applies the imaging kernel to a batch of data, e.g. a long raw segment or several epochs which are stacked
+     * column-wise. The data is processed in blocks of columns. The norm over the three orientations (free orientation
+     * only) and the dSPM/sLORETA noise normalization are applied to each block directly after the kernel
+     * multiplication, so no further passes over the solution and no temporary allocations per column are needed.
+     * doInverseSetup has to be called before.
+     *
+     * @param[in] data           The data (channels x samples).
+     * @param[out] matSol        The caller provided buffer (sources x samples) the solution is written to.
+     * @param[in] pick_normal    Must match the value used in doInverseSetup. If False, the three orientations of free
+     *                           orientation sources are pooled by taking the norm.
+     * @param[in] iBlockSize     The number of columns which are processed at once.
+     *
+     * @return true if successful, false otherwise (inverse not set up or dimension mismatch).
+     */
+    bool applyInverse(const MatrixXd &data,
+                      Eigen::Ref<MatrixXd> matSol,
+                      bool pick_normal = false,
+                      int iBlockSize = 256) const;
+
+    //=========================================================================================================
+    /**
+     * Returns the number of rows the solution of applyInverse will have.
+     *
+     * @param[in] pick_normal    Must match the value used in doInverseSetup.
+     *
+     * @return the number of sources, -1 if the inverse is not set up.
+     */
+    int getNumberOfSources(bool pick_normal = false) const;
+
     //=========================================================================================================
     /**
      * Perform the inverse setup: Prepares this inverse operator and assembles the kernel.
@@ -187,6 +218,28 @@ public:
      */
     void setRegularization(float lambda);
 
+    //=========================================================================================================
+    /**
+     * Set whether the imaging kernel is stored and applied in single precision. The kernel is still assembled in
+     * double precision, only the result is converted. The kernel multiplication then runs in float, while the
+     * orientation pooling and the noise normalization are done in double. This halves the memory footprint of the
+     * kernel and the memory bandwidth needed per sample. Since the sum over the channels is accumulated in float,
+     * the error is bounded relative to the largest source amplitude (below 1e-4 on the sample data, see
+     * test_minimum_norm) rather than relative to each source.
+     * Has to be set before doInverseSetup is called. If active, getKernel returns an empty matrix.
+     *
+     * @param[in] bSinglePrecision   Whether to use a single precision kernel.
+     */
+    void setSinglePrecision(bool bSinglePrecision);
+
+    //=========================================================================================================
+    /**
+     * Returns whether the imaging kernel is stored and applied in single precision.
+     *
+     * @return true if the single precision kernel is used, false otherwise.
+     */
+    inline bool isSinglePrecision() const;
+
     //=========================================================================================================
     /**
      * Get the assembled kernel
@@ -208,6 +261,8 @@ private:
     QList<VectorXi> vertno;                 /**< The vertices numbers */
     Label label;                            /**< The corresponding labels */
     MatrixXd K;                             /**< Imaging kernel */
+    MatrixXf m_matKernelSingle;             /**< Imaging kernel in single precision, only used if m_bSinglePrecision is set */
+    bool m_bSinglePrecision;                /**< Store and apply the imaging kernel in single precision */
 
 };
 
@@ -229,6 +284,14 @@ inline MNEInverseOperator& MinimumNorm::getPreparedInverseOperator()
     return inv;
 }
 
+
+//*************************************************************************************************************
+
+inline bool MinimumNorm::isSinglePrecision() const
+{
+    return m_bSinglePrecision;
+}
+
 } //NAMESPACE
 
 #endif // MINIMUMNORM_H
@@ -133,7 +133,7 @@ public:
     MneNamedMatrix*  data;      /* The compensation data */
     FIFFLIB::FiffSparseMatrix* presel;   /* Apply this selector prior to compensation */
     FIFFLIB::FiffSparseMatrix* postsel;  /* Apply this selector after compensation */
-    float           *presel_data;           /* These are used for the intermediate results in the calculations */
+    float           *presel_data;           /* Unused: mne_apply_ctf_comp keeps its intermediate results in local space */
     float           *comp_data;
     float           *postsel_data;
 
@@ -145,7 +145,7 @@ public:
 //    MNELIB::MneNamedMatrix*  data;      /* The compensation data */
 //    MNELIB::FiffSparseMatrix* presel;   /* Apply this selector prior to compensation */
 //    MNELIB::FiffSparseMatrix* postsel;  /* Apply this selector after compensation */
-//    float           *presel_data;           /* These are used for the intermediate results in the calculations */
+//    float           *presel_data;           /* Unused: mne_apply_ctf_comp keeps its intermediate results in local space */
 //    float           *comp_data;
 //    float           *postsel_data;
 //} *mneCTFcompData,mneCTFcompDataRec;
@@ -1014,6 +1014,7 @@ int MneCTFCompDataSet::mne_apply_ctf_comp(MneCTFCompDataSet *set, int do_it, flo
 {
     MneCTFCompData* this_comp;
     float *presel,*comp;
+    VectorXf vecPresel,vecComp,vecPostsel;  /* Intermediate results, local so that the set can be shared by threads */
     int   k;
 
     if (compdata == NULL) {
@@ -1054,32 +1055,28 @@ int MneCTFCompDataSet::mne_apply_ctf_comp(MneCTFCompDataSet *set, int do_it, flo
         * Preselection is optional
         */
     if (this_comp->presel) {
-        if (!this_comp->presel_data)
-            this_comp->presel_data = MALLOC_32(this_comp->presel->m,float);
-        if (mne_sparse_vec_mult2_32(this_comp->presel,compdata,this_comp->presel_data) != OK)
+        vecPresel.resize(this_comp->presel->m);
+        if (mne_sparse_vec_mult2_32(this_comp->presel,compdata,vecPresel.data()) != OK)
             return FAIL;
-        presel = this_comp->presel_data;
+        presel = vecPresel.data();
     }
     else
         presel = compdata;
     /*
         * This always happens
         */
-    if (!this_comp->comp_data)
-        this_comp->comp_data = MALLOC_32(this_comp->data->nrow,float);
-    mne_mat_vec_mult2_32(this_comp->data->data,presel,this_comp->comp_data,this_comp->data->nrow,this_comp->data->ncol);
+    vecComp.resize(this_comp->data->nrow);
+    mne_mat_vec_mult2_32(this_comp->data->data,presel,vecComp.data(),this_comp->data->nrow,this_comp->data->ncol);
     /*
         * Optional postselection
         */
     if (!this_comp->postsel)
-        comp = this_comp->comp_data;
+        comp = vecComp.data();
     else {
-        if (!this_comp->postsel_data) {
-            this_comp->postsel_data = MALLOC_32(this_comp->postsel->m,float);
-        }
-        if (mne_sparse_vec_mult2_32(this_comp->postsel,this_comp->comp_data,this_comp->postsel_data) != OK)
+        vecPostsel.resize(this_comp->postsel->m);
+        if (mne_sparse_vec_mult2_32(this_comp->postsel,vecComp.data(),vecPostsel.data()) != OK)
             return FAIL;
-        comp = this_comp->postsel_data;
+        comp = vecPostsel.data();
     }
     /*
         * Compensate or revert compensation?
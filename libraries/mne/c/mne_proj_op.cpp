@@ -480,10 +480,10 @@ int MneProjOp::mne_proj_op_proj_vector(MneProjOp *op, float *vec, int nvec, int
 /*
      * Apply projection operator to a vector (floats)
      * Assume that all dimension checking etc. has been done before
+     * The work vector is local so that the projection can be applied from several threads at once
      */
 {
-    static float *res = NULL;
-    int    res_size   = 0;
+    float *res;
     float *pvec;
     float  w;
     int k,p;
@@ -496,11 +496,7 @@ int MneProjOp::mne_proj_op_proj_vector(MneProjOp *op, float *vec, int nvec, int
         return FAIL;
     }
 
-    if (op->nch > res_size) {
-        res = REALLOC_23(res,op->nch,float);
-        res_size = op->nch;
-    }
-
+    res = MALLOC_23(op->nch,float);
     for (k = 0; k < op->nch; k++)
         res[k] = 0.0;
 
@@ -518,6 +514,7 @@ int MneProjOp::mne_proj_op_proj_vector(MneProjOp *op, float *vec, int nvec, int
         for (k = 0; k < op->nch; k++)
             vec[k] = res[k];
     }
+    FREE_23(res);
     return OK;
 }
 
@@ -97,10 +97,12 @@ RtAveWorker::RtAveWorker(quint32 numAverages,
 , m_bDoBaselineCorrection(false)
 , m_pairBaselineSec(qMakePair(QVariant(QString::number(iBaselineFromSecs)),QVariant(QString::number(iBaselineToSecs))))
 , m_bActivateThreshold(false)
+, m_iNumSamples(0)
 {
     m_mapThresholds["eog"] = 300e-6;
 
     m_stimEvokedSet.info = *m_pFiffInfo.data();
+    m_stdErrEvokedSet.info = *m_pFiffInfo.data();
 
     m_iNewPreStimSamples = m_iPreStimSamples;
     m_iNewPostStimSamples = m_iPostStimSamples;
@@ -137,22 +139,12 @@ void RtAveWorker::setAverageNumber(qint32 numAve)
         return;
     }
 
-    if(numAve < m_iNumAverages) {
-        int iDiff = m_iNumAverages - numAve;
+    //Keep the most recent epochs of each trigger type
+    QMutableMapIterator<double,AveCondition> idx(m_mapConditions);
 
-        //Do averaging for each trigger type
-        QMutableMapIterator<double,QList<Eigen::MatrixXd> > idx(m_mapStimAve);
-
-        while(idx.hasNext()) {
-            idx.next();
-
-            if(idx.value().size() > iDiff) {
-                //Pop data from buffer
-                for(int i = 0; i < iDiff; ++i) {
-                    idx.value().pop_front();
-                }
-            }
-        }
+    while(idx.hasNext()) {
+        idx.next();
+        resizeEpochRing(idx.value(), numAve);
     }
 
     m_iNumAverages = numAve;
@@ -252,225 +244,221 @@ void RtAveWorker::doAveraging(const MatrixXd& rawSegment)
     //Detect trigger
     QList<QPair<int,double> > lDetectedTriggers = DetectTrigger::detectTriggerFlanksMax(rawSegment, m_iTriggerChIndex, 0, m_fTriggerThreshold, true);
 
-    //TODO: This does not permit the same trigger type twice in one data block
+    //Every detected trigger starts its own epoch, so the same trigger type may occur several times in one data block
     for(int i = 0; i < lDetectedTriggers.size(); ++i) {
-        if(!m_mapFillingBackBuffer.contains(lDetectedTriggers.at(i).second)) {
-            double dTriggerType = lDetectedTriggers.at(i).second;
-
-            //qDebug()<<"Adding dTriggerType"<<dTriggerType;
-
-            m_mapFillingBackBuffer[dTriggerType] = false;
-            m_mapMatDataPostIdx[dTriggerType] = 0;
-            m_mapDataPost[dTriggerType].resize(m_pFiffInfo->chs.size(), m_iPostStimSamples);
-            m_mapDataPost[dTriggerType].setZero();
-        }
+        m_vecPendingTriggers.append(qMakePair(lDetectedTriggers.at(i).second,
+                                              m_iNumSamples + lDetectedTriggers.at(i).first));
     }
 
-    //Fill front / pre stim buffer even if no triggers have been located at all yet
-    if(m_mapFillingBackBuffer.isEmpty()) {
-        fillFrontBuffer(rawSegment, -1.0);
-    }
+    appendToRing(rawSegment);
 
-    //Do averaging for each trigger type
-    QMutableMapIterator<double,bool> idx(m_mapFillingBackBuffer);
+    //Add all epochs whose post stim data is complete. The epochs have equal length, so these are the oldest ones.
     QStringList lResponsibleTriggerTypes;
+    int iNumCompleted = 0;
 
-    while(idx.hasNext()) {
-        idx.next();
+    m_matEpoch.resize(m_pFiffInfo->chs.size(), m_iPreStimSamples + m_iPostStimSamples);
 
-        double dTriggerType = idx.key();
+    for(int i = 0; i < m_vecPendingTriggers.size(); ++i) {
+        double dTriggerType = m_vecPendingTriggers.at(i).first;
+        qint64 iTriggerSample = m_vecPendingTriggers.at(i).second;
 
-        //Fill front / pre stim buffer
-        if(lDetectedTriggers.isEmpty()) {
-            fillFrontBuffer(rawSegment, -1.0);
+        if(iTriggerSample + m_iPostStimSamples > m_iNumSamples) {
+            break;
         }
 
-        //Fill back buffer and decide when to do the data packing of the different buffers
-        if(m_mapFillingBackBuffer[dTriggerType]) {
-            if(m_mapMatDataPostIdx[dTriggerType] != m_iPostStimSamples) {
-                fillBackBuffer(rawSegment, dTriggerType);
-            }
+        copyFromRing(iTriggerSample - m_iPreStimSamples, m_matEpoch);
 
-            if(m_mapMatDataPostIdx[dTriggerType] == m_iPostStimSamples) {
-                m_mapMatDataPostIdx[dTriggerType] = 0;
-                m_mapFillingBackBuffer[dTriggerType] = false;
-                emitEvoked(dTriggerType, lResponsibleTriggerTypes);
-            }
-        } else {
-            if(lDetectedTriggers.isEmpty()) {
-                //Fill front / pre stim buffer
-                fillFrontBuffer(rawSegment, dTriggerType);
-            } else {
-                for(int i = 0; i < lDetectedTriggers.size(); ++i) {
-                    if(dTriggerType == lDetectedTriggers.at(i).second) {
-                        int iTriggerPos = lDetectedTriggers.at(i).first;
-
-                        //Do front buffer stuff
-                        MatrixXd tempMat;
-
-                        if(iTriggerPos >= m_iPreStimSamples) {
-                            tempMat = rawSegment.block(0,
-                                                       iTriggerPos - m_iPreStimSamples,
-                                                       rawSegment.rows(),
-                                                       m_iPreStimSamples);
-                        } else {
-                            tempMat = rawSegment.block(0,
-                                                       0,
-                                                       rawSegment.rows(),
-                                                       iTriggerPos);
-                        }
-
-                        fillFrontBuffer(tempMat, dTriggerType);
-
-                        //Do back buffer stuff
-                        if(rawSegment.cols() - iTriggerPos >= m_mapDataPost[dTriggerType].cols()) {
-                            m_mapDataPost[dTriggerType] = rawSegment.block(0,
-                                                                           iTriggerPos,
-                                                                           m_mapDataPost[dTriggerType].rows(),
-                                                                           m_mapDataPost[dTriggerType].cols());
-                            emitEvoked(dTriggerType, lResponsibleTriggerTypes);
-                            m_mapMatDataPostIdx[dTriggerType] = 0;
-                            m_mapFillingBackBuffer[dTriggerType] = false;
-                        } else {
-                            m_mapDataPost[dTriggerType].block(0,
-                                                              0,
-                                                              m_mapDataPost[dTriggerType].rows(),
-                                                              rawSegment.cols() - iTriggerPos) = rawSegment.block(0,
-                                                                                                                  iTriggerPos,
-                                                                                                                  rawSegment.rows(),
-                                                                                                                  rawSegment.cols() - iTriggerPos);
-                            m_mapMatDataPostIdx[dTriggerType] = rawSegment.cols() - iTriggerPos;
-                            m_mapFillingBackBuffer[dTriggerType] = true;
-                        }
-
-                        //qDebug()<<"Trigger type "<<dTriggerType<<" found at "<<iTriggerPos;
-                    }
-                }
+        if(addEpoch(dTriggerType, m_matEpoch)) {
+            generateEvoked(dTriggerType);
+
+            //List of all trigger types which lead to the recent emit of a new evoked set. */
+            if(!lResponsibleTriggerTypes.contains(QString::number(dTriggerType))) {
+                lResponsibleTriggerTypes << QString::number(dTriggerType);
             }
         }
+
+        ++iNumCompleted;
     }
 
-    //qDebug()<<"RtAveWorker::doAveraging() - time for procesing"<<time.elapsed();
+    m_vecPendingTriggers.remove(0, iNumCompleted);
+
+    if(!lResponsibleTriggerTypes.isEmpty()) {
+        emitEvoked(lResponsibleTriggerTypes);
+    }
 }
 
 
 //*************************************************************************************************************
 
-void RtAveWorker::emitEvoked(double dTriggerType, QStringList& lResponsibleTriggerTypes)
+void RtAveWorker::appendToRing(const MatrixXd& data)
 {
-    //Merge the different buffers
-    mergeData(dTriggerType);
+    //The ring has to hold the pre and post stim data of the oldest pending trigger plus one new block
+    qint64 iRequiredCols = data.cols() + m_iPreStimSamples + m_iPostStimSamples;
 
-    //Calculate the final average/evoked data
-    generateEvoked(dTriggerType);
+    if(m_matRingData.rows() != data.rows() || m_matRingData.cols() < iRequiredCols) {
+        MatrixXd matRingData = MatrixXd::Zero(data.rows(), iRequiredCols);
 
-    //List of all trigger types which lead to the recent emit of a new evoked set. */
-    if(!lResponsibleTriggerTypes.contains(QString::number(dTriggerType))) {
-        lResponsibleTriggerTypes << QString::number(dTriggerType);
+        if(m_matRingData.rows() == data.rows()) {
+            //Keep the received samples at their new ring positions
+            qint64 iNumKept = qMin(m_iNumSamples, qint64(m_matRingData.cols()));
+            MatrixXd matKept(data.rows(), iNumKept);
+            copyFromRing(m_iNumSamples - iNumKept, matKept);
+
+            for(qint64 j = 0; j < iNumKept; ++j) {
+                matRingData.col((m_iNumSamples - iNumKept + j) % iRequiredCols) = matKept.col(j);
+            }
+        }
+
+        m_matRingData = matRingData;
     }
 
-    if(m_stimEvokedSet.evoked.size() > 0) {
-        emit resultReady(m_stimEvokedSet, lResponsibleTriggerTypes);
+    const qint64 iRingCols = m_matRingData.cols();
+    qint64 iCol = m_iNumSamples % iRingCols;
+    qint64 iFirst = qMin(qint64(data.cols()), iRingCols - iCol);
+
+    m_matRingData.block(0, iCol, data.rows(), iFirst) = data.leftCols(iFirst);
+    if(iFirst < data.cols()) {
+        m_matRingData.leftCols(data.cols() - iFirst) = data.rightCols(data.cols() - iFirst);
     }
 
-//    qDebug()<<"RtAveWorker::emitEvoked() - dTriggerType:" << dTriggerType;
-//    qDebug()<<"RtAveWorker::emitEvoked() - m_mapStimAve[dTriggerType].size():" << m_mapStimAve[dTriggerType].size();
+    m_iNumSamples += data.cols();
 }
 
 
 //*************************************************************************************************************
 
-void RtAveWorker::fillBackBuffer(const MatrixXd &data, double dTriggerType)
+void RtAveWorker::copyFromRing(qint64 iFirstSample, MatrixXd& matEpoch) const
 {
-    int iResidualCols = data.cols();
-    if(m_mapMatDataPostIdx[dTriggerType] + data.cols() > m_iPostStimSamples) {
-        iResidualCols = m_iPostStimSamples - m_mapMatDataPostIdx[dTriggerType];
-        m_mapDataPost[dTriggerType].block(0,m_mapMatDataPostIdx[dTriggerType],m_mapDataPost[dTriggerType].rows(),iResidualCols) = data.block(0,0,data.rows(),iResidualCols);
-    } else {
-        m_mapDataPost[dTriggerType].block(0,m_mapMatDataPostIdx[dTriggerType],m_mapDataPost[dTriggerType].rows(),iResidualCols) = data;
-    }
+    const qint64 iRingCols = m_matRingData.cols();
+    const qint64 iOldestSample = qMax(qint64(0), m_iNumSamples - iRingCols);
+
+    for(qint64 j = 0; j < matEpoch.cols(); ) {
+        qint64 iSample = iFirstSample + j;
+
+        if(iSample < iOldestSample || iSample >= m_iNumSamples || m_matRingData.rows() != matEpoch.rows()) {
+            matEpoch.col(j).setZero();
+            ++j;
+            continue;
+        }
+
+        //Copy the contiguous part up to the end of the ring or the newest sample in one go
+        qint64 iCol = iSample % iRingCols;
+        qint64 iNumCols = qMin(qMin(matEpoch.cols() - j, iRingCols - iCol), m_iNumSamples - iSample);
 
-    m_mapMatDataPostIdx[dTriggerType] += iResidualCols;
+        matEpoch.middleCols(j, iNumCols) = m_matRingData.middleCols(iCol, iNumCols);
+        j += iNumCols;
+    }
 }
 
 
 //*************************************************************************************************************
 
-void RtAveWorker::fillFrontBuffer(const MatrixXd &data, double dTriggerType)
+bool RtAveWorker::addEpoch(double dTriggerType, const MatrixXd& matEpoch)
 {
-    //Init m_mapDataPre
-    if(!m_mapDataPre.contains(dTriggerType)) {
-        if(dTriggerType != -1.0) {
-            m_mapDataPre[dTriggerType] = m_mapDataPre[-1.0];
-        } else {
-            m_mapDataPre[-1.0].resize(m_pFiffInfo->chs.size(), m_iPreStimSamples);
-            m_mapDataPre[-1.0].setZero();
+    //Perform artifact threshold
+    if(m_bActivateThreshold && m_pFiffInfo) {
+        qDebug() << "RtAveWorker::addEpoch - Doing artifact reduction for" << m_mapThresholds;
+
+        if(MNEEpochDataList::checkForArtifact(matEpoch,
+                                              *m_pFiffInfo,
+                                              m_mapThresholds)) {
+            return false;
         }
     }
 
-    if(m_mapDataPre[dTriggerType].cols() <= data.cols()) {
-        if(m_iPreStimSamples > 0 && data.cols() >= m_iPreStimSamples) {
-            m_mapDataPre[dTriggerType] = data.block(0,
-                                                    data.cols() - m_iPreStimSamples,
-                                                    data.rows(),
-                                                    m_iPreStimSamples);
-        }
+    //Init condition with preallocated epoch ring
+    if(!m_mapConditions.contains(dTriggerType)) {
+        AveCondition condition;
+        condition.matSum = MatrixXd::Zero(matEpoch.rows(), matEpoch.cols());
+        condition.matSumSq = MatrixXd::Zero(matEpoch.rows(), matEpoch.cols());
+        condition.vecEpochRing.fill(MatrixXd::Zero(matEpoch.rows(), matEpoch.cols()), m_iNumAverages);
+        condition.iRingIndex = 0;
+        condition.iNumEpochs = 0;
+
+        m_mapConditions.insert(dTriggerType, condition);
+    }
+
+    AveCondition& condition = m_mapConditions[dTriggerType];
+    MatrixXd& matSlot = condition.vecEpochRing[condition.iRingIndex];
+
+    //Replace the oldest epoch once the number of averages is reached
+    if(condition.iNumEpochs == condition.vecEpochRing.size()) {
+        condition.matSum -= matSlot;
+        condition.matSumSq -= matSlot.cwiseAbs2();
     } else {
-        int residual = m_mapDataPre[dTriggerType].cols() - data.cols();
-
-        //Copy shift data
-        m_mapDataPre[dTriggerType].block(0,
-                                         0,
-                                         m_mapDataPre[dTriggerType].rows(),
-                                         residual) = m_mapDataPre[dTriggerType].block(0,
-                                                                                      m_mapDataPre[dTriggerType].cols() - residual,
-                                                                                      m_mapDataPre[dTriggerType].rows(),
-                                                                                      residual);
-
-        //Copy new data in
-        m_mapDataPre[dTriggerType].block(0,
-                                         residual,
-                                         m_mapDataPre[dTriggerType].rows(),
-                                         data.cols()) = data;
+        ++condition.iNumEpochs;
     }
+
+    matSlot = matEpoch;
+    condition.matSum += matSlot;
+    condition.matSumSq += matSlot.cwiseAbs2();
+
+    condition.iRingIndex = (condition.iRingIndex + 1) % condition.vecEpochRing.size();
+
+    if(condition.iRingIndex == 0) {
+        recomputeSums(condition);
+    }
+
+    return true;
 }
 
 
 //*************************************************************************************************************
 
-void RtAveWorker::mergeData(double dTriggerType)
+void RtAveWorker::resizeEpochRing(AveCondition& condition, int iNumAverages)
 {
-    if(m_mapDataPre[dTriggerType].rows() != m_mapDataPost[dTriggerType].rows()) {
-        qDebug() << "RtAveWorker::mergeData - Rows of m_mapDataPre (" << m_mapDataPre[dTriggerType].rows() << ") and m_mapDataPost (" << m_mapDataPost[dTriggerType].rows() << ") are not the same. Returning.";
+    const int iRingSize = condition.vecEpochRing.size();
+
+    if(iNumAverages == iRingSize || iRingSize == 0) {
         return;
     }
 
-    MatrixXd mergedData(m_mapDataPre[dTriggerType].rows(), m_mapDataPre[dTriggerType].cols() + m_mapDataPost[dTriggerType].cols());
+    //Reorder from oldest to newest and drop the oldest epochs which do not fit anymore
+    int iNumKept = qMin(condition.iNumEpochs, iNumAverages);
+    int iOldest = (condition.iRingIndex - condition.iNumEpochs + iRingSize) % iRingSize;
 
-    mergedData << m_mapDataPre[dTriggerType], m_mapDataPost[dTriggerType];
+    QVector<MatrixXd> vecEpochRing(iNumAverages);
+    for(int i = 0; i < iNumAverages; ++i) {
+        if(i < iNumKept) {
+            vecEpochRing[i] = condition.vecEpochRing[(iOldest + condition.iNumEpochs - iNumKept + i) % iRingSize];
+        } else {
+            vecEpochRing[i] = MatrixXd::Zero(condition.matSum.rows(), condition.matSum.cols());
+        }
+    }
 
-    //Perform artifact threshold
-    bool bArtifactDetected = false;
+    condition.vecEpochRing = vecEpochRing;
+    condition.iNumEpochs = iNumKept;
+    condition.iRingIndex = iNumKept % iNumAverages;
 
-    if(m_bActivateThreshold && m_pFiffInfo) {
-        qDebug() << "RtAveWorker::mergeData - Doing artifact reduction for" << m_mapThresholds;
+    recomputeSums(condition);
+}
+
+
+//*************************************************************************************************************
+
+void RtAveWorker::recomputeSums(AveCondition& condition)
+{
+    condition.matSum.setZero();
+    condition.matSumSq.setZero();
+
+    const int iRingSize = condition.vecEpochRing.size();
+    int iOldest = (condition.iRingIndex - condition.iNumEpochs + iRingSize) % iRingSize;
 
-        bArtifactDetected = MNEEpochDataList::checkForArtifact(mergedData,
-                                                               *m_pFiffInfo,
-                                                               m_mapThresholds);
+    for(int i = 0; i < condition.iNumEpochs; ++i) {
+        const MatrixXd& matEpoch = condition.vecEpochRing.at((iOldest + i) % iRingSize);
+        condition.matSum += matEpoch;
+        condition.matSumSq += matEpoch.cwiseAbs2();
     }
+}
 
-    if(!bArtifactDetected) {
-        //Add cut data to average buffer
-        m_mapStimAve[dTriggerType].append(mergedData);
 
-        //Pop data from buffer
-        int iDiff =  m_mapStimAve[dTriggerType].size() - m_iNumAverages;
-        if(iDiff > 0) {
-            for(int i = 0; i < iDiff; ++i) {
-                m_mapStimAve[dTriggerType].pop_front();
-            }
-        }
+//*************************************************************************************************************
+
+void RtAveWorker::emitEvoked(const QStringList& lResponsibleTriggerTypes)
+{
+    if(m_stimEvokedSet.evoked.size() > 0) {
+        emit resultReady(m_stimEvokedSet, lResponsibleTriggerTypes);
+        emit stdErrReady(m_stdErrEvokedSet, lResponsibleTriggerTypes);
     }
 }
 
@@ -479,20 +467,18 @@ void RtAveWorker::mergeData(double dTriggerType)
 
 void RtAveWorker::generateEvoked(double dTriggerType)
 {
-    if(m_mapStimAve[dTriggerType].isEmpty()) {
-        qDebug() << "RtAveWorker::generateEvoked - m_mapStimAve is empty for type" << dTriggerType << "Returning.";
+    if(!m_mapConditions.contains(dTriggerType) || m_mapConditions[dTriggerType].iNumEpochs == 0) {
+        qDebug() << "RtAveWorker::generateEvoked - No epochs available for type" << dTriggerType << "Returning.";
         return;
     }
 
-    //Init evoked
-    m_stimEvokedSet.info = *m_pFiffInfo.data();
-    FiffEvoked evoked;
-    evoked.setInfo(*m_pFiffInfo.data());
+    const AveCondition& condition = m_mapConditions[dTriggerType];
+    const int n = condition.iNumEpochs;
+
     int iEvokedIdx = -1;
 
     for(int i = 0; i < m_stimEvokedSet.evoked.size(); ++i) {
         if(m_stimEvokedSet.evoked.at(i).comment == QString::number(dTriggerType)) {
-            evoked = m_stimEvokedSet.evoked.at(i);
             iEvokedIdx = i;
             break;
         }
@@ -500,6 +486,8 @@ void RtAveWorker::generateEvoked(double dTriggerType)
 
     //If the evoked is not yet present add it here
     if(iEvokedIdx == -1) {
+        FiffEvoked evoked;
+        evoked.setInfo(*m_pFiffInfo.data());
         evoked.baseline = m_pairBaselineSec;
         evoked.times.resize(m_iPreStimSamples + m_iPostStimSamples);
         evoked.times = RowVectorXf::LinSpaced(m_iPreStimSamples + m_iPostStimSamples,
@@ -509,35 +497,33 @@ void RtAveWorker::generateEvoked(double dTriggerType)
         evoked.first = 0;
         evoked.last = m_iPreStimSamples + m_iPostStimSamples;
         evoked.comment = QString::number(dTriggerType);
-    }
 
-    // Generate final evoked
-    MatrixXd finalAverage = MatrixXd::Zero(m_mapStimAve[dTriggerType].first().rows(), m_iPreStimSamples+m_iPostStimSamples);
+        m_stimEvokedSet.evoked.append(evoked);
 
-    for(int i = 0; i < m_mapStimAve[dTriggerType].size(); ++i) {
-        finalAverage += m_mapStimAve[dTriggerType].at(i);
-    }
+        evoked.aspect_kind = FIFFV_ASPECT_STD_ERR;
+        m_stdErrEvokedSet.evoked.append(evoked);
 
-    if(!m_mapStimAve[dTriggerType].isEmpty()) {
-        finalAverage = finalAverage/m_mapStimAve[dTriggerType].size();
+        iEvokedIdx = m_stimEvokedSet.evoked.size() - 1;
     }
 
+    // Generate final evoked from the running sum
+    FiffEvoked& evoked = m_stimEvokedSet.evoked[iEvokedIdx];
+    evoked.data = condition.matSum / n;
+
     if(m_bDoBaselineCorrection) {
-        finalAverage = MNEMath::rescale(finalAverage, evoked.times, m_pairBaselineSec, QString("mean"));
+        evoked.data = MNEMath::rescale(evoked.data, evoked.times, m_pairBaselineSec, QString("mean"));
     }
 
-    evoked.data = finalAverage;
+    evoked.nave = n;
 
-    evoked.nave = m_mapStimAve[dTriggerType].size();
-
-    //Add new data to evoked data set
-    if(iEvokedIdx != -1) {
-        //Evoked data is already present
-        m_stimEvokedSet.evoked[iEvokedIdx] = evoked;
+    // Standard error of the mean sqrt((sum(x^2) - sum(x)^2/n) / (n(n-1))), not affected by the baseline offset
+    FiffEvoked& stdErr = m_stdErrEvokedSet.evoked[iEvokedIdx];
+    if(n > 1) {
+        stdErr.data = ((condition.matSumSq - condition.matSum.cwiseAbs2() / n) / (double(n) * (n - 1))).cwiseMax(0.0).cwiseSqrt();
     } else {
-        //Evoked data is not present yet
-        m_stimEvokedSet.evoked.append(evoked);
+        stdErr.data = MatrixXd::Zero(condition.matSum.rows(), condition.matSum.cols());
     }
+    stdErr.nave = n;
 }
 
 
@@ -552,14 +538,13 @@ void RtAveWorker::reset()
 
     //Clear all evoked data information
     m_stimEvokedSet.evoked.clear();
+    m_stdErrEvokedSet.evoked.clear();
 
-    //Clear all maps
-    m_mapStimAve.clear();
-    m_mapDataPre.clear();
-    m_mapDataPre[-1.0] = MatrixXd::Zero(m_pFiffInfo->chs.size(), m_iPreStimSamples);
-    m_mapDataPost.clear();
-    m_mapMatDataPostIdx.clear();
-    m_mapFillingBackBuffer.clear();
+    //Clear running sums and the sample ring
+    m_mapConditions.clear();
+    m_vecPendingTriggers.clear();
+    m_matRingData.resize(0,0);
+    m_iNumSamples = 0;
 }
 
 
@@ -598,6 +583,9 @@ RtAve::RtAve(quint32 numAverages,
     connect(worker, &RtAveWorker::resultReady,
             this, &RtAve::handleResults, Qt::DirectConnection);
 
+    connect(worker, &RtAveWorker::stdErrReady,
+            this, &RtAve::handleStdErrResults, Qt::DirectConnection);
+
     connect(this, &RtAve::averageNumberChanged,
             worker, &RtAveWorker::setAverageNumber);
     connect(this, &RtAve::averagePreStimChanged,
@@ -647,6 +635,16 @@ void RtAve::handleResults(const FiffEvokedSet& evokedStimSet,
 }
 
 
+//*************************************************************************************************************
+
+void RtAve::handleStdErrResults(const FiffEvokedSet& stdErrSet,
+                                const QStringList &lResponsibleTriggerTypes)
+{
+    emit evokedStdErr(stdErrSet,
+                      lResponsibleTriggerTypes);
+}
+
+
 //*************************************************************************************************************
 
 void RtAve::restart(quint32 numAverages,
@@ -677,6 +675,9 @@ void RtAve::restart(quint32 numAverages,
     connect(worker, &RtAveWorker::resultReady,
             this, &RtAve::handleResults, Qt::DirectConnection);
 
+    connect(worker, &RtAveWorker::stdErrReady,
+            this, &RtAve::handleStdErrResults, Qt::DirectConnection);
+
     connect(this, &RtAve::averageNumberChanged,
             worker, &RtAveWorker::setAverageNumber);
     connect(this, &RtAve::averagePreStimChanged,
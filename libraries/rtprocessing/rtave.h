@@ -55,6 +55,8 @@
 #include <QThread>
 #include <QSharedPointer>
 #include <QObject>
+#include <QVector>
+#include <QPair>
 
 
 //*************************************************************************************************************
@@ -204,6 +206,18 @@ public:
     void reset();
 
 protected:
+    //=========================================================================================================
+    /**
+     * Running sums of one trigger type (condition) over the epochs currently part of the average.
+     */
+    struct AveCondition {
+        Eigen::MatrixXd             matSum;             /**< Sum of the epochs in the ring. */
+        Eigen::MatrixXd             matSumSq;           /**< Sum of the squared epochs in the ring, used for the standard error. */
+        QVector<Eigen::MatrixXd>    vecEpochRing;       /**< Preallocated ring holding the last m_iNumAverages epochs. */
+        int                         iRingIndex;         /**< Ring index the next epoch is written to. */
+        int                         iNumEpochs;         /**< Number of valid epochs in the ring. */
+    };
+
     //=========================================================================================================
     /**
      * do the actual averaging here.
@@ -212,27 +226,51 @@ protected:
 
     //=========================================================================================================
     /**
-     * Prepends incoming data to front/pre stim buffer.
+     * Appends incoming data to the sample ring which holds the recent pre and post stimulus data.
+     */
+    void appendToRing(const Eigen::MatrixXd& data);
+
+    //=========================================================================================================
+    /**
+     * Copies the samples [iFirstSample, iFirstSample + matEpoch.cols()) from the sample ring to matEpoch.
+     * Samples which were not received (yet) are set to zero.
      */
-    void fillFrontBuffer(const Eigen::MatrixXd& data, double dTriggerType);
+    void copyFromRing(qint64 iFirstSample,
+                      Eigen::MatrixXd& matEpoch) const;
 
-    void emitEvoked(double dTriggerType, QStringList& lResponsibleTriggerTypes);
+    //=========================================================================================================
+    /**
+     * Adds an epoch to the running sums of a trigger type, replacing the oldest epoch once m_iNumAverages
+     * is reached. Epochs with artifacts are discarded.
+     *
+     * @return true if the epoch was added
+     */
+    bool addEpoch(double dTriggerType,
+                  const Eigen::MatrixXd& matEpoch);
+
+    //=========================================================================================================
+    /**
+     * Resizes the epoch ring of a condition, keeping the most recent epochs.
+     */
+    void resizeEpochRing(AveCondition& condition,
+                         int iNumAverages);
 
     //=========================================================================================================
     /**
-     * Prepends incoming data to back/post stim buffer.
+     * Recomputes the running sums of a condition from its epoch ring. Called once per ring cycle to flush
+     * the rounding errors accumulated by subtracting the replaced epochs.
      */
-    void fillBackBuffer(const Eigen::MatrixXd& data, double dTriggerType);
+    void recomputeSums(AveCondition& condition);
 
     //=========================================================================================================
     /**
-     * Packs the buffers togehter as one and calcualtes the current running average and emits the result if number of averages has been reached.
+     * Emits the evoked sets generated for the given trigger types.
      */
-    void mergeData(double dTriggerType);
+    void emitEvoked(const QStringList& lResponsibleTriggerTypes);
 
     //=========================================================================================================
     /**
-     * Generates the final evoke variable.
+     * Generates the final evoke variable and its standard error from the running sums.
      */
     void generateEvoked(double dTriggerType);
 
@@ -264,13 +302,15 @@ protected:
 
     FIFFLIB::FiffInfo::SPtr                         m_pFiffInfo;                /**< Holds the fiff measurement information. */
     FIFFLIB::FiffEvokedSet                          m_stimEvokedSet;            /**< Holds the evoked information. */
+    FIFFLIB::FiffEvokedSet                          m_stdErrEvokedSet;          /**< Holds the standard errors of the evoked data. */
 
     QMap<QString,double>                            m_mapThresholds;            /**< Holds the current thresholds for artifact rejection. */
-    QMap<double,QList<Eigen::MatrixXd> >            m_mapStimAve;               /**< the current stimulus average buffer. Holds m_iNumAverages vectors */
-    QMap<double,Eigen::MatrixXd>                    m_mapDataPre;               /**< The matrix holding pre stim data. */
-    QMap<double,Eigen::MatrixXd>                    m_mapDataPost;              /**< The matrix holding post stim data. */
-    QMap<double,qint32>                             m_mapMatDataPostIdx;        /**< Current index inside of the matrix m_matDataPost */
-    QMap<double,bool>                               m_mapFillingBackBuffer;     /**< Whether the back buffer is currently getting filled. */
+    QMap<double,AveCondition>                       m_mapConditions;            /**< The running sums per trigger type. */
+
+    Eigen::MatrixXd                                 m_matRingData;              /**< Sample ring holding the recently received data. */
+    qint64                                          m_iNumSamples;              /**< Number of samples received since the last reset. */
+    QVector<QPair<double,qint64> >                  m_vecPendingTriggers;       /**< Detected triggers (type, sample) whose post stimulus data is not complete yet. */
+    Eigen::MatrixXd                                 m_matEpoch;                 /**< Reused epoch matrix. */
 
 signals:
     //=========================================================================================================
@@ -282,6 +322,16 @@ signals:
      */
     void resultReady(const FIFFLIB::FiffEvokedSet& evokedStimSet,
                      const QStringList& lResponsibleTriggerTypes);
+
+    //=========================================================================================================
+    /**
+     * Signal which is emitted together with resultReady and holds the standard errors of the evoked data.
+     *
+     * @param[in] stdErrSet                  The standard errors of the evoked stimulus data (FIFFV_ASPECT_STD_ERR).
+     * @param[in] lResponsibleTriggerTypes   List of all trigger types which lead to the recent emit of a new evoked set.
+     */
+    void stdErrReady(const FIFFLIB::FiffEvokedSet& stdErrSet,
+                     const QStringList& lResponsibleTriggerTypes);
 };
 
 
@@ -447,11 +497,20 @@ protected:
     void handleResults(const FIFFLIB::FiffEvokedSet& evokedStimSet,
                        const QStringList& lResponsibleTriggerTypes);
 
+    //=========================================================================================================
+    /**
+     * Handles the standard error results.
+     */
+    void handleStdErrResults(const FIFFLIB::FiffEvokedSet& stdErrSet,
+                             const QStringList& lResponsibleTriggerTypes);
+
     QThread             m_workerThread;         /**< The worker thread. */
 
 signals:
     void evokedStim(const FIFFLIB::FiffEvokedSet& evokedStimSet,
                     const QStringList& lResponsibleTriggerTypes);
+    void evokedStdErr(const FIFFLIB::FiffEvokedSet& stdErrSet,
+                      const QStringList& lResponsibleTriggerTypes);
     void operate(const Eigen::MatrixXd& matData);
     void averageNumberChanged(qint32 numAve);
     void averagePreStimChanged(qint32 samples,
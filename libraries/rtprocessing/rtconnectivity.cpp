@@ -40,7 +40,6 @@
 
 #include "rtconnectivity.h"
 
-#include <connectivity/connectivitysettings.h>
 #include <connectivity/connectivity.h>
 #include <connectivity/network/network.h>
 
@@ -109,6 +108,70 @@ void RtConnectivityWorker::doWork(const ConnectivitySettings &connectivitySettin
 }
 
 
+//*************************************************************************************************************
+
+void RtConnectivityWorker::doIncrementalWork(const ConnectivitySettings& connectivitySettings,
+                                             int iNumberAverages)
+{
+    if(this->thread()->isInterruptionRequested()) {
+        return;
+    }
+
+    if(connectivitySettings.getConnectivityMethods().isEmpty()) {
+        qDebug()<<"RtConnectivityWorker::doIncrementalWork() - Network methods are empty";
+        return;
+    }
+
+    // Restart the window if the new trials do not fit the stored ones
+    bool bRestart = m_connectivitySettings.isEmpty() ||
+                    m_connectivitySettings.getSamplingFrequency() != connectivitySettings.getSamplingFrequency() ||
+                    m_connectivitySettings.getFFTSize() != connectivitySettings.getFFTSize() ||
+                    m_connectivitySettings.getWindowType() != connectivitySettings.getWindowType();
+
+    if(!bRestart && !connectivitySettings.isEmpty()) {
+        bRestart = m_connectivitySettings.at(0).matData.rows() != connectivitySettings.at(0).matData.rows() ||
+                   m_connectivitySettings.at(0).matData.cols() != connectivitySettings.at(0).matData.cols();
+    }
+
+    if(bRestart) {
+        m_connectivitySettings = connectivitySettings;
+        m_connectivitySettings.clearIntermediateData();
+
+        // The intermediate data of the trials must be kept in order to remove their contributions later on
+        m_connectivitySettings.setStorageModeActive(true);
+    } else {
+        m_connectivitySettings.setConnectivityMethods(connectivitySettings.getConnectivityMethods());
+        m_connectivitySettings.setNodePositions(connectivitySettings.getNodePositions());
+
+        for(int i = 0; i < connectivitySettings.size(); ++i) {
+            m_connectivitySettings.append(connectivitySettings.at(i));
+        }
+    }
+
+    // Remove the oldest trials and substract their contributions
+    if(m_connectivitySettings.size() > iNumberAverages) {
+        m_connectivitySettings.removeFirst(m_connectivitySettings.size() - iNumberAverages);
+    }
+
+    if(m_connectivitySettings.isEmpty()) {
+        return;
+    }
+
+    // Trials which already hold their intermediate data are skipped by the metrics
+    QList<Network> finalNetworks = Connectivity::calculate(m_connectivitySettings);
+
+    // Only pass on the settings. Copying the window would deep copy the trial and the intermediate sum data on every update.
+    ConnectivitySettings connectivitySettingsOut;
+    connectivitySettingsOut.setConnectivityMethods(m_connectivitySettings.getConnectivityMethods());
+    connectivitySettingsOut.setSamplingFrequency(m_connectivitySettings.getSamplingFrequency());
+    connectivitySettingsOut.setFFTSize(m_connectivitySettings.getFFTSize());
+    connectivitySettingsOut.setWindowType(m_connectivitySettings.getWindowType());
+    connectivitySettingsOut.setNodePositions(m_connectivitySettings.getNodePositions());
+
+    emit resultReady(finalNetworks, connectivitySettingsOut);
+}
+
+
 //*************************************************************************************************************
 //=============================================================================================================
 // DEFINE MEMBER METHODS RtConnectivity
@@ -126,6 +189,9 @@ RtConnectivity::RtConnectivity(QObject *parent)
     connect(this, &RtConnectivity::operate,
             worker, &RtConnectivityWorker::doWork);
 
+    connect(this, &RtConnectivity::operateIncremental,
+            worker, &RtConnectivityWorker::doIncrementalWork);
+
     connect(worker, &RtConnectivityWorker::resultReady,
             this, &RtConnectivity::newConnectivityResultAvailable);
 
@@ -149,6 +215,15 @@ void RtConnectivity::append(const ConnectivitySettings& connectivitySettings)
 }
 
 
+//*************************************************************************************************************
+
+void RtConnectivity::appendIncremental(const ConnectivitySettings& connectivitySettings,
+                                       int iNumberAverages)
+{
+    emit operateIncremental(connectivitySettings, iNumberAverages);
+}
+
+
 //*************************************************************************************************************
 
 void RtConnectivity::restart()
@@ -164,6 +239,9 @@ void RtConnectivity::restart()
     connect(this, &RtConnectivity::operate,
             worker, &RtConnectivityWorker::doWork);
 
+    connect(this, &RtConnectivity::operateIncremental,
+            worker, &RtConnectivityWorker::doIncrementalWork);
+
     connect(worker, &RtConnectivityWorker::resultReady,
             this, &RtConnectivity::newConnectivityResultAvailable);
 
@@ -43,6 +43,8 @@
 
 #include "rtprocessing_global.h"
 
+#include <connectivity/connectivitysettings.h>
+
 
 //*************************************************************************************************************
 //=============================================================================================================
@@ -69,7 +71,6 @@ namespace FIFFLIB {
 }
 
 namespace CONNECTIVITYLIB {
-    class ConnectivitySettings;
     class Network;
 }
 
@@ -108,6 +109,23 @@ public:
      */
     void doWork(const CONNECTIVITYLIB::ConnectivitySettings& connectivitySettings);
 
+    //=========================================================================================================
+    /**
+     * Perform incremental connectivity estimation over a sliding window of trials. The new trials are appended to the
+     * window kept by this worker and the oldest trials are removed so that at most iNumberAverages trials remain. Only
+     * the new trials are transformed, their contributions are added to the intermediate sums and the contributions of
+     * the removed trials are substracted. The window is restarted if the data dimensions, sampling frequency, FFT size
+     * or window type change.
+     *
+     * @param[in] connectivitySettings           The connectivity settings holding only the new trials.
+     * @param[in] iNumberAverages                The number of trials in the sliding window.
+     */
+    void doIncrementalWork(const CONNECTIVITYLIB::ConnectivitySettings& connectivitySettings,
+                           int iNumberAverages);
+
+protected:
+    CONNECTIVITYLIB::ConnectivitySettings   m_connectivitySettings;     /**< The sliding window of trials and their intermediate data used in incremental mode. */
+
 signals:
     void resultReady(const  QList<CONNECTIVITYLIB::Network>& connectivityResults, const CONNECTIVITYLIB::ConnectivitySettings& connectivitySettings);
 };
@@ -148,6 +166,17 @@ public:
      */
     void append(const CONNECTIVITYLIB::ConnectivitySettings& connectivitySettings);
 
+    //=========================================================================================================
+    /**
+     * Slot to receive new trials for incremental sliding-window estimation. Only the new trials need to be passed. The
+     * worker keeps the last iNumberAverages trials and their intermediate data. Call restart() to discard the window.
+     *
+     * @param[in] connectivitySettings   The connectivity settings holding the new trials.
+     * @param[in] iNumberAverages        The number of trials in the sliding window.
+     */
+    void appendIncremental(const CONNECTIVITYLIB::ConnectivitySettings& connectivitySettings,
+                           int iNumberAverages);
+
     //=========================================================================================================
     /**
      * Restarts the thread by interrupting its computation queue, quitting, waiting and then starting it again.
@@ -167,6 +196,8 @@ signals:
     void newConnectivityResultAvailable(const QList<CONNECTIVITYLIB::Network>& connectivityResults, const CONNECTIVITYLIB::ConnectivitySettings& connectivitySettings);
 
     void operate(const CONNECTIVITYLIB::ConnectivitySettings& connectivitySettings);
+    void operateIncremental(const CONNECTIVITYLIB::ConnectivitySettings& connectivitySettings,
+                            int iNumberAverages);
 };
 
 //*************************************************************************************************************
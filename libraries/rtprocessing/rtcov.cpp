@@ -52,6 +52,7 @@
 
 #include <QDebug>
 #include <QtConcurrent>
+#include <QtMath>
 
 
 //*************************************************************************************************************
@@ -61,6 +62,7 @@
 
 using namespace RTPROCESSINGLIB;
 using namespace FIFFLIB;
+using namespace Eigen;
 
 
 //*************************************************************************************************************
@@ -68,6 +70,17 @@ using namespace FIFFLIB;
 // DEFINE MEMBER METHODS RtCovWorker
 //=============================================================================================================
 
+RtCovWorker::RtCovWorker()
+: QObject()
+, m_dForgettingFactor(1.0)
+, m_dWeight(0.0)
+, m_dWeightSq(0.0)
+{
+}
+
+
+//*************************************************************************************************************
+
 void RtCovWorker::doWork(const RtCovInput &inputData)
 {
     if(this->thread()->isInterruptionRequested()) {
@@ -83,51 +96,160 @@ void RtCovWorker::doWork(const RtCovInput &inputData)
     RtCovComputeResult finalResult = result.result();
 
     //Final computation
-    FiffCov computedCov;
-    computedCov.data = finalResult.matData;
+    if(inputData.iSamples > 0) {
+        finalResult.mu /= (float)inputData.iSamples;
+        finalResult.matData.array() -= inputData.iSamples * (finalResult.mu * finalResult.mu.transpose()).array();
+        finalResult.matData.array() /= (inputData.iSamples - 1);
 
-    QStringList exclude;
-    for(int i = 0; i<inputData.fiffInfo.chs.size(); i++) {
-        if(inputData.fiffInfo.chs.at(i).kind != FIFFV_MEG_CH &&
-           inputData.fiffInfo.chs.at(i).kind != FIFFV_EEG_CH) {
-            exclude << inputData.fiffInfo.chs.at(i).ch_name;
-        }
+        emit resultReady(regularizeCov(finalResult.matData, inputData.iSamples, inputData.fiffInfo));
+    } else {
+        qDebug() << "RtCovWorker::doWork - Number of samples equals zero. Regularization not possible. Returning without result.";
     }
-    bool doProj = true;
 
-    if(inputData.iSamples > 0) {
-        finalResult.mu /= (float)inputData.iSamples;
-        computedCov.data.array() -= inputData.iSamples * (finalResult.mu * finalResult.mu.transpose()).array();
-        computedCov.data.array() /= (inputData.iSamples - 1);
+}
+
+
+//*************************************************************************************************************
+
+void RtCovWorker::doWorkIncremental(const RtCovInput &inputData,
+                                    bool bEmitResult)
+{
+    if(this->thread()->isInterruptionRequested()) {
+        return;
+    }
 
-        computedCov.kind = FIFFV_MNE_NOISE_COV;
-        computedCov.diag = false;
-        computedCov.dim = computedCov.data.rows();
+    for(int i = 0; i < inputData.lData.size(); ++i) {
+        const MatrixXd& matData = inputData.lData.at(i);
+        const int iNSamples = matData.cols();
 
-        //ToDo do picks
-        computedCov.names = inputData.fiffInfo.ch_names;
-        computedCov.projs = inputData.fiffInfo.projs;
-        computedCov.bads = inputData.fiffInfo.bads;
-        computedCov.nfree = inputData.iSamples;
+        if(iNSamples == 0) {
+            continue;
+        }
+
+        //Restart the estimate if the number of channels changed
+        if(m_vecMean.size() != matData.rows()) {
+            m_vecMean = VectorXd::Zero(matData.rows());
+            m_matScatter = MatrixXd::Zero(matData.rows(), matData.rows());
+            m_dWeight = 0.0;
+            m_dWeightSq = 0.0;
+        }
 
-        // regularize noise covariance
-        computedCov = computedCov.regularize(inputData.fiffInfo, 0.05, 0.05, 0.1, doProj, exclude);
+        //Center the block and compute its scatter as rank-k update of the lower triangle only
+        VectorXd vecBlockMean = matData.rowwise().mean();
+        m_matCentered = matData.colwise() - vecBlockMean;
 
-//            qint32 samples = rawSegment.cols();
-//            VectorXf mu = rawSegment.rowwise().sum().array() / (float)samples;
+        m_matBlockScatter.setZero(matData.rows(), matData.rows());
+        m_matBlockScatter.selfadjointView<Lower>().rankUpdate(m_matCentered);
 
-//            MatrixXf noise_covariance = rawSegment * rawSegment.transpose();// noise_covariance == raw_covariance
-//            noise_covariance.array() -= samples * (mu * mu.transpose()).array();
-//            noise_covariance.array() /= (samples - 1);
+        //Forget the past and merge block statistics (Chan et al. parallel variant of Welford's algorithm)
+        double dDecay = qPow(m_dForgettingFactor, iNSamples);
+        double dOldWeight = dDecay * m_dWeight;
+        double dNewWeight = dOldWeight + iNSamples;
 
-//            std::cout << "Noise Covariance:\n" << noise_covariance.block(0,0,10,10) << std::endl;
+        VectorXd vecDelta = vecBlockMean - m_vecMean;
 
-//            printf("%d raw buffer (%d x %d) generated\r\n", count, tmp.rows(), tmp.cols());
-        emit resultReady(computedCov);
+        m_matScatter.triangularView<Lower>() *= dDecay;
+        m_matScatter.triangularView<Lower>() += m_matBlockScatter;
+        m_matScatter.selfadjointView<Lower>().rankUpdate(vecDelta, dOldWeight * iNSamples / dNewWeight);
+
+        m_vecMean += vecDelta * (iNSamples / dNewWeight);
+        m_dWeight = dNewWeight;
+        m_dWeightSq = dDecay * dDecay * m_dWeightSq + iNSamples;
+    }
+
+    if(!bEmitResult) {
+        return;
+    }
+
+    MatrixXd matCov;
+    int iNFree;
+
+    if(getIncrementalCov(matCov, iNFree)) {
+        emit resultReady(regularizeCov(matCov, iNFree, inputData.fiffInfo));
     } else {
-        qDebug() << "RtCovWorker::doWork - Number of samples equals zero. Regularization not possible. Returning without result.";
+        qDebug() << "RtCovWorker::doWorkIncremental - Not enough samples. Regularization not possible. Returning without result.";
     }
+}
 
+
+//*************************************************************************************************************
+
+void RtCovWorker::setForgettingFactor(double dLambda)
+{
+    if(dLambda <= 0.0 || dLambda > 1.0) {
+        qDebug() << "RtCovWorker::setForgettingFactor - Forgetting factor must be in (0,1]. Returning.";
+        return;
+    }
+
+    m_dForgettingFactor = dLambda;
+}
+
+
+//*************************************************************************************************************
+
+void RtCovWorker::resetIncremental()
+{
+    m_vecMean.resize(0);
+    m_matScatter.resize(0,0);
+    m_dWeight = 0.0;
+    m_dWeightSq = 0.0;
+}
+
+
+//*************************************************************************************************************
+
+bool RtCovWorker::getIncrementalCov(MatrixXd& matCov,
+                                    int& iNFree) const
+{
+    if(m_dWeight <= 0.0) {
+        return false;
+    }
+
+    //Unbiased estimate for reliability weights, reduces to n - 1 without forgetting
+    double dDenominator = m_dWeight - m_dWeightSq / m_dWeight;
+
+    if(dDenominator <= 0.0) {
+        return false;
+    }
+
+    matCov = m_matScatter.selfadjointView<Lower>();
+    matCov /= dDenominator;
+    iNFree = qRound(m_dWeight * m_dWeight / m_dWeightSq);
+
+    return true;
+}
+
+
+//*************************************************************************************************************
+
+FiffCov RtCovWorker::regularizeCov(const MatrixXd& matCov,
+                                   int iNFree,
+                                   const FiffInfo& fiffInfo)
+{
+    FiffCov computedCov;
+    computedCov.data = matCov;
+
+    QStringList exclude;
+    for(int i = 0; i<fiffInfo.chs.size(); i++) {
+        if(fiffInfo.chs.at(i).kind != FIFFV_MEG_CH &&
+           fiffInfo.chs.at(i).kind != FIFFV_EEG_CH) {
+            exclude << fiffInfo.chs.at(i).ch_name;
+        }
+    }
+    bool doProj = true;
+
+    computedCov.kind = FIFFV_MNE_NOISE_COV;
+    computedCov.diag = false;
+    computedCov.dim = computedCov.data.rows();
+
+    //ToDo do picks
+    computedCov.names = fiffInfo.ch_names;
+    computedCov.projs = fiffInfo.projs;
+    computedCov.bads = fiffInfo.bads;
+    computedCov.nfree = iNFree;
+
+    // regularize noise covariance
+    return computedCov.regularize(fiffInfo, 0.05, 0.05, 0.1, doProj, exclude);
 }
 
 
@@ -169,6 +291,8 @@ RtCov::RtCov(qint32 iMaxSamples,
 , m_pFiffInfo(pFiffInfo)
 , m_iSamples(0)
 , m_iNewMaxSamples(iMaxSamples)
+, m_bIncremental(false)
+, m_dForgettingFactor(1.0)
 {
     RtCovWorker *worker = new RtCovWorker;
     worker->moveToThread(&m_workerThread);
@@ -179,9 +303,18 @@ RtCov::RtCov(qint32 iMaxSamples,
     connect(this, &RtCov::operate,
             worker, &RtCovWorker::doWork);
 
+    connect(this, &RtCov::operateIncremental,
+            worker, &RtCovWorker::doWorkIncremental);
+
     connect(worker, &RtCovWorker::resultReady,
             this, &RtCov::handleResults);
 
+    connect(this, &RtCov::forgettingFactorChanged,
+            worker, &RtCovWorker::setForgettingFactor);
+
+    connect(this, &RtCov::incrementalResetRequested,
+            worker, &RtCovWorker::resetIncremental);
+
     m_workerThread.start();
 
     qRegisterMetaType<RtCovInput>("RtCovInput");
@@ -204,10 +337,55 @@ void RtCov::setSamples(qint32 samples)
 }
 
 
+//*************************************************************************************************************
+
+void RtCov::setIncremental(bool bIncremental)
+{
+    if(bIncremental == m_bIncremental) {
+        return;
+    }
+
+    m_bIncremental = bIncremental;
+    m_iSamples = 0;
+    m_lData.clear();
+
+    emit incrementalResetRequested();
+}
+
+
+//*************************************************************************************************************
+
+void RtCov::setForgettingFactor(double dLambda)
+{
+    m_dForgettingFactor = dLambda;
+
+    emit forgettingFactorChanged(dLambda);
+}
+
+
 //*************************************************************************************************************
 
 void RtCov::append(const MatrixXd &matDataSegment)
 {
+    if(m_bIncremental) {
+        m_iSamples += matDataSegment.cols();
+
+        RtCovInput inputData;
+        inputData.lData.append(matDataSegment);
+        inputData.iSamples = matDataSegment.cols();
+
+        //The measurement info is only needed for the regularization of the emitted covariance
+        bool bEmitResult = m_iSamples >= m_iMaxSamples;
+        if(bEmitResult) {
+            inputData.fiffInfo = *m_pFiffInfo;
+            m_iSamples = 0;
+        }
+
+        emit operateIncremental(inputData, bEmitResult);
+
+        return;
+    }
+
     m_lData.append(matDataSegment);
     m_iSamples += matDataSegment.cols();
 
@@ -248,10 +426,21 @@ void RtCov::restart()
     connect(this, &RtCov::operate,
             worker, &RtCovWorker::doWork);
 
+    connect(this, &RtCov::operateIncremental,
+            worker, &RtCovWorker::doWorkIncremental);
+
     connect(worker, &RtCovWorker::resultReady,
             this, &RtCov::handleResults);
 
+    connect(this, &RtCov::forgettingFactorChanged,
+            worker, &RtCovWorker::setForgettingFactor);
+
+    connect(this, &RtCov::incrementalResetRequested,
+            worker, &RtCovWorker::resetIncremental);
+
     m_workerThread.start();
+
+    emit forgettingFactorChanged(m_dForgettingFactor);
 }
 
 
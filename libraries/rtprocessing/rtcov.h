@@ -94,7 +94,7 @@ struct RtCovComputeResult {
 
 struct RtCovInput {
     QList<Eigen::MatrixXd>      lData;
-    FIFFLIB::FiffInfo           fiffInfo;
+    FIFFLIB::FiffInfo           fiffInfo;       /**< Only set if a covariance should be emitted. */
     int                         iSamples;
 };
 
@@ -110,6 +110,12 @@ class RTPROCESINGSHARED_EXPORT RtCovWorker : public QObject
     Q_OBJECT
 
 public:
+    //=========================================================================================================
+    /**
+     * Creates the real-time covariance worker.
+     */
+    RtCovWorker();
+
     //=========================================================================================================
     /**
      * Perform actual covariance estimation.
@@ -118,7 +124,60 @@ public:
      */
     void doWork(const RtCovInput &inputData);
 
+    //=========================================================================================================
+    /**
+     * Folds the data blocks into the running covariance estimate. The block is centered on its own mean and
+     * added as symmetric rank-k update of the lower triangle. Block mean and scatter are merged with the
+     * running (exponentially forgotten) estimate as in Welford's algorithm.
+     *
+     * @param[in] inputData      Data blocks to fold into the running estimate.
+     * @param[in] bEmitResult    Whether to emit the regularized covariance after folding the data.
+     */
+    void doWorkIncremental(const RtCovInput &inputData,
+                           bool bEmitResult);
+
+    //=========================================================================================================
+    /**
+     * Sets the per sample forgetting factor of the incremental estimate. The past estimate is weighted by
+     * dLambda^n when n new samples are folded in.
+     *
+     * @param[in] dLambda    The forgetting factor in (0,1]. 1 does not forget (cumulative estimate).
+     */
+    void setForgettingFactor(double dLambda);
+
+    //=========================================================================================================
+    /**
+     * Discards the running estimate of the incremental mode.
+     */
+    void resetIncremental();
+
+    //=========================================================================================================
+    /**
+     * Returns the unregularized covariance of the incremental estimate.
+     *
+     * @param[out] matCov    The weighted covariance of the data folded in so far.
+     * @param[out] iNFree    The effective degrees of freedom.
+     *
+     * @return   Whether enough samples were folded in to estimate the covariance.
+     */
+    bool getIncrementalCov(Eigen::MatrixXd& matCov,
+                           int& iNFree) const;
+
 protected:
+    //=========================================================================================================
+    /**
+     * Fills in the covariance information and regularizes the covariance.
+     *
+     * @param[in] matCov     The (unregularized) covariance data.
+     * @param[in] iNFree     The degrees of freedom.
+     * @param[in] fiffInfo   The measurement information.
+     *
+     * @return   The regularized noise covariance.
+     */
+    static FIFFLIB::FiffCov regularizeCov(const Eigen::MatrixXd& matCov,
+                                          int iNFree,
+                                          const FIFFLIB::FiffInfo& fiffInfo);
+
     //=========================================================================================================
     /**
      * Computer multiplication with transposed.
@@ -138,6 +197,14 @@ protected:
      */
     static void reduce(RtCovComputeResult& finalResult, const RtCovComputeResult &tempResult);
 
+    double              m_dForgettingFactor;    /**< Per sample forgetting factor of the incremental estimate. */
+    double              m_dWeight;              /**< Sum of the sample weights of the incremental estimate. */
+    double              m_dWeightSq;            /**< Sum of the squared sample weights, used for the effective degrees of freedom. */
+    Eigen::VectorXd     m_vecMean;              /**< Weighted mean of the incremental estimate. */
+    Eigen::MatrixXd     m_matScatter;           /**< Weighted centered scatter matrix, only the lower triangle is valid. */
+    Eigen::MatrixXd     m_matBlockScatter;      /**< Reused scatter matrix of the current block. */
+    Eigen::MatrixXd     m_matCentered;          /**< Reused centered data of the current block. */
+
 signals:
     //=========================================================================================================
     /**
@@ -197,6 +264,25 @@ public:
      */
     void setSamples(qint32 samples);
 
+    //=========================================================================================================
+    /**
+     * Switches between the block wise and the incremental estimation. In incremental mode every appended data
+     * segment is folded into a running estimate at constant cost and a regularized covariance is emitted
+     * every time the number of estimation samples (see setSamples) was received. Past data is not stored.
+     *
+     * @param[in] bIncremental   Whether to use the incremental estimation.
+     */
+    void setIncremental(bool bIncremental);
+
+    //=========================================================================================================
+    /**
+     * Sets the per sample forgetting factor of the incremental estimation. E.g. 1 - 1/(10*sfreq) forgets
+     * with a time constant of about 10 seconds.
+     *
+     * @param[in] dLambda    The forgetting factor in (0,1]. 1 does not forget (cumulative estimate).
+     */
+    void setForgettingFactor(double dLambda);
+
     //=========================================================================================================
     /**
      * Restarts the thread by interrupting its computation queue, quitting, waiting and then starting it again.
@@ -221,6 +307,8 @@ protected:
     qint32                  m_iMaxSamples;              /**< Maximal amount of samples received, before covariance is estimated.*/
     qint32                  m_iNewMaxSamples;           /**< New maximal amount of samples received, before covariance is estimated.*/
     int                     m_iSamples;                 /**< The number of stored samples. */
+    bool                    m_bIncremental;             /**< Whether to fold each data segment into a running estimate. */
+    double                  m_dForgettingFactor;        /**< Per sample forgetting factor of the incremental estimation. */
 
     QList<Eigen::MatrixXd>  m_lData;                    /**< The stored data blocks. */
 
@@ -243,6 +331,30 @@ signals:
      */
     void operate(const RtCovInput &inputData);
 
+    //=========================================================================================================
+    /**
+     * Emit this signal whenver the worker should fold a new data segment into the running estimate.
+     *
+     * @param[in] inputData      The new data segment.
+     * @param[in] bEmitResult    Whether the worker should emit the regularized covariance.
+     */
+    void operateIncremental(const RtCovInput &inputData,
+                            bool bEmitResult);
+
+    //=========================================================================================================
+    /**
+     * Emit this signal whenever the forgetting factor of the incremental estimation changed.
+     *
+     * @param[in] dLambda    The new forgetting factor.
+     */
+    void forgettingFactorChanged(double dLambda);
+
+    //=========================================================================================================
+    /**
+     * Emit this signal whenever the running estimate of the incremental estimation should be discarded.
+     */
+    void incrementalResetRequested();
+
 };
 
 //*************************************************************************************************************
@@ -60,26 +60,13 @@ using namespace FIFFLIB;
 
 #include <QDebug>
 
-//*************************************************************************************************************
-//=============================================================================================================
-// DEFINE GLOBAL METHODS
-//=============================================================================================================
-
-void doFilterPerChannelRTMSA(QPair<QList<FilterData>,QPair<int,RowVectorXd> > &channelDataTime)
-{
-    for(int i = 0; i < channelDataTime.first.size(); ++i) {
-        //channelDataTime.second.second = channelDataTime.first.at(i).applyConvFilter(channelDataTime.second.second, true, FilterData::ZeroPad);
-        channelDataTime.second.second = channelDataTime.first.at(i).applyFFTFilter(channelDataTime.second.second, true, FilterData::ZeroPad); //FFT Convolution for rt is not suitable. FFT make the signal filtering non causal.
-    }
-}
-
-
 //*************************************************************************************************************
 //=============================================================================================================
 // DEFINE MEMBER METHODS
 //=============================================================================================================
 
 RtFilter::RtFilter()
+: m_bStreamSettingsValid(false)
 {
 }
 
@@ -93,133 +80,99 @@ RtFilter::~RtFilter()
 
 //*************************************************************************************************************
 
-MatrixXd RtFilter::filterDataBlock(const MatrixXd& matDataIn,
-                                   int iOrder,
-                                   const RowVectorXi &vecPicks,
-                                   const QList<FilterData>& lFilterData)
+MatrixXd RtFilter::filterData(const MatrixXd& matDataIn,
+                              FilterData::FilterType type,
+                              double dCenterfreq,
+                              double bandwidth,
+                              double dTransition,
+                              double dSFreq,
+                              const RowVectorXi& vecPicks,
+                              int iOrder,
+                              qint32 iFftLength,
+                              FilterData::DesignMethod designMethod)
 {
-    //Initialise the overlay matrix
-    if(m_matOverlap.cols() != iOrder || m_matOverlap.rows() < matDataIn.rows()) {
-        m_matOverlap.resize(matDataIn.rows(), iOrder);
-        m_matOverlap.setZero();
+    // Check for size of data
+    if (matDataIn.cols()<iOrder){
+        qDebug() << QString("RtFilter::filterData - Filter length bigger then data length.");
     }
 
-    if(m_matDelay.cols() != iOrder/2 || m_matOverlap.rows() < matDataIn.rows()) {
-        m_matDelay.resize(matDataIn.rows(), iOrder/2);
-        m_matDelay.setZero();
-    }
+    //Only design and prepare the filter again if the settings or the picks changed. Otherwise keep the filter state,
+    //so that consecutive blocks are filtered without discontinuities.
+    bool bSettingsChanged = !m_bStreamSettingsValid
+                            || m_streamSettings.type != type
+                            || m_streamSettings.dCenterfreq != dCenterfreq
+                            || m_streamSettings.dBandwidth != bandwidth
+                            || m_streamSettings.dTransition != dTransition
+                            || m_streamSettings.dSFreq != dSFreq
+                            || m_streamSettings.iOrder != iOrder
+                            || m_streamSettings.iFftLength != iFftLength
+                            || m_streamSettings.designMethod != designMethod
+                            || m_streamingFilter.getPicks().cols() != vecPicks.cols()
+                            || m_streamingFilter.getPicks() != vecPicks;
+
+    if(bSettingsChanged) {
+        // create filter with the cut off frequencies normalized to nyquist
+        FilterData filter = FilterData("rt_filter",
+                                       type,
+                                       iOrder,
+                                       dCenterfreq/(dSFreq/2.0),
+                                       bandwidth/(dSFreq/2.0),
+                                       dTransition/(dSFreq/2.0),
+                                       dSFreq,
+                                       iFftLength,
+                                       designMethod);
+
+        QList<FilterData> filterList;
+        filterList << filter;
+
+        if(!prepareFilter(filterList, vecPicks)) {
+            return matDataIn;
+        }
 
-    //Resize output matrix to match input matrix
-    MatrixXd matDataOut = matDataIn;
+        m_streamSettings.type = type;
+        m_streamSettings.dCenterfreq = dCenterfreq;
+        m_streamSettings.dBandwidth = bandwidth;
+        m_streamSettings.dTransition = dTransition;
+        m_streamSettings.dSFreq = dSFreq;
+        m_streamSettings.iOrder = iOrder;
+        m_streamSettings.iFftLength = iFftLength;
+        m_streamSettings.designMethod = designMethod;
+        m_bStreamSettingsValid = true;
+    }
 
-    //Generate QList structure which can be handled by the QConcurrent framework
-    QList<QPair<QList<FilterData>,QPair<int,RowVectorXd> > > timeData;
+    MatrixXd matDataOut;
 
-    //Only select channels specified in vecPicks
-    for(qint32 i = 0; i < vecPicks.cols(); ++i) {
-        timeData.append(QPair<QList<FilterData>,QPair<int,RowVectorXd> >(lFilterData,QPair<int,RowVectorXd>(vecPicks[i],matDataIn.row(vecPicks[i]))));
+    if(!filterDataBlock(matDataIn, matDataOut)) {
+        return matDataIn;
     }
 
-    //Do the concurrent filtering
-    if(!timeData.isEmpty()) {
-        QFuture<void> future = QtConcurrent::map(timeData,
-                                             doFilterPerChannelRTMSA);
-
-        future.waitForFinished();
+    return matDataOut;
+}
 
-        //Do the overlap add method and store in matDataOut
-        int iFilteredNumberCols = timeData.at(0).second.second.cols();
 
-        for(int r = 0; r < timeData.size(); r++) {
-            //Get the currently filtered data. This data has a delay of filterLength/2 in front and back.
-            RowVectorXd tempData = timeData.at(r).second.second;
+//*************************************************************************************************************
 
-            //Perform the actual overlap add by adding the last filterlength data to the newly filtered one
-            tempData.head(iOrder) += m_matOverlap.row(timeData.at(r).second.first);
+bool RtFilter::prepareFilter(const QList<FilterData>& lFilterData,
+                             const RowVectorXi& vecPicks)
+{
+    m_bStreamSettingsValid = false;
 
-            //Write the newly calulated filtered data to the filter data matrix. Keep in mind that the current block also effect last part of the last block (begin at dataIndex-iFilterDelay).
-            int start = 0;
-            matDataOut.row(timeData.at(r).second.first).segment(start,iFilteredNumberCols-iOrder) = tempData.head(iFilteredNumberCols-iOrder);
+    return m_streamingFilter.prepareFilter(lFilterData, vecPicks);
+}
 
-            //Refresh the m_matOverlap with the new calculated filtered data.
-            m_matOverlap.row(timeData.at(r).second.first) = timeData.at(r).second.second.tail(iOrder);
-        }
-    }
 
-    if(matDataIn.cols() >= iOrder/2) {
-        m_matDelay = matDataIn.block(0, matDataIn.cols()-iOrder/2, matDataIn.rows(), iOrder/2);
-    } else {
-            qWarning() << "RtFilter::filterDataBlock - Half of filter length is larger than data size. Not filling m_matDelay for next step.";
-    }
+//*************************************************************************************************************
 
-    return matDataOut;
+bool RtFilter::filterDataBlock(const MatrixXd& matDataIn,
+                               MatrixXd& matDataOut)
+{
+    return m_streamingFilter.filterDataBlock(matDataIn, matDataOut);
 }
 
 
 //*************************************************************************************************************
 
-MatrixXd RtFilter::filterData(const MatrixXd& matDataIn,
-                              FilterData::FilterType type,
-                              double dCenterfreq,
-                              double bandwidth,
-                              double dTransition,
-                              double dSFreq,
-                              const RowVectorXi& vecPicks,
-                              int iOrder,
-                              qint32 iFftLength,
-                              FilterData::DesignMethod designMethod)
+void RtFilter::resetFilter()
 {
-    // Check for size of data
-    if (matDataIn.cols()<iOrder){
-        qDebug() << QString("RtFilter::filterData - Filter length bigger then data length.");
-    }
-
-    // Normalize cut off frequencies to nyquist
-    dCenterfreq = dCenterfreq/(dSFreq/2.0);
-    bandwidth = bandwidth/(dSFreq/2.0);
-    dTransition = dTransition/(dSFreq/2.0);
-
-    // create output matrix with size of inputmatrix and temporal input matrix with size of pick
-    MatrixXd matDataOut = matDataIn;
-    MatrixXd sliceFiltered;
-    // create filter
-    FilterData filter = FilterData("rt_filter",
-                                   type,
-                                   iOrder,
-                                   dCenterfreq,
-                                   bandwidth,
-                                   dTransition,
-                                   dSFreq,
-                                   iFftLength,
-                                   designMethod);
-
-    QList<FilterData> filterList;
-    filterList << filter;
-
-    // slice input data into data junks with proper length for fft
-    int iSize = iFftLength-iOrder;
-
-    if(matDataIn.cols() > iSize) {
-        int from = 0;
-        int numSlices = ceil(float(matDataIn.cols())/float(iSize)); //calculate number of data slices
-
-        for (int i = 0; i<numSlices; i++) {
-            if(i == numSlices-1) {
-                //catch the last one that might be shorter then original size
-                iSize = matDataIn.cols() - (iSize * (numSlices -1));
-            }
-            sliceFiltered = filterDataBlock(matDataIn.block(0,from,matDataIn.rows(),iSize),
-                                            iOrder,
-                                            vecPicks,
-                                            filterList);
-            matDataOut.block(0,from,matDataIn.rows(),iSize) = sliceFiltered;
-            from += iSize;
-        }
-    } else {
-        matDataOut = filterDataBlock(matDataIn,
-                                    iOrder,
-                                    vecPicks,
-                                    filterList);
-    }
-    return matDataOut;
+    m_streamingFilter.resetFilter();
 }
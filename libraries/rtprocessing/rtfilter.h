@@ -45,6 +45,8 @@
 #include "rtprocessing_global.h"
 
 #include <utils/filterTools/filterdata.h>
+#include <utils/filterTools/iirfilter.h>
+#include <utils/filterTools/streamingfilter.h>
 #include <fiff/fiff_info.h>
 
 
@@ -54,8 +56,6 @@
 //=============================================================================================================
 
 #include <QSharedPointer>
-#include <QtConcurrent/QtConcurrent>
-#include <QFuture>
 
 
 //*************************************************************************************************************
@@ -64,7 +64,6 @@
 //=============================================================================================================
 
 #include <Eigen/Core>
-#include <unsupported/Eigen/FFT>
 
 
 //*************************************************************************************************************
@@ -108,21 +107,6 @@ public:
     ~RtFilter();
 
     //=========================================================================================================
-    /**
-     * Calculates the filtered version of the raw input data
-     *
-     * @param [in] matDataIn The data which is to be filtered
-     * @param [in] iOrder The maximum filterlength, sames as filter order(FIR)
-     * @param [in] vecPicks The used channel as index in RowVector
-     * @param [in] lFilterData The FilterData generated by filterobject from utilslib
-     *
-     * @return The filtered data in form of a matrix.
-     */
-    Eigen::MatrixXd filterDataBlock(const Eigen::MatrixXd& matDataIn,
-                                               int iOrder,
-                                               const Eigen::RowVectorXi& vecPicks,
-                                               const QList<UTILSLIB::FilterData> &lFilterData);
-
     /**
      * Calculates the filtered version of the raw input data AND creates filter
      *
@@ -136,7 +120,10 @@ public:
      * @param [in] vecPicks - used channel as index in QVector
      * @param [in] iOrder represents the order of the filter, the higher the higher is the stopband attenuation
      * @param [in] iFftLength length of the fft (multiple integer of 2^x) - Default = 4096
-     * @param [in] designMethod specifies the design method to use. Choose between Cosind and Tschebyscheff; Defaul = Cosine
+     * @param [in] designMethod specifies the design method to use. Choose between Cosind and Tschebyscheff (FIR) or IIRButterworth and IIRChebyshev (IIR, iOrder is then the order of the prototype); Defaul = Cosine
+     *
+     * The filter is only designed and prepared again if the filter settings or the picks differ from the last call.
+     * Otherwise the state of the streaming filter is kept, so that consecutive blocks can be passed one after another.
      *
      * @return The filtered data in form of a matrix.
      */
@@ -152,12 +139,57 @@ public:
                                qint32 iFftLength = 4096,
                                UTILSLIB::FilterData::DesignMethod designMethod = UTILSLIB::FilterData::Cosine);
 
-protected:
-    Eigen::MatrixXd                 m_matOverlap;                   /**< Last overlap block */
-    Eigen::MatrixXd                 m_matDelay;                     /**< Last delay block */
+    //=========================================================================================================
+    /**
+     * Prepares the streaming filter for the given filters and channels, see UTILSLIB::StreamingFilter::prepareFilter.
+     * The state of the streaming filter is reset.
+     *
+     * @param [in] lFilterData   The filters to apply (in cascade).
+     * @param [in] vecPicks      The channels to filter as index in RowVector.
+     *
+     * @return true if succeeded, false otherwise.
+     */
+    bool prepareFilter(const QList<UTILSLIB::FilterData> &lFilterData,
+                       const Eigen::RowVectorXi& vecPicks);
 
-private:
+    //=========================================================================================================
+    /**
+     * Filters a data block with the streaming filter set up via prepareFilter, see
+     * UTILSLIB::StreamingFilter::filterDataBlock. The overlap and IIR state of every channel is kept between calls.
+     *
+     * @param [in] matDataIn     The data block which is to be filtered.
+     * @param [out] matDataOut   The filtered data block. Only resized if its dimensions do not match the input.
+     *
+     * @return true if succeeded, false otherwise.
+     */
+    bool filterDataBlock(const Eigen::MatrixXd& matDataIn,
+                         Eigen::MatrixXd& matDataOut);
 
+    //=========================================================================================================
+    /**
+     * Resets the per-channel state of the streaming filter.
+     */
+    void resetFilter();
+
+private:
+    //=========================================================================================================
+    /**
+     * The settings passed to filterData, used to detect whether the filter needs to be designed again.
+     */
+    struct FilterSettings {
+        UTILSLIB::FilterData::FilterType    type;           /**< The filter type. */
+        double                              dCenterfreq;    /**< The center frequency in Hz. */
+        double                              dBandwidth;     /**< The bandwidth in Hz. */
+        double                              dTransition;    /**< The transition width in Hz. */
+        double                              dSFreq;         /**< The sampling frequency. */
+        int                                 iOrder;         /**< The filter order. */
+        qint32                              iFftLength;     /**< The FFT length. */
+        UTILSLIB::FilterData::DesignMethod  designMethod;   /**< The design method. */
+    };
+
+    bool                            m_bStreamSettingsValid;         /**< Whether the streaming filter was prepared by filterData with m_streamSettings. */
+    FilterSettings                  m_streamSettings;               /**< The settings of the last call to filterData. */
+    UTILSLIB::StreamingFilter       m_streamingFilter;              /**< The streaming filter. */
 };
 
 //*************************************************************************************************************
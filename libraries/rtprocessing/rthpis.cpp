@@ -89,15 +89,15 @@ void RtHPISWorker::doWork(const Eigen::MatrixXd& matData,
     fitResult.devHeadTrans.from = 1;
     fitResult.devHeadTrans.to = 4;
 
-    HPIFit::fitHPI(matData,
-                    matProjectors,
-                    fitResult.devHeadTrans,
-                    vFreqs,
-                    fitResult.errorDistances,
-                    fitResult.fittedCoils,
-                    pFiffInfo);
-
-    emit resultReady(fitResult);
+    if(m_hpiFit.fitHPIContinuous(matData,
+                                 matProjectors,
+                                 fitResult.devHeadTrans,
+                                 vFreqs,
+                                 fitResult.errorDistances,
+                                 fitResult.fittedCoils,
+                                 pFiffInfo)) {
+        emit resultReady(fitResult);
+    }
 }
 
 
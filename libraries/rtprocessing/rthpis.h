@@ -47,6 +47,8 @@
 #include <fiff/fiff_dig_point.h>
 #include <fiff/fiff_coord_trans.h>
 
+#include <inverse/hpiFit/hpifit.h>
+
 
 //*************************************************************************************************************
 //=============================================================================================================
@@ -124,6 +126,9 @@ public:
                 const QVector<int>& vFreqs,
                 QSharedPointer<FIFFLIB::FiffInfo> pFiffInfo);
 
+protected:
+    INVERSELIB::HPIFit      m_hpiFit;       /**< The continuous HPI fit, keeps its setup and the last coil positions between fits. */
+
 signals:
     void resultReady(const RTPROCESSINGLIB::FittingResult &fitResult);
 };
@@ -0,0 +1,371 @@
+//=============================================================================================================
+/**
+ * @file     rtresample.cpp
+ * @author   agent <agent@local>
+ * @version  dev
+ * @date     October, 2026
+ *
+ * @section  LICENSE
+ *
+ * Copyright (C) 2026, agent. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+ * the following conditions are met:
+ *     * Redistributions of source code must retain the above copyright notice, this list of conditions and the
+ *       following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+ *       the following disclaimer in the documentation and/or other materials provided with the distribution.
+ *     * Neither the name of MNE-CPP authors nor the names of its contributors may be used
+ *       to endorse or promote products derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+ * WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ * PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+ * INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ * NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ *
+ * @brief    Definition of the RtResample class
+ *
+ */
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// INCLUDES
+//=============================================================================================================
+
+#include "rtresample.h"
+
+#include <fiff/fiff_raw_data.h>
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// QT INCLUDES
+//=============================================================================================================
+
+#include <QDebug>
+#include <QtMath>
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// USED NAMESPACES
+//=============================================================================================================
+
+using namespace RTPROCESSINGLIB;
+using namespace UTILSLIB;
+using namespace FIFFLIB;
+using namespace Eigen;
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// DEFINE GLOBAL METHODS
+//=============================================================================================================
+
+namespace {
+
+int greatestCommonDivisor(int a, int b)
+{
+    while(b != 0) {
+        int t = a % b;
+        a = b;
+        b = t;
+    }
+
+    return a;
+}
+
+} // namespace
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// DEFINE MEMBER METHODS
+//=============================================================================================================
+
+RtResample::RtResample()
+: m_iUp(1)
+, m_iDown(1)
+, m_iNumPhaseTaps(0)
+, m_iFilterDelay(0)
+, m_iNextOutput(0)
+, m_dSFreqIn(0.0)
+{
+}
+
+
+//*************************************************************************************************************
+
+bool RtResample::prepareResample(double dSFreqIn,
+                                 double dSFreqOut,
+                                 int iFilterOrder,
+                                 FilterData::DesignMethod designMethod)
+{
+    int iSFreqIn = qRound(dSFreqIn);
+    int iSFreqOut = qRound(dSFreqOut);
+
+    if(iSFreqIn <= 0 || iSFreqOut <= 0) {
+        qWarning() << "RtResample::prepareResample - Sampling frequencies need to be at least 1 Hz.";
+        return false;
+    }
+
+    int iGcd = greatestCommonDivisor(iSFreqIn, iSFreqOut);
+
+    return prepareResample(iSFreqOut / iGcd,
+                           iSFreqIn / iGcd,
+                           dSFreqIn,
+                           iFilterOrder,
+                           designMethod);
+}
+
+
+//*************************************************************************************************************
+
+bool RtResample::prepareResample(int iUp,
+                                 int iDown,
+                                 double dSFreqIn,
+                                 int iFilterOrder,
+                                 FilterData::DesignMethod designMethod)
+{
+    m_matPhases.resize(0,0);
+
+    if(iUp < 1 || iDown < 1 || dSFreqIn <= 0.0) {
+        qWarning() << "RtResample::prepareResample - Invalid resampling factors or sampling frequency.";
+        return false;
+    }
+
+    int iGcd = greatestCommonDivisor(iUp, iDown);
+
+    m_iUp = iUp / iGcd;
+    m_iDown = iDown / iGcd;
+    m_dSFreqIn = dSFreqIn;
+
+    RowVectorXd vecTaps = RowVectorXd::Ones(1);
+
+    if(m_iUp != 1 || m_iDown != 1) {
+        //Design the anti-alias filter at the upsampled frequency
+        int iFactor = qMax(m_iUp, m_iDown);
+        int iNumTaps = iFilterOrder > 0 ? iFilterOrder : 20 * iFactor;
+        iNumTaps += iNumTaps % 2;
+
+        double dSFreqUp = dSFreqIn * m_iUp;
+        double dNyquistUp = dSFreqUp / 2.0;
+        double dNyquistOut = dSFreqUp / (2.0 * iFactor);
+
+        int iFftLength = 512;
+        while(iFftLength < 4 * iNumTaps) {
+            iFftLength *= 2;
+        }
+
+        FilterData filter("resample_anti_alias",
+                          FilterData::LPF,
+                          iNumTaps,
+                          0.8 * dNyquistOut / dNyquistUp,
+                          0.0,
+                          0.4 * dNyquistOut / dNyquistUp,
+                          dSFreqUp,
+                          iFftLength,
+                          designMethod);
+
+        vecTaps = filter.m_dCoeffA;
+
+        if(vecTaps.cols() == 0 || vecTaps.sum() == 0.0) {
+            qWarning() << "RtResample::prepareResample - Anti-alias filter design failed.";
+            return false;
+        }
+
+        //Normalize the DC gain to the upsampling factor, which compensates for the inserted zeros
+        vecTaps *= m_iUp / vecTaps.sum();
+    }
+
+    m_iFilterDelay = vecTaps.cols() / 2;
+    m_iNumPhaseTaps = (vecTaps.cols() + m_iUp - 1) / m_iUp;
+
+    //Split the filter into its polyphase components. Tap p + j*up multiplies the input sample j steps in the past.
+    //The taps are stored reversed, so that one phase can be applied to a contiguous block of input samples.
+    m_matPhases = MatrixXd::Zero(m_iNumPhaseTaps, m_iUp);
+
+    for(int p = 0; p < m_iUp; ++p) {
+        for(int j = 0; j < m_iNumPhaseTaps; ++j) {
+            if(p + j * m_iUp < vecTaps.cols()) {
+                m_matPhases(m_iNumPhaseTaps - 1 - j, p) = vecTaps[p + j * m_iUp];
+            }
+        }
+    }
+
+    resetResample();
+
+    return true;
+}
+
+
+//*************************************************************************************************************
+
+bool RtResample::resampleData(const MatrixXd& matDataIn,
+                              MatrixXd& matDataOut)
+{
+    if(m_matPhases.size() == 0) {
+        qWarning() << "RtResample::resampleData - Resampling was not prepared. Call prepareResample first.";
+        return false;
+    }
+
+    const int iNumSamples = matDataIn.cols();
+    const int iNumOutput = int((qint64(iNumSamples) * m_iUp + m_iDown - 1) / m_iDown);
+
+    //Pad both edges with enough samples to cover the filter length, mirror the data if possible
+    const int iPad = m_iNumPhaseTaps;
+
+    resetResample();
+
+    m_matWork = MatrixXd::Zero(matDataIn.rows(), m_iNumPhaseTaps - 1 + iNumSamples + 2 * iPad);
+    m_matWork.middleCols(m_iNumPhaseTaps - 1 + iPad, iNumSamples) = matDataIn;
+
+    if(iNumSamples > iPad) {
+        m_matWork.middleCols(m_iNumPhaseTaps - 1, iPad) = matDataIn.leftCols(iPad).rowwise().reverse();
+        m_matWork.rightCols(iPad) = matDataIn.rightCols(iPad).rowwise().reverse();
+    }
+
+    //Start at the first data sample plus the filter delay
+    m_iNextOutput = qint64(iPad) * m_iUp + m_iFilterDelay;
+
+    resampleWorkBuffer(iNumSamples + 2 * iPad, iNumOutput, matDataOut);
+
+    resetResample();
+    m_matWork.resize(0,0);
+
+    return true;
+}
+
+
+//*************************************************************************************************************
+
+bool RtResample::resampleRawSegment(const FiffRawData& raw,
+                                    double dSFreqOut,
+                                    MatrixXd& matData,
+                                    MatrixXd& matTimes,
+                                    fiff_int_t from,
+                                    fiff_int_t to,
+                                    const RowVectorXi& sel)
+{
+    if(m_matPhases.size() == 0 || m_dSFreqIn != raw.info.sfreq || qRound(getSFreqOut()) != qRound(dSFreqOut)) {
+        if(!prepareResample(raw.info.sfreq, dSFreqOut)) {
+            return false;
+        }
+    }
+
+    MatrixXd matDataRaw;
+    MatrixXd matTimesRaw;
+
+    if(!raw.read_raw_segment(matDataRaw, matTimesRaw, from, to, sel)) {
+        qWarning() << "RtResample::resampleRawSegment - Could not read raw segment.";
+        return false;
+    }
+
+    if(!resampleData(matDataRaw, matData)) {
+        return false;
+    }
+
+    double dStart = matTimesRaw.cols() > 0 ? matTimesRaw(0,0) : 0.0;
+
+    matTimes.resize(1, matData.cols());
+
+    for(int i = 0; i < matData.cols(); ++i) {
+        matTimes(0,i) = dStart + i / getSFreqOut();
+    }
+
+    return true;
+}
+
+
+//*************************************************************************************************************
+
+bool RtResample::resampleDataBlock(const MatrixXd& matDataIn,
+                                   MatrixXd& matDataOut)
+{
+    if(m_matPhases.size() == 0) {
+        qWarning() << "RtResample::resampleDataBlock - Resampling was not prepared. Call prepareResample first.";
+        return false;
+    }
+
+    const int iNumSamples = matDataIn.cols();
+
+    if(m_matHistory.rows() != matDataIn.rows()) {
+        m_matHistory = MatrixXd::Zero(matDataIn.rows(), m_iNumPhaseTaps - 1);
+    }
+
+    if(m_matWork.rows() != matDataIn.rows() || m_matWork.cols() != m_iNumPhaseTaps - 1 + iNumSamples) {
+        m_matWork.resize(matDataIn.rows(), m_iNumPhaseTaps - 1 + iNumSamples);
+    }
+
+    m_matWork.leftCols(m_iNumPhaseTaps - 1) = m_matHistory;
+    m_matWork.rightCols(iNumSamples) = matDataIn;
+
+    resampleWorkBuffer(iNumSamples, -1, matDataOut);
+
+    m_matHistory = m_matWork.rightCols(m_iNumPhaseTaps - 1);
+
+    return true;
+}
+
+
+//*************************************************************************************************************
+
+void RtResample::resetResample()
+{
+    m_iNextOutput = 0;
+    m_matHistory.resize(0,0);
+}
+
+
+//*************************************************************************************************************
+
+double RtResample::getDelay() const
+{
+    return double(m_iFilterDelay) / m_iDown;
+}
+
+
+//*************************************************************************************************************
+
+double RtResample::getSFreqOut() const
+{
+    return m_dSFreqIn * m_iUp / m_iDown;
+}
+
+
+//*************************************************************************************************************
+
+void RtResample::resampleWorkBuffer(int iNumSamples,
+                                    int iMaxOutput,
+                                    MatrixXd& matDataOut)
+{
+    const qint64 iEnd = qint64(iNumSamples) * m_iUp;
+
+    int iNumOutput = m_iNextOutput < iEnd ? int((iEnd - m_iNextOutput + m_iDown - 1) / m_iDown) : 0;
+
+    if(iMaxOutput >= 0) {
+        iNumOutput = qMin(iNumOutput, iMaxOutput);
+    }
+
+    if(matDataOut.rows() != m_matWork.rows() || matDataOut.cols() != iNumOutput) {
+        matDataOut.resize(m_matWork.rows(), iNumOutput);
+    }
+
+    //Output sample n is located at position m_iNextOutput + n*down of the upsampled block. Its phase selects the
+    //taps, the window of input samples ends at the last input sample at or before this position.
+    for(int n = 0; n < iNumOutput; ++n) {
+        const qint64 t = m_iNextOutput + qint64(n) * m_iDown;
+        const int i = int(t / m_iUp);
+        const int p = int(t % m_iUp);
+
+        matDataOut.col(n).noalias() = m_matWork.middleCols(i, m_iNumPhaseTaps) * m_matPhases.col(p);
+    }
+
+    m_iNextOutput += qint64(iNumOutput) * m_iDown - iEnd;
+}
@@ -0,0 +1,245 @@
+//=============================================================================================================
+/**
+ * @file     rtresample.h
+ * @author   agent <agent@local>
+ * @version  dev
+ * @date     October, 2026
+ *
+ * @section  LICENSE
+ *
+ * Copyright (C) 2026, agent. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+ * the following conditions are met:
+ *     * Redistributions of source code must retain the above copyright notice, this list of conditions and the
+ *       following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+ *       the following disclaimer in the documentation and/or other materials provided with the distribution.
+ *     * Neither the name of MNE-CPP authors nor the names of its contributors may be used
+ *       to endorse or promote products derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+ * WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ * PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+ * INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ * NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ *
+ * @brief    Declaration of the RtResample class
+ *
+ */
+
+#ifndef RTRESAMPLE_H
+#define RTRESAMPLE_H
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// INCLUDES
+//=============================================================================================================
+
+#include "rtprocessing_global.h"
+
+#include <utils/filterTools/filterdata.h>
+#include <fiff/fiff_types.h>
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// QT INCLUDES
+//=============================================================================================================
+
+#include <QSharedPointer>
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// Eigen INCLUDES
+//=============================================================================================================
+
+#include <Eigen/Core>
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// FORWARD DECLARATIONS
+//=============================================================================================================
+
+namespace FIFFLIB {
+    class FiffRawData;
+}
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// DEFINE NAMESPACE RTPROCESSINGLIB
+//=============================================================================================================
+
+namespace RTPROCESSINGLIB
+{
+
+
+//=============================================================================================================
+/**
+ * Rational resampling by a factor up/down with a polyphase FIR filter bank. The data is (virtually) upsampled by
+ * inserting zeros, low pass filtered with an anti-alias filter designed via UTILSLIB::FilterData and decimated.
+ * Only the filter taps which hit non-zero input samples are evaluated and only for the output samples which are
+ * kept. Whole data segments are resampled with compensated filter delay, data blocks can be streamed with
+ * per-channel state.
+ *
+ * @brief Polyphase resampling and decimation
+ */
+class RTPROCESINGSHARED_EXPORT RtResample
+{
+
+public:
+    typedef QSharedPointer<RtResample> SPtr;             /**< Shared pointer type for RtResample. */
+    typedef QSharedPointer<const RtResample> ConstSPtr;  /**< Const shared pointer type for RtResample. */
+
+    //=========================================================================================================
+    /**
+     * Creates the resampling object.
+     */
+    explicit RtResample();
+
+    //=========================================================================================================
+    /**
+     * Prepares the resampling from the input to the output sampling frequency. The resampling factors are derived
+     * from the frequencies rounded to Hz. The state of the streaming resampler is reset.
+     *
+     * @param [in] dSFreqIn         The sampling frequency of the input data.
+     * @param [in] dSFreqOut        The desired sampling frequency of the output data.
+     * @param [in] iFilterOrder     The number of taps of the anti-alias filter. Default (-1) uses 20 taps per factor.
+     * @param [in] designMethod     The design method of the anti-alias filter. Default is Cosine.
+     *
+     * @return true if succeeded, false otherwise.
+     */
+    bool prepareResample(double dSFreqIn,
+                         double dSFreqOut,
+                         int iFilterOrder = -1,
+                         UTILSLIB::FilterData::DesignMethod designMethod = UTILSLIB::FilterData::Cosine);
+
+    //=========================================================================================================
+    /**
+     * Prepares the resampling by the rational factor iUp/iDown. The anti-alias filter is designed at the upsampled
+     * frequency with a pass band up to 80% of the smaller of the input and output nyquist frequency. The state of the
+     * streaming resampler is reset.
+     *
+     * @param [in] iUp              The upsampling factor.
+     * @param [in] iDown            The downsampling factor.
+     * @param [in] dSFreqIn         The sampling frequency of the input data.
+     * @param [in] iFilterOrder     The number of taps of the anti-alias filter. Default (-1) uses 20 taps per factor.
+     * @param [in] designMethod     The design method of the anti-alias filter. Default is Cosine.
+     *
+     * @return true if succeeded, false otherwise.
+     */
+    bool prepareResample(int iUp,
+                         int iDown,
+                         double dSFreqIn,
+                         int iFilterOrder = -1,
+                         UTILSLIB::FilterData::DesignMethod designMethod = UTILSLIB::FilterData::Cosine);
+
+    //=========================================================================================================
+    /**
+     * Resamples a whole data segment. The delay of the anti-alias filter is compensated and the edges are padded by
+     * mirroring the data. The state of the streaming resampler is reset.
+     *
+     * @param [in] matDataIn     The data to resample (channels x samples).
+     * @param [out] matDataOut   The resampled data (channels x ceil(samples*up/down)).
+     *
+     * @return true if succeeded, false otherwise.
+     */
+    bool resampleData(const Eigen::MatrixXd& matDataIn,
+                      Eigen::MatrixXd& matDataOut);
+
+    //=========================================================================================================
+    /**
+     * Reads and resamples a raw data segment. Resampling is prepared for the sampling frequency of the raw data,
+     * if it was not prepared for it before.
+     *
+     * @param [in] raw              The raw data to read from.
+     * @param [in] dSFreqOut        The desired sampling frequency.
+     * @param [out] matData         The resampled data.
+     * @param [out] matTimes        The times of the resampled data.
+     * @param [in] from             The first sample to read.
+     * @param [in] to               The last sample to read.
+     * @param [in] sel              The channel selection.
+     *
+     * @return true if succeeded, false otherwise.
+     */
+    bool resampleRawSegment(const FIFFLIB::FiffRawData& raw,
+                            double dSFreqOut,
+                            Eigen::MatrixXd& matData,
+                            Eigen::MatrixXd& matTimes,
+                            FIFFLIB::fiff_int_t from = -1,
+                            FIFFLIB::fiff_int_t to = -1,
+                            const Eigen::RowVectorXi& sel = FIFFLIB::defaultRowVectorXi);
+
+    //=========================================================================================================
+    /**
+     * Resamples a data block with the streaming resampler. The input history of every channel and the position of
+     * the next output sample are kept between calls. Hence, consecutive blocks of any length yield the same result
+     * as one long block. The number of output samples can vary between blocks if the block size is not a multiple of
+     * the downsampling factor. The output is delayed by the group delay of the anti-alias filter, see getDelay().
+     *
+     * @param [in] matDataIn     The data block to resample (channels x samples).
+     * @param [out] matDataOut   The resampled data block. Only reallocated if its dimensions change.
+     *
+     * @return true if succeeded, false otherwise.
+     */
+    bool resampleDataBlock(const Eigen::MatrixXd& matDataIn,
+                           Eigen::MatrixXd& matDataOut);
+
+    //=========================================================================================================
+    /**
+     * Resets the state of the streaming resampler.
+     */
+    void resetResample();
+
+    //=========================================================================================================
+    /**
+     * Returns the group delay of the streaming resampler in output samples.
+     *
+     * @return The delay in output samples.
+     */
+    double getDelay() const;
+
+    //=========================================================================================================
+    /**
+     * Returns the sampling frequency of the resampled data.
+     *
+     * @return The output sampling frequency.
+     */
+    double getSFreqOut() const;
+
+private:
+    //=========================================================================================================
+    /**
+     * Computes all output samples of the current work buffer.
+     *
+     * @param [in] iNumSamples   The number of new input samples in the work buffer.
+     * @param [in] iMaxOutput    The maximum number of output samples to compute. -1 for all.
+     * @param [out] matDataOut   The resampled data.
+     */
+    void resampleWorkBuffer(int iNumSamples,
+                            int iMaxOutput,
+                            Eigen::MatrixXd& matDataOut);
+
+    int                 m_iUp;                  /**< The upsampling factor. */
+    int                 m_iDown;                /**< The downsampling factor. */
+    int                 m_iNumPhaseTaps;        /**< The number of taps per polyphase component. */
+    int                 m_iFilterDelay;         /**< The delay of the anti-alias filter at the upsampled frequency. */
+    qint64              m_iNextOutput;          /**< Position of the next output sample at the upsampled frequency, relative to the current block. */
+    double              m_dSFreqIn;             /**< The input sampling frequency. */
+
+    Eigen::MatrixXd     m_matPhases;            /**< The reversed polyphase components (taps per phase x up), scaled by up. */
+    Eigen::MatrixXd     m_matHistory;           /**< The last input samples of the previous block (channels x taps per phase - 1). */
+    Eigen::MatrixXd     m_matWork;              /**< The work buffer holding the history followed by the current block. */
+};
+
+} // NAMESPACE RTPROCESSINGLIB
+
+#endif // RTRESAMPLE_H
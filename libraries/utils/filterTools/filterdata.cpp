@@ -45,6 +45,7 @@
 
 #include "parksmcclellan.h"
 #include "cosinefilter.h"
+#include "iirfilter.h"
 
 //*************************************************************************************************************
 //=============================================================================================================
@@ -59,6 +60,9 @@
 //=============================================================================================================
 
 #include <QDebug>
+#include <QThread>
+#include <QVector>
+#include <QtConcurrent/QtConcurrent>
 
 //*************************************************************************************************************
 //=============================================================================================================
@@ -78,6 +82,85 @@
 
 using namespace UTILSLIB;
 
+
+//*************************************************************************************************************
+//=============================================================================================================
+// DEFINE GLOBAL METHODS
+//=============================================================================================================
+
+namespace {
+
+//=============================================================================================================
+/**
+ * Scratch memory and row range of one worker of FilterData::applyFFTFilter(const MatrixXd&, ...).
+ */
+struct FFTFilterWorker {
+    Eigen::FFT<double>      fft;            /**< The FFT object, keeps its plan for all rows of this worker. */
+    RowVectorXd             vecPadded;      /**< The zero padded or mirrored input row. */
+    RowVectorXd             vecTime;        /**< Time domain scratch buffer of FFT length. */
+    RowVectorXcd            vecFreq;        /**< Frequency domain scratch buffer of half FFT length + 1. */
+    RowVectorXd             vecConv;        /**< The linear convolution of the padded row with the filter. */
+    int                     iFirstRow;      /**< The first row handled by this worker. */
+    int                     iNumRows;       /**< The number of rows handled by this worker. */
+    int                     iPad;           /**< The number of mirrored samples in front and back of the data. */
+    bool                    bKeepOverhead;  /**< Whether to keep the overhead in the output. */
+    const FilterData*       pFilter;        /**< The filter to apply. */
+    const MatrixXd*         pDataIn;        /**< The input data. */
+    MatrixXd*               pDataOut;       /**< The output data. */
+};
+
+//*************************************************************************************************************
+
+void doFilterRowsFFT(FFTFilterWorker& worker)
+{
+    const MatrixXd& matDataIn = *worker.pDataIn;
+    MatrixXd& matDataOut = *worker.pDataOut;
+
+    const int iFFTLength = worker.pFilter->m_iFFTlength;
+    const int iNumTaps = worker.pFilter->m_dCoeffA.cols();
+    const int iNumSamples = matDataIn.cols();
+    const int iPad = worker.iPad;
+    const int iPaddedLength = iNumSamples + 2 * iPad;
+
+    //The linear convolution of a step and the filter needs to fit into the FFT length to avoid circular convolution
+    const int iStepSize = iFFTLength - iNumTaps;
+
+    for(int r = worker.iFirstRow; r < worker.iFirstRow + worker.iNumRows; ++r) {
+        //Zero pad or mirror the data
+        worker.vecPadded.segment(iPad, iNumSamples) = matDataIn.row(r);
+
+        if(iPad > 0) {
+            worker.vecPadded.head(iPad) = matDataIn.row(r).head(iPad).reverse();
+            worker.vecPadded.tail(iPad) = matDataIn.row(r).tail(iPad).reverse();
+        }
+
+        //Overlap add over all steps
+        worker.vecConv.setZero();
+
+        for(int from = 0; from < iPaddedLength; from += iStepSize) {
+            const int iLength = qMin(iStepSize, iPaddedLength - from);
+
+            worker.vecTime.head(iLength) = worker.vecPadded.segment(from, iLength);
+            worker.vecTime.tail(iFFTLength - iLength).setZero();
+
+            worker.fft.fwd(worker.vecFreq.data(), worker.vecTime.data(), iFFTLength);
+            worker.vecFreq.array() *= worker.pFilter->m_dFFTCoeffA.array();
+            worker.fft.inv(worker.vecTime.data(), worker.vecFreq.data(), iFFTLength);
+
+            worker.vecConv.segment(from, iFFTLength) += worker.vecTime;
+        }
+
+        //Return filtered data
+        if(worker.bKeepOverhead) {
+            matDataOut.row(r) = worker.vecConv.head(iNumSamples + iNumTaps);
+        } else {
+            matDataOut.row(r) = worker.vecConv.segment(iPad + iNumTaps/2, iNumSamples);
+        }
+    }
+}
+
+} // namespace
+
 //*************************************************************************************************************
 
 FilterData::FilterData()
@@ -126,6 +209,8 @@ FilterData::FilterData(QString unique_name,
 
 void FilterData::designFilter()
 {
+    m_matSOS.resize(0,6);
+
     switch(m_designMethod) {
         case Tschebyscheff: {
             ParksMcClellan filter(m_iFilterOrder,
@@ -189,6 +274,33 @@ void FilterData::designFilter()
 
             break;
         }
+
+        case IIRButterworth:
+        case IIRChebyshev: {
+            double dLowpass = m_dCenterFreq*(m_sFreq/2);
+            double dHighpass = m_dCenterFreq*(m_sFreq/2);
+
+            if(m_Type == BPF || m_Type == NOTCH) {
+                dLowpass = (m_dCenterFreq + m_dBandwidth/2)*(m_sFreq/2);
+                dHighpass = (m_dCenterFreq - m_dBandwidth/2)*(m_sFreq/2);
+            }
+
+            IIRFilter filteriir(m_iFilterOrder,
+                                dLowpass,
+                                dHighpass,
+                                m_sFreq,
+                                (IIRFilter::TPassType)m_Type,
+                                m_designMethod == IIRChebyshev ? IIRFilter::Chebyshev : IIRFilter::Butterworth);
+
+            m_matSOS = filteriir.m_matSOS;
+
+            //The FIR representations are only kept for plotting and for FIR based filter routines. They hold the truncated
+            //impulse response and the exact frequency response.
+            m_dCoeffA = filteriir.impulseResponse(m_iFFTlength/2);
+            m_dFFTCoeffA = filteriir.frequencyResponse(m_iFFTlength);
+
+            break;
+        }
     }
 
     switch(m_Type) {
@@ -334,6 +446,79 @@ RowVectorXd FilterData::applyFFTFilter(const RowVectorXd& data, bool keepOverhea
 }
 
 
+//*************************************************************************************************************
+
+MatrixXd FilterData::applyFFTFilter(const MatrixXd& data, bool keepOverhead, CompensateEdgeEffects compensateEdgeEffects) const
+{
+    #ifdef EIGEN_FFTW_DEFAULT
+        fftw_make_planner_thread_safe();
+    #endif
+
+    const int iNumTaps = m_dCoeffA.cols();
+
+    if(data.cols()<iNumTaps/2 && compensateEdgeEffects==MirrorData) {
+        qDebug()<<QString("Error in FilterData: Number of filter taps(%1) bigger then data size(%2). Not enough data to perform mirroring!").arg(iNumTaps).arg(data.cols());
+        return data;
+    }
+
+    if(iNumTaps >= m_iFFTlength || m_dFFTCoeffA.cols() != m_iFFTlength/2+1) {
+        qDebug()<<"Error in FilterData: Number of filter taps is bigger then fft length!";
+        return data;
+    }
+
+    const int iPad = compensateEdgeEffects == MirrorData ? iNumTaps/2 : 0;
+    const int iPaddedLength = data.cols() + 2 * iPad;
+
+    MatrixXd matDataOut(data.rows(), keepOverhead ? data.cols() + iNumTaps : data.cols());
+
+    if(data.rows() == 0) {
+        return matDataOut;
+    }
+
+    //Distribute the rows evenly over the workers and allocate their scratch memory once
+    int iNumWorkers = qMax(1, qMin(QThread::idealThreadCount(), int(data.rows())));
+    int iRowsPerWorker = data.rows() / iNumWorkers;
+    int iResidual = data.rows() % iNumWorkers;
+    int iFirstRow = 0;
+
+    QVector<FFTFilterWorker> workers(iNumWorkers);
+
+    for(int i = 0; i < iNumWorkers; ++i) {
+        FFTFilterWorker& worker = workers[i];
+        worker.fft.SetFlag(worker.fft.HalfSpectrum);
+        worker.vecPadded.resize(iPaddedLength);
+        worker.vecTime.resize(m_iFFTlength);
+        worker.vecFreq.resize(m_iFFTlength/2+1);
+        worker.vecConv.resize(iPaddedLength + m_iFFTlength);
+        worker.iFirstRow = iFirstRow;
+        worker.iNumRows = iRowsPerWorker + (i < iResidual ? 1 : 0);
+        worker.iPad = iPad;
+        worker.bKeepOverhead = keepOverhead;
+        worker.pFilter = this;
+        worker.pDataIn = &data;
+        worker.pDataOut = &matDataOut;
+
+        iFirstRow += worker.iNumRows;
+    }
+
+    if(workers.size() == 1) {
+        doFilterRowsFFT(workers[0]);
+    } else {
+        QtConcurrent::blockingMap(workers, doFilterRowsFFT);
+    }
+
+    return matDataOut;
+}
+
+
+//*************************************************************************************************************
+
+bool FilterData::isIIR() const
+{
+    return m_matSOS.rows() > 0;
+}
+
+
 //*************************************************************************************************************
 
 QString FilterData::getStringForDesignMethod(const FilterData::DesignMethod &designMethod)
@@ -349,6 +534,12 @@ QString FilterData::getStringForDesignMethod(const FilterData::DesignMethod &des
     if(designMethod == FilterData::Tschebyscheff)
         designMethodString = "Tschebyscheff";
 
+    if(designMethod == FilterData::IIRButterworth)
+        designMethodString = "IIRButterworth";
+
+    if(designMethod == FilterData::IIRChebyshev)
+        designMethodString = "IIRChebyshev";
+
     return designMethodString;
 }
 
@@ -390,6 +581,12 @@ FilterData::DesignMethod FilterData::getDesignMethodForString(const QString &des
     if(designMethodString == "Cosine")
         designMethod = FilterData::Cosine;
 
+    if(designMethodString == "IIRButterworth")
+        designMethod = FilterData::IIRButterworth;
+
+    if(designMethodString == "IIRChebyshev")
+        designMethod = FilterData::IIRChebyshev;
+
     return designMethod;
 }
 
@@ -100,7 +100,9 @@ public:
     enum DesignMethod {
         Tschebyscheff,
         Cosine,
-        External
+        External,
+        IIRButterworth,
+        IIRChebyshev
     } m_designMethod;
 
     enum FilterType {
@@ -126,13 +128,13 @@ public:
      * Constructs a FilterData object 
      * @param [in] unique_name defines the name of the generated filter
      * @param [in] type of the filter: LPF, HPF, BPF, NOTCH (from enum FilterType)
-     * @param [in] order represents the order of the filter, the higher the higher is the stopband attenuation
+     * @param [in] order represents the order of the filter, the higher the higher is the stopband attenuation. For IIR designs this is the order of the analog prototype.
      * @param [in] centerfreq determines the center of the frequency - normed to sFreq/2 (nyquist)
      * @param [in] bandwidth ignored if FilterType is set to LPF,HPF. if NOTCH/BPF: bandwidth of stop-/passband - normed to sFreq/2 (nyquist)
      * @param [in] parkswidth determines the width of the filter slopes (steepness) - normed to sFreq/2 (nyquist)
      * @param [in] sFreq sampling frequency
      * @param [in] fftlength length of the fft (multiple integer of 2^x)
-     * @param [in] designMethod specifies the design method to use. Choose between Cosind and Tschebyscheff
+     * @param [in] designMethod specifies the design method to use. Choose between Cosind and Tschebyscheff (FIR) or IIRButterworth and IIRChebyshev (IIR)
      **/
 
     FilterData(QString unique_name,
@@ -179,6 +181,30 @@ public:
                                CompensateEdgeEffects compensateEdgeEffects = MirrorData)
                                const;
 
+    /**
+     * Applies the current filter to all rows of the input data using multiplication in frequency domain. The FFT is
+     * planned once per call and the scratch buffers are reused for all channels. Data longer than the FFT length
+     * is filtered with overlap-add, so there is no restriction on the number of samples. The channels are distributed
+     * over the available threads.
+     * Without overhead the output is aligned to the input data, i.e. the filter delay of half the filter length and
+     * the length of the mirrored data in front are compensated.
+     *
+     * @param [in] data holds the data to be filtered (channels x samples)
+     * @param [in] keepOverhead whether the result should still include the overhead information in front and back of the data
+     * @param [in] compensateEdgeEffects defines how the edge effects should be handlted. Choose between ZeroPad and Mirroring
+     *
+     * @return the filtered data in form of a MatrixXd
+     */
+    MatrixXd applyFFTFilter(const MatrixXd& data,
+                            bool keepOverhead = false,
+                            CompensateEdgeEffects compensateEdgeEffects = MirrorData)
+                            const;
+
+    /**
+     * @brief isIIR returns whether this is an IIR filter, which needs to be applied with its second order sections m_matSOS
+     */
+    bool isIIR() const;
+
     /**
      * @brief getStringForDesignMethod returns the current design method as a string
      */
@@ -213,6 +239,7 @@ public:
 
     RowVectorXd     m_dCoeffA;          /**< contains the forward filter coefficient set. */
     RowVectorXd     m_dCoeffB;          /**< contains the backward filter coefficient set (empty if FIR filter). */
+    MatrixXd        m_matSOS;           /**< contains the second order sections of IIR filters, one per row: b0 b1 b2 a0 a1 a2 (empty if FIR filter). */
 
     RowVectorXcd    m_dFFTCoeffA;       /**< the FFT-transformed forward filter coefficient set, required for frequency-domain filtering, zero-padded to m_iFFTlength. */
     RowVectorXcd    m_dFFTCoeffB;       /**< the FFT-transformed backward filter coefficient set, required for frequency-domain filtering, zero-padded to m_iFFTlength. */
@@ -160,6 +160,10 @@ bool FilterIO::readFilter(QString path, FilterData &filter)
     //Compute fft of filtercoeeficients
     filter.fftTransformCoeffs();
 
+    //Filter files only store the (truncated) impulse response. Hence, loaded IIR filters are applied as FIR filters.
+    if(filter.m_designMethod == FilterData::IIRButterworth || filter.m_designMethod == FilterData::IIRChebyshev)
+        filter.m_designMethod = FilterData::External;
+
     file.close();
 
     return true;
@@ -0,0 +1,405 @@
+//=============================================================================================================
+/**
+ * @file     iirfilter.cpp
+ * @author   agent <agent@local>
+ * @version  dev
+ * @date     October, 2026
+ *
+ * @section  LICENSE
+ *
+ * Copyright (C) 2026, agent. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+ * the following conditions are met:
+ *     * Redistributions of source code must retain the above copyright notice, this list of conditions and the
+ *       following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+ *       the following disclaimer in the documentation and/or other materials provided with the distribution.
+ *     * Neither the name of MNE-CPP authors nor the names of its contributors may be used
+ *       to endorse or promote products derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+ * WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ * PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+ * INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ * NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ *
+ * @brief    Definition of the IIRFilter class
+ *
+ */
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// INCLUDES
+//=============================================================================================================
+
+#include "iirfilter.h"
+
+#define _USE_MATH_DEFINES
+#include <math.h>
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// STL INCLUDES
+//=============================================================================================================
+
+#include <complex>
+#include <vector>
+#include <algorithm>
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// Qt INCLUDES
+//=============================================================================================================
+
+#include <QDebug>
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// USED NAMESPACES
+//=============================================================================================================
+
+using namespace UTILSLIB;
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// DEFINE GLOBAL METHODS
+//=============================================================================================================
+
+namespace {
+
+typedef std::complex<double> Complex;
+
+//=============================================================================================================
+/**
+ * A pair of zeros or poles forming the numerator or denominator of one second order section.
+ */
+struct RootPair {
+    Complex     root;           /**< The representative root, used for pairing zeros with poles. */
+    double      c1;             /**< Coefficient of z^-1. */
+    double      c2;             /**< Coefficient of z^-2. */
+};
+
+//*************************************************************************************************************
+
+const double ROOT_TOLERANCE = 1e-10;
+
+//*************************************************************************************************************
+
+/**
+ * Groups roots into conjugate complex pairs and pairs of real roots. Real roots are sorted and the smallest is
+ * combined with the largest, which puts one zero at -1 and one at +1 into each band pass section.
+ */
+std::vector<RootPair> pairRoots(const std::vector<Complex>& roots)
+{
+    std::vector<RootPair> pairs;
+    std::vector<double> real;
+
+    for(size_t i = 0; i < roots.size(); ++i) {
+        if(std::abs(roots[i].imag()) <= ROOT_TOLERANCE) {
+            real.push_back(roots[i].real());
+        } else if(roots[i].imag() > 0) {
+            RootPair pair;
+            pair.root = roots[i];
+            pair.c1 = -2.0 * roots[i].real();
+            pair.c2 = std::norm(roots[i]);
+            pairs.push_back(pair);
+        }
+    }
+
+    std::sort(real.begin(), real.end());
+
+    //Pad with a root at zero so that all real roots can be paired
+    if(real.size() % 2 != 0) {
+        real.push_back(0.0);
+    }
+
+    for(size_t i = 0; i < real.size()/2; ++i) {
+        double r1 = real[i];
+        double r2 = real[real.size()-1-i];
+
+        RootPair pair;
+        pair.root = std::abs(r1) > std::abs(r2) ? Complex(r1, 0.0) : Complex(r2, 0.0);
+        pair.c1 = -(r1 + r2);
+        pair.c2 = r1 * r2;
+        pairs.push_back(pair);
+    }
+
+    return pairs;
+}
+
+//*************************************************************************************************************
+
+bool compareRootPairs(const RootPair& first, const RootPair& second)
+{
+    return std::abs(first.root) < std::abs(second.root);
+}
+
+} // namespace
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// DEFINE MEMBER METHODS
+//=============================================================================================================
+
+IIRFilter::IIRFilter()
+: m_iFilterOrder(0)
+{
+
+}
+
+
+//*************************************************************************************************************
+
+IIRFilter::IIRFilter(int order, double lowpass, double highpass, double sFreq, TPassType type, TDesignType designType, double ripple)
+: m_iFilterOrder(order)
+{
+    if(order < 1 || sFreq <= 0) {
+        qWarning() << "IIRFilter::IIRFilter - Invalid order or sampling frequency.";
+        return;
+    }
+
+    //Analog low pass prototype with cut off frequency 1 rad/s. The prototype has no finite zeros.
+    std::vector<Complex> poles;
+    std::vector<Complex> zeros;
+    double gain = 1.0;
+
+    switch(designType) {
+        case Chebyshev: {
+            double eps = std::sqrt(std::pow(10.0, ripple/10.0) - 1.0);
+            double mu = std::asinh(1.0/eps) / order;
+            Complex prod(1.0, 0.0);
+
+            for(int k = 0; k < order; ++k) {
+                double theta = M_PI * (2*k + 1) / (2.0 * order);
+                poles.push_back(Complex(-std::sinh(mu) * std::sin(theta), std::cosh(mu) * std::cos(theta)));
+                prod *= -poles.back();
+            }
+
+            gain = prod.real();
+
+            if(order % 2 == 0) {
+                gain /= std::sqrt(1.0 + eps * eps);
+            }
+
+            break;
+        }
+
+        default: {
+            for(int k = 0; k < order; ++k) {
+                double theta = M_PI * (2*k + 1) / (2.0 * order);
+                poles.push_back(Complex(-std::sin(theta), std::cos(theta)));
+            }
+
+            break;
+        }
+    }
+
+    //Prewarp the cut off frequencies for the bilinear transform
+    double fs2 = 2.0 * sFreq;
+    double wLow = fs2 * std::tan(M_PI * highpass / sFreq);
+    double wHigh = fs2 * std::tan(M_PI * lowpass / sFreq);
+
+    //Transform the prototype to the requested filter type
+    std::vector<Complex> polesAnalog;
+    Complex prodPoles(1.0, 0.0);
+
+    for(size_t i = 0; i < poles.size(); ++i) {
+        prodPoles *= -poles[i];
+    }
+
+    switch(type) {
+        case HPF: {
+            for(size_t i = 0; i < poles.size(); ++i) {
+                polesAnalog.push_back(wLow / poles[i]);
+                zeros.push_back(Complex(0.0, 0.0));
+            }
+
+            gain *= (1.0 / prodPoles).real();
+            break;
+        }
+
+        case BPF: {
+            double w0 = std::sqrt(wLow * wHigh);
+            double bw = wHigh - wLow;
+
+            for(size_t i = 0; i < poles.size(); ++i) {
+                Complex p = poles[i] * bw / 2.0;
+                Complex root = std::sqrt(p * p - w0 * w0);
+                polesAnalog.push_back(p + root);
+                polesAnalog.push_back(p - root);
+                zeros.push_back(Complex(0.0, 0.0));
+            }
+
+            gain *= std::pow(bw, int(poles.size()));
+            break;
+        }
+
+        case NOTCH: {
+            double w0 = std::sqrt(wLow * wHigh);
+            double bw = wHigh - wLow;
+
+            for(size_t i = 0; i < poles.size(); ++i) {
+                Complex p = (bw / 2.0) / poles[i];
+                Complex root = std::sqrt(p * p - w0 * w0);
+                polesAnalog.push_back(p + root);
+                polesAnalog.push_back(p - root);
+                zeros.push_back(Complex(0.0, w0));
+                zeros.push_back(Complex(0.0, -w0));
+            }
+
+            gain *= (1.0 / prodPoles).real();
+            break;
+        }
+
+        default: {
+            for(size_t i = 0; i < poles.size(); ++i) {
+                polesAnalog.push_back(wHigh * poles[i]);
+            }
+
+            gain *= std::pow(wHigh, int(poles.size()));
+            break;
+        }
+    }
+
+    //Bilinear transform. Zeros at infinity are mapped to z = -1.
+    std::vector<Complex> polesDigital;
+    std::vector<Complex> zerosDigital;
+    Complex prodGain(1.0, 0.0);
+
+    for(size_t i = 0; i < zeros.size(); ++i) {
+        zerosDigital.push_back((fs2 + zeros[i]) / (fs2 - zeros[i]));
+        prodGain *= fs2 - zeros[i];
+    }
+
+    for(size_t i = 0; i < polesAnalog.size(); ++i) {
+        polesDigital.push_back((fs2 + polesAnalog[i]) / (fs2 - polesAnalog[i]));
+        prodGain /= fs2 - polesAnalog[i];
+    }
+
+    while(zerosDigital.size() < polesDigital.size()) {
+        zerosDigital.push_back(Complex(-1.0, 0.0));
+    }
+
+    gain *= prodGain.real();
+
+    //Split into second order sections. Zeros are paired with the closest poles, starting with the poles closest to
+    //the unit circle. The sections are ordered with increasing pole radius.
+    std::vector<RootPair> polePairs = pairRoots(polesDigital);
+    std::vector<RootPair> zeroPairs = pairRoots(zerosDigital);
+    std::sort(polePairs.begin(), polePairs.end(), compareRootPairs);
+
+    m_matSOS = MatrixXd::Zero(polePairs.size(), 6);
+
+    for(int i = int(polePairs.size()) - 1; i >= 0; --i) {
+        size_t iClosest = 0;
+
+        for(size_t j = 1; j < zeroPairs.size(); ++j) {
+            if(std::abs(zeroPairs[j].root - polePairs[i].root) < std::abs(zeroPairs[iClosest].root - polePairs[i].root)) {
+                iClosest = j;
+            }
+        }
+
+        m_matSOS(i,0) = 1.0;
+        m_matSOS(i,3) = 1.0;
+        m_matSOS(i,4) = polePairs[i].c1;
+        m_matSOS(i,5) = polePairs[i].c2;
+
+        if(!zeroPairs.empty()) {
+            m_matSOS(i,1) = zeroPairs[iClosest].c1;
+            m_matSOS(i,2) = zeroPairs[iClosest].c2;
+            zeroPairs.erase(zeroPairs.begin() + iClosest);
+        }
+    }
+
+    if(m_matSOS.rows() > 0) {
+        m_matSOS.block(0,0,1,3) *= gain;
+    }
+}
+
+
+//*************************************************************************************************************
+
+RowVectorXcd IIRFilter::frequencyResponse(int fftLength) const
+{
+    RowVectorXcd vecResponse = RowVectorXcd::Ones(fftLength/2+1);
+
+    for(int k = 0; k < vecResponse.cols(); ++k) {
+        Complex z1 = std::polar(1.0, -2.0 * M_PI * k / fftLength);
+        Complex z2 = z1 * z1;
+
+        for(int s = 0; s < m_matSOS.rows(); ++s) {
+            vecResponse[k] *= (m_matSOS(s,0) + m_matSOS(s,1) * z1 + m_matSOS(s,2) * z2)
+                              / (m_matSOS(s,3) + m_matSOS(s,4) * z1 + m_matSOS(s,5) * z2);
+        }
+    }
+
+    return vecResponse;
+}
+
+
+//*************************************************************************************************************
+
+RowVectorXd IIRFilter::impulseResponse(int length) const
+{
+    MatrixXd matData = MatrixXd::Zero(1, length);
+    MatrixXd matState;
+
+    if(length > 0) {
+        matData(0,0) = 1.0;
+    }
+
+    filterSOS(m_matSOS, matData, matState);
+
+    return matData.row(0);
+}
+
+
+//*************************************************************************************************************
+
+void IIRFilter::filterSOS(const MatrixXd& matSOS,
+                          MatrixXd& matData,
+                          MatrixXd& matState)
+{
+    const int iNumChannels = matData.rows();
+    const int iNumSamples = matData.cols();
+
+    if(matState.rows() != iNumChannels || matState.cols() != 2 * matSOS.rows()) {
+        matState = MatrixXd::Zero(iNumChannels, 2 * matSOS.rows());
+    }
+
+    for(int s = 0; s < matSOS.rows(); ++s) {
+        const double a0 = matSOS(s,3);
+        const double b0 = matSOS(s,0) / a0;
+        const double b1 = matSOS(s,1) / a0;
+        const double b2 = matSOS(s,2) / a0;
+        const double a1 = matSOS(s,4) / a0;
+        const double a2 = matSOS(s,5) / a0;
+
+        double* pState1 = matState.col(2*s).data();
+        double* pState2 = matState.col(2*s+1).data();
+
+        //The samples of all channels are contiguous in memory. The inner loop has no dependencies between channels.
+        for(int t = 0; t < iNumSamples; ++t) {
+            double* pData = matData.col(t).data();
+
+            for(int c = 0; c < iNumChannels; ++c) {
+                const double x = pData[c];
+                const double y = b0 * x + pState1[c];
+                pState1[c] = b1 * x - a1 * y + pState2[c];
+                pState2[c] = b2 * x - a2 * y;
+                pData[c] = y;
+            }
+        }
+    }
+}
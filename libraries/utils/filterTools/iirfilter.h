@@ -0,0 +1,149 @@
+//=============================================================================================================
+/**
+ * @file     iirfilter.h
+ * @author   agent <agent@local>
+ * @version  dev
+ * @date     October, 2026
+ *
+ * @section  LICENSE
+ *
+ * Copyright (C) 2026, agent. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+ * the following conditions are met:
+ *     * Redistributions of source code must retain the above copyright notice, this list of conditions and the
+ *       following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+ *       the following disclaimer in the documentation and/or other materials provided with the distribution.
+ *     * Neither the name of MNE-CPP authors nor the names of its contributors may be used
+ *       to endorse or promote products derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+ * WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ * PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+ * INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ * NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ *
+ * @brief    Declaration of the IIRFilter class
+ *
+ */
+
+#ifndef IIRFILTER_H
+#define IIRFILTER_H
+
+//*************************************************************************************************************
+//=============================================================================================================
+// INCLUDES
+//=============================================================================================================
+
+#include "../utils_global.h"
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// Eigen INCLUDES
+//=============================================================================================================
+
+#include <Eigen/Core>
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// DEFINE NAMESPACE UTILSLIB
+//=============================================================================================================
+
+namespace UTILSLIB
+{
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// USED NAMESPACES
+//=============================================================================================================
+
+using namespace Eigen;
+
+
+//=============================================================================================================
+/**
+ * Designs Butterworth and Chebyshev (type I) IIR filters as cascade of second order sections (biquads) and applies
+ * them to multichannel data. The analog prototype is transformed to the requested filter type, mapped to the z-plane
+ * via the bilinear transform with prewarped cut off frequencies and finally split into second order sections.
+ *
+ * @brief Creates IIR filters as second order sections.
+ */
+class UTILSSHARED_EXPORT IIRFilter
+{
+public:
+    enum TPassType {LPF, HPF, BPF, NOTCH };
+
+    enum TDesignType {Butterworth, Chebyshev };
+
+    //=========================================================================================================
+    /**
+     * Constructs an IIRFilter object.
+     *
+     */
+    IIRFilter();
+
+    //=========================================================================================================
+    /**
+     * Constructs an IIRFilter object.
+     *
+     * @param order the order of the analog prototype. Band pass and notch filters have twice the order.
+     * @param lowpass the upper cut off frequency in Hz (LPF, BPF, NOTCH)
+     * @param highpass the lower cut off frequency in Hz (HPF, BPF, NOTCH)
+     * @param sFreq sampling frequency
+     * @param type filter type (lowpass, highpass, etc.)
+     * @param designType the design of the analog prototype (Butterworth, Chebyshev)
+     * @param ripple the pass band ripple in dB, only used for Chebyshev designs.
+     */
+    IIRFilter(int order, double lowpass, double highpass, double sFreq, TPassType type, TDesignType designType = Butterworth, double ripple = 1.0);
+
+    //=========================================================================================================
+    /**
+     * Evaluates the frequency response of the filter at the frequencies of a real valued FFT.
+     *
+     * @param [in] fftLength    length of the fft (multiple integer of 2^x)
+     *
+     * @return The complex frequency response of length fftLength/2+1.
+     */
+    RowVectorXcd frequencyResponse(int fftLength) const;
+
+    //=========================================================================================================
+    /**
+     * Computes the (truncated) impulse response of the filter.
+     *
+     * @param [in] length    number of samples to compute
+     *
+     * @return The impulse response.
+     */
+    RowVectorXd impulseResponse(int length) const;
+
+    //=========================================================================================================
+    /**
+     * Filters all rows of the data in place with a cascade of second order sections in direct form II transposed.
+     * All channels are processed together per sample, which allows the compiler to vectorize over the channels. The
+     * state is kept in matState between calls so that consecutive blocks are filtered without discontinuities. The
+     * state is reset to zero if its dimensions do not match the data and sections.
+     *
+     * @param [in] matSOS           the second order sections, one per row: b0 b1 b2 a0 a1 a2 (a0 = 1)
+     * @param [in, out] matData     the data to filter (channels x samples)
+     * @param [in, out] matState    the filter state (channels x 2*sections)
+     */
+    static void filterSOS(const MatrixXd& matSOS,
+                          MatrixXd& matData,
+                          MatrixXd& matState);
+
+    MatrixXd        m_matSOS;           /**< the second order sections, one per row: b0 b1 b2 a0 a1 a2 (a0 = 1) */
+
+    int             m_iFilterOrder;     /**< the order of the analog prototype */
+};
+
+} // NAMESPACE UTILSLIB
+
+#endif // IIRFILTER_H
@@ -0,0 +1,264 @@
+//=============================================================================================================
+/**
+ * @file     streamingfilter.cpp
+ * @author   agent <agent@local>
+ * @version  dev
+ * @date     October, 2026
+ *
+ * @section  LICENSE
+ *
+ * Copyright (C) 2026, agent. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+ * the following conditions are met:
+ *     * Redistributions of source code must retain the above copyright notice, this list of conditions and the
+ *       following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+ *       the following disclaimer in the documentation and/or other materials provided with the distribution.
+ *     * Neither the name of MNE-CPP authors nor the names of its contributors may be used
+ *       to endorse or promote products derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+ * WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ * PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+ * INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ * NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ *
+ * @brief    Definition of the StreamingFilter class
+ *
+ */
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// INCLUDES
+//=============================================================================================================
+
+#include "streamingfilter.h"
+#include "iirfilter.h"
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// Qt INCLUDES
+//=============================================================================================================
+
+#include <QDebug>
+#include <QThread>
+#include <QtConcurrent>
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// USED NAMESPACES
+//=============================================================================================================
+
+using namespace UTILSLIB;
+using namespace Eigen;
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// DEFINE MEMBER METHODS
+//=============================================================================================================
+
+StreamingFilter::StreamingFilter()
+: m_bPrepared(false)
+, m_iFftLength(0)
+, m_iFilterLength(0)
+{
+}
+
+
+//*************************************************************************************************************
+
+bool StreamingFilter::prepareFilter(const QList<FilterData>& lFilterData,
+                                    const RowVectorXi& vecPicks)
+{
+    m_bPrepared = false;
+    m_vecWorkspaces.clear();
+    m_iFftLength = 0;
+    m_iFilterLength = 0;
+    m_matSOS.resize(0,6);
+
+    if(lFilterData.isEmpty()) {
+        qWarning() << "StreamingFilter::prepareFilter - No filters provided.";
+        return false;
+    }
+
+    //IIR filters are cascaded by concatenating their second order sections. The spectra of the FIR filters are
+    //combined, since filters in cascade multiply in the frequency domain.
+    int iFftLength = 0;
+    int iFilterLength = 0;
+
+    for(int i = 0; i < lFilterData.size(); ++i) {
+        const FilterData& filter = lFilterData.at(i);
+
+        if(filter.isIIR()) {
+            m_matSOS.conservativeResize(m_matSOS.rows() + filter.m_matSOS.rows(), 6);
+            m_matSOS.bottomRows(filter.m_matSOS.rows()) = filter.m_matSOS;
+            continue;
+        }
+
+        if(iFftLength == 0) {
+            iFftLength = filter.m_iFFTlength;
+            m_vecSpectrum = VectorXcd::Ones(iFftLength/2+1);
+        }
+
+        if(filter.m_iFFTlength != iFftLength || filter.m_dFFTCoeffA.cols() != iFftLength/2+1) {
+            qWarning() << "StreamingFilter::prepareFilter - All filters need to be designed with the same FFT length.";
+            return false;
+        }
+
+        m_vecSpectrum.array() *= filter.m_dFFTCoeffA.transpose().array();
+        iFilterLength += filter.m_dCoeffA.cols();
+    }
+
+    if(iFftLength > 0 && iFilterLength >= iFftLength) {
+        qWarning() << "StreamingFilter::prepareFilter - Filter length is larger than the FFT length.";
+        return false;
+    }
+
+    m_iFftLength = iFftLength;
+    m_iFilterLength = iFilterLength;
+    m_vecPicks = vecPicks;
+    m_matOverlap = MatrixXd::Zero(vecPicks.cols(), iFilterLength);
+    m_matSOSState = MatrixXd::Zero(vecPicks.cols(), 2 * m_matSOS.rows());
+
+    //Split the channels evenly between the workers and preallocate their scratch memory
+    if(iFftLength > 0) {
+        int iNumWorkspaces = qMax(1, qMin(QThread::idealThreadCount(), int(vecPicks.cols())));
+        int iPicksPerWorkspace = vecPicks.cols() / iNumWorkspaces;
+        int iResidual = vecPicks.cols() % iNumWorkspaces;
+        int iFirstPick = 0;
+
+        m_vecWorkspaces.resize(iNumWorkspaces);
+
+        for(int i = 0; i < iNumWorkspaces; ++i) {
+            FilterWorkspace& workspace = m_vecWorkspaces[i];
+            workspace.fft.SetFlag(workspace.fft.HalfSpectrum);
+            workspace.vecTime = VectorXd::Zero(iFftLength);
+            workspace.vecFreq = VectorXcd::Zero(iFftLength/2+1);
+            workspace.iFirstPick = iFirstPick;
+            workspace.iNumPicks = iPicksPerWorkspace + (i < iResidual ? 1 : 0);
+            workspace.pFilter = this;
+            workspace.pDataIn = Q_NULLPTR;
+            workspace.pDataOut = Q_NULLPTR;
+
+            iFirstPick += workspace.iNumPicks;
+        }
+    }
+
+    m_bPrepared = true;
+
+    return true;
+}
+
+
+//*************************************************************************************************************
+
+bool StreamingFilter::filterDataBlock(const MatrixXd& matDataIn,
+                                      MatrixXd& matDataOut)
+{
+    if(!m_bPrepared) {
+        qWarning() << "StreamingFilter::filterDataBlock - Streaming filter was not prepared. Call prepareFilter first.";
+        return false;
+    }
+
+    if(m_vecPicks.size() > 0 && m_vecPicks.maxCoeff() >= matDataIn.rows()) {
+        qWarning() << "StreamingFilter::filterDataBlock - Picks exceed the number of channels.";
+        return false;
+    }
+
+    //Channels which are not picked are passed through unchanged. This only allocates if the dimensions changed.
+    matDataOut = matDataIn;
+
+    if(m_vecPicks.size() == 0) {
+        return true;
+    }
+
+    //FIR filters via overlap add
+    if(!m_vecWorkspaces.isEmpty()) {
+        for(int i = 0; i < m_vecWorkspaces.size(); ++i) {
+            m_vecWorkspaces[i].pDataIn = &matDataIn;
+            m_vecWorkspaces[i].pDataOut = &matDataOut;
+        }
+
+        if(m_vecWorkspaces.size() == 1) {
+            filterChannels(m_vecWorkspaces[0]);
+        } else {
+            QtConcurrent::blockingMap(m_vecWorkspaces, filterChannels);
+        }
+    }
+
+    //IIR filters via second order sections. The picked channels are gathered so that all channels of one sample are
+    //contiguous in memory.
+    if(m_matSOS.rows() > 0) {
+        if(m_matSOSData.rows() != m_vecPicks.cols() || m_matSOSData.cols() != matDataOut.cols()) {
+            m_matSOSData.resize(m_vecPicks.cols(), matDataOut.cols());
+        }
+
+        for(int i = 0; i < m_vecPicks.cols(); ++i) {
+            m_matSOSData.row(i) = matDataOut.row(m_vecPicks[i]);
+        }
+
+        IIRFilter::filterSOS(m_matSOS, m_matSOSData, m_matSOSState);
+
+        for(int i = 0; i < m_vecPicks.cols(); ++i) {
+            matDataOut.row(m_vecPicks[i]) = m_matSOSData.row(i);
+        }
+    }
+
+    return true;
+}
+
+
+//*************************************************************************************************************
+
+void StreamingFilter::resetFilter()
+{
+    m_matOverlap.setZero();
+    m_matSOSState.setZero();
+}
+
+
+//*************************************************************************************************************
+
+void StreamingFilter::filterChannels(FilterWorkspace& workspace)
+{
+    StreamingFilter* pFilter = workspace.pFilter;
+    const MatrixXd& matDataIn = *workspace.pDataIn;
+    MatrixXd& matDataOut = *workspace.pDataOut;
+
+    const int iFftLength = pFilter->m_iFftLength;
+    const int iFilterLength = pFilter->m_iFilterLength;
+
+    //The linear convolution of a step and the filter needs to fit into the FFT length to avoid circular convolution
+    const int iStepSize = iFftLength - iFilterLength;
+
+    for(int p = workspace.iFirstPick; p < workspace.iFirstPick + workspace.iNumPicks; ++p) {
+        const int iChannel = pFilter->m_vecPicks[p];
+
+        for(int from = 0; from < matDataIn.cols(); from += iStepSize) {
+            const int iNumSamples = qMin(iStepSize, int(matDataIn.cols()) - from);
+
+            //Zero pad the data step
+            workspace.vecTime.head(iNumSamples) = matDataIn.row(iChannel).segment(from, iNumSamples).transpose();
+            workspace.vecTime.tail(iFftLength - iNumSamples).setZero();
+
+            //Filter in the frequency domain
+            workspace.fft.fwd(workspace.vecFreq.data(), workspace.vecTime.data(), iFftLength);
+            workspace.vecFreq.array() *= pFilter->m_vecSpectrum.array();
+            workspace.fft.inv(workspace.vecTime.data(), workspace.vecFreq.data(), iFftLength);
+
+            //Overlap add: add the tail of the previous steps and keep the tail of this one for the next step
+            workspace.vecTime.head(iFilterLength) += pFilter->m_matOverlap.row(p).transpose();
+            matDataOut.row(iChannel).segment(from, iNumSamples) = workspace.vecTime.head(iNumSamples).transpose();
+            pFilter->m_matOverlap.row(p) = workspace.vecTime.segment(iNumSamples, iFilterLength).transpose();
+        }
+    }
+}
@@ -0,0 +1,198 @@
+//=============================================================================================================
+/**
+ * @file     streamingfilter.h
+ * @author   agent <agent@local>
+ * @version  dev
+ * @date     October, 2026
+ *
+ * @section  LICENSE
+ *
+ * Copyright (C) 2026, agent. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+ * the following conditions are met:
+ *     * Redistributions of source code must retain the above copyright notice, this list of conditions and the
+ *       following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+ *       the following disclaimer in the documentation and/or other materials provided with the distribution.
+ *     * Neither the name of MNE-CPP authors nor the names of its contributors may be used
+ *       to endorse or promote products derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+ * WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ * PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+ * INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ * NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ *
+ * @brief    Declaration of the StreamingFilter class
+ *
+ */
+
+#ifndef STREAMINGFILTER_H
+#define STREAMINGFILTER_H
+
+//*************************************************************************************************************
+//=============================================================================================================
+// INCLUDES
+//=============================================================================================================
+
+#include "../utils_global.h"
+#include "filterdata.h"
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// QT INCLUDES
+//=============================================================================================================
+
+#include <QList>
+#include <QVector>
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// Eigen INCLUDES
+//=============================================================================================================
+
+#include <Eigen/Core>
+#include <unsupported/Eigen/FFT>
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// DEFINE NAMESPACE UTILSLIB
+//=============================================================================================================
+
+namespace UTILSLIB
+{
+
+
+//=============================================================================================================
+/**
+ * Applies a cascade of FIR and IIR filters to consecutive data blocks. FIR filters are applied via FFT overlap-add,
+ * IIR filters via their second order sections. The overlap and IIR state of every channel is kept between blocks.
+ *
+ * @brief Streaming multichannel filter.
+ */
+class UTILSSHARED_EXPORT StreamingFilter
+{
+public:
+    //=========================================================================================================
+    /**
+     * Constructs a StreamingFilter object.
+     */
+    StreamingFilter();
+
+    //=========================================================================================================
+    /**
+     * Prepares the streaming filter for the given filters and channels. The spectra of FIR filters are combined into
+     * one spectrum, the second order sections of IIR filters are cascaded. All per-channel state and scratch memory
+     * is preallocated, so that subsequent calls to filterDataBlock do not allocate. All FIR filters must share the
+     * same FFT length. The state of the streaming filter is reset.
+     *
+     * @param [in] lFilterData   The filters to apply (in cascade).
+     * @param [in] vecPicks      The channels to filter as index in RowVector.
+     *
+     * @return true if succeeded, false otherwise.
+     */
+    bool prepareFilter(const QList<FilterData> &lFilterData,
+                       const Eigen::RowVectorXi& vecPicks);
+
+    //=========================================================================================================
+    /**
+     * Filters a data block. All picked channels are filtered with one FFT overlap-add pass per block and the cascade
+     * of second order sections. FIR filtered channels are delayed by half the filter length, channels which are not
+     * picked are copied unchanged. Blocks longer than the FFT length minus the filter length are processed in
+     * several steps.
+     *
+     * @param [in] matDataIn     The data block which is to be filtered.
+     * @param [out] matDataOut   The filtered data block. Only resized if its dimensions do not match the input.
+     *
+     * @return true if succeeded, false otherwise.
+     */
+    bool filterDataBlock(const Eigen::MatrixXd& matDataIn,
+                         Eigen::MatrixXd& matDataOut);
+
+    //=========================================================================================================
+    /**
+     * Resets the per-channel state of the streaming filter.
+     */
+    void resetFilter();
+
+    //=========================================================================================================
+    /**
+     * Returns whether the streaming filter was prepared.
+     *
+     * @return true if prepareFilter succeeded, false otherwise.
+     */
+    bool isPrepared() const;
+
+    //=========================================================================================================
+    /**
+     * Returns the channels filtered by the streaming filter.
+     *
+     * @return The picks as index in RowVector.
+     */
+    const Eigen::RowVectorXi& getPicks() const;
+
+private:
+    //=========================================================================================================
+    /**
+     * Scratch memory and channel range of one worker of the streaming filter.
+     */
+    struct FilterWorkspace {
+        Eigen::FFT<double>              fft;                /**< The FFT object, keeps its plans between blocks. */
+        Eigen::VectorXd                 vecTime;            /**< Time domain scratch buffer of FFT length. */
+        Eigen::VectorXcd                vecFreq;            /**< Frequency domain scratch buffer of half FFT length + 1. */
+        int                             iFirstPick;         /**< First pick (index into the picks) handled by this worker. */
+        int                             iNumPicks;          /**< Number of picks handled by this worker. */
+        StreamingFilter*                pFilter;            /**< The filter this workspace belongs to. */
+        const Eigen::MatrixXd*          pDataIn;            /**< The current input block. */
+        Eigen::MatrixXd*                pDataOut;           /**< The current output block. */
+    };
+
+    //=========================================================================================================
+    /**
+     * Filters the channels of one workspace. Called concurrently for all workspaces.
+     *
+     * @param [in, out] workspace    The workspace to process.
+     */
+    static void filterChannels(FilterWorkspace& workspace);
+
+    bool                            m_bPrepared;            /**< Whether the streaming filter was prepared. */
+    Eigen::RowVectorXi              m_vecPicks;             /**< The channels filtered by the streaming filter. */
+    Eigen::VectorXcd                m_vecSpectrum;          /**< The combined half spectrum of all FIR filters. */
+    Eigen::MatrixXd                 m_matOverlap;           /**< The overlap state (picks x filter length). */
+    QVector<FilterWorkspace>        m_vecWorkspaces;        /**< The preallocated workspaces, one per worker. */
+    int                             m_iFftLength;           /**< The FFT length of the streaming filter. */
+    int                             m_iFilterLength;        /**< The length of the combined FIR filter. */
+    Eigen::MatrixXd                 m_matSOS;               /**< The cascaded second order sections of all IIR filters. */
+    Eigen::MatrixXd                 m_matSOSState;          /**< The IIR filter state (picks x 2*sections). */
+    Eigen::MatrixXd                 m_matSOSData;           /**< The gathered picked channels for the IIR filtering. */
+};
+
+//*************************************************************************************************************
+//=============================================================================================================
+// INLINE DEFINITIONS
+//=============================================================================================================
+
+inline bool StreamingFilter::isPrepared() const
+{
+    return m_bPrepared;
+}
+
+
+//*************************************************************************************************************
+
+inline const Eigen::RowVectorXi& StreamingFilter::getPicks() const
+{
+    return m_vecPicks;
+}
+
+} // NAMESPACE UTILSLIB
+
+#endif // STREAMINGFILTER_H
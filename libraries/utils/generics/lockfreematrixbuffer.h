@@ -0,0 +1,493 @@
+//=============================================================================================================
+/**
+ * @file     lockfreematrixbuffer.h
+ * @author   agent <agent@local>
+ * @version  dev
+ * @date     October, 2026
+ *
+ * @section  LICENSE
+ *
+ * Copyright (C) 2026, agent. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+ * the following conditions are met:
+ *     * Redistributions of source code must retain the above copyright notice, this list of conditions and the
+ *       following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+ *       the following disclaimer in the documentation and/or other materials provided with the distribution.
+ *     * Neither the name of MNE-CPP authors nor the names of its contributors may be used
+ *       to endorse or promote products derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+ * WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ * PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+ * INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ * NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ *
+ * @brief    LockFreeMatrixBuffer class declaration
+ *
+ */
+
+#ifndef LOCKFREEMATRIXBUFFER_H
+#define LOCKFREEMATRIXBUFFER_H
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// INCLUDES
+//=============================================================================================================
+
+#include "../utils_global.h"
+#include "buffer.h"
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// STL INCLUDES
+//=============================================================================================================
+
+#include <typeinfo>
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// Eigen INCLUDES
+//=============================================================================================================
+
+#include <Eigen/Core>
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// Qt INCLUDES
+//=============================================================================================================
+
+#include <QAtomicInt>
+#include <QElapsedTimer>
+#include <QMutex>
+#include <QMutexLocker>
+#include <QSharedPointer>
+#include <QVector>
+#include <QWaitCondition>
+#include <stdio.h>
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// DEFINE NAMESPACE IOBUFFER
+//=============================================================================================================
+
+namespace IOBUFFER
+{
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// USED NAMESPACES
+//=============================================================================================================
+
+using namespace Eigen;
+
+
+//=============================================================================================================
+/**
+ * Lock-free single producer/single consumer ring of preallocated matrices. In contrast to CircularMatrixBuffer
+ * no memory is allocated and no semaphore is touched when handing over a matrix: the producer fills a slot in place
+ * (acquireWrite/commitWrite) and the consumer reads it in place (acquireRead/release). Only one thread may write
+ * and only one thread may read at a time.
+ *
+ * If the ring is full or empty the acquire functions can block. The waiting side sleeps on a wait condition which
+ * is only touched when somebody is actually waiting. push() and pop() are provided as copying, blocking fallbacks.
+ *
+ * @brief The lock-free single producer/single consumer matrix buffer
+ */
+template<typename _Tp>
+class LockFreeMatrixBuffer : public Buffer
+{
+public:
+    typedef QSharedPointer<LockFreeMatrixBuffer> SPtr;              /**< Shared pointer type for LockFreeMatrixBuffer. */
+    typedef QSharedPointer<const LockFreeMatrixBuffer> ConstSPtr;   /**< Const shared pointer type for LockFreeMatrixBuffer. */
+
+    typedef Matrix<_Tp, Dynamic, Dynamic> MatrixType;               /**< The type of the stored matrices. */
+
+    //=========================================================================================================
+    /**
+     * Constructs a LockFreeMatrixBuffer and preallocates all slots.
+     *
+     * @param [in] uiMaxNumMatrices  Number of slots.
+     * @param [in] uiRows            Number of rows.
+     * @param [in] uiCols            Number of columns.
+     */
+    explicit LockFreeMatrixBuffer(unsigned int uiMaxNumMatrices, unsigned int uiRows, unsigned int uiCols);
+
+    //=========================================================================================================
+    /**
+     * Returns the next free slot to be filled in place by the producer. The slot must not be resized. Call
+     * commitWrite() to hand it over to the consumer.
+     *
+     * @param [in] iTimeoutMs    Time to wait for a free slot. 0 returns immediately, a negative value waits until
+     *                           a slot is free or releaseFromWait() is called.
+     *
+     * @return the slot to write to, NULL if no slot is free.
+     */
+    inline MatrixType* acquireWrite(int iTimeoutMs = 0);
+
+    //=========================================================================================================
+    /**
+     * Hands the slot returned by acquireWrite() over to the consumer.
+     */
+    inline void commitWrite();
+
+    //=========================================================================================================
+    /**
+     * Returns the oldest filled slot to be read in place by the consumer. Call release() once done with it.
+     *
+     * @param [in] iTimeoutMs    Time to wait for a filled slot. 0 returns immediately, a negative value waits until
+     *                           a slot is filled or releaseFromWait() is called.
+     *
+     * @return the slot to read from, NULL if no slot is filled.
+     */
+    inline const MatrixType* acquireRead(int iTimeoutMs = 0);
+
+    //=========================================================================================================
+    /**
+     * Hands the slot returned by acquireRead() back to the producer.
+     */
+    inline void release();
+
+    //=========================================================================================================
+    /**
+     * Copies a matrix into the next free slot. Blocking fallback of acquireWrite()/commitWrite().
+     *
+     * @param [in] matrix        The matrix to append. Must have the dimensions of the buffer.
+     * @param [in] iTimeoutMs    Time to wait for a free slot, a negative value waits until a slot is free.
+     *
+     * @return true if the matrix was appended, false otherwise.
+     */
+    inline bool push(const MatrixType& matrix, int iTimeoutMs = -1);
+
+    //=========================================================================================================
+    /**
+     * Copies the oldest matrix into a caller provided matrix. Blocking fallback of acquireRead()/release(). No
+     * memory is allocated if the matrix already has the dimensions of the buffer.
+     *
+     * @param [out] matrix       The popped matrix.
+     * @param [in] iTimeoutMs    Time to wait for a filled slot, a negative value waits until a slot is filled.
+     *
+     * @return true if a matrix was popped, false otherwise.
+     */
+    inline bool pop(MatrixType& matrix, int iTimeoutMs = -1);
+
+    //=========================================================================================================
+    /**
+     * Releases all threads which are waiting in one of the acquire, push or pop functions. Until clear() is called
+     * they return immediately if they would have to wait.
+     */
+    inline void releaseFromWait();
+
+    //=========================================================================================================
+    /**
+     * Clears the buffer and resets releaseFromWait(). Must only be called while neither producer nor consumer
+     * access the buffer.
+     */
+    void clear();
+
+    //=========================================================================================================
+    /**
+     * Number of slots of the buffer.
+     */
+    inline quint32 size() const;
+
+    //=========================================================================================================
+    /**
+     * Number of filled slots which are ready to be read.
+     */
+    inline quint32 count() const;
+
+    //=========================================================================================================
+    /**
+     * Rows of the stored matrices of the buffer.
+     */
+    inline quint32 rows() const;
+
+    //=========================================================================================================
+    /**
+     * Cols of the stored matrices of the buffer.
+     */
+    inline quint32 cols() const;
+
+private:
+    //=========================================================================================================
+    /**
+     * Waits until a slot is free (producer) or filled (consumer).
+     *
+     * @param [in] bForWrite     Whether to wait for a free slot, otherwise waits for a filled slot.
+     * @param [in] iTimeoutMs    Time to wait, a negative value waits until releaseFromWait() is called.
+     *
+     * @return true if a slot is available, false otherwise.
+     */
+    bool waitForSlot(bool bForWrite, int iTimeoutMs);
+
+    //=========================================================================================================
+    /**
+     * Wakes up a thread which waits in waitForSlot.
+     */
+    inline void wakeWaiting();
+
+    unsigned int            m_uiMaxNumMatrices;     /**< Holds the number of slots.*/
+    unsigned int            m_uiRows;               /**< Holds the number rows.*/
+    unsigned int            m_uiCols;               /**< Holds the number cols.*/
+    QVector<MatrixType>     m_vecSlots;             /**< Holds the preallocated slots.*/
+    QAtomicInt              m_iWriteIndex;          /**< Holds the write position in [0, 2*size), only changed by the producer.*/
+    QAtomicInt              m_iReadIndex;           /**< Holds the read position in [0, 2*size), only changed by the consumer.*/
+    QAtomicInt              m_iWaiting;             /**< Holds the number of threads which are waiting for a slot.*/
+    QAtomicInt              m_iReleased;            /**< Holds whether waiting threads were released.*/
+    QMutex                  m_mutex;                /**< Holds the mutex of the wait condition.*/
+    QWaitCondition          m_waitCondition;        /**< Holds the wait condition for the blocking fallback.*/
+};
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// DEFINE MEMBER METHODS
+//=============================================================================================================
+
+template<typename _Tp>
+LockFreeMatrixBuffer<_Tp>::LockFreeMatrixBuffer(unsigned int uiMaxNumMatrices, unsigned int uiRows, unsigned int uiCols)
+: Buffer(typeid(_Tp).name())
+, m_uiMaxNumMatrices(qMax(uiMaxNumMatrices, 1u))
+, m_uiRows(uiRows)
+, m_uiCols(uiCols)
+, m_vecSlots(m_uiMaxNumMatrices, MatrixType(MatrixType::Zero(uiRows, uiCols)))
+, m_iWriteIndex(0)
+, m_iReadIndex(0)
+, m_iWaiting(0)
+, m_iReleased(0)
+{
+}
+
+
+//*************************************************************************************************************
+
+template<typename _Tp>
+inline typename LockFreeMatrixBuffer<_Tp>::MatrixType* LockFreeMatrixBuffer<_Tp>::acquireWrite(int iTimeoutMs)
+{
+    if(count() >= m_uiMaxNumMatrices && !waitForSlot(true, iTimeoutMs)) {
+        return NULL;
+    }
+
+    return &m_vecSlots[m_iWriteIndex.loadAcquire() % m_uiMaxNumMatrices];
+}
+
+
+//*************************************************************************************************************
+
+template<typename _Tp>
+inline void LockFreeMatrixBuffer<_Tp>::commitWrite()
+{
+    m_iWriteIndex.fetchAndStoreOrdered((m_iWriteIndex.loadAcquire() + 1) % (2 * m_uiMaxNumMatrices));
+    wakeWaiting();
+}
+
+
+//*************************************************************************************************************
+
+template<typename _Tp>
+inline const typename LockFreeMatrixBuffer<_Tp>::MatrixType* LockFreeMatrixBuffer<_Tp>::acquireRead(int iTimeoutMs)
+{
+    if(count() == 0 && !waitForSlot(false, iTimeoutMs)) {
+        return NULL;
+    }
+
+    return &m_vecSlots[m_iReadIndex.loadAcquire() % m_uiMaxNumMatrices];
+}
+
+
+//*************************************************************************************************************
+
+template<typename _Tp>
+inline void LockFreeMatrixBuffer<_Tp>::release()
+{
+    m_iReadIndex.fetchAndStoreOrdered((m_iReadIndex.loadAcquire() + 1) % (2 * m_uiMaxNumMatrices));
+    wakeWaiting();
+}
+
+
+//*************************************************************************************************************
+
+template<typename _Tp>
+inline bool LockFreeMatrixBuffer<_Tp>::push(const MatrixType& matrix, int iTimeoutMs)
+{
+    if(matrix.rows() != static_cast<int>(m_uiRows) || matrix.cols() != static_cast<int>(m_uiCols)) {
+        printf("Error: Matrix not appended to LockFreeMatrixBuffer - wrong dimensions\n");
+        return false;
+    }
+
+    MatrixType* pSlot = acquireWrite(iTimeoutMs);
+
+    if(!pSlot) {
+        return false;
+    }
+
+    pSlot->noalias() = matrix;
+    commitWrite();
+
+    return true;
+}
+
+
+//*************************************************************************************************************
+
+template<typename _Tp>
+inline bool LockFreeMatrixBuffer<_Tp>::pop(MatrixType& matrix, int iTimeoutMs)
+{
+    const MatrixType* pSlot = acquireRead(iTimeoutMs);
+
+    if(!pSlot) {
+        return false;
+    }
+
+    matrix = *pSlot;
+    release();
+
+    return true;
+}
+
+
+//*************************************************************************************************************
+
+template<typename _Tp>
+inline void LockFreeMatrixBuffer<_Tp>::releaseFromWait()
+{
+    m_iReleased.storeRelease(1);
+
+    QMutexLocker locker(&m_mutex);
+    m_waitCondition.wakeAll();
+}
+
+
+//*************************************************************************************************************
+
+template<typename _Tp>
+void LockFreeMatrixBuffer<_Tp>::clear()
+{
+    m_iWriteIndex.storeRelease(0);
+    m_iReadIndex.storeRelease(0);
+    m_iReleased.storeRelease(0);
+}
+
+
+//*************************************************************************************************************
+
+template<typename _Tp>
+inline quint32 LockFreeMatrixBuffer<_Tp>::size() const
+{
+    return m_uiMaxNumMatrices;
+}
+
+
+//*************************************************************************************************************
+
+template<typename _Tp>
+inline quint32 LockFreeMatrixBuffer<_Tp>::count() const
+{
+    int iUsed = m_iWriteIndex.loadAcquire() - m_iReadIndex.loadAcquire();
+
+    if(iUsed < 0) {
+        iUsed += 2 * m_uiMaxNumMatrices;
+    }
+
+    return static_cast<quint32>(iUsed);
+}
+
+
+//*************************************************************************************************************
+
+template<typename _Tp>
+inline quint32 LockFreeMatrixBuffer<_Tp>::rows() const
+{
+    return m_uiRows;
+}
+
+
+//*************************************************************************************************************
+
+template<typename _Tp>
+inline quint32 LockFreeMatrixBuffer<_Tp>::cols() const
+{
+    return m_uiCols;
+}
+
+
+//*************************************************************************************************************
+
+template<typename _Tp>
+bool LockFreeMatrixBuffer<_Tp>::waitForSlot(bool bForWrite, int iTimeoutMs)
+{
+    if(iTimeoutMs == 0) {
+        return false;
+    }
+
+    QElapsedTimer timer;
+    timer.start();
+
+    //Announce the waiting thread before checking the indices again, so that a commit in between wakes us up
+    m_iWaiting.ref();
+
+    QMutexLocker locker(&m_mutex);
+
+    bool bAvailable = bForWrite ? count() < m_uiMaxNumMatrices : count() > 0;
+
+    while(!bAvailable && !m_iReleased.loadAcquire()) {
+        //Wake up regularly in any case, this keeps the fallback robust against missed notifications
+        unsigned long ulWait = 10;
+
+        if(iTimeoutMs > 0) {
+            qint64 iRemaining = iTimeoutMs - timer.elapsed();
+
+            if(iRemaining <= 0) {
+                break;
+            }
+
+            ulWait = static_cast<unsigned long>(qMin(iRemaining, static_cast<qint64>(ulWait)));
+        }
+
+        m_waitCondition.wait(&m_mutex, ulWait);
+
+        bAvailable = bForWrite ? count() < m_uiMaxNumMatrices : count() > 0;
+    }
+
+    m_iWaiting.deref();
+
+    return bAvailable;
+}
+
+
+//*************************************************************************************************************
+
+template<typename _Tp>
+inline void LockFreeMatrixBuffer<_Tp>::wakeWaiting()
+{
+    //Only touch the mutex if somebody is actually waiting
+    if(m_iWaiting.fetchAndAddOrdered(0) > 0) {
+        QMutexLocker locker(&m_mutex);
+        m_waitCondition.wakeAll();
+    }
+}
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// TYPEDEF
+//=============================================================================================================
+
+typedef LockFreeMatrixBuffer<float>     _float_LockFreeMatrixBuffer;    /**< Defines LockFreeMatrixBuffer of float type.*/
+typedef LockFreeMatrixBuffer<double>    _double_LockFreeMatrixBuffer;   /**< Defines LockFreeMatrixBuffer of double type.*/
+
+} // NAMESPACE
+
+#endif // LOCKFREEMATRIXBUFFER_H
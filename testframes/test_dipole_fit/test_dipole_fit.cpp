@@ -41,6 +41,7 @@
 
 #include <inverse/dipoleFit/dipole_fit_settings.h>
 #include <inverse/dipoleFit/dipole_fit.h>
+#include <mne/mne_bem.h>
 
 
 //*************************************************************************************************************
@@ -49,6 +50,7 @@
 //=============================================================================================================
 
 #include <QtTest>
+#include <QTemporaryDir>
 
 
 //*************************************************************************************************************
@@ -57,6 +59,8 @@
 //=============================================================================================================
 
 using namespace INVERSELIB;
+using namespace MNELIB;
+using namespace FIFFLIB;
 
 
 //=============================================================================================================
@@ -77,10 +81,14 @@ private slots:
     void initTestCase();
     void dipoleFitSimple();
     void dipoleFitAdvanced();
+    void dipoleFitGuessCache();
+    void dipoleFitThreads();
     void cleanupTestCase();
 
 private:
     void compareFit();
+    ECDSet fitWithGuessCache(const QString& bemname, const QString& cachedir);
+    ECDSet fitWithThreads(bool bBem, int nthreads);
 
     double epsilon;
 
@@ -277,6 +285,164 @@ void TestDipoleFit::dipoleFitAdvanced()
 }
 
 
+//*************************************************************************************************************
+
+ECDSet TestDipoleFit::fitWithGuessCache(const QString& bemname, const QString& cachedir)
+{
+    DipoleFitSettings settings;
+
+    settings.measname = QCoreApplication::applicationDirPath() + "/mne-cpp-test-data/MEG/sample/sample_audvis-ave.fif";
+    settings.is_raw = false;
+    settings.setno = 1;
+    settings.include_meg = true;
+    settings.include_eeg = false;
+    settings.tmin = 0.15f;
+    settings.tmax = 0.17f;
+    settings.tstep = 0.01f;
+    settings.bemname = bemname;
+    settings.bmin = 1000000.0f;
+    settings.bmax = 1000000.0f;
+    settings.guess_mindist = 0.0f;
+    settings.guess_rad = 0.1f;
+    settings.mriname = QCoreApplication::applicationDirPath() + "/mne-cpp-test-data/MEG/sample/all-trans.fif";
+    settings.noisename = QCoreApplication::applicationDirPath() + "/mne-cpp-test-data/MEG/sample/sample_audvis-cov.fif";
+    settings.guess_cachedir = cachedir;
+
+    settings.checkIntegrity();
+
+    DipoleFit dipFit(&settings);
+    return dipFit.calculateFit();
+}
+
+
+//*************************************************************************************************************
+
+void TestDipoleFit::dipoleFitGuessCache()
+{
+    QTemporaryDir tempDir;
+    QVERIFY(tempDir.isValid());
+
+    QString sBemName = tempDir.filePath("sample-5120-bem.fif");
+    QString sCacheDir = tempDir.filePath("guesscache");
+    QVERIFY(QFile::copy(QCoreApplication::applicationDirPath() + "/mne-cpp-test-data/subjects/sample/bem/sample-5120-bem.fif", sBemName));
+
+    //*********************************************************************************************************
+    // Miss: the guess fields are computed and stored
+    //*********************************************************************************************************
+
+    ECDSet setMiss = fitWithGuessCache(sBemName, sCacheDir);
+
+    QFileInfoList lCacheFiles = QDir(sCacheDir).entryInfoList(QDir::Files);
+    QCOMPARE(lCacheFiles.size(), 1);
+    QDateTime cacheTime = lCacheFiles.first().lastModified();
+
+    //*********************************************************************************************************
+    // Hit: the stored fields are reused and give the same fit
+    //*********************************************************************************************************
+
+    ECDSet setHit = fitWithGuessCache(sBemName, sCacheDir);
+
+    lCacheFiles = QDir(sCacheDir).entryInfoList(QDir::Files);
+    QCOMPARE(lCacheFiles.size(), 1);
+    QCOMPARE(lCacheFiles.first().lastModified(), cacheTime);
+
+    QCOMPARE(setHit.size(), setMiss.size());
+    for (int i = 0; i < setMiss.size(); ++i) {
+        QVERIFY( setHit[i].rd == setMiss[i].rd );
+        QVERIFY( setHit[i].Q == setMiss[i].Q );
+        QVERIFY( setHit[i].good == setMiss[i].good );
+    }
+
+    //*********************************************************************************************************
+    // Invalidation: a BEM regenerated at the same path gets its own cache entry
+    //*********************************************************************************************************
+
+    QFile bemFile(sBemName);
+    MNEBem bem(bemFile);
+    QVERIFY(bem.size() > 0);
+    bem[0].sigma *= 2.0f;
+
+    QVERIFY(QFile::remove(sBemName));
+    QFile bemOutFile(sBemName);
+    FiffStream::SPtr t_pStream = FiffStream::start_file(bemOutFile);
+    bem.writeToStream(t_pStream.data());
+    t_pStream->end_file();
+    bemOutFile.close();
+
+    fitWithGuessCache(sBemName, sCacheDir);
+
+    QCOMPARE(QDir(sCacheDir).entryInfoList(QDir::Files).size(), 2);
+}
+
+
+//*************************************************************************************************************
+
+ECDSet TestDipoleFit::fitWithThreads(bool bBem, int nthreads)
+{
+    DipoleFitSettings settings;
+
+    settings.measname = QCoreApplication::applicationDirPath() + "/mne-cpp-test-data/MEG/sample/sample_audvis-ave.fif";
+    settings.is_raw = false;
+    settings.setno = 1;
+    settings.include_meg = true;
+    settings.nthreads = nthreads;
+
+    if (bBem) {
+        // BEM with compensation data, noise covariance and projection
+        settings.include_eeg = false;
+        settings.tmin = 0.15f;
+        settings.tmax = 0.25f;
+        settings.tstep = 0.01f;
+        settings.bemname = QCoreApplication::applicationDirPath() + "/mne-cpp-test-data/subjects/sample/bem/sample-5120-bem.fif";
+        settings.bmin = 1000000.0f;
+        settings.bmax = 1000000.0f;
+        settings.guess_mindist = 0.0f;
+        settings.guess_rad = 0.1f;
+        settings.mriname = QCoreApplication::applicationDirPath() + "/mne-cpp-test-data/MEG/sample/all-trans.fif";
+        settings.noisename = QCoreApplication::applicationDirPath() + "/mne-cpp-test-data/MEG/sample/sample_audvis-cov.fif";
+        settings.projnames.append(settings.measname);
+    } else {
+        // Sphere models for MEG and EEG
+        settings.include_eeg = true;
+        settings.tmin = 32.0f/1000.0f;
+        settings.tmax = 148.0f/1000.0f;
+        settings.bmin = -100.0f/1000.0f;
+        settings.bmax = 0.0f/1000.0f;
+    }
+
+    settings.checkIntegrity();
+
+    DipoleFit dipFit(&settings);
+    return dipFit.calculateFit();
+}
+
+
+//*************************************************************************************************************
+
+void TestDipoleFit::dipoleFitThreads()
+{
+    // The worker threads share the setup, the fits need to be identical to the sequential ones
+    for (int b = 0; b < 2; ++b) {
+        ECDSet setSequential = fitWithThreads(b == 1, 1);
+        ECDSet setThreaded = fitWithThreads(b == 1, 4);
+
+        QVERIFY( setSequential.size() > 4 );
+        QCOMPARE(setThreaded.size(), setSequential.size());
+
+        for (int i = 0; i < setSequential.size(); ++i) {
+            QVERIFY( setThreaded[i].valid == setSequential[i].valid );
+            QVERIFY( setThreaded[i].time == setSequential[i].time );
+            QVERIFY( setThreaded[i].rd == setSequential[i].rd );
+            QVERIFY( setThreaded[i].Q == setSequential[i].Q );
+            QVERIFY( setThreaded[i].good == setSequential[i].good );
+            QVERIFY( setThreaded[i].khi2 == setSequential[i].khi2 );
+            QVERIFY( setThreaded[i].nfree == setSequential[i].nfree );
+            QVERIFY( setThreaded[i].neval == setSequential[i].neval );
+        }
+    }
+}
+
+
 //*************************************************************************************************************
 
 void TestDipoleFit::compareFit()
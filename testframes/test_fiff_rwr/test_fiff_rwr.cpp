@@ -79,6 +79,9 @@ private slots:
     void compareData();
     void compareTimes();
     void compareInfo();
+    void compareMemoryMapped();
+    void compareOperatorCache();
+    void compareBlockReader();
     void cleanupTestCase();
 
 private:
@@ -320,6 +323,215 @@ void TestFiffRWR::compareInfo()
     }
 }
 
+//*************************************************************************************************************
+
+void TestFiffRWR::compareMemoryMapped()
+{
+    // Reading straight from the memory mapped file needs to give the same data as reading the tags
+    QFile t_fileIn(QCoreApplication::applicationDirPath() + "/mne-cpp-test-data/MEG/sample/sample_audvis_trunc_raw.fif");
+    QFile t_fileInMapped(QCoreApplication::applicationDirPath() + "/mne-cpp-test-data/MEG/sample/sample_audvis_trunc_raw.fif");
+
+    FiffRawData raw(t_fileIn);
+    FiffRawData rawMapped(t_fileInMapped);
+    rawMapped.setMemoryMapped(true);
+
+    QVERIFY(!raw.isMemoryMapped());
+    QVERIFY(rawMapped.isMemoryMapped());
+
+    QStringList include;
+    include << "STI 014";
+    RowVectorXi picks = raw.info.pick_types(true, false, false, include, raw.info.bads);
+
+    MatrixXd data, dataMapped, times, timesMapped;
+
+    // Whole file, segments which start and end inside of buffers and a channel selection
+    QList<QPair<fiff_int_t,fiff_int_t> > lSegments;
+    lSegments << qMakePair(raw.first_samp, raw.last_samp)
+              << qMakePair(raw.first_samp + 17, raw.first_samp + 17 + 3001)
+              << qMakePair(raw.first_samp + 2000, raw.first_samp + 2000 + 599);
+
+    for(int i = 0; i < lSegments.size(); ++i) {
+        for(int j = 0; j < 2; ++j) {
+            RowVectorXi sel = j == 0 ? RowVectorXi() : picks;
+
+            QVERIFY(raw.read_raw_segment(data, times, lSegments.at(i).first, lSegments.at(i).second, sel));
+            QVERIFY(rawMapped.read_raw_segment(dataMapped, timesMapped, lSegments.at(i).first, lSegments.at(i).second, sel));
+
+            QCOMPARE(dataMapped.rows(), data.rows());
+            QCOMPARE(dataMapped.cols(), data.cols());
+            QVERIFY( (dataMapped - data).cwiseAbs().maxCoeff() <= 1e-12 * data.cwiseAbs().maxCoeff() );
+            QVERIFY( (timesMapped - times).cwiseAbs().maxCoeff() < epsilon );
+        }
+    }
+}
+
+
+//*************************************************************************************************************
+
+void TestFiffRWR::compareOperatorCache()
+{
+    // The cached operators need to give the same data as applying projector, compensator and selection directly,
+    // and need to be recomputed whenever one of them changes
+    QFile t_fileIn(QCoreApplication::applicationDirPath() + "/mne-cpp-test-data/MEG/sample/sample_audvis_trunc_raw.fif");
+    FiffRawData raw(t_fileIn);
+
+    fiff_int_t from = raw.first_samp + 100;
+    fiff_int_t to = raw.first_samp + 1100;
+    qint32 nchan = raw.info.nchan;
+
+    // Calibrated data without projector and compensator
+    raw.proj = MatrixXd();
+    raw.comp = FiffCtfComp();
+
+    MatrixXd dataCal, data, times;
+    QVERIFY(raw.read_raw_segment(dataCal, times, from, to));
+
+    // Two different projectors which remove one random direction each
+    std::srand(3);
+    VectorXd vecDir1 = VectorXd::Random(nchan).normalized();
+    VectorXd vecDir2 = VectorXd::Random(nchan).normalized();
+    MatrixXd matProj1 = MatrixXd::Identity(nchan, nchan) - vecDir1 * vecDir1.transpose();
+    MatrixXd matProj2 = MatrixXd::Identity(nchan, nchan) - vecDir2 * vecDir2.transpose();
+
+    MatrixXd matComp = MatrixXd::Identity(nchan, nchan) + 0.01 * MatrixXd::Random(nchan, nchan);
+
+    QStringList include;
+    include << "STI 014";
+    RowVectorXi sel = raw.info.pick_types(true, false, false, include, raw.info.bads);
+
+    MatrixXd dataRef;
+
+    // Projector, read twice to use the cache the second time
+    raw.proj = matProj1;
+    dataRef = matProj1 * dataCal;
+
+    for(int i = 0; i < 2; ++i) {
+        QVERIFY(raw.read_raw_segment(data, times, from, to));
+        QVERIFY( (data - dataRef).cwiseAbs().maxCoeff() < epsilon * dataRef.cwiseAbs().maxCoeff() );
+    }
+
+    // Changed projector
+    raw.proj = matProj2;
+    dataRef = matProj2 * dataCal;
+
+    QVERIFY(raw.read_raw_segment(data, times, from, to));
+    QVERIFY( (data - dataRef).cwiseAbs().maxCoeff() < epsilon * dataRef.cwiseAbs().maxCoeff() );
+
+    // Changed selection
+    MatrixXd dataSelRef(sel.size(), dataRef.cols());
+    for(int i = 0; i < sel.size(); ++i) {
+        dataSelRef.row(i) = dataRef.row(sel[i]);
+    }
+
+    QVERIFY(raw.read_raw_segment(data, times, from, to, sel));
+    QVERIFY( (data - dataSelRef).cwiseAbs().maxCoeff() < epsilon * dataSelRef.cwiseAbs().maxCoeff() );
+
+    // Added compensator and changed compensator data
+    raw.comp.kind = 101;
+    raw.comp.data = FiffNamedMatrix::SDPtr(new FiffNamedMatrix());
+
+    for(int j = 0; j < 2; ++j) {
+        raw.comp.data->data = j == 0 ? matComp : MatrixXd(matComp.transpose());
+        dataRef = matProj2 * raw.comp.data->data * dataCal;
+
+        QVERIFY(raw.read_raw_segment(data, times, from, to));
+        QVERIFY( (data - dataRef).cwiseAbs().maxCoeff() < epsilon * dataRef.cwiseAbs().maxCoeff() );
+    }
+
+    // A copy shares the cache but has its own projector
+    FiffRawData rawCopy(raw);
+    rawCopy.proj = matProj1;
+    rawCopy.comp = FiffCtfComp();
+
+    QVERIFY(rawCopy.read_raw_segment(data, times, from, to));
+    dataRef = matProj1 * dataCal;
+    QVERIFY( (data - dataRef).cwiseAbs().maxCoeff() < epsilon * dataRef.cwiseAbs().maxCoeff() );
+
+    QVERIFY(raw.read_raw_segment(data, times, from, to));
+    dataRef = matProj2 * raw.comp.data->data * dataCal;
+    QVERIFY( (data - dataRef).cwiseAbs().maxCoeff() < epsilon * dataRef.cwiseAbs().maxCoeff() );
+
+    // Back to calibration only
+    raw.proj = MatrixXd();
+    raw.comp = FiffCtfComp();
+
+    QVERIFY(raw.read_raw_segment(data, times, from, to));
+    QVERIFY( (data - dataCal).cwiseAbs().maxCoeff() < epsilon * dataCal.cwiseAbs().maxCoeff() );
+}
+
+
+//*************************************************************************************************************
+
+void TestFiffRWR::compareBlockReader()
+{
+    // The blocks of the block reader need to give the same data as reading the segments directly, also for blocks
+    // which are shorter than a buffer and share it with their neighbours and after seeking back and forth.
+    // The reader gets its own file, since the file must not be read by others while the reader is active.
+    QFile t_fileIn(QCoreApplication::applicationDirPath() + "/mne-cpp-test-data/MEG/sample/sample_audvis_trunc_raw.fif");
+    QFile t_fileInReader(QCoreApplication::applicationDirPath() + "/mne-cpp-test-data/MEG/sample/sample_audvis_trunc_raw.fif");
+
+    FiffRawData raw(t_fileIn);
+    FiffRawData rawReader(t_fileInReader);
+
+    QStringList include;
+    include << "STI 014";
+    RowVectorXi picks = raw.info.pick_types(true, false, false, include, raw.info.bads);
+
+    fiff_int_t iBlockSize = 97;
+    MatrixXd data, times, dataRef, timesRef;
+
+    for(int j = 0; j < 2; ++j) {
+        RowVectorXi sel = j == 0 ? RowVectorXi() : picks;
+
+        FiffRawBlockReader reader(rawReader, iBlockSize, sel);
+
+        // Iterate over the whole recording
+        fiff_int_t from = raw.first_samp;
+        int iBlocks = 0;
+
+        while(reader.hasNext()) {
+            fiff_int_t to = qMin(from + iBlockSize - 1, raw.last_samp);
+
+            QVERIFY(reader.next(data, times));
+            QVERIFY(raw.read_raw_segment(dataRef, timesRef, from, to, sel));
+
+            QCOMPARE(data.rows(), dataRef.rows());
+            QCOMPARE(data.cols(), dataRef.cols());
+            QVERIFY( (data - dataRef).cwiseAbs().maxCoeff() <= 1e-12 * dataRef.cwiseAbs().maxCoeff() );
+            QVERIFY( (times - timesRef).cwiseAbs().maxCoeff() < epsilon );
+
+            from = to + 1;
+            ++iBlocks;
+        }
+
+        QCOMPARE(from, raw.last_samp + 1);
+        QCOMPARE(iBlocks, (raw.last_samp - raw.first_samp + iBlockSize) / iBlockSize);
+
+        // Seek back, forward and back again
+        QList<fiff_int_t> lSeeks;
+        lSeeks << raw.first_samp + 1234 << raw.first_samp + 17 << raw.last_samp - 2 * iBlockSize + 5 << raw.first_samp + 600;
+
+        for(int i = 0; i < lSeeks.size(); ++i) {
+            reader.seek(lSeeks.at(i));
+            from = lSeeks.at(i);
+
+            for(int k = 0; k < 3 && reader.hasNext(); ++k) {
+                fiff_int_t to = qMin(from + iBlockSize - 1, raw.last_samp);
+
+                QVERIFY(reader.next(data, times));
+                QVERIFY(raw.read_raw_segment(dataRef, timesRef, from, to, sel));
+
+                QCOMPARE(data.cols(), dataRef.cols());
+                QVERIFY( (data - dataRef).cwiseAbs().maxCoeff() <= 1e-12 * dataRef.cwiseAbs().maxCoeff() );
+                QVERIFY( (times - timesRef).cwiseAbs().maxCoeff() < epsilon );
+
+                from = to + 1;
+            }
+        }
+    }
+}
+
+
 //*************************************************************************************************************
 
 void TestFiffRWR::cleanupTestCase()
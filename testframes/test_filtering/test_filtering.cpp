@@ -84,6 +84,9 @@ private slots:
     void initTestCase();
     void compareData();
     void compareTimes();
+    void compareStreaming();
+    void compareMultichannel();
+    void compareIIR();
     void cleanupTestCase();
 
 private:
@@ -99,6 +102,9 @@ private:
     MatrixXd ref_filtered;
 
     MatrixXi picks;
+
+    RowVectorXi stream_picks;
+    double sFreq;
 };
 
 //*************************************************************************************************************
@@ -139,6 +145,7 @@ void TestFiffRFR::initTestCase()
 
     // Only filter MEG channels
     RowVectorXi picks = first_in_raw.info.pick_types(true, true, false);
+    stream_picks = picks;
     RowVectorXd cals;
     FiffStream::SPtr outfid = FiffStream::start_writing_raw(t_fileOut, first_in_raw.info, cals);
 
@@ -151,7 +158,7 @@ void TestFiffRFR::initTestCase()
     // initialize filter settings
     QString filter_name = "example_cosine";
     FilterData::FilterType type = FilterData::BPF;
-    double sFreq = first_in_raw.info.sfreq;
+    sFreq = first_in_raw.info.sfreq;
     double dCenterfreq = 10;
     double dBandwidth = 10;
     double dTransition = 1;
@@ -226,6 +233,155 @@ void TestFiffRFR::compareTimes()
 
 }
 
+//*************************************************************************************************************
+
+void TestFiffRFR::compareStreaming()
+{
+    // Filter the whole data at once and in irregular blocks with the streaming filter. Both need to match.
+    RtFilter rtFilter;
+    MatrixXd dataFiltered = rtFilter.filterData(first_in_data, FilterData::BPF, 10, 10, 1, sFreq, stream_picks);
+
+    QList<FilterData> filterList;
+    filterList << FilterData("rt_filter",
+                             FilterData::BPF,
+                             order,
+                             10/(sFreq/2.0),
+                             10/(sFreq/2.0),
+                             1/(sFreq/2.0),
+                             sFreq,
+                             4096,
+                             FilterData::Cosine);
+
+    RtFilter rtFilterStreaming;
+    QVERIFY(rtFilterStreaming.prepareFilter(filterList, stream_picks));
+
+    MatrixXd dataStreamed(first_in_data.rows(), first_in_data.cols());
+    MatrixXd block;
+    int blockSizes[] = {100, 1000, 7, 5000};
+    int from = 0;
+
+    for(int i = 0; from < first_in_data.cols(); ++i) {
+        int size = qMin(blockSizes[i % 4], int(first_in_data.cols()) - from);
+        QVERIFY(rtFilterStreaming.filterDataBlock(first_in_data.middleCols(from, size), block));
+        dataStreamed.middleCols(from, size) = block;
+        from += size;
+    }
+
+    QVERIFY( (dataStreamed - dataFiltered).cwiseAbs().maxCoeff() < epsilon * dataFiltered.cwiseAbs().maxCoeff() );
+
+    // filterData keeps the filter state between calls with unchanged settings
+    RtFilter rtFilterBlocks;
+    MatrixXd dataBlocks(first_in_data.rows(), first_in_data.cols());
+    from = 0;
+
+    for(int i = 0; from < first_in_data.cols(); ++i) {
+        int size = qMin(blockSizes[i % 4], int(first_in_data.cols()) - from);
+        dataBlocks.middleCols(from, size) = rtFilterBlocks.filterData(first_in_data.middleCols(from, size), FilterData::BPF, 10, 10, 1, sFreq, stream_picks);
+        from += size;
+    }
+
+    QVERIFY( (dataBlocks - dataFiltered).cwiseAbs().maxCoeff() < epsilon * dataFiltered.cwiseAbs().maxCoeff() );
+}
+
+//*************************************************************************************************************
+
+void TestFiffRFR::compareMultichannel()
+{
+    // The matrix version needs to match the channel wise version for data which fits into one FFT
+    FilterData filter("rt_filter",
+                      FilterData::BPF,
+                      order,
+                      10/(sFreq/2.0),
+                      10/(sFreq/2.0),
+                      1/(sFreq/2.0),
+                      sFreq,
+                      4096,
+                      FilterData::Cosine);
+
+    MatrixXd data = first_in_data.leftCols(4096-order);
+
+    MatrixXd dataFiltered = filter.applyFFTFilter(data, false, FilterData::ZeroPad);
+    MatrixXd dataFilteredOverhead = filter.applyFFTFilter(data, true, FilterData::ZeroPad);
+
+    // The channel types differ by orders of magnitude (MEG around 1e-12), hence the error is relative to each row
+    for(int i = 0; i < data.rows(); ++i) {
+        RowVectorXd row = data.row(i);
+        RowVectorXd rowFiltered = filter.applyFFTFilter(row, false, FilterData::ZeroPad);
+        RowVectorXd rowFilteredOverhead = filter.applyFFTFilter(row, true, FilterData::ZeroPad);
+
+        QVERIFY( (dataFiltered.row(i) - rowFiltered).cwiseAbs().maxCoeff() <= epsilon * rowFiltered.cwiseAbs().maxCoeff() );
+        QVERIFY( (dataFilteredOverhead.row(i) - rowFilteredOverhead).cwiseAbs().maxCoeff() <= epsilon * rowFilteredOverhead.cwiseAbs().maxCoeff() );
+    }
+
+    // Data longer than the FFT length is filtered with overlap add and needs to match the streaming filter
+    RtFilter rtFilter;
+    MatrixXd dataStreamed = rtFilter.filterData(first_in_data, FilterData::BPF, 10, 10, 1, sFreq, stream_picks);
+    MatrixXd dataOverhead = filter.applyFFTFilter(first_in_data, true, FilterData::ZeroPad);
+
+    for(int i = 0; i < stream_picks.cols(); ++i) {
+        RowVectorXd rowOverhead = dataOverhead.row(stream_picks[i]).head(first_in_data.cols());
+        QVERIFY( (dataStreamed.row(stream_picks[i]) - rowOverhead).cwiseAbs().maxCoeff() <= epsilon * rowOverhead.cwiseAbs().maxCoeff() );
+    }
+}
+
+//*************************************************************************************************************
+
+void TestFiffRFR::compareIIR()
+{
+    // Streaming a Butterworth high pass in blocks needs to match filtering all data at once
+    RtFilter rtFilter;
+    MatrixXd dataFiltered = rtFilter.filterData(first_in_data, FilterData::HPF, 1, 0, 0, sFreq, stream_picks, 4, 4096, FilterData::IIRButterworth);
+
+    QList<FilterData> filterList;
+    filterList << FilterData("rt_filter",
+                             FilterData::HPF,
+                             4,
+                             1/(sFreq/2.0),
+                             0,
+                             0,
+                             sFreq,
+                             4096,
+                             FilterData::IIRButterworth);
+
+    QVERIFY(filterList.first().isIIR());
+
+    RtFilter rtFilterStreaming;
+    QVERIFY(rtFilterStreaming.prepareFilter(filterList, stream_picks));
+
+    MatrixXd dataStreamed(first_in_data.rows(), first_in_data.cols());
+    MatrixXd block;
+    int blockSizes[] = {100, 1, 333, 5000};
+    int from = 0;
+
+    for(int i = 0; from < first_in_data.cols(); ++i) {
+        int size = qMin(blockSizes[i % 4], int(first_in_data.cols()) - from);
+        QVERIFY(rtFilterStreaming.filterDataBlock(first_in_data.middleCols(from, size), block));
+        dataStreamed.middleCols(from, size) = block;
+        from += size;
+    }
+
+    // MEG data is in the order of 1e-12, so the tolerance needs to be relative to the data
+    QVERIFY( (dataStreamed - dataFiltered).cwiseAbs().maxCoeff() < epsilon * dataFiltered.cwiseAbs().maxCoeff() );
+
+    // The high pass removes the offset of the filtered channels. Add an offset which dominates the raw row mean, so
+    // that the remaining mean can be compared against it independently of the channel's own offset.
+    MatrixXd dataOffset = first_in_data;
+
+    for(int i = 0; i < stream_picks.cols(); ++i) {
+        dataOffset.row(stream_picks[i]).array() += 100.0 * first_in_data.row(stream_picks[i]).cwiseAbs().maxCoeff();
+    }
+
+    RtFilter rtFilterOffset;
+    MatrixXd dataOffsetFiltered = rtFilterOffset.filterData(dataOffset, FilterData::HPF, 1, 0, 0, sFreq, stream_picks, 4, 4096, FilterData::IIRButterworth);
+
+    for(int i = 0; i < stream_picks.cols(); ++i) {
+        double dRawMean = dataOffset.row(stream_picks[i]).mean();
+        QVERIFY( std::abs(dataOffsetFiltered.row(stream_picks[i]).tail(1000).mean()) < 0.01 * std::abs(dRawMean) );
+    }
+}
+
+//*************************************************************************************************************
+
 void TestFiffRFR::cleanupTestCase()
 {
 }
@@ -47,6 +47,7 @@
 //=============================================================================================================
 
 #include <disp3D/helpers/geometryinfo/geometryinfo.h>
+#include <disp3D/helpers/geometryinfo/vertexkdtree.h>
 #include <mne/mne_bem.h>
 #include <mne/mne_bem_surface.h>
 
@@ -85,6 +86,8 @@ private slots:
     void testEmptyInputsForProjecting();
     void testEmptyInputsForSCDC();
     void testDimensionsForSCDC();
+    void testSparseSCDC();
+    void testVertexKdTree();
     void cleanupTestCase();
 
 private:
@@ -208,6 +211,57 @@ void TestGeometryInfo::testDimensionsForSCDC() {
 }
 
 
+//*************************************************************************************************************
+
+void TestGeometryInfo::testSparseSCDC() {
+    const double dCancelDist = 0.5;
+    QSharedPointer<MatrixXd> distTable = GeometryInfo::scdc(smallSurface.rr, smallSurface.neighbor_vert, smallSubset, dCancelDist);
+    QSharedPointer<SparseMatrix<double, RowMajor> > sparseDistTable = GeometryInfo::scdcSparse(smallSurface.rr, smallSurface.neighbor_vert, smallSubset, dCancelDist);
+
+    QVERIFY(sparseDistTable->rows() == distTable->rows());
+    QVERIFY(sparseDistTable->cols() == distTable->cols());
+
+    // every distance within the cancel distance has to be stored with the same value, all others have to be missing
+    qint64 iBelowCount = 0;
+    for (qint32 row = 0; row < distTable->rows(); ++row) {
+        for (qint32 col = 0; col < distTable->cols(); ++col) {
+            if (distTable->coeff(row, col) <= dCancelDist) {
+                iBelowCount++;
+                QVERIFY(qAbs(sparseDistTable->coeff(row, col) - distTable->coeff(row, col)) < 1e-9);
+            }
+        }
+    }
+    QVERIFY(sparseDistTable->nonZeros() == iBelowCount);
+}
+
+
+//*************************************************************************************************************
+
+void TestGeometryInfo::testVertexKdTree() {
+    VertexKdTree emptyTree;
+    QVERIFY(emptyTree.nearestNeighbor(Vector3f::Zero()) == -1);
+
+    VertexKdTree vertexTree(realSurface.rr);
+    QVERIFY(vertexTree.size() == realSurface.rr.rows());
+
+    // compare against a linear search for random positions around the surface
+    for (int i = 0; i < 100; ++i) {
+        Vector3f vecPosition = Vector3f::Random() * 0.1f;
+
+        float fTreeDist = 0.0f;
+        qint32 iTreeId = vertexTree.nearestNeighbor(vecPosition, &fTreeDist);
+
+        float fLinDist = std::numeric_limits<float>::max();
+        for (qint32 row = 0; row < realSurface.rr.rows(); ++row) {
+            fLinDist = qMin(fLinDist, (realSurface.rr.row(row).transpose() - vecPosition).squaredNorm());
+        }
+
+        QVERIFY(iTreeId >= 0 && iTreeId < realSurface.rr.rows());
+        QVERIFY(fTreeDist == fLinDist);
+    }
+}
+
+
 //*************************************************************************************************************
 
 void TestGeometryInfo::cleanupTestCase() {
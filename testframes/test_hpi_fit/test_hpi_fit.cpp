@@ -0,0 +1,508 @@
+//=============================================================================================================
+/**
+ * @file     test_hpi_fit.cpp
+ * @author   agent <agent@local>
+ * @version  dev
+ * @date     October, 2026
+ *
+ * @section  LICENSE
+ *
+ * Copyright (C) 2026, agent. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+ * the following conditions are met:
+ *     * Redistributions of source code must retain the above copyright notice, this list of conditions and the
+ *       following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+ *       the following disclaimer in the documentation and/or other materials provided with the distribution.
+ *     * Neither the name of MNE-CPP authors nor the names of its contributors may be used
+ *       to endorse or promote products derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+ * WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ * PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+ * INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ * NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ *
+ * @brief    The HPI fit unit test
+ *
+ */
+
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// INCLUDES
+//=============================================================================================================
+
+#include <fiff/fiff.h>
+#include <fiff/fiff_dig_point_set.h>
+#include <inverse/hpiFit/hpifit.h>
+#include <inverse/hpiFit/hpifitdata.h>
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// QT INCLUDES
+//=============================================================================================================
+
+#include <QtTest>
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// USED NAMESPACES
+//=============================================================================================================
+
+using namespace FIFFLIB;
+using namespace INVERSELIB;
+using namespace Eigen;
+
+
+//=============================================================================================================
+/**
+ * Gives access to the magnetic dipole model the coils are fitted with.
+ */
+class HPIFitDataAccess : public HPIFitData
+{
+public:
+    using HPIFitData::compute_leadfield;
+};
+
+
+//=============================================================================================================
+/**
+ * Gives access to the state of a continuous HPI fit.
+ */
+class HPIFitAccess : public HPIFit
+{
+public:
+    MatrixXd startPositions() const
+    {
+        return computeStartPositions(computeAmplitudes(m_matInnerdata, m_matSimsigPinvT, m_matHeadHPI.rows()),
+                                     *m_pFiffInfo);
+    }
+
+    MatrixXd seedPositions() const
+    {
+        MatrixXd amp = computeAmplitudes(m_matInnerdata, m_matSimsigPinvT, m_matHeadHPI.rows());
+        MatrixXd seedPos(amp.cols(),3);
+
+        for(int j = 0; j < amp.cols(); ++j) {
+            seedPos.row(j) = computeSeedPosition(amp, m_vInnerind, *m_pFiffInfo, j);
+        }
+
+        return seedPos;
+    }
+
+    CoilParam& previousCoils()
+    {
+        return m_coilPrevious;
+    }
+
+    bool hasPrevious() const
+    {
+        return m_bHasPrevious;
+    }
+};
+
+
+//=============================================================================================================
+/**
+ * DECLARE CLASS TestHPIFit
+ *
+ * @brief The TestHPIFit class provides tests of the single and the continuous HPI fit
+ *
+ */
+class TestHPIFit : public QObject
+{
+    Q_OBJECT
+
+public:
+    TestHPIFit();
+
+private slots:
+    void initTestCase();
+    void compareContinuous();
+    void warmStartFallback();
+    void changeDigitizer();
+    void cleanupTestCase();
+
+private:
+    MatrixXd fittedPositions(const FiffDigPointSet& fittedPointSet);
+    void compareFits(const FiffCoordTrans& transDevHead,
+                     const QVector<double>& vGof,
+                     const FiffDigPointSet& fittedPointSet);
+
+    double epsilonPos;
+    double epsilonTrans;
+
+    FiffInfo::SPtr m_pFiffInfo;
+    QVector<int> m_vFreqs;
+    MatrixXd m_matData;
+    MatrixXd m_matProjectors;
+    MatrixXd m_matDevHPI;
+
+    FiffCoordTrans m_transDevHeadRef;
+    QVector<double> m_vGofRef;
+    MatrixXd m_matFittedRef;
+};
+
+
+//*************************************************************************************************************
+
+TestHPIFit::TestHPIFit()
+: epsilonPos(0.0001)
+, epsilonTrans(0.001)
+{
+}
+
+
+//*************************************************************************************************************
+
+void TestHPIFit::initTestCase()
+{
+    QFile t_fileIn(QCoreApplication::applicationDirPath() + "/mne-cpp-test-data/MEG/sample/sample_audvis_trunc_raw.fif");
+    FiffRawData raw(t_fileIn);
+    m_pFiffInfo = FiffInfo::SPtr(new FiffInfo(raw.info));
+
+    // The coils sit at the digitized HPI positions, transformed to the device space
+    QList<int> lHPIPoints;
+
+    for(int i = 0; i < m_pFiffInfo->dig.size(); ++i) {
+        if(m_pFiffInfo->dig[i].kind == FIFFV_POINT_HPI) {
+            lHPIPoints.append(i);
+        }
+    }
+
+    const int numCoils = lHPIPoints.size();
+    QVERIFY(numCoils >= 3);
+
+    Matrix4d invTrans = m_pFiffInfo->dev_head_t.invtrans.cast<double>();
+    m_matDevHPI.resize(numCoils,3);
+
+    for(int j = 0; j < numCoils; ++j) {
+        Vector4d headPos(m_pFiffInfo->dig[lHPIPoints[j]].r[0],
+                         m_pFiffInfo->dig[lHPIPoints[j]].r[1],
+                         m_pFiffInfo->dig[lHPIPoints[j]].r[2],
+                         1.0);
+        m_matDevHPI.row(j) = (invTrans * headPos).head(3).transpose();
+    }
+
+    // Simulate the coil signals on the channels the coils are fitted with, using the same dipole model
+    QVector<int> vChannels;
+
+    for(int i = 0; i < m_pFiffInfo->nchan; ++i) {
+        int iCoilType = m_pFiffInfo->chs[i].chpos.coil_type;
+
+        if(iCoilType == FIFFV_COIL_BABY_MAG ||
+                iCoilType == FIFFV_COIL_VV_PLANAR_T1 ||
+                iCoilType == FIFFV_COIL_VV_PLANAR_T2 ||
+                iCoilType == FIFFV_COIL_VV_PLANAR_T3) {
+            vChannels.append(i);
+        }
+    }
+
+    SensorInfo sensors;
+    sensors.coilpos.resize(vChannels.size(),3);
+    sensors.coilori.resize(vChannels.size(),3);
+    sensors.tra = MatrixXd::Identity(vChannels.size(),vChannels.size());
+
+    for(int i = 0; i < vChannels.size(); ++i) {
+        for(int k = 0; k < 3; ++k) {
+            sensors.coilpos(i,k) = m_pFiffInfo->chs[vChannels[i]].chpos.r0[k];
+            sensors.coilori(i,k) = m_pFiffInfo->chs[vChannels[i]].chpos.ez[k];
+        }
+    }
+
+    const int iNumSamples = 300;
+    m_vFreqs << 154 << 158 << 161 << 166;
+
+    while(m_vFreqs.size() < numCoils) {
+        m_vFreqs << m_vFreqs.last() + 4;
+    }
+
+    m_matData = MatrixXd::Zero(m_pFiffInfo->nchan, iNumSamples);
+    HPIFitDataAccess dipoleModel;
+
+    for(int j = 0; j < numCoils; ++j) {
+        MatrixXd lf = dipoleModel.compute_leadfield(m_matDevHPI.row(j), sensors);
+        Vector3d mom(1.0, 0.5 * j, 2.0 - 0.3 * j);
+        VectorXd topo = lf * mom * 1e-9;
+
+        for(int t = 0; t < iNumSamples; ++t) {
+            double dSignal = sin(2 * M_PI * m_vFreqs[j] * t / m_pFiffInfo->sfreq);
+
+            for(int i = 0; i < vChannels.size(); ++i) {
+                m_matData(vChannels[i],t) += topo(i) * dSignal;
+            }
+        }
+    }
+
+    m_matProjectors = MatrixXd::Identity(m_pFiffInfo->nchan, m_pFiffInfo->nchan);
+
+    // The reference is a single fit, which needs to find the simulated coils
+    FiffDigPointSet fittedPointSet;
+    HPIFit::fitHPI(m_matData,
+                   m_matProjectors,
+                   m_transDevHeadRef,
+                   m_vFreqs,
+                   m_vGofRef,
+                   fittedPointSet,
+                   m_pFiffInfo);
+
+    m_matFittedRef = fittedPositions(fittedPointSet);
+
+    QCOMPARE(m_matFittedRef.rows(), m_matDevHPI.rows());
+    QVERIFY((m_matFittedRef - m_matDevHPI).rowwise().norm().maxCoeff() < epsilonPos);
+}
+
+
+//*************************************************************************************************************
+
+void TestHPIFit::compareContinuous()
+{
+    // Repeated continuous fits reuse the setup and are warm-started, they need to end up where the single fit does
+    HPIFitAccess hpiFit;
+
+    for(int i = 0; i < 3; ++i) {
+        FiffCoordTrans transDevHead;
+        QVector<double> vGof;
+        FiffDigPointSet fittedPointSet;
+
+        QVERIFY(hpiFit.fitHPIContinuous(m_matData,
+                                        m_matProjectors,
+                                        transDevHead,
+                                        m_vFreqs,
+                                        vGof,
+                                        fittedPointSet,
+                                        m_pFiffInfo));
+        QVERIFY(hpiFit.hasPrevious());
+
+        compareFits(transDevHead, vGof, fittedPointSet);
+    }
+
+    // Starting over without the previous fit gives the same result
+    hpiFit.resetContinuous();
+    QVERIFY(!hpiFit.hasPrevious());
+
+    FiffCoordTrans transDevHead;
+    QVector<double> vGof;
+    FiffDigPointSet fittedPointSet;
+
+    QVERIFY(hpiFit.fitHPIContinuous(m_matData,
+                                    m_matProjectors,
+                                    transDevHead,
+                                    m_vFreqs,
+                                    vGof,
+                                    fittedPointSet,
+                                    m_pFiffInfo));
+
+    compareFits(transDevHead, vGof, fittedPointSet);
+}
+
+
+//*************************************************************************************************************
+
+void TestHPIFit::warmStartFallback()
+{
+    HPIFitAccess hpiFit;
+    FiffCoordTrans transDevHead;
+    QVector<double> vGof;
+    FiffDigPointSet fittedPointSet;
+
+    QVERIFY(hpiFit.fitHPIContinuous(m_matData,
+                                    m_matProjectors,
+                                    transDevHead,
+                                    m_vFreqs,
+                                    vGof,
+                                    fittedPointSet,
+                                    m_pFiffInfo));
+
+    const int numCoils = m_matDevHPI.rows();
+    MatrixXd matSeedPos = hpiFit.seedPositions();
+
+    // Move the previous coils away from their seeds, the residual decides which of the two a coil starts from
+    CoilParam& coilPrevious = hpiFit.previousCoils();
+    coilPrevious.pos = matSeedPos.array() + 0.2;
+
+    for(int j = 0; j < numCoils; ++j) {
+        switch(j % 4) {
+            case 0: coilPrevious.dpfiterror(j) = HPI_WARM_START_MAX_ERROR; break;
+            case 1: coilPrevious.dpfiterror(j) = 2 * HPI_WARM_START_MAX_ERROR; break;
+            case 2: coilPrevious.dpfiterror(j) = 0.5 * HPI_WARM_START_MAX_ERROR; break;
+            default: coilPrevious.dpfiterror(j) = 0.0; break;
+        }
+    }
+
+    MatrixXd matStartPos = hpiFit.startPositions();
+    QCOMPARE(int(matStartPos.rows()), numCoils);
+
+    for(int j = 0; j < numCoils; ++j) {
+        if(coilPrevious.dpfiterror(j) < HPI_WARM_START_MAX_ERROR) {
+            QVERIFY(matStartPos.row(j) == coilPrevious.pos.row(j));
+        } else {
+            QVERIFY(matStartPos.row(j) == matSeedPos.row(j));
+        }
+    }
+
+    // Coils which were fitted badly are fitted from their seed position again, starting from the previous
+    // position would not find the coils
+    coilPrevious.pos = matSeedPos.array() + 0.5;
+    coilPrevious.dpfiterror.setConstant(HPI_WARM_START_MAX_ERROR);
+
+    QVERIFY(hpiFit.startPositions() == matSeedPos);
+
+    fittedPointSet = FiffDigPointSet();
+
+    QVERIFY(hpiFit.fitHPIContinuous(m_matData,
+                                    m_matProjectors,
+                                    transDevHead,
+                                    m_vFreqs,
+                                    vGof,
+                                    fittedPointSet,
+                                    m_pFiffInfo));
+
+    compareFits(transDevHead, vGof, fittedPointSet);
+}
+
+
+//*************************************************************************************************************
+
+void TestHPIFit::changeDigitizer()
+{
+    // The digitizer points can be loaded into the same measurement info after the first fit
+    FiffInfo::SPtr pFiffInfo(new FiffInfo(*m_pFiffInfo));
+    QList<FiffDigPoint> lDig = pFiffInfo->dig;
+
+    int iLastHPI = -1;
+
+    for(int i = 0; i < lDig.size(); ++i) {
+        if(lDig[i].kind == FIFFV_POINT_HPI) {
+            iLastHPI = i;
+        }
+    }
+
+    QVERIFY(iLastHPI >= 0);
+
+    HPIFitAccess hpiFit;
+    FiffCoordTrans transDevHead;
+    QVector<double> vGof;
+    FiffDigPointSet fittedPointSet;
+
+    // Start with one coil less
+    pFiffInfo->dig.removeAt(iLastHPI);
+
+    QVERIFY(hpiFit.fitHPIContinuous(m_matData,
+                                    m_matProjectors,
+                                    transDevHead,
+                                    m_vFreqs,
+                                    vGof,
+                                    fittedPointSet,
+                                    pFiffInfo));
+    QCOMPARE(fittedPointSet.size(), int(m_matDevHPI.rows()) - 1);
+
+    // All coils are fitted once they are digitized
+    pFiffInfo->dig = lDig;
+    fittedPointSet = FiffDigPointSet();
+
+    QVERIFY(hpiFit.fitHPIContinuous(m_matData,
+                                    m_matProjectors,
+                                    transDevHead,
+                                    m_vFreqs,
+                                    vGof,
+                                    fittedPointSet,
+                                    pFiffInfo));
+
+    compareFits(transDevHead, vGof, fittedPointSet);
+
+    // Moved digitizer points change the dev head transformation, even if the number of coils stays the same
+    for(int i = 0; i < pFiffInfo->dig.size(); ++i) {
+        if(pFiffInfo->dig[i].kind == FIFFV_POINT_HPI) {
+            pFiffInfo->dig[i].r[2] += 0.01f;
+        }
+    }
+
+    fittedPointSet = FiffDigPointSet();
+
+    QVERIFY(hpiFit.fitHPIContinuous(m_matData,
+                                    m_matProjectors,
+                                    transDevHead,
+                                    m_vFreqs,
+                                    vGof,
+                                    fittedPointSet,
+                                    pFiffInfo));
+
+    QVERIFY(std::fabs(transDevHead.trans(2,3) - m_transDevHeadRef.trans(2,3) - 0.01) < epsilonTrans);
+
+    // And back again
+    pFiffInfo->dig = lDig;
+    fittedPointSet = FiffDigPointSet();
+
+    QVERIFY(hpiFit.fitHPIContinuous(m_matData,
+                                    m_matProjectors,
+                                    transDevHead,
+                                    m_vFreqs,
+                                    vGof,
+                                    fittedPointSet,
+                                    pFiffInfo));
+
+    compareFits(transDevHead, vGof, fittedPointSet);
+}
+
+
+//*************************************************************************************************************
+
+void TestHPIFit::cleanupTestCase()
+{
+}
+
+
+//*************************************************************************************************************
+
+MatrixXd TestHPIFit::fittedPositions(const FiffDigPointSet& fittedPointSet)
+{
+    MatrixXd matPos(fittedPointSet.size(),3);
+
+    for(int i = 0; i < fittedPointSet.size(); ++i) {
+        for(int k = 0; k < 3; ++k) {
+            matPos(i,k) = fittedPointSet[i].r[k];
+        }
+    }
+
+    return matPos;
+}
+
+
+//*************************************************************************************************************
+
+void TestHPIFit::compareFits(const FiffCoordTrans& transDevHead,
+                             const QVector<double>& vGof,
+                             const FiffDigPointSet& fittedPointSet)
+{
+    MatrixXd matFitted = fittedPositions(fittedPointSet);
+
+    QCOMPARE(matFitted.rows(), m_matFittedRef.rows());
+    QVERIFY((matFitted - m_matFittedRef).rowwise().norm().maxCoeff() < epsilonPos);
+
+    QCOMPARE(vGof.size(), m_vGofRef.size());
+
+    for(int i = 0; i < vGof.size(); ++i) {
+        QVERIFY(std::fabs(vGof[i] - m_vGofRef[i]) < epsilonPos);
+    }
+
+    QVERIFY((transDevHead.trans - m_transDevHeadRef.trans).cwiseAbs().maxCoeff() < epsilonTrans);
+}
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// MAIN
+//=============================================================================================================
+
+QTEST_GUILESS_MAIN(TestHPIFit)
+#include "test_hpi_fit.moc"
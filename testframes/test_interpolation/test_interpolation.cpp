@@ -87,6 +87,7 @@ private slots:
     void testDimensionsForInterpolation();
     void testSumOfRow();
     void testEmptyInputsForWeightMatrix();
+    void testSparseDistanceTable();
     void cleanupTestCase();
 
 private:
@@ -252,6 +253,77 @@ void TestInterpolation::testEmptyInputsForWeightMatrix()
 
 //*************************************************************************************************************
 
+void TestInterpolation::testSparseDistanceTable()
+{
+    // weight matrices from the dense and the bounded sparse distance table have to match
+    QVector<int> mappedSubSet = GeometryInfo::projectSensors(realSurface.rr,
+                                                                megSensors);
+
+    QSharedPointer<MatrixXd> distanceMatrix = GeometryInfo::scdc(realSurface.rr,
+                                                 realSurface.neighbor_vert,
+                                                 mappedSubSet,
+                                                 0.05);
+    QSharedPointer<SparseMatrix<double, RowMajor> > sparseDistanceMatrix = GeometryInfo::scdcSparse(realSurface.rr,
+                                                                                                     realSurface.neighbor_vert,
+                                                                                                     mappedSubSet,
+                                                                                                     0.05);
+
+    QSharedPointer<SparseMatrix<float> > w = Interpolation::createInterpolationMat(mappedSubSet,
+                                                                  distanceMatrix,
+                                                                  Interpolation::cubic,
+                                                                  0.05);
+    QSharedPointer<SparseMatrix<float> > wSparse = Interpolation::createInterpolationMat(mappedSubSet,
+                                                                        sparseDistanceMatrix,
+                                                                        Interpolation::cubic,
+                                                                        0.05);
+
+    QVERIFY(w->rows() == wSparse->rows());
+    QVERIFY(w->cols() == wSparse->cols());
+
+    MatrixXf matDiff = MatrixXf(*w) - MatrixXf(*wSparse);
+    QVERIFY(matDiff.cwiseAbs().maxCoeff() < 1e-5f);
+
+    // bad channels: the excluded columns must not get any weight, their vertices are interpolated from the good sensors
+    QVector<int> vecExcludeIndex;
+    vecExcludeIndex << 0 << mappedSubSet.size() / 2 << mappedSubSet.size() - 1;
+
+    QSharedPointer<SparseMatrix<double, RowMajor> > sparseDistanceMatrixBad = GeometryInfo::scdcSparse(realSurface.rr,
+                                                                                                        realSurface.neighbor_vert,
+                                                                                                        mappedSubSet,
+                                                                                                        0.20);
+    QSharedPointer<SparseMatrix<float> > wBad = Interpolation::createInterpolationMat(mappedSubSet,
+                                                                     sparseDistanceMatrixBad,
+                                                                     Interpolation::linear,
+                                                                     0.20,
+                                                                     vecExcludeIndex);
+
+    QVERIFY(wBad->rows() == realSurface.rr.rows());
+    QVERIFY(wBad->cols() == mappedSubSet.size());
+
+    const float LOWER_TRESH = 0.99999f;
+    const float UPPER_TRESH = 1.00001f;
+
+    VectorXf vecRowSum = VectorXf::Zero(wBad->rows());
+    for (int k = 0; k < wBad->outerSize(); ++k) {
+        for (SparseMatrix<float>::InnerIterator it(*wBad, k); it; ++it) {
+            QVERIFY(!vecExcludeIndex.contains(it.col()));
+            vecRowSum[it.row()] += it.value();
+        }
+    }
+
+    for (int r = 0; r < vecRowSum.size(); ++r) {
+        // either 1.0 (within range of some sensors) or 0.0 (out of range for all sensors)
+        QVERIFY((vecRowSum[r] >= LOWER_TRESH && vecRowSum[r] <= UPPER_TRESH) || vecRowSum[r] == 0.0f);
+    }
+
+    for (const int iBad : vecExcludeIndex) {
+        const float fRowSum = vecRowSum[mappedSubSet.at(iBad)];
+        QVERIFY(fRowSum >= LOWER_TRESH && fRowSum <= UPPER_TRESH);
+    }
+}
+
+//*************************************************************************************************************
+
 void TestInterpolation::cleanupTestCase()
 {
 
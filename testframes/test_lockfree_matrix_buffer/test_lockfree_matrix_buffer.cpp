@@ -0,0 +1,379 @@
+//=============================================================================================================
+/**
+ * @file     test_lockfree_matrix_buffer.cpp
+ * @author   agent <agent@local>
+ * @version  dev
+ * @date     October, 2026
+ *
+ * @section  LICENSE
+ *
+ * Copyright (C) 2026, agent. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+ * the following conditions are met:
+ *     * Redistributions of source code must retain the above copyright notice, this list of conditions and the
+ *       following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+ *       the following disclaimer in the documentation and/or other materials provided with the distribution.
+ *     * Neither the name of MNE-CPP authors nor the names of its contributors may be used
+ *       to endorse or promote products derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+ * WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ * PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+ * INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ * NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ *
+ * @brief    The lock-free matrix buffer unit test
+ *
+ */
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// INCLUDES
+//=============================================================================================================
+
+#include <utils/generics/lockfreematrixbuffer.h>
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// STL INCLUDES
+//=============================================================================================================
+
+#include <functional>
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// QT INCLUDES
+//=============================================================================================================
+
+#include <QtTest>
+#include <QThread>
+#include <QElapsedTimer>
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// USED NAMESPACES
+//=============================================================================================================
+
+using namespace IOBUFFER;
+using namespace Eigen;
+
+
+//=============================================================================================================
+/**
+ * Runs a function in its own thread.
+ */
+class FunctionThread : public QThread
+{
+public:
+    explicit FunctionThread(const std::function<void()>& function)
+    : m_function(function)
+    {
+    }
+
+protected:
+    void run()
+    {
+        m_function();
+    }
+
+private:
+    std::function<void()> m_function;
+};
+
+
+//=============================================================================================================
+/**
+ * DECLARE CLASS TestLockFreeMatrixBuffer
+ *
+ * @brief The TestLockFreeMatrixBuffer class provides tests of the single producer/single consumer matrix buffer
+ *
+ */
+class TestLockFreeMatrixBuffer: public QObject
+{
+    Q_OBJECT
+
+public:
+    TestLockFreeMatrixBuffer();
+
+private slots:
+    void initTestCase();
+    void wrapAround();
+    void fullAndEmpty();
+    void producerConsumer();
+    void releaseFromWait();
+    void cleanupTestCase();
+};
+
+
+//*************************************************************************************************************
+
+TestLockFreeMatrixBuffer::TestLockFreeMatrixBuffer()
+{
+}
+
+
+//*************************************************************************************************************
+
+void TestLockFreeMatrixBuffer::initTestCase()
+{
+}
+
+
+//*************************************************************************************************************
+
+void TestLockFreeMatrixBuffer::wrapAround()
+{
+    // Write and read a varying number of matrices, so that the indices run through the ring several times
+    LockFreeMatrixBuffer<double> buffer(3, 2, 4);
+
+    QCOMPARE(buffer.size(), 3u);
+    QCOMPARE(buffer.rows(), 2u);
+    QCOMPARE(buffer.cols(), 4u);
+    QCOMPARE(buffer.count(), 0u);
+
+    int iWritten = 0;
+    int iRead = 0;
+
+    for(int round = 0; round < 20; ++round) {
+        int iNumWrite = qMin(round % 3 + 1, int(buffer.size() - buffer.count()));
+
+        for(int i = 0; i < iNumWrite; ++i) {
+            MatrixXd* pSlot = buffer.acquireWrite(0);
+            QVERIFY(pSlot);
+            QCOMPARE(int(pSlot->rows()), 2);
+            QCOMPARE(int(pSlot->cols()), 4);
+            pSlot->setConstant(iWritten++);
+            buffer.commitWrite();
+        }
+
+        QCOMPARE(int(buffer.count()), iWritten - iRead);
+
+        int iNumRead = qMin((round + 1) % 3 + 1, int(buffer.count()));
+
+        for(int i = 0; i < iNumRead; ++i) {
+            const MatrixXd* pSlot = buffer.acquireRead(0);
+            QVERIFY(pSlot);
+            QVERIFY(pSlot->isConstant(iRead++));
+            buffer.release();
+        }
+
+        QCOMPARE(int(buffer.count()), iWritten - iRead);
+    }
+
+    QVERIFY(iWritten > 4 * int(buffer.size()));
+
+    // The copying fallbacks follow the same order
+    MatrixXd matrix;
+
+    while(buffer.count() > 0) {
+        QVERIFY(buffer.pop(matrix, 0));
+        QVERIFY(matrix.isConstant(iRead++));
+    }
+
+    QVERIFY(buffer.push(MatrixXd::Constant(2, 4, iWritten), 0));
+    QVERIFY(!buffer.push(MatrixXd::Zero(3, 4), 0));
+    QVERIFY(buffer.pop(matrix, 0));
+    QVERIFY(matrix.isConstant(iWritten));
+}
+
+
+//*************************************************************************************************************
+
+void TestLockFreeMatrixBuffer::fullAndEmpty()
+{
+    LockFreeMatrixBuffer<double> buffer(2, 1, 1);
+    QElapsedTimer timer;
+
+    // An empty ring has nothing to read, with a timeout the reader waits for it
+    QVERIFY(!buffer.acquireRead(0));
+
+    timer.start();
+    QVERIFY(!buffer.acquireRead(30));
+    QVERIFY(timer.elapsed() >= 30);
+
+    // A full ring has no free slot, with a timeout the writer waits for it
+    QVERIFY(buffer.push(MatrixXd::Ones(1, 1), 0));
+    QVERIFY(buffer.push(MatrixXd::Ones(1, 1), 0));
+    QCOMPARE(buffer.count(), 2u);
+    QVERIFY(!buffer.acquireWrite(0));
+
+    timer.restart();
+    QVERIFY(!buffer.acquireWrite(30));
+    QVERIFY(timer.elapsed() >= 30);
+
+    // A slot which is released while the writer waits wakes it up
+    FunctionThread consumer([&buffer]() {
+        QThread::msleep(20);
+        buffer.release();
+    });
+
+    QVERIFY(buffer.acquireRead(0));
+    consumer.start();
+
+    timer.restart();
+    MatrixXd* pSlot = buffer.acquireWrite(5000);
+    qint64 iElapsed = timer.elapsed();
+
+    consumer.wait();
+
+    QVERIFY(pSlot);
+    QVERIFY(iElapsed < 5000);
+    QCOMPARE(buffer.count(), 1u);
+}
+
+
+//*************************************************************************************************************
+
+void TestLockFreeMatrixBuffer::producerConsumer()
+{
+    // A small ring forces both sides to wait: the producer pauses from time to time, so that the ring runs empty,
+    // and the consumer pauses from time to time, so that the ring runs full.
+    const int iNumMatrices = 20000;
+    LockFreeMatrixBuffer<double> buffer(4, 8, 16);
+
+    FunctionThread producer([&buffer, iNumMatrices]() {
+        for(int i = 0; i < iNumMatrices; ++i) {
+            MatrixXd* pSlot = buffer.acquireWrite(-1);
+
+            if(!pSlot) {
+                return;
+            }
+
+            pSlot->setConstant(i);
+            (*pSlot)(0,0) = -i;
+            buffer.commitWrite();
+
+            if(i % 1000 == 0) {
+                QThread::msleep(2);
+            }
+        }
+    });
+
+    producer.start();
+
+    int iNumReceived = 0;
+    int iNumErrors = 0;
+
+    for(int i = 0; i < iNumMatrices; ++i) {
+        const MatrixXd* pSlot = buffer.acquireRead(5000);
+
+        if(!pSlot) {
+            break;
+        }
+
+        // The slot is read in place, all of it needs to be written before it is handed over
+        if((*pSlot)(0,0) != -i || (*pSlot)(7,15) != i || pSlot->col(8).sum() != 8 * i) {
+            ++iNumErrors;
+        }
+
+        buffer.release();
+        ++iNumReceived;
+
+        if(i % 1500 == 0) {
+            QThread::msleep(2);
+        }
+    }
+
+    // Do not leave the producer waiting if the consumer gave up
+    buffer.releaseFromWait();
+    producer.wait();
+
+    QCOMPARE(iNumReceived, iNumMatrices);
+    QCOMPARE(iNumErrors, 0);
+    QCOMPARE(buffer.count(), 0u);
+}
+
+
+//*************************************************************************************************************
+
+void TestLockFreeMatrixBuffer::releaseFromWait()
+{
+    LockFreeMatrixBuffer<double> buffer(2, 1, 1);
+
+    // A consumer which waits on the empty ring is released
+    bool bReadReturned = false;
+    const MatrixXd* pRead = Q_NULLPTR;
+
+    FunctionThread consumer([&buffer, &bReadReturned, &pRead]() {
+        pRead = buffer.acquireRead(-1);
+        bReadReturned = true;
+    });
+
+    consumer.start();
+    QThread::msleep(50);
+    bool bConsumerWaited = consumer.isRunning();
+
+    buffer.releaseFromWait();
+    bool bConsumerFinished = consumer.wait(5000);
+
+    QVERIFY(bConsumerWaited);
+    QVERIFY(bConsumerFinished);
+    QVERIFY(bReadReturned);
+    QVERIFY(!pRead);
+
+    // Until the buffer is cleared, calls which would have to wait return immediately
+    QVERIFY(!buffer.acquireRead(-1));
+
+    // A producer which waits on the full ring is released
+    buffer.clear();
+    QVERIFY(buffer.push(MatrixXd::Ones(1, 1), 0));
+    QVERIFY(buffer.push(MatrixXd::Ones(1, 1), 0));
+
+    bool bPushed = true;
+
+    FunctionThread producer([&buffer, &bPushed]() {
+        bPushed = buffer.push(MatrixXd::Ones(1, 1), -1);
+    });
+
+    producer.start();
+    QThread::msleep(50);
+    bool bProducerWaited = producer.isRunning();
+
+    buffer.releaseFromWait();
+    bool bProducerFinished = producer.wait(5000);
+
+    QVERIFY(bProducerWaited);
+    QVERIFY(bProducerFinished);
+    QVERIFY(!bPushed);
+    QCOMPARE(buffer.count(), 2u);
+
+    // Clearing empties the buffer and resets the release
+    buffer.clear();
+    QCOMPARE(buffer.count(), 0u);
+
+    QElapsedTimer timer;
+    timer.start();
+    QVERIFY(!buffer.acquireRead(30));
+    QVERIFY(timer.elapsed() >= 30);
+
+    MatrixXd matrix;
+    QVERIFY(buffer.push(MatrixXd::Constant(1, 1, 3.0), 0));
+    QVERIFY(buffer.pop(matrix, 0));
+    QCOMPARE(matrix(0,0), 3.0);
+}
+
+
+//*************************************************************************************************************
+
+void TestLockFreeMatrixBuffer::cleanupTestCase()
+{
+}
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// MAIN
+//=============================================================================================================
+
+QTEST_GUILESS_MAIN(TestLockFreeMatrixBuffer)
+#include "test_lockfree_matrix_buffer.moc"
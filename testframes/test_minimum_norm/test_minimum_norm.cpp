@@ -0,0 +1,272 @@
+//=============================================================================================================
+/**
+ * @file     test_minimum_norm.cpp
+ * @author   agent <agent@local>
+ * @version  dev
+ * @date     October, 2026
+ *
+ * @section  LICENSE
+ *
+ * Copyright (C) 2026, agent. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+ * the following conditions are met:
+ *     * Redistributions of source code must retain the above copyright notice, this list of conditions and the
+ *       following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+ *       the following disclaimer in the documentation and/or other materials provided with the distribution.
+ *     * Neither the name of MNE-CPP authors nor the names of its contributors may be used
+ *       to endorse or promote products derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+ * WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ * PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+ * INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ * NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ *
+ * @brief    The minimum norm unit test
+ *
+ */
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// INCLUDES
+//=============================================================================================================
+
+#include <fiff/fiff_cov.h>
+#include <fiff/fiff_evoked.h>
+#include <mne/mne_forwardsolution.h>
+#include <mne/mne_inverse_operator.h>
+#include <mne/mne_sourceestimate.h>
+#include <inverse/minimumNorm/minimumnorm.h>
+#include <utils/mnemath.h>
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// QT INCLUDES
+//=============================================================================================================
+
+#include <QtTest>
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// USED NAMESPACES
+//=============================================================================================================
+
+using namespace FIFFLIB;
+using namespace MNELIB;
+using namespace INVERSELIB;
+using namespace UTILSLIB;
+using namespace Eigen;
+
+
+//=============================================================================================================
+/**
+ * DECLARE CLASS TestMinimumNorm
+ *
+ * @brief The TestMinimumNorm class provides minimum norm tests
+ *
+ */
+class TestMinimumNorm: public QObject
+{
+    Q_OBJECT
+
+public:
+    TestMinimumNorm();
+
+private slots:
+    void initTestCase();
+    void compareSinglePrecision_data();
+    void compareSinglePrecision();
+    void compareApplyInverse_data();
+    void compareApplyInverse();
+    void cleanupTestCase();
+
+private:
+    double                  epsilonSingle;
+    double                  epsilonApply;
+
+    FiffEvoked              m_evoked;
+    MNEInverseOperator      m_inverseOperator;
+};
+
+
+//*************************************************************************************************************
+
+TestMinimumNorm::TestMinimumNorm()
+: epsilonSingle(0.0001)
+, epsilonApply(0.0000000001)
+{
+}
+
+
+//*************************************************************************************************************
+
+void TestMinimumNorm::initTestCase()
+{
+    qDebug() << "Epsilon single precision" << epsilonSingle;
+
+    QFile t_fileEvoked(QCoreApplication::applicationDirPath() + "/mne-cpp-test-data/MEG/sample/sample_audvis-ave.fif");
+    QFile t_fileFwd(QCoreApplication::applicationDirPath() + "/mne-cpp-test-data/Result/ref-sample_audvis-meg-eeg-oct-6-fwd.fif");
+    QFile t_fileCov(QCoreApplication::applicationDirPath() + "/mne-cpp-test-data/MEG/sample/sample_audvis-cov.fif");
+
+    fiff_int_t setno = 0;
+    QPair<QVariant, QVariant> baseline(QVariant(), 0);
+    m_evoked = FiffEvoked(t_fileEvoked, setno, baseline);
+    QVERIFY(!m_evoked.isEmpty());
+
+    MNEForwardSolution t_forward(t_fileFwd, false, true);
+    QVERIFY(!t_forward.isEmpty());
+
+    FiffCov noise_cov(t_fileCov);
+    noise_cov = noise_cov.regularize(m_evoked.info, 0.05, 0.05, 0.1, true);
+
+    FiffInfo info = m_evoked.info;
+    m_inverseOperator = MNEInverseOperator(info, t_forward, noise_cov, 0.2f, 0.8f);
+}
+
+
+//*************************************************************************************************************
+
+void TestMinimumNorm::compareSinglePrecision_data()
+{
+    QTest::addColumn<QString>("method");
+
+    QTest::newRow("MNE") << QString("MNE");
+    QTest::newRow("dSPM") << QString("dSPM");
+    QTest::newRow("sLORETA") << QString("sLORETA");
+}
+
+
+//*************************************************************************************************************
+
+void TestMinimumNorm::compareSinglePrecision()
+{
+    QFETCH(QString, method);
+
+    // The single precision kernel needs to match the double precision kernel. The kernel multiplication sums over
+    // all channels in float, so the error is stated relative to the largest source amplitude.
+    float lambda2 = 1.0f / 9.0f;
+
+    MinimumNorm minimumNormDouble(m_inverseOperator, lambda2, method);
+    MNESourceEstimate sourceEstimateDouble = minimumNormDouble.calculateInverse(m_evoked);
+
+    MinimumNorm minimumNormSingle(m_inverseOperator, lambda2, method);
+    minimumNormSingle.setSinglePrecision(true);
+    MNESourceEstimate sourceEstimateSingle = minimumNormSingle.calculateInverse(m_evoked);
+
+    QVERIFY(minimumNormSingle.isSinglePrecision());
+    QVERIFY(!sourceEstimateDouble.isEmpty());
+    QVERIFY(!sourceEstimateSingle.isEmpty());
+    QCOMPARE(sourceEstimateSingle.data.rows(), sourceEstimateDouble.data.rows());
+    QCOMPARE(sourceEstimateSingle.data.cols(), sourceEstimateDouble.data.cols());
+
+    double dMaxAmplitude = sourceEstimateDouble.data.cwiseAbs().maxCoeff();
+    double dMaxError = (sourceEstimateSingle.data - sourceEstimateDouble.data).cwiseAbs().maxCoeff();
+
+    qDebug() << method << "- Maximum error of the single precision kernel relative to the largest amplitude" << dMaxError / dMaxAmplitude;
+
+    QVERIFY(dMaxAmplitude > 0.0);
+    QVERIFY(dMaxError < epsilonSingle * dMaxAmplitude);
+}
+
+
+//*************************************************************************************************************
+
+void TestMinimumNorm::compareApplyInverse_data()
+{
+    QTest::addColumn<QString>("method");
+    QTest::addColumn<int>("blockSize");
+
+    QTest::newRow("MNE") << QString("MNE") << 256;
+    QTest::newRow("dSPM") << QString("dSPM") << 256;
+    QTest::newRow("sLORETA") << QString("sLORETA") << 256;
+    QTest::newRow("dSPM small blocks") << QString("dSPM") << 100;
+    QTest::newRow("sLORETA one block") << QString("sLORETA") << 0;
+}
+
+
+//*************************************************************************************************************
+
+void TestMinimumNorm::compareApplyInverse()
+{
+    QFETCH(QString, method);
+    QFETCH(int, blockSize);
+
+    // The blocked application with fused orientation pooling and noise normalization needs to give the same
+    // solution as applying the kernel to all data, combining the orientations and normalizing afterwards
+    float lambda2 = 1.0f / 9.0f;
+
+    MinimumNorm minimumNorm(m_inverseOperator, lambda2, method);
+    minimumNorm.doInverseSetup(m_evoked.nave, false);
+
+    MNEInverseOperator& inv = minimumNorm.getPreparedInverseOperator();
+    const MatrixXd& matKernel = minimumNorm.getKernel();
+
+    // Free orientation sources are pooled
+    QVERIFY(inv.source_ori == FIFFV_MNE_FREE_ORI);
+    QCOMPARE(int(matKernel.rows()), 3 * minimumNorm.getNumberOfSources(false));
+
+    // The last block is only partially filled
+    MatrixXd matEvoked = m_evoked.pick_channels(inv.noise_cov->names).data;
+    MatrixXd matData(matEvoked.rows(), 2 * 256 + 37);
+    for(int i = 0; i < matData.cols(); ++i) {
+        matData.col(i) = matEvoked.col(i % matEvoked.cols());
+    }
+
+    QVERIFY(blockSize <= 0 || matData.cols() % blockSize != 0);
+
+    // Reference: K * data, combine_xyz and noise normalization
+    MatrixXd matSolRef = matKernel * matData;
+    MatrixXd matSolCombined(matSolRef.rows() / 3, matSolRef.cols());
+    for(int i = 0; i < matSolRef.cols(); ++i) {
+        VectorXd* pVecCombined = MNEMath::combine_xyz(matSolRef.col(i));
+        matSolCombined.col(i) = pVecCombined->cwiseSqrt();
+        delete pVecCombined;
+    }
+
+    if(method != "MNE") {
+        QCOMPARE(int(inv.noisenorm.rows()), int(matSolCombined.rows()));
+        matSolRef = inv.noisenorm * matSolCombined;
+    } else {
+        matSolRef = matSolCombined;
+    }
+
+    MatrixXd matSol(minimumNorm.getNumberOfSources(false), matData.cols());
+    QVERIFY(minimumNorm.applyInverse(matData, matSol, false, blockSize));
+
+    QCOMPARE(matSol.rows(), matSolRef.rows());
+    QCOMPARE(matSol.cols(), matSolRef.cols());
+
+    double dMaxAmplitude = matSolRef.cwiseAbs().maxCoeff();
+
+    QVERIFY(dMaxAmplitude > 0.0);
+    QVERIFY((matSol - matSolRef).cwiseAbs().maxCoeff() < epsilonApply * dMaxAmplitude);
+
+    // Wrong solution buffer dimensions are rejected
+    MatrixXd matSolWrong(matSol.rows(), matSol.cols() - 1);
+    QVERIFY(!minimumNorm.applyInverse(matData, matSolWrong, false, blockSize));
+}
+
+
+//*************************************************************************************************************
+
+void TestMinimumNorm::cleanupTestCase()
+{
+}
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// MAIN
+//=============================================================================================================
+
+QTEST_GUILESS_MAIN(TestMinimumNorm)
+#include "test_minimum_norm.moc"
@@ -0,0 +1,274 @@
+//=============================================================================================================
+/**
+ * @file     test_rt_ave.cpp
+ * @author   agent <agent@local>
+ * @version  dev
+ * @date     October, 2026
+ *
+ * @section  LICENSE
+ *
+ * Copyright (C) 2026, agent. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+ * the following conditions are met:
+ *     * Redistributions of source code must retain the above copyright notice, this list of conditions and the
+ *       following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+ *       the following disclaimer in the documentation and/or other materials provided with the distribution.
+ *     * Neither the name of MNE-CPP authors nor the names of its contributors may be used
+ *       to endorse or promote products derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+ * WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ * PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+ * INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ * NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ *
+ * @brief    The real-time averaging unit test
+ *
+ */
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// INCLUDES
+//=============================================================================================================
+
+#include <rtprocessing/rtave.h>
+
+#include <fiff/fiff_evoked_set.h>
+#include <fiff/fiff_info.h>
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// QT INCLUDES
+//=============================================================================================================
+
+#include <QtTest>
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// USED NAMESPACES
+//=============================================================================================================
+
+using namespace RTPROCESSINGLIB;
+using namespace FIFFLIB;
+using namespace Eigen;
+
+
+//=============================================================================================================
+/**
+ * DECLARE CLASS TestRtAve
+ *
+ * @brief The TestRtAve class provides tests of the real-time averaging with synthetic data and known triggers
+ *
+ */
+class TestRtAve: public QObject
+{
+    Q_OBJECT
+
+public:
+    TestRtAve();
+
+private slots:
+    void initTestCase();
+    void compareAverage();
+    void cleanupTestCase();
+
+private:
+    double          epsilon;
+
+    int             m_iNumChannels;
+    int             m_iTriggerCh;
+    int             m_iPreStim;
+    int             m_iPostStim;
+    int             m_iNumAverages;
+
+    FiffInfo::SPtr  m_pFiffInfo;
+    MatrixXd        m_matData;
+    QList<int>      m_lTriggers;
+    QList<int>      m_lBlockStarts;
+};
+
+
+//*************************************************************************************************************
+
+TestRtAve::TestRtAve()
+: epsilon(0.0000000001)
+, m_iNumChannels(5)
+, m_iTriggerCh(4)
+, m_iPreStim(20)
+, m_iPostStim(50)
+, m_iNumAverages(5)
+{
+}
+
+
+//*************************************************************************************************************
+
+void TestRtAve::initTestCase()
+{
+    // Four data channels and one stimulus channel
+    m_pFiffInfo = FiffInfo::SPtr(new FiffInfo);
+    m_pFiffInfo->sfreq = 1000.0;
+    m_pFiffInfo->nchan = m_iNumChannels;
+
+    for(int i = 0; i < m_iNumChannels; ++i) {
+        FiffChInfo chInfo;
+        chInfo.ch_name = i == m_iTriggerCh ? QString("STI 014") : QString("MEG %1").arg(i);
+        chInfo.kind = i == m_iTriggerCh ? FIFFV_STIM_CH : FIFFV_MEG_CH;
+
+        m_pFiffInfo->chs.append(chInfo);
+        m_pFiffInfo->ch_names.append(chInfo.ch_name);
+    }
+
+    // Irregular blocks
+    int blockSizes[] = {250, 130, 400, 90, 333};
+    int iNumSamples = 6000;
+
+    for(int i = 0, from = 0; from < iNumSamples; ++i) {
+        m_lBlockStarts.append(from);
+        from += blockSizes[i % 5];
+    }
+
+    // Random data with single sample trigger pulses. The trigger detection removes the first sample of a block
+    // and skips 100 samples after a detection, so triggers are not placed on the first sample of a block.
+    std::srand(7);
+    m_matData = MatrixXd::Random(m_iNumChannels, iNumSamples);
+    m_matData.row(m_iTriggerCh).setZero();
+
+    for(int iSample = 60; iSample + m_iPostStim < iNumSamples; iSample += 137) {
+        if(m_lBlockStarts.contains(iSample)) {
+            continue;
+        }
+
+        m_matData(m_iTriggerCh, iSample) = 1.0;
+        m_lTriggers.append(iSample);
+    }
+}
+
+
+//*************************************************************************************************************
+
+void TestRtAve::compareAverage()
+{
+    RtAveWorker worker(m_iNumAverages, m_iPreStim, m_iPostStim, 0, 0, m_iTriggerCh, m_pFiffInfo);
+
+    FiffEvokedSet evokedSet, stdErrSet;
+    int iNumEmits = 0;
+
+    connect(&worker, &RtAveWorker::resultReady, [&](const FiffEvokedSet& set, const QStringList&) {
+        evokedSet = set;
+        ++iNumEmits;
+    });
+    connect(&worker, &RtAveWorker::stdErrReady, [&](const FiffEvokedSet& set, const QStringList&) {
+        stdErrSet = set;
+    });
+
+    bool bTwoTriggersInOneBlock = false;
+    bool bStraddlingEpoch = false;
+    bool bComparedBeforeWrap = false;
+    bool bComparedAfterWrap = false;
+    int iLastCompleted = 0;
+
+    for(int i = 0; i < m_lBlockStarts.size(); ++i) {
+        int from = m_lBlockStarts.at(i);
+        int to = i + 1 < m_lBlockStarts.size() ? m_lBlockStarts.at(i + 1) : int(m_matData.cols());
+
+        int iNumEmitsBefore = iNumEmits;
+        worker.doWork(m_matData.middleCols(from, to - from));
+
+        // Triggers whose post stimulus data is complete after this block
+        int iNumCompleted = 0;
+        int iNumInBlock = 0;
+
+        for(int j = 0; j < m_lTriggers.size(); ++j) {
+            int iTrigger = m_lTriggers.at(j);
+
+            if(iTrigger + m_iPostStim <= to) {
+                ++iNumCompleted;
+            }
+
+            if(iTrigger >= from && iTrigger < to) {
+                ++iNumInBlock;
+
+                if(iTrigger + m_iPostStim > to) {
+                    bStraddlingEpoch = true;
+                }
+            }
+        }
+
+        bTwoTriggersInOneBlock |= iNumInBlock > 1;
+
+        if(iNumCompleted == iLastCompleted) {
+            QCOMPARE(iNumEmits, iNumEmitsBefore);
+            continue;
+        }
+
+        // One emit per block, holding all epochs completed so far
+        QCOMPARE(iNumEmits, iNumEmitsBefore + 1);
+        iLastCompleted = iNumCompleted;
+
+        QCOMPARE(evokedSet.evoked.size(), 1);
+        QCOMPARE(stdErrSet.evoked.size(), 1);
+        QCOMPARE(evokedSet.evoked.first().comment, QString::number(1.0));
+
+        // Direct average over the last m_iNumAverages epochs
+        int n = qMin(iNumCompleted, m_iNumAverages);
+        MatrixXd matSum = MatrixXd::Zero(m_iNumChannels, m_iPreStim + m_iPostStim);
+        MatrixXd matSumSqDev = MatrixXd::Zero(m_iNumChannels, m_iPreStim + m_iPostStim);
+
+        for(int j = iNumCompleted - n; j < iNumCompleted; ++j) {
+            matSum += m_matData.middleCols(m_lTriggers.at(j) - m_iPreStim, m_iPreStim + m_iPostStim);
+        }
+
+        MatrixXd matMean = matSum / n;
+
+        for(int j = iNumCompleted - n; j < iNumCompleted; ++j) {
+            matSumSqDev += (m_matData.middleCols(m_lTriggers.at(j) - m_iPreStim, m_iPreStim + m_iPostStim) - matMean).cwiseAbs2();
+        }
+
+        MatrixXd matStdErr = n > 1 ? MatrixXd((matSumSqDev / (double(n) * (n - 1))).cwiseSqrt())
+                                   : MatrixXd::Zero(m_iNumChannels, m_iPreStim + m_iPostStim);
+
+        QCOMPARE(evokedSet.evoked.first().nave, n);
+        QCOMPARE(stdErrSet.evoked.first().nave, n);
+        QVERIFY( (evokedSet.evoked.first().data - matMean).cwiseAbs().maxCoeff() < epsilon );
+        QVERIFY( (stdErrSet.evoked.first().data - matStdErr).cwiseAbs().maxCoeff() < epsilon );
+
+        if(iNumCompleted < m_iNumAverages) {
+            bComparedBeforeWrap = true;
+        } else if(iNumCompleted > 2 * m_iNumAverages) {
+            bComparedAfterWrap = true;
+        }
+    }
+
+    // Make sure the synthetic data covers the cases of interest
+    QCOMPARE(iLastCompleted, m_lTriggers.size());
+    QVERIFY(bTwoTriggersInOneBlock);
+    QVERIFY(bStraddlingEpoch);
+    QVERIFY(bComparedBeforeWrap);
+    QVERIFY(bComparedAfterWrap);
+}
+
+
+//*************************************************************************************************************
+
+void TestRtAve::cleanupTestCase()
+{
+}
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// MAIN
+//=============================================================================================================
+
+QTEST_GUILESS_MAIN(TestRtAve)
+#include "test_rt_ave.moc"
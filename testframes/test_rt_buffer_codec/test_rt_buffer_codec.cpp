@@ -0,0 +1,365 @@
+//=============================================================================================================
+/**
+ * @file     test_rt_buffer_codec.cpp
+ * @author   agent <agent@local>
+ * @version  dev
+ * @date     October, 2026
+ *
+ * @section  LICENSE
+ *
+ * Copyright (C) 2026, agent. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+ * the following conditions are met:
+ *     * Redistributions of source code must retain the above copyright notice, this list of conditions and the
+ *       following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+ *       the following disclaimer in the documentation and/or other materials provided with the distribution.
+ *     * Neither the name of MNE-CPP authors nor the names of its contributors may be used
+ *       to endorse or promote products derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+ * WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ * PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+ * INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ * NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ *
+ * @brief    The real-time buffer codec unit test
+ *
+ */
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// INCLUDES
+//=============================================================================================================
+
+#include <communication/rtClient/rtbuffercodec.h>
+#include <communication/rtClient/rtdataclient.h>
+
+#include <fiff/fiff_stream.h>
+#include <fiff/fiff_tag.h>
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// QT INCLUDES
+//=============================================================================================================
+
+#include <QtTest>
+#include <QBuffer>
+#include <QTcpServer>
+#include <QTcpSocket>
+#include <QtEndian>
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// USED NAMESPACES
+//=============================================================================================================
+
+using namespace COMMUNICATIONLIB;
+using namespace FIFFLIB;
+using namespace Eigen;
+
+
+//=============================================================================================================
+/**
+ * DECLARE CLASS TestRtBufferCodec
+ *
+ * @brief The TestRtBufferCodec class provides round trip tests of the real-time buffer encodings
+ *
+ */
+class TestRtBufferCodec: public QObject
+{
+    Q_OBJECT
+
+public:
+    TestRtBufferCodec();
+
+private slots:
+    void initTestCase();
+    void compareFloat();
+    void compareInt16();
+    void compareInt24();
+    void compareInt16Delta();
+    void compareInt24Delta();
+    void compareCompression();
+    void rejectTruncated();
+    void readRawBufferRing();
+    void cleanupTestCase();
+
+private:
+    FiffTag::SPtr roundTrip(RtBufferCodec::Encoding encoding, MatrixXf& matDecoded);
+    QByteArray makeTag(fiff_int_t kind, fiff_int_t type, const QByteArray& payload);
+    QByteArray makeFloatTag(const MatrixXf& matData);
+
+    MatrixXf    m_matData;
+    VectorXf    m_vecCalSteps;
+};
+
+
+//*************************************************************************************************************
+
+TestRtBufferCodec::TestRtBufferCodec()
+{
+}
+
+
+//*************************************************************************************************************
+
+void TestRtBufferCodec::initTestCase()
+{
+    //Random walks of integer ADC values in units of the calibration step, one channel uses the full int16 range
+    int iNChan = 64;
+    int iNSamp = 500;
+
+    m_vecCalSteps.resize(iNChan);
+    m_matData.resize(iNChan, iNSamp);
+
+    qsrand(42);
+
+    for(int c = 0; c < iNChan; ++c) {
+        m_vecCalSteps[c] = 1e-13f * (1 + c % 5);
+
+        int iValue = 0;
+        for(int s = 0; s < iNSamp; ++s) {
+            iValue = qBound(-32767, iValue + qrand() % 101 - 50, 32767);
+            if(c == 0) {
+                iValue = s % 2 ? 32767 : -32767;
+            }
+            m_matData(c,s) = iValue * m_vecCalSteps[c];
+        }
+    }
+}
+
+
+//*************************************************************************************************************
+
+FiffTag::SPtr TestRtBufferCodec::roundTrip(RtBufferCodec::Encoding encoding, MatrixXf& matDecoded)
+{
+    QByteArray t_blockTag = RtBufferCodec::encodeTag(m_matData, m_vecCalSteps, encoding);
+
+    QBuffer t_buffer(&t_blockTag);
+    t_buffer.open(QIODevice::ReadOnly);
+    FiffStream t_fiffStream(&t_buffer);
+
+    FiffTag::SPtr t_pTag;
+    t_fiffStream.read_tag(t_pTag);
+
+    if(t_pTag->kind == FIFF_DATA_BUFFER) {
+        matDecoded = Map<MatrixXf>(t_pTag->toFloat(), m_matData.rows(), m_matData.cols());
+    } else {
+        RtBufferCodec::decodeTag(*t_pTag, matDecoded);
+    }
+
+    return t_pTag;
+}
+
+
+//*************************************************************************************************************
+
+void TestRtBufferCodec::compareFloat()
+{
+    MatrixXf matDecoded;
+    FiffTag::SPtr t_pTag = roundTrip(RtBufferCodec::Float, matDecoded);
+
+    QVERIFY(t_pTag->kind == FIFF_DATA_BUFFER);
+    QVERIFY(matDecoded == m_matData);
+}
+
+
+//*************************************************************************************************************
+
+void TestRtBufferCodec::compareInt16()
+{
+    MatrixXf matDecoded;
+    FiffTag::SPtr t_pTag = roundTrip(RtBufferCodec::Int16, matDecoded);
+
+    QVERIFY(t_pTag->kind == FIFF_MNE_RT_COMPACT_DATA_BUFFER);
+    QVERIFY(matDecoded == m_matData);
+}
+
+
+//*************************************************************************************************************
+
+void TestRtBufferCodec::compareInt24()
+{
+    MatrixXf matDecoded;
+    roundTrip(RtBufferCodec::Int24, matDecoded);
+
+    QVERIFY(matDecoded == m_matData);
+}
+
+
+//*************************************************************************************************************
+
+void TestRtBufferCodec::compareInt16Delta()
+{
+    MatrixXf matDecoded;
+    roundTrip(RtBufferCodec::Int16Delta, matDecoded);
+
+    QVERIFY(matDecoded == m_matData);
+}
+
+
+//*************************************************************************************************************
+
+void TestRtBufferCodec::compareInt24Delta()
+{
+    MatrixXf matDecoded;
+    roundTrip(RtBufferCodec::Int24Delta, matDecoded);
+
+    QVERIFY(matDecoded == m_matData);
+}
+
+
+//*************************************************************************************************************
+
+void TestRtBufferCodec::compareCompression()
+{
+    int iFloatSize = RtBufferCodec::encodeTag(m_matData, m_vecCalSteps, RtBufferCodec::Float).size();
+
+    QVERIFY(RtBufferCodec::encodeTag(m_matData, m_vecCalSteps, RtBufferCodec::Int16).size() < iFloatSize / 2 + 4 * m_matData.rows() + 64);
+    QVERIFY(RtBufferCodec::encodeTag(m_matData, m_vecCalSteps, RtBufferCodec::Int16Delta).size() < iFloatSize / 3);
+}
+
+
+//*************************************************************************************************************
+
+void TestRtBufferCodec::rejectTruncated()
+{
+    QByteArray t_blockTag = RtBufferCodec::encodeTag(m_matData, m_vecCalSteps, RtBufferCodec::Int16Delta);
+
+    FiffTag t_tag;
+    t_tag.kind = FIFF_MNE_RT_COMPACT_DATA_BUFFER;
+    t_tag.append(t_blockTag.mid(16, t_blockTag.size() - 16 - 10));
+
+    MatrixXf matDecoded;
+    QVERIFY(!RtBufferCodec::decodeTag(t_tag, matDecoded));
+}
+
+
+//*************************************************************************************************************
+
+QByteArray TestRtBufferCodec::makeTag(fiff_int_t kind, fiff_int_t type, const QByteArray& payload)
+{
+    QByteArray t_tag(16, 0);
+    qToBigEndian<qint32>(kind, reinterpret_cast<uchar*>(t_tag.data()));
+    qToBigEndian<qint32>(type, reinterpret_cast<uchar*>(t_tag.data()) + 4);
+    qToBigEndian<qint32>(payload.size(), reinterpret_cast<uchar*>(t_tag.data()) + 8);
+    t_tag.append(payload);
+
+    return t_tag;
+}
+
+
+//*************************************************************************************************************
+
+QByteArray TestRtBufferCodec::makeFloatTag(const MatrixXf& matData)
+{
+    QByteArray t_payload(int(matData.size() * 4), 0);
+    for(int i = 0; i < matData.size(); ++i) {
+        quint32 iBits;
+        memcpy(&iBits, matData.data() + i, 4);
+        qToBigEndian<quint32>(iBits, reinterpret_cast<uchar*>(t_payload.data()) + 4 * i);
+    }
+
+    return makeTag(FIFF_DATA_BUFFER, FIFFT_FLOAT, t_payload);
+}
+
+
+//*************************************************************************************************************
+
+void TestRtBufferCodec::readRawBufferRing()
+{
+    QTcpServer t_server;
+    QVERIFY(t_server.listen(QHostAddress::LocalHost));
+
+    RtDataClient t_client;
+    t_client.QAbstractSocket::connectToHost(QHostAddress::LocalHost, t_server.serverPort());
+    QVERIFY(t_server.waitForNewConnection(5000));
+    QVERIFY(t_client.waitForConnected(5000));
+    QTcpSocket* t_pServerSocket = t_server.nextPendingConnection();
+
+    const int iNChan = m_matData.rows();
+    const int iNSamp = 100;
+
+    // Float buffers 0-4 and 8, a short buffer 5, a float buffer 6 whose size does not fit the channels, a compact buffer 7
+    QList<MatrixXf> lFloatData;
+    QByteArray t_stream;
+    for(int i = 0; i < 5; ++i) {
+        lFloatData << m_matData.leftCols(iNSamp) * float(i + 1);
+        t_stream.append(makeFloatTag(lFloatData.last()));
+    }
+
+    MatrixXf matShort(iNChan, iNSamp);
+    QByteArray t_shortPayload(iNChan * iNSamp * 2, 0);
+    for(int i = 0; i < matShort.size(); ++i) {
+        qint16 iValue = qint16(i % 2001 - 1000);
+        matShort.data()[i] = iValue;
+        qToBigEndian<qint16>(iValue, reinterpret_cast<uchar*>(t_shortPayload.data()) + 2 * i);
+    }
+    t_stream.append(makeTag(FIFF_DATA_BUFFER, FIFFT_SHORT, t_shortPayload));
+    t_stream.append(makeTag(FIFF_DATA_BUFFER, FIFFT_FLOAT, QByteArray(4 * iNChan * iNSamp + 4, 0)));
+    t_stream.append(RtBufferCodec::encodeTag(m_matData, m_vecCalSteps, RtBufferCodec::Int16));
+    lFloatData << m_matData.rightCols(iNSamp);
+    t_stream.append(makeFloatTag(lFloatData.last()));
+
+    t_pServerSocket->write(t_stream);
+    QVERIFY(t_pServerSocket->waitForBytesWritten(5000));
+    while(t_client.bytesAvailable() < t_stream.size()) {
+        QVERIFY(t_client.waitForReadyRead(5000));
+    }
+
+    // Ring of three slots, starting at the last slot to cover the wrap-around
+    QVector<MatrixXf> t_ring(3);
+    fiff_int_t kind;
+
+    QCOMPARE(t_client.readRawBuffers(iNChan, t_ring, 2, 3, kind), 3);
+    QVERIFY(kind == FIFF_DATA_BUFFER);
+    QVERIFY(t_ring[2] == lFloatData[0]);
+    QVERIFY(t_ring[0] == lFloatData[1]);
+    QVERIFY(t_ring[1] == lFloatData[2]);
+
+    QCOMPARE(t_client.readRawBuffers(iNChan, t_ring, 2, 3, kind), 3);
+    QVERIFY(t_ring[2] == lFloatData[3]);
+    QVERIFY(t_ring[0] == lFloatData[4]);
+    QVERIFY(t_ring[1] == matShort);
+
+    // The malformed buffer must not be reported as data
+    QCOMPARE(t_client.readRawBuffers(iNChan, t_ring, 2, 3, kind), 0);
+    QVERIFY(kind != FIFF_DATA_BUFFER);
+    QVERIFY(t_ring[2] == lFloatData[3]);
+
+    // Only the buffers which are already received are read
+    QCOMPARE(t_client.readRawBuffers(iNChan, t_ring, 2, 3, kind), 2);
+    QVERIFY(t_ring[2] == m_matData);
+    QVERIFY(t_ring[0] == lFloatData[5]);
+
+    // A lost connection returns immediately
+    t_pServerSocket->disconnectFromHost();
+    t_client.waitForDisconnected(5000);
+    QCOMPARE(t_client.readRawBuffers(iNChan, t_ring, 1, 3, kind), 0);
+    QVERIFY(kind == FIFF_NOP);
+}
+
+
+//*************************************************************************************************************
+
+void TestRtBufferCodec::cleanupTestCase()
+{
+}
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// MAIN
+//=============================================================================================================
+
+QTEST_GUILESS_MAIN(TestRtBufferCodec)
+#include "test_rt_buffer_codec.moc"
@@ -0,0 +1,297 @@
+//=============================================================================================================
+/**
+ * @file     test_rt_cov.cpp
+ * @author   agent <agent@local>
+ * @version  dev
+ * @date     October, 2026
+ *
+ * @section  LICENSE
+ *
+ * Copyright (C) 2026, agent. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+ * the following conditions are met:
+ *     * Redistributions of source code must retain the above copyright notice, this list of conditions and the
+ *       following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+ *       the following disclaimer in the documentation and/or other materials provided with the distribution.
+ *     * Neither the name of MNE-CPP authors nor the names of its contributors may be used
+ *       to endorse or promote products derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+ * WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ * PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+ * INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ * NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ *
+ * @brief    The real-time covariance unit test
+ *
+ */
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// INCLUDES
+//=============================================================================================================
+
+#include <rtprocessing/rtcov.h>
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// Eigen INCLUDES
+//=============================================================================================================
+
+#include <Eigen/Dense>
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// QT INCLUDES
+//=============================================================================================================
+
+#include <QtTest>
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// USED NAMESPACES
+//=============================================================================================================
+
+using namespace RTPROCESSINGLIB;
+using namespace Eigen;
+
+
+//=============================================================================================================
+/**
+ * DECLARE CLASS TestRtCov
+ *
+ * @brief The TestRtCov class provides tests of the incremental real-time covariance estimation
+ *
+ */
+class TestRtCov: public QObject
+{
+    Q_OBJECT
+
+public:
+    TestRtCov();
+
+private slots:
+    void initTestCase();
+    void compareIncremental_data();
+    void compareIncremental();
+    void compareMultipleBlocks();
+    void reset();
+    void cleanupTestCase();
+
+private:
+    MatrixXd weightedCov(const MatrixXd& matData,
+                         const VectorXd& vecWeights,
+                         double& dNFree) const;
+
+    double      epsilon;
+
+    MatrixXd    m_matData;
+};
+
+
+//*************************************************************************************************************
+
+TestRtCov::TestRtCov()
+: epsilon(0.0000000001)
+{
+}
+
+
+//*************************************************************************************************************
+
+void TestRtCov::initTestCase()
+{
+    // Correlated channels with different offsets and scales
+    std::srand(42);
+    MatrixXd matMixing = MatrixXd::Random(6, 6);
+    m_matData = matMixing * MatrixXd::Random(6, 2000);
+
+    for(int i = 0; i < m_matData.rows(); ++i) {
+        m_matData.row(i).array() += 10.0 * (i + 1);
+    }
+
+    m_matData *= 1e-12;
+}
+
+
+//*************************************************************************************************************
+
+void TestRtCov::compareIncremental_data()
+{
+    QTest::addColumn<double>("lambda");
+
+    QTest::newRow("cumulative") << 1.0;
+    QTest::newRow("lambda 0.999") << 0.999;
+    QTest::newRow("lambda 0.98") << 0.98;
+}
+
+
+//*************************************************************************************************************
+
+void TestRtCov::compareIncremental()
+{
+    QFETCH(double, lambda);
+
+    RtCovWorker worker;
+    worker.setForgettingFactor(lambda);
+
+    // Every sample of a block enters with weight 1, the past is weighted by lambda^n for n new samples
+    int blockSizes[] = {37, 1, 150, 2, 64, 500};
+    VectorXd vecWeights = VectorXd::Zero(m_matData.cols());
+    int from = 0;
+
+    for(int i = 0; from < m_matData.cols(); ++i) {
+        int size = qMin(blockSizes[i % 6], int(m_matData.cols()) - from);
+
+        RtCovInput inputData;
+        inputData.lData.append(m_matData.middleCols(from, size));
+        inputData.iSamples = size;
+
+        worker.doWorkIncremental(inputData, false);
+
+        vecWeights.head(from) *= std::pow(lambda, size);
+        vecWeights.segment(from, size).setOnes();
+        from += size;
+
+        MatrixXd matCov;
+        int iNFree = 0;
+        QVERIFY(worker.getIncrementalCov(matCov, iNFree));
+
+        double dNFree;
+        MatrixXd matCovRef = weightedCov(m_matData.leftCols(from), vecWeights.head(from), dNFree);
+
+        QVERIFY( (matCov - matCovRef).cwiseAbs().maxCoeff() < epsilon * matCovRef.cwiseAbs().maxCoeff() );
+        QVERIFY(std::abs(iNFree - dNFree) <= 0.5 + epsilon);
+    }
+
+    // Without forgetting the estimate is the unbiased sample covariance
+    if(lambda == 1.0) {
+        MatrixXd matCov;
+        int iNFree = 0;
+        QVERIFY(worker.getIncrementalCov(matCov, iNFree));
+
+        MatrixXd matCentered = m_matData.colwise() - m_matData.rowwise().mean();
+        MatrixXd matCovRef = matCentered * matCentered.transpose() / (m_matData.cols() - 1);
+
+        QVERIFY( (matCov - matCovRef).cwiseAbs().maxCoeff() < epsilon * matCovRef.cwiseAbs().maxCoeff() );
+        QCOMPARE(iNFree, int(m_matData.cols()));
+    }
+}
+
+
+//*************************************************************************************************************
+
+void TestRtCov::compareMultipleBlocks()
+{
+    // Several blocks in one input are folded in one after another
+    double lambda = 0.99;
+
+    RtCovWorker workerSingle;
+    workerSingle.setForgettingFactor(lambda);
+    RtCovWorker workerMultiple;
+    workerMultiple.setForgettingFactor(lambda);
+
+    RtCovInput inputData;
+    int blockSizes[] = {100, 7, 300};
+    int from = 0;
+
+    for(int i = 0; from < m_matData.cols(); ++i) {
+        int size = qMin(blockSizes[i % 3], int(m_matData.cols()) - from);
+
+        RtCovInput inputSingle;
+        inputSingle.lData.append(m_matData.middleCols(from, size));
+        inputSingle.iSamples = size;
+        workerSingle.doWorkIncremental(inputSingle, false);
+
+        inputData.lData.append(m_matData.middleCols(from, size));
+        from += size;
+    }
+
+    inputData.iSamples = from;
+    workerMultiple.doWorkIncremental(inputData, false);
+
+    MatrixXd matCovSingle, matCovMultiple;
+    int iNFreeSingle = 0, iNFreeMultiple = 0;
+    QVERIFY(workerSingle.getIncrementalCov(matCovSingle, iNFreeSingle));
+    QVERIFY(workerMultiple.getIncrementalCov(matCovMultiple, iNFreeMultiple));
+
+    QVERIFY( (matCovSingle - matCovMultiple).cwiseAbs().maxCoeff() < epsilon * matCovSingle.cwiseAbs().maxCoeff() );
+    QCOMPARE(iNFreeSingle, iNFreeMultiple);
+}
+
+
+//*************************************************************************************************************
+
+void TestRtCov::reset()
+{
+    RtCovWorker worker;
+
+    RtCovInput inputData;
+    inputData.lData.append(m_matData.leftCols(100));
+    inputData.iSamples = 100;
+    worker.doWorkIncremental(inputData, false);
+
+    MatrixXd matCov;
+    int iNFree = 0;
+    QVERIFY(worker.getIncrementalCov(matCov, iNFree));
+
+    // After a reset only the new data is used
+    worker.resetIncremental();
+    QVERIFY(!worker.getIncrementalCov(matCov, iNFree));
+
+    inputData.lData.clear();
+    inputData.lData.append(m_matData.rightCols(100));
+    worker.doWorkIncremental(inputData, false);
+    QVERIFY(worker.getIncrementalCov(matCov, iNFree));
+
+    double dNFree;
+    MatrixXd matCovRef = weightedCov(m_matData.rightCols(100), VectorXd::Ones(100), dNFree);
+
+    QVERIFY( (matCov - matCovRef).cwiseAbs().maxCoeff() < epsilon * matCovRef.cwiseAbs().maxCoeff() );
+    QCOMPARE(iNFree, 100);
+}
+
+
+//*************************************************************************************************************
+
+void TestRtCov::cleanupTestCase()
+{
+}
+
+
+//*************************************************************************************************************
+
+MatrixXd TestRtCov::weightedCov(const MatrixXd& matData,
+                                const VectorXd& vecWeights,
+                                double& dNFree) const
+{
+    // Directly weighted covariance with the unbiased normalization for reliability weights
+    double dWeight = vecWeights.sum();
+    double dWeightSq = vecWeights.squaredNorm();
+
+    VectorXd vecMean = matData * vecWeights / dWeight;
+    MatrixXd matCentered = matData.colwise() - vecMean;
+
+    dNFree = dWeight * dWeight / dWeightSq;
+
+    return matCentered * vecWeights.asDiagonal() * matCentered.transpose() / (dWeight - dWeightSq / dWeight);
+}
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// MAIN
+//=============================================================================================================
+
+QTEST_GUILESS_MAIN(TestRtCov)
+#include "test_rt_cov.moc"
@@ -0,0 +1,238 @@
+//=============================================================================================================
+/**
+ * @file     test_rt_resample.cpp
+ * @author   agent <agent@local>
+ * @version  dev
+ * @date     October, 2026
+ *
+ * @section  LICENSE
+ *
+ * Copyright (C) 2026, agent. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+ * the following conditions are met:
+ *     * Redistributions of source code must retain the above copyright notice, this list of conditions and the
+ *       following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+ *       the following disclaimer in the documentation and/or other materials provided with the distribution.
+ *     * Neither the name of MNE-CPP authors nor the names of its contributors may be used
+ *       to endorse or promote products derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+ * WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ * PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+ * INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ * NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ *
+ * @brief    The polyphase resampling unit test
+ *
+ */
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// INCLUDES
+//=============================================================================================================
+
+#include <rtprocessing/rtresample.h>
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// QT INCLUDES
+//=============================================================================================================
+
+#include <QtTest>
+#include <QtMath>
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// USED NAMESPACES
+//=============================================================================================================
+
+using namespace RTPROCESSINGLIB;
+using namespace Eigen;
+
+
+//=============================================================================================================
+/**
+ * DECLARE CLASS TestRtResample
+ *
+ * @brief The TestRtResample class provides tests of the polyphase resampling
+ *
+ */
+class TestRtResample: public QObject
+{
+    Q_OBJECT
+
+public:
+    TestRtResample();
+
+private slots:
+    void initTestCase();
+    void compareStreaming_data();
+    void compareStreaming();
+    void compareSinusoid_data();
+    void compareSinusoid();
+    void cleanupTestCase();
+
+private:
+    double epsilon;
+    double epsilonFilter;
+};
+
+
+//*************************************************************************************************************
+
+TestRtResample::TestRtResample()
+: epsilon(0.000000000001)
+, epsilonFilter(0.01)
+{
+}
+
+
+//*************************************************************************************************************
+
+void TestRtResample::initTestCase()
+{
+    qDebug() << "Epsilon" << epsilon;
+    qDebug() << "Epsilon filter" << epsilonFilter;
+}
+
+
+//*************************************************************************************************************
+
+void TestRtResample::compareStreaming_data()
+{
+    QTest::addColumn<int>("up");
+    QTest::addColumn<int>("down");
+
+    QTest::newRow("decimation 1/4") << 1 << 4;
+    QTest::newRow("rational 2/3") << 2 << 3;
+    QTest::newRow("rational 3/2") << 3 << 2;
+}
+
+
+//*************************************************************************************************************
+
+void TestRtResample::compareStreaming()
+{
+    QFETCH(int, up);
+    QFETCH(int, down);
+
+    // Streaming in blocks of any length needs to give the same result as streaming all data in one block
+    std::srand(11);
+    MatrixXd matData = MatrixXd::Random(3, 5003);
+
+    RtResample resampleOneShot;
+    QVERIFY(resampleOneShot.prepareResample(up, down, 1000.0));
+
+    MatrixXd matOneShot;
+    QVERIFY(resampleOneShot.resampleDataBlock(matData, matOneShot));
+
+    RtResample resampleStreaming;
+    QVERIFY(resampleStreaming.prepareResample(up, down, 1000.0));
+
+    MatrixXd matStreamed(matData.rows(), matOneShot.cols() + 1);
+    MatrixXd matBlock;
+    int blockSizes[] = {1, 7, 100, 333, 64};
+    int from = 0;
+    int iNumOut = 0;
+
+    for(int i = 0; from < matData.cols(); ++i) {
+        int size = qMin(blockSizes[i % 5], int(matData.cols()) - from);
+        QVERIFY(resampleStreaming.resampleDataBlock(matData.middleCols(from, size), matBlock));
+
+        QVERIFY(iNumOut + matBlock.cols() <= matOneShot.cols());
+        matStreamed.middleCols(iNumOut, matBlock.cols()) = matBlock;
+        iNumOut += matBlock.cols();
+        from += size;
+    }
+
+    QCOMPARE(iNumOut, int(matOneShot.cols()));
+    QVERIFY( (matStreamed.leftCols(iNumOut) - matOneShot).cwiseAbs().maxCoeff() < epsilon * matOneShot.cwiseAbs().maxCoeff() );
+
+    // After a reset the same output is produced again
+    resampleStreaming.resetResample();
+    QVERIFY(resampleStreaming.resampleDataBlock(matData, matBlock));
+    QVERIFY( (matBlock - matOneShot).cwiseAbs().maxCoeff() < epsilon * matOneShot.cwiseAbs().maxCoeff() );
+}
+
+
+//*************************************************************************************************************
+
+void TestRtResample::compareSinusoid_data()
+{
+    QTest::addColumn<int>("up");
+    QTest::addColumn<int>("down");
+    QTest::addColumn<double>("sFreqIn");
+    QTest::addColumn<double>("passFreq");
+    QTest::addColumn<double>("aliasFreq");
+
+    // The pass band ends at 60% of the output nyquist frequency, the alias frequency lies above the output nyquist
+    QTest::newRow("decimation 1/4") << 1 << 4 << 1000.0 << 20.0 << 300.0;
+    QTest::newRow("rational 2/3") << 2 << 3 << 600.0 << 50.0 << 250.0;
+}
+
+
+//*************************************************************************************************************
+
+void TestRtResample::compareSinusoid()
+{
+    QFETCH(int, up);
+    QFETCH(int, down);
+    QFETCH(double, sFreqIn);
+    QFETCH(double, passFreq);
+    QFETCH(double, aliasFreq);
+
+    int iNumSamples = 10 * sFreqIn;
+    double dSFreqOut = sFreqIn * up / down;
+
+    MatrixXd matData(2, iNumSamples);
+    for(int i = 0; i < iNumSamples; ++i) {
+        matData(0, i) = qSin(2.0 * M_PI * passFreq * i / sFreqIn);
+        matData(1, i) = qSin(2.0 * M_PI * aliasFreq * i / sFreqIn);
+    }
+
+    RtResample resample;
+    QVERIFY(resample.prepareResample(up, down, sFreqIn));
+    QCOMPARE(resample.getSFreqOut(), dSFreqOut);
+
+    MatrixXd matResampled;
+    QVERIFY(resample.resampleData(matData, matResampled));
+    QCOMPARE(int(matResampled.cols()), (iNumSamples * up + down - 1) / down);
+
+    // Ignore the edges which are affected by the padding
+    int iEdge = matResampled.cols() / 10;
+    int iNumInner = matResampled.cols() - 2 * iEdge;
+
+    RowVectorXd vecExpected(iNumInner);
+    for(int i = 0; i < iNumInner; ++i) {
+        vecExpected[i] = qSin(2.0 * M_PI * passFreq * (iEdge + i) / dSFreqOut);
+    }
+
+    // The pass band sinusoid is kept in amplitude and phase, the one above the output nyquist frequency is removed
+    QVERIFY( (matResampled.row(0).segment(iEdge, iNumInner) - vecExpected).cwiseAbs().maxCoeff() < epsilonFilter );
+    QVERIFY( matResampled.row(1).segment(iEdge, iNumInner).cwiseAbs().maxCoeff() < epsilonFilter );
+}
+
+
+//*************************************************************************************************************
+
+void TestRtResample::cleanupTestCase()
+{
+}
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// MAIN
+//=============================================================================================================
+
+QTEST_GUILESS_MAIN(TestRtResample)
+#include "test_rt_resample.moc"
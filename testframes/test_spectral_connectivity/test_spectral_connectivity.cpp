@@ -50,8 +50,14 @@
 #include <connectivity/metrics/weightedphaselagindex.h>
 #include <connectivity/metrics/debiasedsquaredweightedphaselagindex.h>
 #include <connectivity/metrics/crosscorrelation.h>
+#include <connectivity/metrics/abstractmetric.h>
 #include <connectivity/connectivitysettings.h>
+#include <connectivity/connectivity.h>
 #include <connectivity/network/network.h>
+#include <connectivity/network/networkedge.h>
+#include <connectivity/network/networknode.h>
+
+#include <rtprocessing/rtconnectivity.h>
 
 
 //*************************************************************************************************************
@@ -77,6 +83,7 @@
 
 using namespace Eigen;
 using namespace CONNECTIVITYLIB;
+using namespace RTPROCESSINGLIB;
 using namespace UTILSLIB;
 
 
@@ -104,6 +111,9 @@ private slots:
     void spectralConnectivityCoherence();
     void spectralConnectivityImagCoherence();
     void spectralConnectivityXCOR();
+    void packedNetworkEqualsEdgeNetwork();
+    void copyPackedNetwork();
+    void incrementalConnectivityEqualsFull();
     void cleanupTestCase();
 
 private:
@@ -402,6 +412,226 @@ void TestSpectralConnectivity::compareConnectivity()
 }
 
 
+//*************************************************************************************************************
+
+void TestSpectralConnectivity::packedNetworkEqualsEdgeNetwork()
+{
+    //*********************************************************************************************************
+    // Fill a packed and an edge based network with the same weights, including self connections
+    //*********************************************************************************************************
+
+    const int iNumberNodes = 6;
+    const int iNumberBins = 10;
+
+    Network packedNetwork("PLV");
+    Network edgeNetwork("PLV");
+
+    for(int i = 0; i < iNumberNodes; ++i) {
+        packedNetwork.append(NetworkNode::SPtr(new NetworkNode(i, RowVectorXf::Zero(3))));
+        edgeNetwork.append(NetworkNode::SPtr(new NetworkNode(i, RowVectorXf::Zero(3))));
+    }
+
+    packedNetwork.initPackedWeights(iNumberBins);
+
+    MatrixXd matWeight;
+    QSharedPointer<NetworkEdge> pEdge;
+
+    for(int i = 0; i < iNumberNodes; ++i) {
+        for(int j = i; j < iNumberNodes; ++j) {
+            // Self connections get the largest weight, like for COH or PLV. The first edge holds the smallest weight.
+            if(i == j) {
+                matWeight = MatrixXd::Ones(iNumberBins, 1);
+            } else if(i == 0 && j == 1) {
+                matWeight = MatrixXd::Constant(iNumberBins, 1, 0.05);
+            } else {
+                matWeight = MatrixXd::Constant(iNumberBins, 1, 0.1) + (MatrixXd::Random(iNumberBins, 1).array() + 1.0).matrix() * 0.4;
+            }
+
+            packedNetwork.setPackedWeights(i, j, matWeight);
+
+            pEdge = QSharedPointer<NetworkEdge>(new NetworkEdge(i, j, matWeight));
+            edgeNetwork.getNodeAt(i)->append(pEdge);
+            edgeNetwork.getNodeAt(j)->append(pEdge);
+            edgeNetwork.append(pEdge);
+        }
+    }
+
+    packedNetwork.finalizePackedWeights();
+
+    //*********************************************************************************************************
+    // Compare
+    //*********************************************************************************************************
+
+    QVERIFY(packedNetwork.getFullConnectivityMatrix().isApprox(edgeNetwork.getFullConnectivityMatrix(), epsilon));
+    QVERIFY(packedNetwork.getFullConnectivityMatrix().diagonal().isZero());
+    QVERIFY(qAbs(packedNetwork.getMinMaxFullWeights().first - edgeNetwork.getMinMaxFullWeights().first) < epsilon);
+    QVERIFY(qAbs(packedNetwork.getMinMaxFullWeights().second - edgeNetwork.getMinMaxFullWeights().second) < epsilon);
+    QVERIFY(packedNetwork.getMinMaxFullWeights().second < 1.0);
+
+    packedNetwork.setThreshold(0.4);
+    edgeNetwork.setThreshold(0.4);
+
+    QVERIFY(packedNetwork.getThresholdedConnectivityMatrix().isApprox(edgeNetwork.getThresholdedConnectivityMatrix(), epsilon));
+    QCOMPARE(packedNetwork.getFullEdges().size(), edgeNetwork.getFullEdges().size());
+    QCOMPARE(packedNetwork.getThresholdedEdges().size(), edgeNetwork.getThresholdedEdges().size());
+
+    for(int i = 0; i < iNumberNodes; ++i) {
+        QCOMPARE(packedNetwork.getNodeAt(i)->getFullEdges().size(), iNumberNodes - 1);
+    }
+
+    packedNetwork.normalize();
+    edgeNetwork.normalize();
+
+    QVERIFY(packedNetwork.getFullConnectivityMatrix().isApprox(edgeNetwork.getFullConnectivityMatrix(), epsilon));
+
+    //*********************************************************************************************************
+    // The packed metric output ignores self connections as well
+    //*********************************************************************************************************
+
+    Network network = PhaseLockingValue::calculate(m_connectivitySettings);
+    int iNodes = network.getNodes().size();
+
+    QVERIFY(network.getFullConnectivityMatrix().diagonal().isZero());
+    QCOMPARE(network.getFullEdges().size(), iNodes * (iNodes - 1) / 2);
+}
+
+
+//*************************************************************************************************************
+
+void TestSpectralConnectivity::copyPackedNetwork()
+{
+    //*********************************************************************************************************
+    // Copies share the nodes, using a copy must not append the edges to the nodes again
+    //*********************************************************************************************************
+
+    const int iNumberNodes = 8;
+    const int iNumberBins = 4;
+    const int iNumberEdges = iNumberNodes * (iNumberNodes - 1) / 2;
+
+    Network packedNetwork("PLV");
+
+    for(int i = 0; i < iNumberNodes; ++i) {
+        packedNetwork.append(NetworkNode::SPtr(new NetworkNode(i, RowVectorXf::Zero(3))));
+    }
+
+    packedNetwork.initPackedWeights(iNumberBins);
+
+    for(int i = 0; i < iNumberNodes; ++i) {
+        for(int j = i + 1; j < iNumberNodes; ++j) {
+            packedNetwork.setPackedWeights(i, j, MatrixXd::Constant(iNumberBins, 1, 0.1 + 0.8 * ((i + 2 * j) % 7) / 6.0));
+        }
+    }
+
+    // A copy made before the weights are finalized
+    Network copyBefore = packedNetwork;
+
+    packedNetwork.finalizePackedWeights();
+
+    QCOMPARE(packedNetwork.getFullEdges().size(), iNumberEdges);
+
+    for(int iRound = 0; iRound < 3; ++iRound) {
+        // Same as the threshold and color changes of the 3D view, which copy the network and plot it again
+        Network copy = packedNetwork;
+        copy.setThreshold(0.2 + 0.2 * iRound);
+
+        QCOMPARE(copy.getFullEdges().size(), iNumberEdges);
+        QCOMPARE(copy.getFullDistribution(), qint16(2 * iNumberEdges));
+        QCOMPARE(copy.getThresholdedDistribution(), qint16(2 * copy.getThresholdedEdges().size()));
+        QCOMPARE(copy.getMinMaxFullDegrees().second, iNumberNodes - 1);
+
+        copyBefore.getMinMaxFullDegrees();
+        copyBefore.getFullEdges();
+
+        for(int i = 0; i < iNumberNodes; ++i) {
+            QCOMPARE(int(copy.getNodes().at(i)->getFullDegree()), iNumberNodes - 1);
+            QCOMPARE(int(copy.getNodes().at(i)->getFullEdges().size()), iNumberNodes - 1);
+            QCOMPARE(int(copyBefore.getNodes().at(i)->getFullDegree()), iNumberNodes - 1);
+            QCOMPARE(int(packedNetwork.getNodeAt(i)->getFullDegree()), iNumberNodes - 1);
+        }
+    }
+
+    QCOMPARE(packedNetwork.getFullEdges().size(), iNumberEdges);
+    QCOMPARE(packedNetwork.getFullDistribution(), qint16(2 * iNumberEdges));
+}
+
+
+//*************************************************************************************************************
+
+void TestSpectralConnectivity::incrementalConnectivityEqualsFull()
+{
+    //*********************************************************************************************************
+    // Slide a window over the trials, adding and evicting trials in blocks of different size
+    //*********************************************************************************************************
+
+    QList<MatrixXd> matDataList = readConnectivityData();
+    const int iNumberAverages = 5;
+    const int blockSizes[] = {1, 3, 2};
+
+    QVERIFY(matDataList.size() >= 2 * iNumberAverages);
+
+    QStringList lMethods;
+    lMethods << "COH" << "IMAGCOH" << "PLV" << "WPLI";
+
+    QList<Network> incrementalNetworks;
+    ConnectivitySettings connectivitySettingsOut;
+    RtConnectivityWorker worker;
+    connect(&worker, &RtConnectivityWorker::resultReady,
+            [&incrementalNetworks, &connectivitySettingsOut](const QList<Network>& connectivityResults, const ConnectivitySettings& connectivitySettings) {
+                incrementalNetworks = connectivityResults;
+                connectivitySettingsOut = connectivitySettings;
+            });
+
+    int iFrom = 0;
+
+    for(int b = 0; iFrom < matDataList.size(); ++b) {
+        int iBlockSize = qMin(blockSizes[b % 3], matDataList.size() - iFrom);
+
+        ConnectivitySettings newTrials;
+        newTrials.setFFTSize(matDataList.at(0).cols());
+        newTrials.setWindowType("hanning");
+        newTrials.setConnectivityMethods(lMethods);
+        newTrials.append(matDataList.mid(iFrom, iBlockSize));
+
+        incrementalNetworks.clear();
+        worker.doIncrementalWork(newTrials, iNumberAverages);
+        iFrom += iBlockSize;
+
+        // The storage mode is kept by the worker's window and must not leak into the process wide setting
+        QVERIFY(!AbstractMetric::m_bStorageModeIsActive);
+
+        // Only the settings are passed on, neither the trials nor the intermediate sums
+        QVERIFY(connectivitySettingsOut.isEmpty());
+        QVERIFY(!connectivitySettingsOut.isStorageModeActive());
+        QVERIFY(connectivitySettingsOut.getIntermediateSumData().vecPairCsdSum.isEmpty());
+        QVERIFY(connectivitySettingsOut.getIntermediateSumData().matPsdSum.size() == 0);
+        QCOMPARE(connectivitySettingsOut.getConnectivityMethods(), lMethods);
+        QCOMPARE(connectivitySettingsOut.getFFTSize(), int(matDataList.at(0).cols()));
+
+        //*****************************************************************************************************
+        // Compare to a full recomputation over the same window
+        //*****************************************************************************************************
+
+        int iWindowStart = qMax(0, iFrom - iNumberAverages);
+
+        ConnectivitySettings windowTrials;
+        windowTrials.setFFTSize(matDataList.at(0).cols());
+        windowTrials.setWindowType("hanning");
+        windowTrials.setConnectivityMethods(lMethods);
+        windowTrials.append(matDataList.mid(iWindowStart, iFrom - iWindowStart));
+
+        QList<Network> fullNetworks = Connectivity::calculate(windowTrials);
+
+        QCOMPARE(incrementalNetworks.size(), fullNetworks.size());
+
+        // The evicted trials are substracted from the running sums, which costs a few digits
+        for(int i = 0; i < fullNetworks.size(); ++i) {
+            MatrixXd matDiff = incrementalNetworks.at(i).getFullConnectivityMatrix() - fullNetworks.at(i).getFullConnectivityMatrix();
+            QVERIFY(matDiff.cwiseAbs().maxCoeff() < 1e-8);
+        }
+    }
+}
+
+
 //*************************************************************************************************************
 
 void TestSpectralConnectivity::cleanupTestCase()
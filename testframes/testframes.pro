@@ -53,6 +53,10 @@ SUBDIRS += \
     test_fiff_cov \
     test_fiff_digitizer \
     test_mne_msh_display_surface_set \
+    test_rt_buffer_codec \
+    test_lockfree_matrix_buffer \
+    test_minimum_norm \
+    test_hpi_fit \
 
 !contains(MNECPP_CONFIG, minimalVersion) {
     qtHaveModule(charts) {
@@ -61,5 +65,8 @@ SUBDIRS += \
             test_geometryinfo \
             test_spectral_connectivity \
             test_filtering \
+            test_rt_cov \
+            test_rt_ave \
+            test_rt_resample \
     }
 }